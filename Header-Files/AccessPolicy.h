@@ -0,0 +1,29 @@
+# pragma once
+
+// Bounds checking of Matrix::operator() and Vector::operator()/operator[].
+// Debug builds check every index. Release builds (-DNDEBUG) and builds with
+// -DTINI_UNCHECKED_ACCESS skip the check. Element access is then a plain
+// inline load that loops can vectorize.
+namespace bounds {
+
+struct Checked {
+    static constexpr bool enabled = true;
+};
+
+struct Unchecked {
+    static constexpr bool enabled = false;
+};
+
+#if defined(NDEBUG) || defined(TINI_UNCHECKED_ACCESS)
+using Default = Unchecked;
+#else
+using Default = Checked;
+#endif
+
+// True when index lies in [first, last] or the policy does not check
+template <class Policy = Default>
+inline bool inRange(int index, int first, int last) {
+    return !Policy::enabled || (index >= first && index <= last);
+}
+
+}
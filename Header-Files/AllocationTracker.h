@@ -0,0 +1,94 @@
+# pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Accounting of the storage Matrix and Vector allocate. Every buffer goes
+// through allocate()/release(), which keep per-type totals (allocations,
+// frees, bytes, live and peak live bytes) for the whole program.
+//
+// A Scope additionally counts what the calling thread allocates while it is
+// alive, nested scopes included, so a test can assert on a hot path:
+//
+//   allocation::Scope scope("CG solve");
+//   system.Solve();
+//   assert(scope.allocations() == 4);
+//
+// Closed scopes are summed per site name; ALLOCATION_SITE() opens a scope
+// named after its file and line. Allocations made on other threads (e.g. by
+// the thread pool) are in the totals but not in the scope.
+namespace allocation {
+
+enum class Kind { Matrix, Vector };
+
+struct Stats {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes;      // allocated, frees do not subtract
+    int64_t liveBytes;   // allocated minus freed
+    int64_t peakBytes;   // highest liveBytes seen
+};
+
+struct SiteStats {
+    std::string site;
+    uint64_t scopes;     // number of times the scope was closed
+    Stats stats;         // summed over both kinds, peak is the largest of one scope
+};
+
+// Storage for count doubles of the given kind, zeroed on request
+double* allocate(Kind kind, size_t count, bool zero);
+void release(Kind kind, double* data, size_t count);
+
+// Program-wide totals for one kind
+Stats totals(Kind kind);
+
+// Closed scopes merged by site name, most bytes first
+std::vector<SiteStats> sites();
+
+// Zero the counters and forget the sites, live bytes are kept
+void reset();
+
+void writeText(std::ostream& out);
+
+class Scope {
+private:
+    const char* mSite;
+    Scope* mpParent;
+    Stats mStats[2];
+    int64_t mLiveBytes;
+    int64_t mPeakBytes;
+
+    friend double* allocate(Kind, size_t, bool);
+    friend void release(Kind, double*, size_t);
+
+    void add(Kind kind, int64_t bytes, bool allocated);
+
+public:
+    explicit Scope(const char* site);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    // Counts of both kinds since the scope opened
+    uint64_t allocations() const;
+    uint64_t frees() const;
+    uint64_t bytes() const;
+
+    // Highest live bytes allocated inside the scope at any point
+    int64_t peakBytes() const;
+
+    const Stats& stats(Kind kind) const;
+};
+
+}
+
+#define ALLOCATION_STRINGIFY_INNER(x) #x
+#define ALLOCATION_STRINGIFY(x) ALLOCATION_STRINGIFY_INNER(x)
+#define ALLOCATION_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_INNER(a, b)
+#define ALLOCATION_SITE() \
+    allocation::Scope ALLOCATION_CONCAT(allocationScope, __LINE__)(__FILE__ ":" ALLOCATION_STRINGIFY(__LINE__))
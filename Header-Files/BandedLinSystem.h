@@ -0,0 +1,27 @@
+# pragma once
+
+#include "BandedMatrix.h"
+#include "LinearSystem.h"
+
+// Band systems in O(n·kl·(kl+ku)) time and O(n·(2kl+ku+1)) memory.
+// Solve() and SolveMultiple() use band LU with partial pivoting (row swaps
+// widen U to kl+ku superdiagonals, as in LAPACK gbtrf); SolveCholesky()
+// factors a symmetric positive definite band matrix as LLᵀ within the band.
+class BandedLinSystem : public LinearSystem {
+private:
+    BandedMatrix* mpBanded;
+
+    // Overwrite the n x s right-hand sides X with the solution
+    void LUSolve(Matrix& X) const;
+    void CholeskySolve(Matrix& X) const;
+
+public:
+    BandedLinSystem(BandedMatrix* A, Vector* b);
+    BandedLinSystem(BandedMatrix* A, Matrix* B);
+    virtual ~BandedLinSystem();
+
+    virtual Vector Solve() override;
+    virtual Matrix SolveMultiple() override;
+
+    Vector SolveCholesky();
+};
@@ -0,0 +1,40 @@
+# pragma once
+
+#include <vector>
+#include "Matrix.h"
+#include "Vector.h"
+
+// Band matrix with kl subdiagonals and ku superdiagonals, O(n·(kl+ku+1))
+// memory. Row i (zero-based) stores columns i-kl .. i+ku contiguously, so
+// entry (i, j) lives at data()[i*(kl+ku+1) + j-i+kl].
+class BandedMatrix {
+private:
+    int mSize;
+    int mLowerBandwidth;
+    int mUpperBandwidth;
+    std::vector<double> mData;
+
+public:
+    BandedMatrix(int size, int lowerBandwidth, int upperBandwidth);
+
+    int size() const;
+    int lowerBandwidth() const;
+    int upperBandwidth() const;
+
+    // Entry (i, j), one-based; must lie inside the band
+    double& operator()(int i, int j);
+    // Value at (i, j), one-based; zero outside the band
+    double operator()(int i, int j) const;
+
+    bool inBand(int i, int j) const;
+
+    // y = A*x on raw arrays
+    void multiply(const double* x, double* y) const;
+
+    Vector operator*(Vector& v) const;
+
+    Matrix toDense() const;
+
+    // Row-major band storage, kl+ku+1 values per row
+    const double* data() const;
+};
@@ -0,0 +1,15 @@
+# pragma once
+
+#include "KrylovLinSystem.h"
+
+// BiCGSTAB (van der Vorst) with right preconditioning: two operator and two
+// preconditioner applications per iteration and a fixed set of seven work vectors.
+class BiCGSTABLinSystem : public KrylovLinSystem {
+public:
+    BiCGSTABLinSystem(Matrix* A, Vector* b);
+    BiCGSTABLinSystem(SparseMatrix* A, Vector* b);
+    BiCGSTABLinSystem(LinearOperator* A, Vector* b);
+    virtual ~BiCGSTABLinSystem();
+
+    virtual Vector Solve() override;
+};
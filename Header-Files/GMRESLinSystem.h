@@ -0,0 +1,19 @@
+# pragma once
+
+#include "KrylovLinSystem.h"
+
+// Restarted GMRES(m) with modified Gram-Schmidt Arnoldi and Givens rotations.
+// The (m+1) x n Krylov basis and the Hessenberg matrix are allocated once per
+// Solve() and reused across restarts.
+class GMRESLinSystem : public KrylovLinSystem {
+private:
+    int mRestart;
+
+public:
+    GMRESLinSystem(Matrix* A, Vector* b, int restart = 30);
+    GMRESLinSystem(SparseMatrix* A, Vector* b, int restart = 30);
+    GMRESLinSystem(LinearOperator* A, Vector* b, int restart = 30);
+    virtual ~GMRESLinSystem();
+
+    virtual Vector Solve() override;
+};
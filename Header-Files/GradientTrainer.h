@@ -0,0 +1,94 @@
+# pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "Matrix.h"
+#include "Vector.h"
+
+// Step rule of GradientTrainer
+enum class GradientMethod {
+    SGD,        // θ -= η g
+    Momentum,   // v = β v + g, θ -= η v
+    Adam        // Bias-corrected first and second moment estimates
+};
+
+// How GradientTrainer uses the thread pool
+enum class GradientUpdate {
+    Reduction,  // Each batch gradient is summed over row chunks in parallel; same result on any thread count
+    Hogwild     // Every thread runs its own batches against the shared θ without locks
+};
+
+// Training progress after one epoch, as recorded by GradientTrainer::History()
+struct TrainingEpoch {
+    double seconds;     // Training time so far, objective evaluations excluded
+    double objective;   // f(θ) after the epoch
+};
+
+// Mini-batch gradient descent on the ridge least-squares objective
+//   f(θ) = ||Aθ - b||² / (2m) + λ ||θ||² / 2
+// for designs too large to factor. Batches are runs of consecutive rows of A,
+// by default as many as fit in about 128 KB, so a batch is streamed through
+// the cache once: each row is read for its residual and used again for the
+// gradient while it is still in L1. The order of the batches is shuffled
+// every epoch. The constructor allocates all work storage.
+class GradientTrainer {
+private:
+    const Matrix* mpA;
+    const Vector* mpb;
+    int mNumRows;
+    int mNumCols;
+    GradientMethod mMethod;
+    GradientUpdate mUpdate;
+    double mLearningRate;
+    double mDecay;
+    double mMomentum;
+    double mL2;
+    int mBatchSize;
+    int mEpochs;
+    unsigned mSeed;
+
+    Vector* mpTheta;
+    std::unique_ptr<std::atomic<double>[]> mShared;   // θ shared by the Hogwild threads
+    std::vector<double> mWork;        // Per thread: gradient, θ snapshot and two moment vectors
+    std::vector<double> mPartials;    // Gradient of each row chunk of a batch
+    std::vector<int> mOrder;          // Batch order of the current epoch
+    std::vector<TrainingEpoch> mHistory;
+
+public:
+    GradientTrainer(const Matrix* A, const Vector* b);
+    ~GradientTrainer();
+
+    // Train from zero, or from given coefficients
+    const Vector& Train();
+    const Vector& Train(const Vector& start);
+
+    void SetMethod(GradientMethod method);        // Default Adam
+    void SetUpdate(GradientUpdate update);        // Default Reduction
+    void SetLearningRate(double learningRate);    // η, default 0.01
+    void SetDecay(double decay);                  // η / (1 + decay·epoch), default 0
+    void SetMomentum(double momentum);            // β of Momentum, β1 of Adam, default 0.9
+    void SetL2(double lambda);                    // Default 0
+    void SetBatchSize(int batchSize);             // Rows per batch, clipped to the number of rows
+    void SetEpochs(int epochs);                   // Default 20
+    void SetSeed(unsigned seed);                  // Batch shuffling
+
+    int BatchSize() const;
+    const Vector& Coefficients() const;
+    const std::vector<TrainingEpoch>& History() const;   // Entry 0 is the start
+    double Objective(const Vector& theta) const;
+
+private:
+    void RunEpochReduction(int epoch, long& step);
+    void RunEpochHogwild(int epoch, std::vector<long>& steps);
+    // g = Σ (a_i·θ - b_i) a_i over rows [first, last)
+    void BatchGradient(int first, int last, const double* theta, double* g) const;
+    // Turns the gradient into a step and subtracts it: from θ, or from the shared θ
+    void ApplyStep(double* g, const double* theta, double* state, long step, double rate, double* target,
+                   std::atomic<double>* shared) const;
+    double* ThreadWork(int thread);
+
+    // Disabled copy constructor and assignment operator
+    GradientTrainer(const GradientTrainer&);
+    GradientTrainer& operator=(const GradientTrainer&);
+};
@@ -0,0 +1,83 @@
+# pragma once
+
+#include <cstddef>
+#include "MatrixView.h"
+
+// Dense kernels on row-major storage. Every matrix argument is a pointer to
+// its first element plus a leading dimension (the distance between rows), so
+// the kernels work equally on whole matrices and on sub-blocks of them.
+// Indices are zero-based here; Matrix and Vector keep their one-based API.
+namespace kernels {
+
+// C = alpha*A*B + beta*C with A m x k, B k x n and C m x n (cache blocked, parallel over rows)
+void gemm(int m, int n, int k, double alpha, const double* A, int lda,
+          const double* B, int ldb, double beta, double* C, int ldc);
+
+// C = A*B by Strassen-Winograd recursion (7 half-size products per level).
+// Sub-products with any dimension <= crossover use gemm; odd dimensions are
+// peeled off and fixed up with gemm. Extra memory is at most
+// strassenWorkspace(m, n, k, crossover) doubles when run on one thread; with
+// more threads the top level also keeps its seven operands and three
+// products, about 2.75x the size of C for square inputs.
+void strassen(int m, int n, int k, const double* A, int lda, const double* B, int ldb,
+              double* C, int ldc, int crossover);
+size_t strassenWorkspace(int m, int n, int k, int crossover);
+
+// y = A*x with A m x n (parallel over rows)
+void gemv(int m, int n, const double* A, int lda, const double* x, double* y);
+
+// Level 1 operations on contiguous arrays of length n, parallel for long
+// arrays. dot and nrm2 add fixed blocks pairwise, so their results are
+// bitwise identical for any number of threads.
+double dot(int n, const double* x, const double* y);
+double nrm2(int n, const double* x);
+void axpy(int n, double alpha, const double* x, double* y);   // y += alpha*x
+void dot2(int n, const double* x, const double* y, const double* v, double* result);   // x·v and y·v in one pass
+void axpby(int n, double alpha, const double* x, double beta, double* y);   // y = alpha*x + beta*y
+
+// Solve L*X = B in place of B, L lower triangular m x m, B m x n
+void trsmLower(int m, int n, const double* L, int ldl, bool unitDiagonal, double* B, int ldb);
+
+// Solve U*X = B in place of B, U upper triangular m x m with non-unit diagonal
+void trsmUpper(int m, int n, const double* U, int ldu, double* B, int ldb);
+
+// Swap row i with row piv[i] for i in [k1, k2) over ncols columns
+void swapRows(double* A, int lda, int ncols, int k1, int k2, const int* piv);
+
+// Householder QR of the m x n block A (m >= n). R overwrites the upper
+// triangle, the Householder vectors (implicit leading 1) the part below it,
+// and tau receives the n reflector scalars.
+void householderQR(int m, int n, double* A, int lda, double* tau);
+
+// Thin Q (m x n) from the output of householderQR
+void formQ(int m, int n, const double* A, int lda, const double* tau, double* Q, int ldq);
+
+// B = Qᵀ B for the m x nrhs block B, Q from householderQR
+void applyQt(int m, int n, const double* A, int lda, const double* tau, int nrhs, double* B, int ldb);
+
+// Recursive LU with partial pivoting of the m x n block A (m >= n), PA = LU.
+// L (unit diagonal) and U overwrite A and piv[i] is the row swapped with row i.
+// Returns 0, or one plus the index of the first exactly zero pivot.
+int luFactor(int m, int n, double* A, int lda, int* piv);
+
+// Solve AX = B with the factors from luFactor, overwriting the n x nrhs block B
+void luSolve(int n, int nrhs, const double* LU, int lda, const int* piv, double* B, int ldb);
+
+// View overloads: the same kernels taking sizes and leading dimensions from
+// MatrixView/VectorView. Vector views may be strided (e.g. matrix columns).
+void gemm(double alpha, ConstMatrixView A, ConstMatrixView B, double beta, MatrixView C);
+void strassen(ConstMatrixView A, ConstMatrixView B, MatrixView C, int crossover);
+void gemv(ConstMatrixView A, ConstVectorView x, VectorView y);
+double dot(ConstVectorView x, ConstVectorView y);
+double nrm2(ConstVectorView x);
+void axpy(double alpha, ConstVectorView x, VectorView y);
+void trsmLower(ConstMatrixView L, bool unitDiagonal, MatrixView B);
+void trsmUpper(ConstMatrixView U, MatrixView B);
+void swapRows(MatrixView A, int k1, int k2, const int* piv);
+void householderQR(MatrixView A, double* tau);
+void formQ(ConstMatrixView A, const double* tau, MatrixView Q);
+void applyQt(ConstMatrixView A, const double* tau, MatrixView B);
+int luFactor(MatrixView A, int* piv);
+void luSolve(ConstMatrixView LU, const int* piv, MatrixView B);
+
+}
@@ -0,0 +1,69 @@
+# pragma once
+
+#include <vector>
+#include "LinearOperator.h"
+#include "Matrix.h"
+#include "SparseMatrix.h"
+#include "Vector.h"
+
+// Iteration used by KrylovLeastSquares. Both are mathematically CG on the
+// normal equations; LSQR (Paige and Saunders) gets there through Golub-Kahan
+// bidiagonalization and is the more stable of the two on ill-conditioned A,
+// CGLS is simpler and needs one vector update less per iteration.
+enum class LeastSquaresMethod { LSQR, CGLS };
+
+// Least-squares solve of min ||Ax - b||² + damping²·||x||² for rectangular A
+// (m x n, any shape) using only the products A*v and Aᵀ*u, so AᵀA is never
+// formed and its condition number is never squared into the arithmetic. A is
+// a dense Matrix, a SparseMatrix or any LinearOperator with a transpose.
+//
+// The iteration stops early when ||b - Ax|| <= tolerance·(||b|| + ||A||·||x||)
+// (compatible systems) or when the normal-equation residual
+// ||Aᵀ(b - Ax) - damping²x|| <= tolerance·||A||·||r|| (least-squares
+// solutions), with ||A|| estimated on the way. All work vectors are
+// allocated once by the constructor.
+class KrylovLeastSquares {
+private:
+    LinearOperator* mpOperator;   // Used for every product with A and Aᵀ
+    bool mOwnsOperator;           // True for the Matrix/SparseMatrix adapters
+    const Vector* mpb;
+    int mNumRows;
+    int mNumCols;
+    LeastSquaresMethod mMethod;
+    double mDamping;
+    double mTolerance;
+    int mMaxIterations;
+    int mIterations;
+    bool mConverged;
+    double mResidualNorm;         // ||b - Ax|| of the returned solution
+    double mNormalResidualNorm;   // ||Aᵀ(b - Ax) - damping²x|| as last estimated
+    std::vector<double> mWork;    // 2 m + 3 n doubles
+
+public:
+    KrylovLeastSquares(const Matrix* A, const Vector* b);
+    KrylovLeastSquares(const SparseMatrix* A, const Vector* b);
+    KrylovLeastSquares(LinearOperator* A, const Vector* b);
+    ~KrylovLeastSquares();
+
+    KrylovLeastSquares(const KrylovLeastSquares&) = delete;
+    KrylovLeastSquares& operator=(const KrylovLeastSquares&) = delete;
+
+    // Solution x of length n
+    Vector Solve();
+
+    void SetMethod(LeastSquaresMethod method);
+    void SetDamping(double damping);          // Ridge parameter λ (not λ²), default 0
+    void SetTolerance(double tolerance);      // Default 1e-10
+    void SetMaxIterations(int maxIterations); // Default max(2 n, 100)
+
+    int Iterations() const;
+    bool Converged() const;
+    double ResidualNorm() const;
+    double NormalResidualNorm() const;
+
+private:
+    void Initialize();
+    bool Stop(double residual, double normalResidual, double aNorm, double bNorm, double xNorm) const;
+    void SolveLSQR(double* x);
+    void SolveCGLS(double* x);
+};
@@ -0,0 +1,52 @@
+# pragma once
+
+#include <vector>
+#include "LinearSystem.h"
+#include "LinearOperator.h"
+#include "Preconditioner.h"
+#include "SparseMatrix.h"
+
+// Shared state of the Krylov solvers for general (nonsymmetric) systems.
+// The operator is a dense Matrix, a SparseMatrix or any LinearOperator
+// (matrix-free); the optional
+// preconditioner is applied from the right, so the residual the solvers
+// monitor is the true residual ||b - Ax||.
+class KrylovLinSystem : public LinearSystem {
+protected:
+    LinearOperator* mpOperator;         // Used for every product with A
+    bool mOwnsOperator;                 // True for the Matrix/SparseMatrix adapters
+    Preconditioner* mpPreconditioner;   // Not owned, may be null
+    double mTolerance;                  // Stop when ||b - Ax|| <= tolerance * ||b||
+    int mMaxIterations;
+    int mIterations;
+    double mResidualNorm;
+    std::vector<double> mResidualHistory;
+
+    KrylovLinSystem(Matrix* A, Vector* b);
+    KrylovLinSystem(SparseMatrix* A, Vector* b);
+    KrylovLinSystem(LinearOperator* A, Vector* b);
+
+    // y = A*x and z = M⁻¹r on arrays of the system size
+    void ApplyOperator(const double* x, double* y) const;
+    void ApplyPreconditioner(const double* r, double* z) const;
+
+    // Right-hand side as a plain array
+    std::vector<double> RhsArray() const;
+
+    // Record the true final residual and report non-convergence like CG does
+    Vector Finish(const std::vector<double>& x, bool converged, const char* method);
+
+public:
+    virtual ~KrylovLinSystem();
+
+    KrylovLinSystem(const KrylovLinSystem&) = delete;
+    KrylovLinSystem& operator=(const KrylovLinSystem&) = delete;
+
+    void SetTolerance(double tolerance);
+    void SetMaxIterations(int maxIterations);
+    void SetPreconditioner(Preconditioner* preconditioner);
+
+    int Iterations() const;
+    double ResidualNorm() const;
+    const std::vector<double>& ResidualHistory() const;
+};
@@ -0,0 +1,69 @@
+# pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Vector.h"
+
+// Fitted linear regression ready for scoring. The model is fitted on z-scored
+// features, y = Σ c_j (x_j - mean_j) / sd_j; the constructor folds the
+// normalization into raw-feature weights w_j = c_j / sd_j and an intercept
+// b = -Σ c_j mean_j / sd_j, so a prediction is one dot product on the raw row
+// with nothing to normalize or look up.
+//
+// Models are saved as a 32-byte header followed by the means, standard
+// deviations, fitted coefficients and folded weights (numFeatures doubles
+// each) and the intercept, in native byte order.
+class LinearModel {
+public:
+    struct FileHeader {
+        char magic[8];              // "TINIMDL"
+        uint32_t version;
+        uint32_t numFeatures;
+        int64_t reserved[2];
+    };
+
+private:
+    int mNumFeatures;
+    std::vector<double> mMeans;
+    std::vector<double> mStddevs;
+    std::vector<double> mCoefficients;  // On z-scored features, as fitted
+    std::vector<double> mWeights;       // On raw features
+    double mIntercept;
+
+    LinearModel();
+
+public:
+    // Coefficients fitted on features normalized with the given statistics;
+    // every standard deviation must be positive
+    LinearModel(const Vector& coefficients, const Vector& means, const Vector& stddevs);
+
+    void save(const std::string& path) const;
+    static LinearModel load(const std::string& path);
+
+    int numFeatures() const;
+    double intercept() const;
+    const std::vector<double>& weights() const;
+    const std::vector<double>& coefficients() const;
+    const std::vector<double>& means() const;
+    const std::vector<double>& stddevs() const;
+
+    // Prediction for one raw row of numFeatures() values
+    double predict(const double* x) const {
+        const double* w = mWeights.data();
+        double sum = mIntercept;
+        for (int j = 0; j < mNumFeatures; ++j) {
+            sum += w[j] * x[j];
+        }
+        return sum;
+    }
+
+    // Predictions for numRows rows stored ldx doubles apart, on the thread pool
+    void predict(const double* X, int numRows, int ldx, double* y) const;
+
+    // Scores CSV text, one row per line, and appends one prediction per line
+    // to out. A line holds either numFeatures() values or a machine.data
+    // record (vendor, model, then the features); empty lines are skipped.
+    // Throws invalid_argument naming the first malformed line.
+    void score(const char* begin, const char* end, std::string& out) const;
+};
@@ -0,0 +1,118 @@
+# pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "Matrix.h"
+#include "SparseMatrix.h"
+
+// Anything that can compute y = A*x. Iterative solvers only need this, so
+// stencils, implicit Gram matrices and other operators never have to be
+// stored as a dense Matrix. The diagonal and the transpose product are
+// optional; check hasDiagonal()/hasTranspose() before calling them.
+class LinearOperator {
+public:
+    virtual ~LinearOperator() {}
+
+    virtual int numRows() const = 0;
+    virtual int numCols() const = 0;
+
+    // y = A*x, x of length numCols() and y of length numRows()
+    virtual void apply(const double* x, double* y) const = 0;
+
+    // Y = A*X for row-major blocks of s columns (X numCols() x s, Y numRows() x s).
+    // The default calls apply() once per column; stored matrices override it
+    // so that A is read once for all columns.
+    virtual void applyBlock(int s, const double* X, int ldx, double* Y, int ldy) const;
+
+    virtual bool hasDiagonal() const;
+    virtual void diagonal(double* d) const;
+
+    // y = Aᵀ*x, x of length numRows() and y of length numCols()
+    virtual bool hasTranspose() const;
+    virtual void applyTranspose(const double* x, double* y) const;
+};
+
+// Dense Matrix, not owned
+class DenseOperator : public LinearOperator {
+private:
+    const Matrix* mpA;
+
+public:
+    explicit DenseOperator(const Matrix* A);
+
+    virtual int numRows() const override;
+    virtual int numCols() const override;
+    virtual void apply(const double* x, double* y) const override;
+    virtual void applyBlock(int s, const double* X, int ldx, double* Y, int ldy) const override;
+    virtual bool hasDiagonal() const override;
+    virtual void diagonal(double* d) const override;
+    virtual bool hasTranspose() const override;
+    virtual void applyTranspose(const double* x, double* y) const override;
+};
+
+// CSR SparseMatrix, not owned
+class SparseOperator : public LinearOperator {
+private:
+    const SparseMatrix* mpA;
+
+public:
+    explicit SparseOperator(const SparseMatrix* A);
+
+    virtual int numRows() const override;
+    virtual int numCols() const override;
+    virtual void apply(const double* x, double* y) const override;
+    virtual void applyBlock(int s, const double* X, int ldx, double* Y, int ldy) const override;
+    virtual bool hasDiagonal() const override;
+    virtual void diagonal(double* d) const override;
+    virtual bool hasTranspose() const override;
+    virtual void applyTranspose(const double* x, double* y) const override;
+};
+
+// Operator given by callables, e.g. a stencil lambda. The transpose product
+// and the diagonal are optional.
+class FunctionOperator : public LinearOperator {
+public:
+    typedef std::function<void(const double*, double*)> ApplyFunction;
+
+private:
+    int mNumRows;
+    int mNumCols;
+    ApplyFunction mApply;
+    ApplyFunction mApplyTranspose;
+    std::vector<double> mDiagonal;
+
+public:
+    FunctionOperator(int numRows, int numCols, ApplyFunction apply,
+                     ApplyFunction applyTranspose = ApplyFunction(),
+                     const std::vector<double>& diagonal = std::vector<double>());
+
+    virtual int numRows() const override;
+    virtual int numCols() const override;
+    virtual void apply(const double* x, double* y) const override;
+    virtual bool hasDiagonal() const override;
+    virtual void diagonal(double* d) const override;
+    virtual bool hasTranspose() const override;
+    virtual void applyTranspose(const double* x, double* y) const override;
+};
+
+// Implicit Gram operator AᵀA + shift*I (symmetric, numCols x numCols);
+// A must provide the transpose product and is not owned. apply() keeps A*x
+// in a buffer allocated once; concurrent calls are safe, because a call
+// that finds the buffer taken uses a temporary one instead.
+class GramOperator : public LinearOperator {
+private:
+    const LinearOperator* mpA;
+    double mShift;
+    mutable std::vector<double> mWork;   // A*x, length numRows of A
+    mutable std::atomic<bool> mWorkInUse;
+
+public:
+    explicit GramOperator(const LinearOperator* A, double shift = 0.0);
+
+    virtual int numRows() const override;
+    virtual int numCols() const override;
+    virtual void apply(const double* x, double* y) const override;
+    virtual bool hasTranspose() const override;
+    virtual void applyTranspose(const double* x, double* y) const override;
+};
@@ -9,22 +9,44 @@ protected:
     int mSize;
     Matrix* mpA;
     Vector* mpb;
+    Matrix* mpB;   // Right-hand sides stored column by column (optional)
 
 public:
     // Constructor
     LinearSystem(Matrix* A, Vector* b);
 
+    // Constructor for several right-hand sides, one per column of B
+    LinearSystem(Matrix* A, Matrix* B);
+
     // Destructor
     virtual ~LinearSystem();
 
     // Solve method to be overridden in derived classes
     virtual Vector Solve();
 
+    // Solve AX = B for all right-hand sides with a single factorization
+    virtual Matrix SolveMultiple();
+
     // Accessor methods
     int Size() const;
     Matrix* GetMatrix() const;
     Vector* GetVector() const;
-    
+    Matrix* GetRhsMatrix() const;
+
+protected:
+    // Constructor for systems whose operator is not a dense Matrix (mpA is null)
+    LinearSystem(int size, Vector* b);
+    LinearSystem(int size, Matrix* B);
+
+    // Right-hand sides as an n x s matrix (wraps b when only a vector was given)
+    Matrix RhsMatrix() const;
+
+    // Blocked triangular solves (TRSM) overwriting X with the solution.
+    // L is lower triangular, U is upper triangular; only the relevant
+    // triangle is read, so packed LU factors can be passed directly.
+    static void ForwardSubstitution(const Matrix& L, Matrix& X, bool unitDiagonal);
+    static void BackSubstitution(const Matrix& U, Matrix& X);
+
 private:
     // Disabled copy constructor and assignment operator
     LinearSystem (const LinearSystem&);
@@ -0,0 +1,108 @@
+# pragma once
+
+#include <cstdint>
+#include <string>
+#include "Matrix.h"
+#include "MatrixView.h"
+#include "Vector.h"
+
+// Dense matrix stored in a binary file and mapped into memory, so operators
+// larger than RAM can be multiplied without loading them. The file holds a
+// 64-byte header followed by a page-aligned payload of doubles in native
+// byte order, either row-major (rows padded to a multiple of 8 doubles) or
+// tiled (tileSize x tileSize tiles, row-major inside a tile and tiles in
+// row-major order, edge tiles padded to full size).
+//
+// Modes: ReadOnly maps the file shared and read-only; CopyOnWrite maps it
+// privately so writes stay in memory and the file is never modified;
+// ReadWrite maps it shared so writes reach the file (see flush()).
+// On Windows the file is read into memory instead of mapped.
+class MappedMatrix {
+public:
+    enum class Mode { ReadOnly, CopyOnWrite, ReadWrite };
+    enum class Layout { RowMajor, Tiled };
+
+    struct FileHeader {
+        char magic[8];              // "TINIMAT"
+        uint32_t version;
+        uint32_t layout;            // 0 row-major, 1 tiled
+        int64_t numRows;
+        int64_t numCols;
+        int64_t stride;             // doubles per row (row-major) or tile size (tiled)
+        int64_t payloadOffset;      // bytes from the start of the file
+        int64_t reserved[2];
+    };
+
+private:
+    int mNumRows;
+    int mNumCols;
+    Layout mLayout;
+    int mStride;                    // see FileHeader::stride
+    Mode mMode;
+    char* mBase;                    // start of the mapping (or of the loaded copy)
+    size_t mMappedBytes;
+    double* mData;                  // start of the payload
+#ifdef _WIN32
+    std::string mPath;              // written back by flush()
+#endif
+
+    const double* tileData(int ti, int tj) const;
+    void advise(const double* begin, size_t bytes, bool willNeed) const;
+
+    // Disabled copy constructor and assignment operator
+    MappedMatrix(const MappedMatrix&);
+    MappedMatrix& operator=(const MappedMatrix&);
+
+public:
+    MappedMatrix(const std::string& path, Mode mode = Mode::ReadOnly);
+    ~MappedMatrix();
+
+    // Write A to path in the given layout
+    static void write(const std::string& path, const Matrix& A,
+                      Layout layout = Layout::RowMajor, int tileSize = 256);
+    // Create a zero matrix file of the given size to be filled through a
+    // ReadWrite mapping (no memory proportional to the matrix is used)
+    static void create(const std::string& path, int numRows, int numCols,
+                       Layout layout = Layout::RowMajor, int tileSize = 256);
+
+    int numRows() const;
+    int numCols() const;
+    Layout layout() const;
+    Mode mode() const;
+    int tileSize() const;
+
+    // One-based element access
+    double operator()(int i, int j) const;
+
+    // Whole matrix as a view (row-major layout only)
+    ConstMatrixView view() const;
+
+    // Tile (ti, tj), one-based, as a view of its actual extent (tiled layout only)
+    ConstMatrixView tile(int ti, int tj) const;
+    int numTileRows() const;
+    int numTileCols() const;
+
+    // Writing needs CopyOnWrite or ReadWrite; these throw for ReadOnly mappings
+    void set(int i, int j, double value);
+    MatrixView writableView();
+    MatrixView writableTile(int ti, int tj);
+
+    // Load the whole matrix into memory
+    Matrix toMatrix() const;
+
+    // Out-of-core products streaming A panel by panel (or tile row by tile
+    // row): the next panel is prefetched with madvise(WILLNEED) and, unless
+    // the mapping is copy-on-write, consumed panels are released again
+    void multiply(const double* x, double* y) const;              // y = A*x
+    void multiply(ConstMatrixView B, MatrixView C) const;         // C = A*B
+
+    Vector operator*(Vector& v) const;
+    Matrix operator*(const Matrix& B) const;
+
+    // Bytes of a row-major matrix handled per streaming step (default 32 MB)
+    static void setStreamPanelBytes(size_t bytes);
+    static size_t streamPanelBytes();
+
+    // Write modified pages of a ReadWrite mapping back to the file
+    void flush();
+};
@@ -1,5 +1,11 @@
 # pragma once
+#include <cassert>
 #include <iostream>
+#include "AccessPolicy.h"
+#include "MatrixView.h"
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
 class Vector;
 
@@ -7,7 +13,7 @@ class Matrix {
 private:
     int mNumRows;
     int mNumCols;
-    double** mData;
+    double* mData;   // Row-major, element (i, j) at mData[(i-1)*mNumCols + (j-1)]
 
 public:
     // Constructor
@@ -16,6 +22,9 @@ public:
     // Copy Constructor
     Matrix(const Matrix& other);
 
+    // Copy of the elements a view refers to
+    explicit Matrix(ConstMatrixView view);
+
     // Destructor
     ~Matrix();
 
@@ -23,10 +32,39 @@ public:
     int numRows() const;
     int numCols() const;
 
-    // Overloaded round bracket operator for one-based indexing
+    // Raw row-major storage (leading dimension numCols()) for the dense kernels
+    double* data();
+    const double* data() const;
+
+    // Iterators over all elements in row-major order
+    double* begin() { return mData; }
+    double* end() { return mData + (size_t)mNumRows * mNumCols; }
+    const double* begin() const { return mData; }
+    const double* end() const { return mData + (size_t)mNumRows * mNumCols; }
+
+#if __cplusplus >= 202002L
+    std::span<double> span() { return {mData, (size_t)mNumRows * mNumCols}; }
+    std::span<const double> span() const { return {mData, (size_t)mNumRows * mNumCols}; }
+    std::span<double> rowSpan(int i) { return {mData + (size_t)(i - 1) * mNumCols, (size_t)mNumCols}; }
+    std::span<const double> rowSpan(int i) const { return {mData + (size_t)(i - 1) * mNumCols, (size_t)mNumCols}; }
+#endif
+
+    // Overloaded round bracket operator for one-based indexing, checked in
+    // debug builds only (AccessPolicy.h)
     double& operator()(int i, int j);
     double operator()(int i, int j) const;
 
+    // Views without copying: the whole matrix, the rows x cols block whose
+    // top-left element is (i, j), row i and column j (one-based)
+    MatrixView view();
+    ConstMatrixView view() const;
+    MatrixView block(int i, int j, int rows, int cols);
+    ConstMatrixView block(int i, int j, int rows, int cols) const;
+    VectorView row(int i);
+    ConstVectorView row(int i) const;
+    VectorView col(int j);
+    ConstVectorView col(int j) const;
+
     // Overloaded assignment operator
     Matrix& operator=(const Matrix& other);
 
@@ -41,6 +79,15 @@ public:
     Matrix operator*(const Matrix& other) const;
     Matrix operator*(double scalar) const;
 
+    // Strassen-Winograd product; blocks of at most crossover rows/columns
+    // use the classical blocked kernel
+    Matrix strassenProduct(const Matrix& other, int crossover) const;
+
+    // Let operator* switch to Strassen-Winograd for products whose dimensions
+    // all exceed crossover (0, the default, keeps the classical kernel)
+    static void setStrassenCrossover(int crossover);
+    static int strassenCrossover();
+
     Vector operator*(Vector& v) const;
 
     double determinant() const;
@@ -49,3 +96,13 @@ public:
 
     Matrix pseudoInverse() const;
 };
+
+inline double& Matrix::operator()(int i, int j) {
+    assert(bounds::inRange(i, 1, mNumRows) && bounds::inRange(j, 1, mNumCols));
+    return mData[(size_t)(i - 1) * mNumCols + (j - 1)];
+}
+
+inline double Matrix::operator()(int i, int j) const {
+    assert(bounds::inRange(i, 1, mNumRows) && bounds::inRange(j, 1, mNumCols));
+    return mData[(size_t)(i - 1) * mNumCols + (j - 1)];
+}
@@ -0,0 +1,41 @@
+# pragma once
+
+#include <string>
+#include "Matrix.h"
+#include "SparseMatrix.h"
+
+// Matrix Market (.mtx) files: coordinate and array formats with real,
+// integer or pattern values and general or symmetric storage. The entries
+// are parsed in parallel: the data section is split into chunks at line
+// boundaries and every chunk is read with std::from_chars on the thread pool.
+// Symmetric files store one triangle; the readers mirror it, so a symmetric
+// coordinate file becomes a full SparseMatrix without any dense expansion
+// (wrap it in a SparseOperator to hand it to PosSymLinSystem).
+namespace matrixmarket {
+
+enum class Format { Coordinate, Array };
+enum class Field { Real, Integer, Pattern };
+enum class Symmetry { General, Symmetric };
+
+struct Header {
+    Format format;
+    Field field;
+    Symmetry symmetry;
+    int numRows;
+    int numCols;
+    long long numEntries;      // stored entries (one triangle for symmetric files)
+};
+
+Header readHeader(const std::string& path);
+
+Matrix readDense(const std::string& path);
+SparseMatrix readSparse(const std::string& path);
+
+// Array format for dense matrices, coordinate format for sparse ones. With
+// Symmetry::Symmetric only the lower triangle is written; the matrix must be
+// square (symmetry itself is not checked). Values are written with the
+// shortest representation that reads back exactly.
+void write(const std::string& path, const Matrix& A, Symmetry symmetry = Symmetry::General);
+void write(const std::string& path, const SparseMatrix& A, Symmetry symmetry = Symmetry::General);
+
+}
@@ -0,0 +1,180 @@
+# pragma once
+
+#include <cassert>
+
+// Non-owning views onto row-major storage. A matrix view is a pointer to its
+// first element, its size and a leading dimension (distance between rows);
+// a vector view is a pointer, a length and a stride, so a matrix column is a
+// vector view with stride equal to the leading dimension. Views never
+// allocate and stay valid only as long as the storage they refer to.
+// Element access is one-based like Matrix and Vector.
+
+class VectorView;
+class ConstVectorView;
+
+class ConstMatrixView {
+private:
+    const double* mData;
+    int mNumRows;
+    int mNumCols;
+    int mLd;
+
+public:
+    ConstMatrixView(const double* data, int numRows, int numCols, int ld)
+        : mData(data), mNumRows(numRows), mNumCols(numCols), mLd(ld) {
+        assert(numRows >= 0 && numCols >= 0 && ld >= numCols);
+    }
+
+    int numRows() const { return mNumRows; }
+    int numCols() const { return mNumCols; }
+    int ld() const { return mLd; }
+    const double* data() const { return mData; }
+
+    double operator()(int i, int j) const {
+        assert(i >= 1 && i <= mNumRows);
+        assert(j >= 1 && j <= mNumCols);
+        return mData[(size_t)(i - 1) * mLd + (j - 1)];
+    }
+
+    // rows x cols block whose top-left element is (i, j)
+    ConstMatrixView block(int i, int j, int rows, int cols) const {
+        assert(i >= 1 && j >= 1 && rows >= 0 && cols >= 0);
+        assert(i - 1 + rows <= mNumRows && j - 1 + cols <= mNumCols);
+        return ConstMatrixView(mData + (size_t)(i - 1) * mLd + (j - 1), rows, cols, mLd);
+    }
+
+    inline ConstVectorView row(int i) const;
+    inline ConstVectorView col(int j) const;
+};
+
+class MatrixView {
+private:
+    double* mData;
+    int mNumRows;
+    int mNumCols;
+    int mLd;
+
+public:
+    MatrixView(double* data, int numRows, int numCols, int ld)
+        : mData(data), mNumRows(numRows), mNumCols(numCols), mLd(ld) {
+        assert(numRows >= 0 && numCols >= 0 && ld >= numCols);
+    }
+
+    operator ConstMatrixView() const { return ConstMatrixView(mData, mNumRows, mNumCols, mLd); }
+
+    int numRows() const { return mNumRows; }
+    int numCols() const { return mNumCols; }
+    int ld() const { return mLd; }
+    double* data() const { return mData; }
+
+    double& operator()(int i, int j) const {
+        assert(i >= 1 && i <= mNumRows);
+        assert(j >= 1 && j <= mNumCols);
+        return mData[(size_t)(i - 1) * mLd + (j - 1)];
+    }
+
+    MatrixView block(int i, int j, int rows, int cols) const {
+        assert(i >= 1 && j >= 1 && rows >= 0 && cols >= 0);
+        assert(i - 1 + rows <= mNumRows && j - 1 + cols <= mNumCols);
+        return MatrixView(mData + (size_t)(i - 1) * mLd + (j - 1), rows, cols, mLd);
+    }
+
+    inline VectorView row(int i) const;
+    inline VectorView col(int j) const;
+
+    // Copy the elements of a view of the same size into this one
+    void assign(ConstMatrixView other) const {
+        assert(other.numRows() == mNumRows && other.numCols() == mNumCols);
+        for (int i = 0; i < mNumRows; ++i) {
+            const double* src = other.data() + (size_t)i * other.ld();
+            double* dst = mData + (size_t)i * mLd;
+            for (int j = 0; j < mNumCols; ++j) {
+                dst[j] = src[j];
+            }
+        }
+    }
+};
+
+class ConstVectorView {
+private:
+    const double* mData;
+    int mSize;
+    int mStride;
+
+public:
+    ConstVectorView(const double* data, int size, int stride = 1)
+        : mData(data), mSize(size), mStride(stride) {
+        assert(size >= 0 && stride >= 1);
+    }
+
+    int size() const { return mSize; }
+    int stride() const { return mStride; }
+    const double* data() const { return mData; }
+
+    double operator()(int i) const {
+        assert(i >= 1 && i <= mSize);
+        return mData[(size_t)(i - 1) * mStride];
+    }
+
+    // count elements starting at element i
+    ConstVectorView segment(int i, int count) const {
+        assert(i >= 1 && count >= 0 && i - 1 + count <= mSize);
+        return ConstVectorView(mData + (size_t)(i - 1) * mStride, count, mStride);
+    }
+};
+
+class VectorView {
+private:
+    double* mData;
+    int mSize;
+    int mStride;
+
+public:
+    VectorView(double* data, int size, int stride = 1)
+        : mData(data), mSize(size), mStride(stride) {
+        assert(size >= 0 && stride >= 1);
+    }
+
+    operator ConstVectorView() const { return ConstVectorView(mData, mSize, mStride); }
+
+    int size() const { return mSize; }
+    int stride() const { return mStride; }
+    double* data() const { return mData; }
+
+    double& operator()(int i) const {
+        assert(i >= 1 && i <= mSize);
+        return mData[(size_t)(i - 1) * mStride];
+    }
+
+    VectorView segment(int i, int count) const {
+        assert(i >= 1 && count >= 0 && i - 1 + count <= mSize);
+        return VectorView(mData + (size_t)(i - 1) * mStride, count, mStride);
+    }
+
+    void assign(ConstVectorView other) const {
+        assert(other.size() == mSize);
+        for (int i = 0; i < mSize; ++i) {
+            mData[(size_t)i * mStride] = other.data()[(size_t)i * other.stride()];
+        }
+    }
+};
+
+inline ConstVectorView ConstMatrixView::row(int i) const {
+    assert(i >= 1 && i <= mNumRows);
+    return ConstVectorView(mData + (size_t)(i - 1) * mLd, mNumCols, 1);
+}
+
+inline ConstVectorView ConstMatrixView::col(int j) const {
+    assert(j >= 1 && j <= mNumCols);
+    return ConstVectorView(mData + (j - 1), mNumRows, mLd);
+}
+
+inline VectorView MatrixView::row(int i) const {
+    assert(i >= 1 && i <= mNumRows);
+    return VectorView(mData + (size_t)(i - 1) * mLd, mNumCols, 1);
+}
+
+inline VectorView MatrixView::col(int j) const {
+    assert(j >= 1 && j <= mNumCols);
+    return VectorView(mData + (j - 1), mNumRows, mLd);
+}
@@ -0,0 +1,153 @@
+# pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing scheduler shared by every parallel kernel of the project.
+//
+// Each worker owns a deque of tasks. It pushes and pops at the back, and idle
+// workers steal from the front of the others. Threads outside the pool submit
+// through a shared injection queue. A thread waiting for its tasks (in
+// parallelFor or TaskGroup::wait) runs queued tasks meanwhile. Nested
+// parallelFor calls are therefore split as well, and the machine is never
+// oversubscribed: there is only ever one thread per configured slot.
+//
+// The size is numThreads() (workers plus the calling thread). It comes from
+// TINI_NUM_THREADS if set, otherwise from the hardware, and setNumThreads()
+// changes it while the pool is idle.
+class ThreadPool {
+public:
+    struct Task;
+
+    static ThreadPool& instance();
+
+    ~ThreadPool();
+
+    int numThreads() const;
+    void setNumThreads(int numThreads);
+
+    // Run body(chunkBegin, chunkEnd) over [begin, end) in chunks of at least grain items
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body);
+
+    // Queue a task (on the caller's deque when it is a worker)
+    void submit(Task* task);
+
+    // Run one queued task on the calling thread, false when none was found
+    bool runOneTask();
+
+private:
+    struct Worker;
+
+    ThreadPool();
+    void startWorkers(int numWorkers);
+    void stopWorkers();
+    void workerLoop(int index);
+    Task* findTask(int self);
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::vector<std::thread> mThreads;
+    std::deque<Task*> mInjected;
+    std::mutex mInjectedMutex;
+    std::atomic<int> mQueued;
+    std::mutex mSleepMutex;
+    std::condition_variable mWake;
+    bool mStop;
+
+    // Disabled copy constructor and assignment operator
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+// Fork-join group of tasks: run() queues, wait() returns once all have
+// finished and rethrows the first exception one of them threw
+class TaskGroup {
+public:
+    TaskGroup();
+    ~TaskGroup();
+
+    void run(std::function<void()> work);
+    void wait();
+
+private:
+    friend struct ThreadPool::Task;
+
+    std::atomic<int> mPending;
+    std::mutex mMutex;
+    std::condition_variable mDone;
+    std::exception_ptr mError;
+
+    void finish(std::exception_ptr error);
+
+    // Disabled copy constructor and assignment operator
+    TaskGroup(const TaskGroup&);
+    TaskGroup& operator=(const TaskGroup&);
+};
+
+// While alive, parallelFor calls made by the constructing thread run
+// serially on it. Meant for threads that are already one of many concurrent
+// workers (e.g. SolveService) so their kernels do not oversubscribe the pool.
+class SerialRegion {
+public:
+    SerialRegion();
+    ~SerialRegion();
+
+private:
+    bool mPrevious;
+
+    // Disabled copy constructor and assignment operator
+    SerialRegion(const SerialRegion&);
+    SerialRegion& operator=(const SerialRegion&);
+};
+
+inline void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body) {
+    ThreadPool::instance().parallelFor(begin, end, grain, body);
+}
+
+namespace detail {
+
+// Pairwise reduction of chunks [c0, c1); spans wider than forkSpan chunks
+// hand their left half to another task
+template <class T, class Map, class Combine>
+T reduceChunks(int begin, int end, int grain, int c0, int c1, int forkSpan, const T& identity,
+               Map& map, Combine& combine) {
+    if (c1 - c0 == 1) {
+        int chunkBegin = begin + c0 * grain;
+        int chunkEnd = end - chunkBegin > grain ? chunkBegin + grain : end;
+        return map(chunkBegin, chunkEnd);
+    }
+    int mid = c0 + (c1 - c0) / 2;
+    if (c1 - c0 <= forkSpan) {
+        T left = reduceChunks(begin, end, grain, c0, mid, forkSpan, identity, map, combine);
+        return combine(left, reduceChunks(begin, end, grain, mid, c1, forkSpan, identity, map, combine));
+    }
+    T left = identity;
+    TaskGroup group;
+    group.run([&] { left = reduceChunks(begin, end, grain, c0, mid, forkSpan, identity, map, combine); });
+    T right = reduceChunks(begin, end, grain, mid, c1, forkSpan, identity, map, combine);
+    group.wait();
+    return combine(left, right);
+}
+
+}
+
+// Reduce map(chunkBegin, chunkEnd) over [begin, end) with combine. The range
+// is cut into chunks of exactly grain items (the last may be shorter) and the
+// partial results are combined pairwise, always along the same binary tree.
+// The result therefore depends on grain only, not on the number of threads or
+// on scheduling, and rounding errors of sums grow with log(chunks).
+template <class T, class Map, class Combine>
+T parallelReduce(int begin, int end, int grain, T identity, Map map, Combine combine) {
+    if (end <= begin) return identity;
+    grain = grain < 1 ? 1 : grain;
+    int numChunks = (end - begin + grain - 1) / grain;
+    int threads = ThreadPool::instance().numThreads();
+    int forkSpan = threads == 1 ? numChunks : (numChunks + 4 * threads - 1) / (4 * threads);
+    return detail::reduceChunks(begin, end, grain, 0, numChunks, forkSpan, identity, map, combine);
+}
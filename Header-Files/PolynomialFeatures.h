@@ -0,0 +1,66 @@
+# pragma once
+
+#include <string>
+#include <vector>
+#include "Matrix.h"
+#include "Vector.h"
+
+// Which products of distinct base features are generated
+enum class InteractionSet {
+    None,       // Powers of single features only: x_i, x_i², ...
+    Pairwise,   // Also products of two distinct features: x_i^a x_j^b
+    All         // Every monomial up to the degree
+};
+
+// Polynomial expansion of p base features up to a total degree, used
+// implicitly: the normal equations XᵀX θ = Xᵀy of the expanded design are
+// accumulated straight from the base rows, a few rows at a time, so the
+// n x numFeatures() expanded matrix is never stored.
+//
+// Terms are ordered by degree, then lexicographically by their variables
+// (with the intercept first when present); for six features, degree 2 and
+// every interaction that is 6 linear, 6 squared and 15 cross terms. Each term
+// is its parent term (one factor fewer) times one base feature, so expanding
+// a row costs one multiply per term.
+class PolynomialFeatures {
+private:
+    int mNumBase;
+    int mDegree;
+    InteractionSet mInteractions;
+    bool mIntercept;
+    std::vector<std::vector<int>> mTerms;   // Nondecreasing base indices of each term
+    std::vector<int> mParent;               // Term with the last factor removed (-1: none)
+    std::vector<int> mFactor;               // Base feature of the last factor (-1: intercept)
+
+public:
+    PolynomialFeatures(int numBase, int degree, InteractionSet interactions = InteractionSet::All,
+                       bool intercept = true);
+
+    int numBase() const;
+    int degree() const;
+    InteractionSet interactions() const;
+    bool hasIntercept() const;
+
+    // Number of expanded features (columns of the implicit design)
+    int numFeatures() const;
+
+    // Zero-based base features multiplied in term k (empty for the intercept)
+    const std::vector<int>& term(int k) const;
+
+    // Readable name such as "MMAX^2*CACH"
+    std::string termName(int k, const std::vector<std::string>& baseNames) const;
+
+    // Expanded row of numFeatures() values from numBase() base values
+    void expandRow(const double* x, double* out) const;
+
+    // Value of the expanded model θ at a base row
+    double predict(const Vector& coefficients, const double* x) const;
+
+    // G += XᵀX and Xty += Xᵀy for the expanded rows of numRows base rows
+    // stored ldx doubles apart. G is numFeatures() x numFeatures(), row-major.
+    // Can be called repeatedly to stream the rows in pieces.
+    void accumulate(const double* X, int numRows, int ldx, const double* y, double* G, double* Xty) const;
+
+    // Expanded normal equations of the base design X (n x numBase()) and y
+    void normalEquations(const Matrix& X, const Vector& y, Matrix& G, Vector& Xty) const;
+};
@@ -1,14 +1,60 @@
 # pragma once
 
+#include "LinearOperator.h"
 #include "LinearSystem.h"
 
+// Conjugate gradient variant used by Solve(). Pipelined CG (Ghysels and
+// Vanroose) needs one fused reduction per iteration instead of two and runs it
+// while the operator product is computed, at the price of three extra vector
+// recurrences and a somewhat lower attainable accuracy.
+enum class CGVariant { Classic, Pipelined };
+
 class PosSymLinSystem : public LinearSystem {
+private:
+    LinearOperator* mpOperator;   // Used by CG for every product with A
+    bool mOwnsOperator;           // True for the dense Matrix adapter
+    CGVariant mVariant;
+    int mReplacementInterval;     // Pipelined CG recomputes its residuals this often
+    int mIterations;
+    int mReplacements;
+
 public:
-    PosSymLinSystem(Matrix* A, Vector* b);
+    // The O(n²) symmetry check can be skipped when A is known to be symmetric
+    PosSymLinSystem(Matrix* A, Vector* b, bool checkSymmetry = true);
+    PosSymLinSystem(Matrix* A, Matrix* B);
+    // Matrix-free system; A is assumed symmetric positive definite and is
+    // solved by CG
+    PosSymLinSystem(LinearOperator* A, Vector* b);
+    // Matrix-free system with several right-hand sides, solved by block CG
+    PosSymLinSystem(LinearOperator* A, Matrix* B);
     virtual ~PosSymLinSystem();
 
+    PosSymLinSystem(const PosSymLinSystem&) = delete;
+    PosSymLinSystem& operator=(const PosSymLinSystem&) = delete;
+
     virtual Vector Solve() override;
 
+    // Cholesky factorization A = LLᵀ shared by all right-hand sides
+    // (block CG for matrix-free systems)
+    virtual Matrix SolveMultiple() override;
+
+    // Block CG on all right-hand sides at once: every iteration multiplies A
+    // with an n x s block (GEMM or SpMM instead of s GEMVs), and columns that
+    // have converged are deflated from the block
+    Matrix SolveBlockCG();
+
+    void SetVariant(CGVariant variant);
+    // Pipelined CG replaces its recursive residuals by true ones every
+    // interval iterations (0 disables this) and whenever they claim convergence
+    void SetReplacementInterval(int interval);
+
+    // Iterations and residual replacements of the last CG or block CG solve
+    int Iterations() const;
+    int Replacements() const;
+
 private:
     bool isSymmetric(const Matrix& A);
+    Vector SolveClassic();
+    Vector SolvePipelined();
+    void ReplaceResidual(const double* x, const double* p, double* r, double* w, double* s, double* z);
 };
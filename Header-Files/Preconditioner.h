@@ -0,0 +1,29 @@
+# pragma once
+
+#include <vector>
+#include "LinearOperator.h"
+#include "Matrix.h"
+#include "SparseMatrix.h"
+
+// Approximate inverse M⁻¹ applied by the iterative solvers
+class Preconditioner {
+public:
+    virtual ~Preconditioner() {}
+
+    // z = M⁻¹ r for arrays of the system size
+    virtual void Apply(const double* r, double* z) const = 0;
+};
+
+// M = diag(A)
+class JacobiPreconditioner : public Preconditioner {
+private:
+    std::vector<double> mInverseDiagonal;
+
+public:
+    explicit JacobiPreconditioner(const std::vector<double>& diagonal);
+    explicit JacobiPreconditioner(const Matrix& A);
+    explicit JacobiPreconditioner(const SparseMatrix& A);
+    explicit JacobiPreconditioner(const LinearOperator& A);
+
+    virtual void Apply(const double* r, double* z) const override;
+};
@@ -0,0 +1,81 @@
+# pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Hot-path instrumentation, compiled in only when TINI_PROFILE is defined
+// (PROFILE=1 ./compile.sh <target>). Otherwise the macros below expand to
+// nothing and the kernels carry no overhead.
+//
+//   PROFILE_SCOPE("name");                      time the enclosing scope
+//   PROFILE_SCOPE_WORK("name", flops, bytes);   ... and count its work
+//
+// Every thread accumulates into its own counters, so recording takes no
+// lock; reports merge the threads. Timers are inclusive: a region that
+// calls other regions (e.g. an LU calling GEMM) includes their time.
+// At exit the report is written to stderr, or to the file named by
+// TINI_PROFILE_OUTPUT, as a text table or as JSON when
+// TINI_PROFILE_FORMAT=json (TINI_PROFILE_FORMAT=off disables it).
+namespace profiler {
+
+struct RegionStats {
+    std::string name;
+    uint64_t calls;
+    double seconds;
+    double flops;
+    double bytes;
+};
+
+// Id of a named region, registered on first use (call sites cache it)
+int registerRegion(const char* name);
+
+// Add one call to the calling thread's counters for region
+void record(int region, uint64_t nanoseconds, double flops, double bytes);
+
+// All regions with at least one call, merged over threads, slowest first
+std::vector<RegionStats> collect();
+
+void reset();
+
+void writeText(std::ostream& out);
+void writeJson(std::ostream& out);
+
+class ScopedTimer {
+private:
+    int mRegion;
+    double mFlops;
+    double mBytes;
+    std::chrono::steady_clock::time_point mStart;
+
+public:
+    ScopedTimer(int region, double flops, double bytes)
+        : mRegion(region), mFlops(flops), mBytes(bytes), mStart(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - mStart;
+        record(mRegion, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+               mFlops, mBytes);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+}
+
+#ifdef TINI_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE_WORK(name, flops, bytes)                                               \
+    static const int PROFILE_CONCAT(profileRegion, __LINE__) = profiler::registerRegion(name); \
+    profiler::ScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(                             \
+        PROFILE_CONCAT(profileRegion, __LINE__), (double)(flops), (double)(bytes))
+#define PROFILE_SCOPE(name) PROFILE_SCOPE_WORK(name, 0, 0)
+#else
+#define PROFILE_SCOPE_WORK(name, flops, bytes) ((void)0)
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
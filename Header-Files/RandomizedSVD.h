@@ -0,0 +1,42 @@
+# pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+// Truncated SVD A ≈ U Σ Vᵀ from a randomized range finder (Halko, Martinsson
+// and Tropp). A Gaussian sketch of rank + oversampling columns, refined by
+// power iterations, captures the range of A; the SVD of the small projected
+// matrix then gives the leading singular triplets in O(m·n·k) work.
+// Singular values below rankTolerance * σ_max are dropped, so rank-deficient
+// and ill-posed systems get a minimum-norm least-squares solution instead of
+// the exception pseudoInverse() throws.
+class RandomizedSVD {
+private:
+    int mRank;            // Number of singular triplets kept
+    Matrix* mpU;          // m x rank
+    Vector* mpSigma;      // rank, descending
+    Matrix* mpV;          // n x rank
+
+public:
+    // rank <= 0 asks for min(m, n) triplets (subject to the tolerance)
+    RandomizedSVD(const Matrix& A, int rank = 0, double rankTolerance = 1e-10,
+                  int oversampling = 10, int powerIterations = 2, unsigned seed = 42);
+
+    ~RandomizedSVD();
+
+    int Rank() const;
+    const Matrix& U() const;
+    const Vector& SingularValues() const;
+    const Matrix& V() const;
+
+    // A⁺ ≈ V Σ⁻¹ Uᵀ
+    Matrix PseudoInverse() const;
+
+    // Minimum-norm least-squares solution x = V Σ⁻¹ Uᵀ b in O((m + n)·rank)
+    Vector Solve(Vector& b) const;
+
+private:
+    // Disabled copy constructor and assignment operator
+    RandomizedSVD(const RandomizedSVD&);
+    RandomizedSVD& operator=(const RandomizedSVD&);
+};
@@ -0,0 +1,55 @@
+# pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+// Online least squares: the coefficients of min Σ λ^(age) (y - xᵀθ)² are kept
+// up to date one row at a time. P = (XᵀX)⁻¹ (with the forgetting weights) is
+// updated by the Sherman-Morrison formula, so adding or removing a row costs
+// O(p²) and never refactors anything.
+//
+// P starts as priorVariance * I, which is a ridge penalty of 1/priorVariance
+// on θ; with the default the fit matches ordinary least squares once p
+// independent rows have arrived. forgetting < 1 discounts old rows
+// geometrically so the model tracks drifting data. Downdate() removes a row
+// with full weight, so it is meant for sliding windows with forgetting = 1.
+class RecursiveLeastSquares {
+private:
+    int mNumFeatures;
+    double mForgetting;
+    long mCount;          // Rows added minus rows removed
+    Matrix* mpP;          // p x p, symmetric
+    Vector* mpTheta;      // Coefficients
+    Vector* mpWork;       // P*x of the current row
+
+public:
+    RecursiveLeastSquares(int numFeatures, double forgetting = 1.0, double priorVariance = 1e8);
+
+    ~RecursiveLeastSquares();
+
+    // Add the row (x, y); x holds numFeatures() values. Returns the a priori
+    // error y - xᵀθ of the coefficients before the update.
+    double Update(const double* x, double y);
+
+    // Remove a row added earlier; throws runtime_error if the row is not in the
+    // fit (P would lose positive definiteness)
+    double Downdate(const double* x, double y);
+
+    // Add every row of A (m x p) with the targets in b
+    void UpdateRows(const Matrix& A, const Vector& b);
+
+    double Predict(const double* x) const;
+
+    const Vector& Coefficients() const;
+    const Matrix& InverseGram() const;
+    int NumFeatures() const;
+    long Count() const;
+
+private:
+    // P*x into the work vector, returns xᵀPx
+    double MultiplyP(const double* x);
+
+    // Disabled copy constructor and assignment operator
+    RecursiveLeastSquares(const RecursiveLeastSquares&);
+    RecursiveLeastSquares& operator=(const RecursiveLeastSquares&);
+};
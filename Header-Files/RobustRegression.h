@@ -0,0 +1,91 @@
+# pragma once
+
+#include <vector>
+#include "Matrix.h"
+#include "Vector.h"
+
+// M-estimator loss of RobustRegression
+enum class RobustLoss {
+    Huber,   // Quadratic inside the tuning constant, linear outside (convex)
+    Tukey    // Bisquare: residuals beyond the tuning constant get weight 0
+};
+
+// One IRLS iteration as recorded by RobustRegression::History()
+struct IrlsIteration {
+    double seconds;         // Wall time of the whole iteration
+    double scale;           // Robust residual scale used for the weights
+    int reweightedRows;     // Rows whose weight changed
+    bool rebuilt;           // Gram matrix rebuilt instead of updated
+    int solverIterations;   // CG iterations of the weighted solve
+    double step;            // max |Δθ| / max |θ|
+};
+
+// Robust linear regression min Σ ρ(r_i / s) by iteratively reweighted least
+// squares. Each iteration estimates the scale s = 1.4826·median|r|, turns the
+// residuals into weights and solves AᵀWA θ = AᵀWb.
+//
+// The weighted Gram matrix and right-hand side are kept between iterations
+// and updated in place by Σ (w_new - w_old) a_i a_iᵀ over the rows whose
+// weight changed, so Huber fits, where inliers keep weight 1, only touch
+// their outliers; when more than half of the rows change (Tukey, mostly) the
+// Gram matrix is rebuilt. The p x p system is solved by Jacobi-preconditioned
+// CG started from the previous coefficients, which needs fewer and fewer
+// iterations as IRLS converges. All work storage is allocated by the
+// constructor, so Fit() allocates nothing.
+class RobustRegression {
+private:
+    const Matrix* mpA;
+    const Vector* mpb;
+    int mNumRows;
+    int mNumCols;
+    RobustLoss mLoss;
+    double mTuning;
+    double mTolerance;
+    int mMaxIterations;
+    double mScale;
+    bool mConverged;
+    int mIterations;
+
+    Matrix* mpGram;         // AᵀWA
+    Vector* mpRhs;          // AᵀWb
+    Vector* mpTheta;
+    Vector* mpWeights;
+    Vector* mpResiduals;
+    Vector* mpScratch;      // m values: new weights, or |r| for the median
+    Vector* mpSolverWork;   // 4 p values for CG, p for the previous θ
+    std::vector<double> mPartials;   // One upper triangle and right-hand side per row chunk
+    std::vector<IrlsIteration> mHistory;
+
+public:
+    // tuning <= 0 picks the usual 95%-efficiency constants (1.345 Huber, 4.685 Tukey)
+    RobustRegression(const Matrix* A, const Vector* b, RobustLoss loss, double tuning = 0.0);
+    ~RobustRegression();
+
+    // Fit starting from the least-squares solution, or from given coefficients
+    // (e.g. a Huber fit as the start of a Tukey fit, which is not convex)
+    const Vector& Fit();
+    const Vector& Fit(const Vector& start);
+
+    void SetTolerance(double tolerance);      // Stop when the step is below this, default 1e-8
+    void SetMaxIterations(int maxIterations); // Default 50
+
+    const Vector& Coefficients() const;
+    const Vector& Weights() const;
+    double Scale() const;
+    bool Converged() const;
+    int Iterations() const;   // Reweightings of the last Fit
+    // Per-iteration record; after Fit() the first entry is the least-squares start
+    const std::vector<IrlsIteration>& History() const;
+
+private:
+    void Iterate();
+    void ComputeResiduals();
+    double EstimateScale();
+    // G += Σ c_i a_i a_iᵀ and g += Σ c_i b_i a_i over the rows with c_i != 0
+    void Accumulate(const double* c, bool reset);
+    int SolveWeighted();
+
+    // Disabled copy constructor and assignment operator
+    RobustRegression(const RobustRegression&);
+    RobustRegression& operator=(const RobustRegression&);
+};
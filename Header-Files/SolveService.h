@@ -0,0 +1,104 @@
+# pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "LinearSystem.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+// Reported through the future of a request that was cancelled, or still
+// queued when the service shut down
+class SolveCancelled : public std::runtime_error {
+public:
+    SolveCancelled() : std::runtime_error("Solve request was cancelled") {}
+};
+
+struct SolveTicket {
+    uint64_t id;
+    std::future<Vector> result;
+};
+
+// Asynchronous front-end for many small independent systems. Requests are
+// queued, and one dispatcher thread groups them into batches that run as
+// tasks of the shared ThreadPool, at most numWorkers at a time. A batch is
+// the oldest request together with up to maxBatch - 1 queued requests of the
+// same size. Requests in a batch that share a matrix (the shared_ptr
+// overload) are solved with one LU factorization and a blocked multi-RHS
+// solve. Every batch runs its kernels serially, so the parallelism is across
+// systems, and the service adds no compute threads of its own.
+//
+// submit() blocks while maxPending requests wait (backpressure) and
+// trySubmit() refuses instead. Errors of a solve (e.g. a singular matrix)
+// surface from future::get().
+class SolveService {
+public:
+    struct Options {
+        int numWorkers;     // batches solved at once; default: ThreadPool::numThreads()
+        size_t maxPending;  // queued requests before submit() blocks
+        int maxBatch;       // largest number of requests one worker takes at once
+
+        Options();
+    };
+
+    struct Stats {
+        uint64_t submitted;
+        uint64_t completed;
+        uint64_t failed;
+        uint64_t cancelled;
+        uint64_t batches;
+    };
+
+    explicit SolveService(const Options& options = Options());
+
+    // Cancels whatever is still queued, then waits for the running batches
+    ~SolveService();
+
+    // Solve Ax = b; the first overload copies A
+    SolveTicket submit(const Matrix& A, const Vector& b);
+    SolveTicket submit(std::shared_ptr<Matrix> A, const Vector& b);
+
+    // Run a prebuilt system's Solve(), e.g. a PosSymLinSystem
+    SolveTicket submit(std::shared_ptr<LinearSystem> system);
+
+    // As submit(), but false without queueing when the queue is full
+    bool trySubmit(std::shared_ptr<Matrix> A, const Vector& b, SolveTicket& ticket);
+
+    // Drop a queued request, its future reports SolveCancelled. False when
+    // the request has already started or finished.
+    bool cancel(uint64_t id);
+
+    // Stop accepting requests, cancel the queued ones and wait for the running batches
+    void shutdown();
+
+    size_t pending() const;
+    Stats stats() const;
+
+private:
+    struct Request;
+
+    SolveTicket enqueue(std::unique_ptr<Request> request, bool block, bool* accepted);
+    void dispatchLoop();
+    void runBatch(std::vector<std::unique_ptr<Request>>& batch);
+
+    Options mOptions;
+    std::thread mDispatcher;
+    int mRunning;                   // batches handed to the pool and not yet finished
+    std::deque<std::unique_ptr<Request>> mQueue;
+    mutable std::mutex mMutex;
+    std::condition_variable mWork;
+    std::condition_variable mSpace;
+    bool mStop;
+    uint64_t mNextId;
+    Stats mStats;
+
+    // Disabled copy constructor and assignment operator
+    SolveService(const SolveService&);
+    SolveService& operator=(const SolveService&);
+};
@@ -0,0 +1,54 @@
+# pragma once
+
+#include <vector>
+#include "Matrix.h"
+#include "Vector.h"
+
+// Compressed sparse row matrix. Entries are given as one-based (row, col, value)
+// triplets like the round bracket accessors of Matrix; duplicates are summed.
+class SparseMatrix {
+public:
+    struct Triplet {
+        int row;
+        int col;
+        double value;
+    };
+
+private:
+    int mNumRows;
+    int mNumCols;
+    std::vector<int> mRowStart;     // mNumRows + 1 offsets into mColIndex/mValues
+    std::vector<int> mColIndex;     // zero-based column of each stored entry
+    std::vector<double> mValues;
+
+public:
+    SparseMatrix(int numRows, int numCols, const std::vector<Triplet>& entries);
+
+    // Keep the nonzero entries of a dense matrix
+    explicit SparseMatrix(const Matrix& dense);
+
+    int numRows() const;
+    int numCols() const;
+    int nonZeros() const;
+
+    // Value at (i, j), one-based; zero when not stored
+    double operator()(int i, int j) const;
+
+    // y = A*x on raw arrays
+    void multiply(const double* x, double* y) const;
+
+    // Y = A*X for row-major blocks of s columns, X numCols x s and Y numRows x s
+    void multiply(int s, const double* X, int ldx, double* Y, int ldy) const;
+
+    Vector operator*(Vector& v) const;
+
+    // Main diagonal (zero where not stored)
+    std::vector<double> diagonal() const;
+
+    Matrix toDense() const;
+
+    // Raw CSR arrays for kernels
+    const std::vector<int>& rowStart() const;
+    const std::vector<int>& colIndex() const;
+    const std::vector<double>& values() const;
+};
@@ -0,0 +1,37 @@
+# pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+// Least-squares solve of min ||Ax - b|| for tall, skinny A (m >> p) by TSQR.
+// The rows of [A | b] are split into blocks that are QR-factored independently
+// on the thread pool; the (p+1) x (p+1) R factors are then combined pairwise
+// in a reduction tree. The final R holds R(A) in its leading p x p block, Qᵀb
+// in its last column and the residual norm in its corner, so no Q is ever
+// formed and the normal equations (which square the condition number) are avoided.
+class TallSkinnyQR {
+private:
+    int mNumRows;
+    int mNumCols;
+    Matrix* mpR;   // (p+1) x (p+1) factor of [A | b]
+
+public:
+    // numBlocks <= 0 uses one block per pool thread
+    TallSkinnyQR(const Matrix& A, const Vector& b, int numBlocks = 0);
+
+    ~TallSkinnyQR();
+
+    // Coefficients x minimizing ||Ax - b||
+    Vector Solve() const;
+
+    // Upper triangular factor of A (p x p)
+    Matrix R() const;
+
+    // ||Ax - b|| at the least-squares solution
+    double ResidualNorm() const;
+
+private:
+    // Disabled copy constructor and assignment operator
+    TallSkinnyQR(const TallSkinnyQR&);
+    TallSkinnyQR& operator=(const TallSkinnyQR&);
+};
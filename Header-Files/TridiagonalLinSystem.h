@@ -0,0 +1,27 @@
+# pragma once
+
+#include "LinearSystem.h"
+#include "TridiagonalMatrix.h"
+
+// Tridiagonal systems in O(n) time and memory. Solve() and SolveMultiple()
+// use the Thomas algorithm (no pivoting, so A should be diagonally dominant
+// or symmetric positive definite); SolveCyclicReduction() eliminates every
+// other unknown per level, log2(n) levels whose equations are independent
+// and are spread over the thread pool.
+class TridiagonalLinSystem : public LinearSystem {
+private:
+    TridiagonalMatrix* mpTridiagonal;
+
+    // Overwrite the n x s right-hand sides X with the solution
+    void ThomasSweep(Matrix& X) const;
+
+public:
+    TridiagonalLinSystem(TridiagonalMatrix* A, Vector* b);
+    TridiagonalLinSystem(TridiagonalMatrix* A, Matrix* B);
+    virtual ~TridiagonalLinSystem();
+
+    virtual Vector Solve() override;
+    virtual Matrix SolveMultiple() override;
+
+    Vector SolveCyclicReduction();
+};
@@ -0,0 +1,41 @@
+# pragma once
+
+#include <vector>
+#include "Matrix.h"
+#include "Vector.h"
+
+// Tridiagonal matrix stored as three diagonals of length n (O(n) memory).
+// Row i holds lower(i) = A(i, i-1), diagonal(i) = A(i, i) and
+// upper(i) = A(i, i+1); lower(1) and upper(n) are unused and stay zero.
+class TridiagonalMatrix {
+private:
+    int mSize;
+    std::vector<double> mLower;
+    std::vector<double> mDiagonal;
+    std::vector<double> mUpper;
+
+public:
+    explicit TridiagonalMatrix(int size);
+
+    int size() const;
+
+    // One-based accessors for the three diagonals of row i
+    double& lower(int i);
+    double& diagonal(int i);
+    double& upper(int i);
+
+    // Value at (i, j), one-based; zero outside the three diagonals
+    double operator()(int i, int j) const;
+
+    // y = A*x on raw arrays
+    void multiply(const double* x, double* y) const;
+
+    Vector operator*(Vector& v) const;
+
+    Matrix toDense() const;
+
+    // Raw diagonals (zero-based, padded to length n) for the solvers
+    const std::vector<double>& lowerDiagonal() const;
+    const std::vector<double>& mainDiagonal() const;
+    const std::vector<double>& upperDiagonal() const;
+};
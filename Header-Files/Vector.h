@@ -1,6 +1,11 @@
 # pragma once
 
 #include <iostream>
+#include "AccessPolicy.h"
+#include "MatrixView.h"
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 using namespace std;
 
 class Vector {
@@ -8,6 +13,9 @@ private:
     int mSize;
     double* mData;
 
+    // Reports a bad index and falls back to the first element
+    double& outOfBounds(const char* op) const;
+
 public:
     // Constructor
     Vector(int size);
@@ -15,6 +23,14 @@ public:
     // Copy Constructor
     Vector(const Vector& other);
 
+    // Copy of the elements a view refers to
+    explicit Vector(ConstVectorView view);
+
+#if __cplusplus >= 202002L
+    // Copy of a contiguous range
+    explicit Vector(std::span<const double> values);
+#endif
+
     // Destructor
     ~Vector();
 
@@ -31,14 +47,63 @@ public:
 
     Vector operator*(double scalar) const;
 
+    // In-place updates, no temporary vectors
+    Vector& operator+=(const Vector& other);
+    Vector& operator-=(const Vector& other);
+    Vector& operator*=(double scalar);
+
+    // this += alpha * x
+    Vector& addScaled(double alpha, const Vector& x);
+
     // Dot Product
     double dot(const Vector& other) const;
     
-    // Square Bracket Operator Overload for index checking
+    // Square Bracket Operator Overload, zero-based; Round Bracket Operator
+    // Overload, one-based. Indices are checked in debug builds only (AccessPolicy.h)
     double& operator[](int index);
-    // Round Bracket Operator Overload for one-based indexing
+    double operator[](int index) const;
     double& operator()(int index);
-    
+    double operator()(int index) const;
+
     // Get size of the vector
     int size() const;
+
+    // Contiguous storage, zero-based
+    double* data();
+    const double* data() const;
+
+    // Iterators over the contiguous storage, for range-for and <algorithm>
+    double* begin() { return mData; }
+    double* end() { return mData + mSize; }
+    const double* begin() const { return mData; }
+    const double* end() const { return mData + mSize; }
+
+#if __cplusplus >= 202002L
+    std::span<double> span() { return {mData, (size_t)mSize}; }
+    std::span<const double> span() const { return {mData, (size_t)mSize}; }
+#endif
+
+    // View of the whole vector without copying
+    VectorView view();
+    ConstVectorView view() const;
 };
+
+inline double& Vector::operator[](int index) {
+    if (!bounds::inRange(index, 0, mSize - 1)) return outOfBounds("operator[]");
+    return mData[index];
+}
+
+inline double Vector::operator[](int index) const {
+    if (!bounds::inRange(index, 0, mSize - 1)) return outOfBounds("operator[]");
+    return mData[index];
+}
+
+inline double& Vector::operator()(int index) {
+    if (!bounds::inRange(index, 1, mSize)) return outOfBounds("operator()");
+    return mData[index - 1];
+}
+
+inline double Vector::operator()(int index) const {
+    if (!bounds::inRange(index, 1, mSize)) return outOfBounds("operator()");
+    return mData[index - 1];
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <BandedLinSystem.h>
+#include <BandedMatrix.h>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <TridiagonalLinSystem.h>
+#include <TridiagonalMatrix.h>
+#include <Vector.h>
+
+using namespace std;
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// 1D diffusion, diagonally dominant
+static TridiagonalMatrix diffusion(int n) {
+    TridiagonalMatrix T(n);
+    for (int i = 1; i <= n; ++i) {
+        T.diagonal(i) = 2.01;
+        if (i > 1) T.lower(i) = -1.0;
+        if (i < n) T.upper(i) = -1.0;
+    }
+    return T;
+}
+
+// SPD band matrix with the given half bandwidth
+static BandedMatrix spdBand(int n, int k) {
+    BandedMatrix A(n, k, k);
+    for (int i = 1; i <= n; ++i) {
+        A(i, i) = 2.0 * k + 1.0;
+        for (int j = max(1, i - k); j < i; ++j) {
+            A(i, j) = -1.0;
+            A(j, i) = -1.0;
+        }
+    }
+    return A;
+}
+
+// Thomas, cyclic reduction (1 and all threads), band LU and band Cholesky
+// against dense LU on the same systems.
+// Usage: bench_banded [n ...]
+int main(int argc, char* argv[]) {
+    vector<int> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {1000, 100000, 1000000};
+    }
+    int maxThreads = ThreadPool::instance().numThreads();
+    const int k = 4;
+
+    cout << "n\tThomas\tCR(1)\tCR(" << maxThreads << ")\tbandLU(k=" << k
+         << ")\tbandChol\tdenseLU" << endl;
+    for (int n : sizes) {
+        TridiagonalMatrix T = diffusion(n);
+        BandedMatrix A = spdBand(n, k);
+        Vector b(n);
+        for (int i = 1; i <= n; ++i) {
+            b(i) = 1.0;
+        }
+
+        TridiagonalLinSystem tri(&T, &b);
+        auto start = chrono::steady_clock::now();
+        tri.Solve();
+        double thomas = secondsSince(start);
+
+        ThreadPool::instance().setNumThreads(1);
+        start = chrono::steady_clock::now();
+        tri.SolveCyclicReduction();
+        double crSerial = secondsSince(start);
+        ThreadPool::instance().setNumThreads(maxThreads);
+        start = chrono::steady_clock::now();
+        tri.SolveCyclicReduction();
+        double crParallel = secondsSince(start);
+
+        BandedLinSystem band(&A, &b);
+        start = chrono::steady_clock::now();
+        band.Solve();
+        double bandLU = secondsSince(start);
+        start = chrono::steady_clock::now();
+        band.SolveCholesky();
+        double bandChol = secondsSince(start);
+
+        cout << n << "\t" << thomas << "\t" << crSerial << "\t" << crParallel << "\t"
+             << bandLU << "\t" << bandChol << "\t";
+        if (n <= 2000) {
+            Matrix dense = T.toDense();
+            LinearSystem system(&dense, &b);
+            start = chrono::steady_clock::now();
+            system.Solve();
+            cout << secondsSince(start);
+        } else {
+            cout << "-";
+        }
+        cout << endl;
+    }
+    return 0;
+}
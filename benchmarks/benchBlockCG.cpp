@@ -0,0 +1,109 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <LinearOperator.h>
+#include <Matrix.h>
+#include <PosSymLinSystem.h>
+#include <SparseMatrix.h>
+#include <Vector.h>
+
+using namespace std;
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// 5-point Laplacian on an N x N grid
+static SparseMatrix laplacian(int N) {
+    vector<SparseMatrix::Triplet> entries;
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            int row = i * N + j + 1;
+            entries.push_back({row, row, 4.0});
+            if (i > 0) entries.push_back({row, row - N, -1.0});
+            if (i < N - 1) entries.push_back({row, row + N, -1.0});
+            if (j > 0) entries.push_back({row, row - 1, -1.0});
+            if (j < N - 1) entries.push_back({row, row + 1, -1.0});
+        }
+    }
+    return SparseMatrix(N * N, N * N, entries);
+}
+
+// s independent CG solves against one block CG solve of the same right-hand sides
+static void compare(const string& name, LinearOperator& A, const vector<int>& blockSizes) {
+    int n = A.numRows();
+    cout << name << endl << "s\tCG x s (s)\titerations\tblock CG (s)\titerations\tspeedup\tmax difference" << endl;
+    for (int s : blockSizes) {
+        // Independent random right-hand sides
+        srand(7);
+        Matrix B(n, s);
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= s; ++j) {
+                B(i, j) = (rand() % 2001 - 1000) / 1000.0;
+            }
+        }
+
+        streambuf* saved = cout.rdbuf(nullptr);   // CG prints every iteration
+        Matrix independent(n, s);
+        int singleIterations = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int j = 1; j <= s; ++j) {
+            Vector b(n);
+            for (int i = 1; i <= n; ++i) {
+                b(i) = B(i, j);
+            }
+            PosSymLinSystem system(&A, &b);
+            Vector x = system.Solve();
+            singleIterations += system.Iterations();
+            for (int i = 1; i <= n; ++i) {
+                independent(i, j) = x(i);
+            }
+        }
+        double singleSeconds = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        PosSymLinSystem block(&A, &B);
+        Matrix X = block.SolveBlockCG();
+        double blockSeconds = secondsSince(start);
+        cout.rdbuf(saved);
+
+        double difference = 0.0;
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= s; ++j) {
+                difference = max(difference, fabs(X(i, j) - independent(i, j)));
+            }
+        }
+        cout << s << "\t" << singleSeconds << "\t" << (double)singleIterations / s << "\t\t" << blockSeconds << "\t"
+             << block.Iterations() << "\t\t" << singleSeconds / blockSeconds << "\t" << difference << endl;
+    }
+    cout << endl;
+}
+
+// Block CG against s independent CG runs, dense and sparse.
+// Usage: bench_block_cg [dense n] [grid N]
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 2000;
+    int N = argc > 2 ? atoi(argv[2]) : 150;
+    vector<int> blockSizes = {1, 4, 16, 32};
+
+    // Dense SPD with a spread spectrum, so CG needs more than a handful of iterations
+    srand(42);
+    Matrix A(n, n);
+    for (int i = 1; i <= n; ++i) {
+        for (int j = i; j <= n; ++j) {
+            A(i, j) = A(j, i) = (rand() % 2000 - 1000) / 1000.0;
+        }
+        A(i, i) = sqrt((double)n) * (2.0 + 8.0 * i / n);
+    }
+    DenseOperator dense(&A);
+    compare("Dense n = " + to_string(n), dense, blockSizes);
+
+    SparseMatrix S = laplacian(N);
+    SparseOperator sparse(&S);
+    compare("Sparse 5-point Laplacian, " + to_string(N * N) + " unknowns", sparse, blockSizes);
+    return 0;
+}
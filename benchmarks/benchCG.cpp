@@ -0,0 +1,109 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <LinearOperator.h>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <PosSymLinSystem.h>
+#include <SparseMatrix.h>
+#include <Vector.h>
+
+using namespace std;
+
+// Shifted 5-point Laplacian on an N x N grid, well conditioned so CG needs tens of iterations
+static SparseMatrix shiftedLaplacian(int N) {
+    vector<SparseMatrix::Triplet> entries;
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            int row = i * N + j + 1;
+            entries.push_back({row, row, 4.5});
+            if (i > 0) entries.push_back({row, row - N, -1.0});
+            if (i < N - 1) entries.push_back({row, row + N, -1.0});
+            if (j > 0) entries.push_back({row, row - 1, -1.0});
+            if (j < N - 1) entries.push_back({row, row + 1, -1.0});
+        }
+    }
+    return SparseMatrix(N * N, N * N, entries);
+}
+
+// Runs CG on a pool of the given size; returns seconds per iteration
+static double timeCG(LinearOperator& A, Vector& b, int threads, CGVariant variant, Vector& x) {
+    ThreadPool::instance().setNumThreads(threads);
+    PosSymLinSystem system(&A, &b);
+    system.SetVariant(variant);
+
+    streambuf* saved = cout.rdbuf(nullptr);   // CG prints every iteration
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    x = system.Solve();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.rdbuf(saved);
+    return seconds / max(system.Iterations(), 1);
+}
+
+static void scaling(const string& name, LinearOperator& A, Vector& b, const vector<int>& threadCounts) {
+    Vector classic1(b.size());
+    Vector pipelined1(b.size());
+    timeCG(A, b, 1, CGVariant::Classic, classic1);   // warm up caches and page tables
+    cout << name << endl << "threads	classic ms/it	pipelined ms/it	bitwise equal to 1 thread" << endl;
+    for (int threads : threadCounts) {
+        Vector classic(b.size());
+        Vector pipelined(b.size());
+        double classicSeconds = timeCG(A, b, threads, CGVariant::Classic, classic);
+        double pipelinedSeconds = timeCG(A, b, threads, CGVariant::Pipelined, pipelined);
+        if (threads == 1) {
+            classic1 = classic;
+            pipelined1 = pipelined;
+        }
+        bool same = equal(classic.begin(), classic.end(), classic1.begin()) &&
+                    equal(pipelined.begin(), pipelined.end(), pipelined1.begin());
+        cout << threads << "\t" << classicSeconds * 1e3 << "\t\t" << pipelinedSeconds * 1e3 << "\t\t"
+             << (same ? "yes" : "NO") << endl;
+    }
+    cout << endl;
+}
+
+// Classic and pipelined CG time per iteration from one thread to all cores,
+// sparse and dense.
+// Usage: bench_cg [grid N] [dense n]
+int main(int argc, char* argv[]) {
+    int N = argc > 1 ? atoi(argv[1]) : 700;
+    int n = argc > 2 ? atoi(argv[2]) : 2000;
+
+    vector<int> threadCounts;
+    int cores = max(1, (int)thread::hardware_concurrency());
+    for (int t = 1; t < cores; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(cores);
+    if (cores < 4) threadCounts.push_back(4);   // oversubscribed: the cost of every join shows
+
+    SparseMatrix S = shiftedLaplacian(N);
+    SparseOperator sparse(&S);
+    Vector bs(N * N);
+    for (int i = 1; i <= N * N; ++i) {
+        bs(i) = 1.0 + (i % 7);
+    }
+
+    srand(42);
+    Matrix A(n, n);
+    for (int i = 1; i <= n; ++i) {
+        for (int j = i; j <= n; ++j) {
+            A(i, j) = A(j, i) = (rand() % 2000 - 1000) / 1000.0;
+        }
+        A(i, i) = n;
+    }
+    DenseOperator dense(&A);
+    Vector bd(n);
+    for (int i = 1; i <= n; ++i) {
+        bd(i) = 1.0;
+    }
+
+    cout << "hardware threads = " << thread::hardware_concurrency() << endl << endl;
+    scaling("Sparse 5-point Laplacian, " + to_string(N * N) + " unknowns", sparse, bs, threadCounts);
+    scaling("Dense n = " + to_string(n), dense, bd, threadCounts);
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <GradientTrainer.h>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static const int NUM_FEATURES = 6;
+
+static double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+// MYCT..CHMAX (columns 3-8) as z-scores, PRP (column 9) as the target
+static void readMachineData(const string& filename, vector<double>& X, vector<double>& y) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file: " + filename);
+    }
+    string line;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string field;
+        vector<string> fields;
+        while (getline(ss, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 9) continue;
+        for (int j = 0; j < NUM_FEATURES; ++j) {
+            X.push_back(stod(fields[2 + j]));
+        }
+        y.push_back(stod(fields[8]));
+    }
+    int m = (int)y.size();
+    for (int j = 0; j < NUM_FEATURES; ++j) {
+        double mean = 0.0, var = 0.0;
+        for (int i = 0; i < m; ++i) mean += X[i * NUM_FEATURES + j];
+        mean /= m;
+        for (int i = 0; i < m; ++i) var += (X[i * NUM_FEATURES + j] - mean) * (X[i * NUM_FEATURES + j] - mean);
+        double sd = sqrt(var / m);
+        for (int i = 0; i < m; ++i) X[i * NUM_FEATURES + j] = (X[i * NUM_FEATURES + j] - mean) / sd;
+    }
+}
+
+// Training time until the objective is first within each relative gap of the optimum
+static void report(const string& name, const GradientTrainer& trainer, double optimum) {
+    const vector<TrainingEpoch>& history = trainer.History();
+    cout << name;
+    for (double gap : {1e-1, 1e-2, 1e-3}) {
+        auto reached = find_if(history.begin(), history.end(),
+                               [&](const TrainingEpoch& e) { return e.objective <= optimum * (1.0 + gap); });
+        cout << "\t" << (reached == history.end() ? string("-") : to_string(reached->seconds * 1e3));
+    }
+    cout << "\t" << history.back().objective / optimum - 1.0 << "\t" << history.back().seconds * 1e3 << endl;
+}
+
+static void train(const string& name, GradientTrainer& trainer, GradientMethod method, double rate, double decay,
+                  int batch, int epochs, double optimum) {
+    trainer.SetMethod(method);
+    trainer.SetLearningRate(rate);
+    trainer.SetDecay(decay);
+    trainer.SetBatchSize(batch);
+    trainer.SetEpochs(epochs);
+    trainer.Train();
+    report(name, trainer, optimum);
+}
+
+// Mini-batch gradient descent against TSQR: time to reach a relative gap in
+// the objective on machine.data, and on a larger synthetic design, with
+// reduction and Hogwild updates.
+// Usage: bench_gradient [rows] [columns] [epochs]
+int main(int argc, char* argv[]) {
+    int m = argc > 1 ? atoi(argv[1]) : 40000;
+    int p = argc > 2 ? atoi(argv[2]) : 400;
+    int epochs = argc > 3 ? atoi(argv[3]) : 10;
+
+    vector<double> X, y;
+    readMachineData("dataset/machine.data", X, y);
+    int rows = (int)y.size();
+    Matrix M(rows, NUM_FEATURES);
+    Vector t(rows);
+    copy(X.begin(), X.end(), M.data());
+    copy(y.begin(), y.end(), t.begin());
+
+    const int repeats = 1000;
+    Clock::time_point start = Clock::now();
+    Vector direct(NUM_FEATURES);
+    for (int r = 0; r < repeats; ++r) {
+        TallSkinnyQR tsqr(M, t);
+        direct = tsqr.Solve();
+    }
+    double directMs = secondsSince(start) * 1e3 / repeats;
+    GradientTrainer small(&M, &t);
+    double optimum = small.Objective(direct);
+    cout << "machine.data: " << rows << " x " << NUM_FEATURES << ", TSQR " << directMs << " ms" << endl;
+    cout << "method\t\tms to 1e-1\tms to 1e-2\tms to 1e-3\tfinal gap\tms total" << endl;
+    train("SGD, batch 16", small, GradientMethod::SGD, 0.05, 0.0, 16, 400, optimum);
+    train("SGD, decayed", small, GradientMethod::SGD, 0.05, 0.05, 16, 400, optimum);
+    train("momentum, 16", small, GradientMethod::Momentum, 0.005, 0.05, 16, 400, optimum);
+    train("Adam, batch 16", small, GradientMethod::Adam, 1.0, 0.05, 16, 400, optimum);
+    train("GD, full batch", small, GradientMethod::SGD, 0.5, 0.0, rows, 2000, optimum);
+    cout << endl;
+
+    srand(42);
+    Matrix A(m, p);
+    Vector b(m);
+    for (int i = 1; i <= m; ++i) {
+        double sum = 0.0;
+        for (int j = 1; j <= p; ++j) {
+            A(i, j) = (rand() % 2001 - 1000) / 1000.0;
+            sum += A(i, j) * ((j % 7) - 3.0);
+        }
+        b(i) = sum + (rand() % 2001 - 1000) / 1000.0;
+    }
+    start = Clock::now();
+    TallSkinnyQR tsqr(A, b);
+    Vector x = tsqr.Solve();
+    directMs = secondsSince(start) * 1e3;
+    GradientTrainer large(&A, &b);
+    optimum = large.Objective(x);
+    int defaultBatch = large.BatchSize();
+    int hardware = max(1, (int)thread::hardware_concurrency());
+    cout << "synthetic: " << m << " x " << p << ", TSQR " << directMs << " ms, hardware threads = " << hardware << endl;
+    cout << "method\t\tms to 1e-1\tms to 1e-2\tms to 1e-3\tfinal gap\tms total" << endl;
+    ThreadPool::instance().setNumThreads(1);
+    train("GD, full batch", large, GradientMethod::SGD, 2.5, 0.0, m, 5 * epochs, optimum);
+    train("SGD, batch " + to_string(defaultBatch), large, GradientMethod::SGD, 0.3, 1.0, defaultBatch, epochs, optimum);
+    train("SGD, batch 256", large, GradientMethod::SGD, 1.0, 1.0, 256, epochs, optimum);
+    train("Adam, batch 256", large, GradientMethod::Adam, 0.05, 2.0, 256, epochs, optimum);
+    for (int threads : {hardware, 4}) {
+        ThreadPool::instance().setNumThreads(threads);
+        large.SetUpdate(GradientUpdate::Reduction);
+        train("Adam, reduce " + to_string(threads), large, GradientMethod::Adam, 0.05, 2.0, 256, epochs, optimum);
+        large.SetUpdate(GradientUpdate::Hogwild);
+        train("Adam, Hogwild " + to_string(threads), large, GradientMethod::Adam, 0.05, 2.0, 256, epochs, optimum);
+        if (threads == 4) break;
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <BiCGSTABLinSystem.h>
+#include <GMRESLinSystem.h>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <Preconditioner.h>
+#include <SparseMatrix.h>
+#include <Vector.h>
+
+using namespace std;
+
+// Upwind convection-diffusion on an N x N grid
+static SparseMatrix convectionDiffusion(int N, double convection) {
+    vector<SparseMatrix::Triplet> entries;
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            int row = i * N + j + 1;
+            entries.push_back({row, row, 4.0 + convection});
+            if (i > 0) entries.push_back({row, row - N, -1.0 - convection});
+            if (i < N - 1) entries.push_back({row, row + N, -1.0});
+            if (j > 0) entries.push_back({row, row - 1, -1.0});
+            if (j < N - 1) entries.push_back({row, row + 1, -1.0});
+        }
+    }
+    return SparseMatrix(N * N, N * N, entries);
+}
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, KrylovLinSystem& system, double seconds) {
+    const vector<double>& history = system.ResidualHistory();
+    cout << name << "\t" << system.Iterations() << "\t" << seconds << "\t"
+         << system.ResidualNorm() / history.front() << endl;
+}
+
+// Iterations, time and relative residual of GMRES(30) and BiCGSTAB (sparse
+// and dense operators, Jacobi preconditioned) against dense LU.
+// Usage: bench_krylov [gridSize ...]   (n = gridSize²)
+int main(int argc, char* argv[]) {
+    vector<int> grids;
+    for (int i = 1; i < argc; ++i) {
+        grids.push_back(atoi(argv[i]));
+    }
+    if (grids.empty()) {
+        grids = {20, 40, 60};
+    }
+
+    for (int N : grids) {
+        SparseMatrix S = convectionDiffusion(N, 2.0);
+        int n = S.numRows();
+        Vector b(n);
+        for (int i = 1; i <= n; ++i) {
+            b(i) = 1.0;
+        }
+        JacobiPreconditioner jacobi(S);
+        cout << "n = " << n << " (" << S.nonZeros() << " nonzeros)" << endl;
+        cout << "method\t\t\titers\tseconds\trel. residual" << endl;
+
+        auto start = chrono::steady_clock::now();
+        GMRESLinSystem gmres(&S, &b, 30);
+        gmres.SetPreconditioner(&jacobi);
+        gmres.Solve();
+        report("GMRES(30) sparse", gmres, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        BiCGSTABLinSystem bicg(&S, &b);
+        bicg.SetPreconditioner(&jacobi);
+        bicg.Solve();
+        report("BiCGSTAB sparse", bicg, secondsSince(start));
+
+        Matrix dense = S.toDense();
+        start = chrono::steady_clock::now();
+        GMRESLinSystem gmresDense(&dense, &b, 30);
+        gmresDense.SetPreconditioner(&jacobi);
+        gmresDense.Solve();
+        report("GMRES(30) dense", gmresDense, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        BiCGSTABLinSystem bicgDense(&dense, &b);
+        bicgDense.SetPreconditioner(&jacobi);
+        bicgDense.Solve();
+        report("BiCGSTAB dense", bicgDense, secondsSince(start));
+
+        start = chrono::steady_clock::now();
+        LinearSystem direct(&dense, &b);
+        Vector x = direct.Solve();
+        double directSeconds = secondsSince(start);
+        Vector r = b - dense * x;
+        cout << "Dense LU\t\t-\t" << directSeconds << "\t" << sqrt(r.dot(r) / b.dot(b)) << endl << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <Kernels.h>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <Vector.h>
+
+using namespace std;
+
+static void fillRandom(Matrix& A) {
+    for (int i = 1; i <= A.numRows(); ++i) {
+        for (int j = 1; j <= A.numCols(); ++j) {
+            A(i, j) = (rand() % 2000 - 1000) / 1000.0;
+        }
+    }
+}
+
+// LU factorization rate compared with the GEMM rate of the same kernel, for
+// 1 thread and for the full pool.
+// Usage: bench_lu [n ...]
+int main(int argc, char* argv[]) {
+    vector<int> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {500, 1000, 2000};
+    }
+
+    srand(42);
+    int maxThreads = ThreadPool::instance().numThreads();
+    vector<int> threadCounts = {1};
+    if (maxThreads > 1) threadCounts.push_back(maxThreads);
+
+    cout << "n\tthreads\tGEMM GFLOP/s\tLU GFLOP/s\tLU/GEMM\tSolve() s\tresidual" << endl;
+    for (int n : sizes) {
+        Matrix A(n, n);
+        fillRandom(A);
+        Matrix B(n, n);
+        fillRandom(B);
+
+        for (int threads : threadCounts) {
+            ThreadPool::instance().setNumThreads(threads);
+
+            auto start = chrono::steady_clock::now();
+            Matrix C = A * B;
+            double gemmSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            Matrix LU(A);
+            vector<int> piv(n);
+            start = chrono::steady_clock::now();
+            kernels::luFactor(n, n, LU.data(), n, piv.data());
+            double luSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            Vector b(n);
+            for (int i = 1; i <= n; ++i) {
+                b(i) = 1.0;
+            }
+            start = chrono::steady_clock::now();
+            LinearSystem system(&A, &b);
+            Vector x = system.Solve();
+            double solveSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            Vector r = b - A * x;
+            double gemmRate = 2.0 * n * n * (double)n / gemmSeconds * 1e-9;
+            double luRate = 2.0 / 3.0 * n * n * (double)n / luSeconds * 1e-9;
+            cout << n << "\t" << threads << "\t" << gemmRate << "\t\t" << luRate << "\t\t"
+                 << luRate / gemmRate << "\t" << solveSeconds << "\t" << sqrt(r.dot(r)) << endl;
+        }
+        ThreadPool::instance().setNumThreads(maxThreads);
+    }
+
+    return 0;
+}
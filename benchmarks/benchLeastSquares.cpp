@@ -0,0 +1,116 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <KrylovLeastSquares.h>
+#include <Matrix.h>
+#include <SparseMatrix.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double relativeError(const Vector& x, const Vector& exact) {
+    double diff = 0.0, norm = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+        diff += (x.data()[i] - exact.data()[i]) * (x.data()[i] - exact.data()[i]);
+        norm += exact.data()[i] * exact.data()[i];
+    }
+    return sqrt(diff / norm);
+}
+
+static void report(const string& name, double seconds, int iterations, double error) {
+    cout << name << "\t" << seconds << "\t" << iterations << "\t\t" << error << endl;
+}
+
+template <class Operator>
+static void krylov(const string& name, const Operator* A, const Vector& b, LeastSquaresMethod method,
+                   double damping, const Vector& exact, double tolerance = 1e-10, int maxIterations = 5000) {
+    KrylovLeastSquares solver(A, &b);
+    solver.SetTolerance(tolerance);
+    solver.SetMethod(method);
+    solver.SetDamping(damping);
+    solver.SetMaxIterations(maxIterations);
+    streambuf* saved = cout.rdbuf(nullptr);   // runs cut short on purpose warn
+    Clock::time_point start = Clock::now();
+    Vector x = solver.Solve();
+    cout.rdbuf(saved);
+    report(name, secondsSince(start), solver.Iterations(), relativeError(x, exact));
+}
+
+// Tall dense designs with a known solution (b = A x exactly), well and badly
+// conditioned, then a sparse design too large for anything that forms AᵀA.
+// Usage: bench_least_squares [dense rows] [sparse columns]
+int main(int argc, char* argv[]) {
+    int m = argc > 1 ? atoi(argv[1]) : 500000;
+    int nSparse = argc > 2 ? atoi(argv[2]) : 20000;
+    const int n = 8;
+    srand(21);
+
+    // Column j is a base column plus its neighbour scaled by 1 - eps, which
+    // sets the condition number to about 1/eps
+    for (double eps : {1e-1, 1e-6}) {
+        Matrix A(m, n);
+        vector<double> base((size_t)m * n);
+        for (double& v : base) v = (rand() % 2001 - 1000) / 1000.0;
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < n; ++j) {
+                double neighbour = j > 0 ? base[(size_t)i * n + j - 1] : 0.0;
+                A(i + 1, j + 1) = j % 2 == 1 ? neighbour * (1.0 - eps) + eps * base[(size_t)i * n + j]
+                                             : base[(size_t)i * n + j];
+            }
+        }
+        Vector exact(n);
+        for (int j = 1; j <= n; ++j) exact(j) = j - 4.5;
+        Vector b = A * exact;
+
+        cout << "Dense " << m << " x " << n << ", coupling eps = " << eps << endl;
+        cout << "solver\t\tseconds\titerations\trelative error" << endl;
+        Clock::time_point start = Clock::now();
+        Matrix Aplus = A.pseudoInverse();
+        Vector xPinv = Aplus * b;
+        report("pseudoinverse", secondsSince(start), 0, relativeError(xPinv, exact));
+        start = Clock::now();
+        TallSkinnyQR tsqr(A, b);
+        Vector xQR = tsqr.Solve();
+        report("TSQR\t", secondsSince(start), 0, relativeError(xQR, exact));
+        krylov("LSQR\t", &A, b, LeastSquaresMethod::LSQR, 0.0, exact);
+        krylov("CGLS\t", &A, b, LeastSquaresMethod::CGLS, 0.0, exact);
+        // Errors along small singular values barely move the residual, so
+        // recovering x itself takes iterating past the stopping test
+        krylov("LSQR x 40", &A, b, LeastSquaresMethod::LSQR, 0.0, exact, 0.0, 40);
+        krylov("CGLS x 40", &A, b, LeastSquaresMethod::CGLS, 0.0, exact, 0.0, 40);
+        cout << endl;
+    }
+
+    // Sparse: 10 rows per column, 6 entries per row
+    int mSparse = 10 * nSparse;
+    vector<SparseMatrix::Triplet> entries;
+    for (int i = 1; i <= mSparse; ++i) {
+        for (int k = 0; k < 6; ++k) {
+            int j = (int)(((long)i * 7919 + (long)k * 104729) % nSparse) + 1;
+            entries.push_back({i, j, (rand() % 2001 - 1000) / 1000.0});
+        }
+    }
+    SparseMatrix S(mSparse, nSparse, entries);
+    Vector exact(nSparse);
+    for (int j = 1; j <= nSparse; ++j) exact(j) = sin(0.01 * j);
+    Vector b(mSparse);
+    S.multiply(exact.data(), b.data());
+    cout << "Sparse " << mSparse << " x " << nSparse << ", " << S.nonZeros() << " nonzeros (AᵀA would take "
+         << 8.0 * nSparse * nSparse / 1e9 << " GB dense)" << endl;
+    cout << "solver\t\tseconds\titerations\trelative error to the undamped solution" << endl;
+    krylov("LSQR\t", &S, b, LeastSquaresMethod::LSQR, 0.0, exact);
+    krylov("CGLS\t", &S, b, LeastSquaresMethod::CGLS, 0.0, exact);
+    for (double damping : {0.1, 1.0}) {
+        krylov("LSQR damp " + to_string(damping).substr(0, 3), &S, b, LeastSquaresMethod::LSQR, damping, exact);
+    }
+    return 0;
+}
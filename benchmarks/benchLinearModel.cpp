@@ -0,0 +1,136 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <LinearModel.h>
+#include <Vector.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static const int NUM_FEATURES = 6;
+
+static double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double percentile(vector<double>& samples, double q) {
+    size_t k = min(samples.size() - 1, (size_t)(q * samples.size()));
+    nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+// The scoring path cpu_regression had: normalize a copy of the row in place,
+// then six one-based lookups into the coefficient vector
+struct Row {
+    double myct, mmin, mmax, cach, chmin, chmax;
+};
+
+static double legacyPredict(Row r, Vector& c, const Vector& means, const Vector& stddevs) {
+    r.myct = (r.myct - means(1)) / stddevs(1);
+    r.mmin = (r.mmin - means(2)) / stddevs(2);
+    r.mmax = (r.mmax - means(3)) / stddevs(3);
+    r.cach = (r.cach - means(4)) / stddevs(4);
+    r.chmin = (r.chmin - means(5)) / stddevs(5);
+    r.chmax = (r.chmax - means(6)) / stddevs(6);
+    return c(1) * r.myct + c(2) * r.mmin + c(3) * r.mmax + c(4) * r.cach + c(5) * r.chmin + c(6) * r.chmax;
+}
+
+// Single-row scoring latency (p50/p99, timer overhead included and reported),
+// batch scoring bandwidth against a plain read of the same rows, and CSV
+// scoring throughput.
+// Usage: bench_linear_model [rows]
+int main(int argc, char* argv[]) {
+    int m = argc > 1 ? atoi(argv[1]) : 2000000;
+    const int p = NUM_FEATURES;
+    Vector c(p), means(p), stddevs(p);
+    for (int j = 1; j <= p; ++j) {
+        c(j) = 10.0 * j - 25.0;
+        means(j) = 100.0 * j;
+        stddevs(j) = 3.0 + j * j;
+    }
+    LinearModel model(c, means, stddevs);
+
+    srand(5);
+    vector<double> X((size_t)m * p);
+    for (double& v : X) {
+        v = rand() % 64000;
+    }
+    double sink = 0.0;
+
+    // Single rows, each timed on its own
+    int samples = min(m, 1000000);
+    vector<double> timer(samples), folded(samples), legacy(samples);
+    for (int i = 0; i < samples; ++i) {
+        Clock::time_point start = Clock::now();
+        timer[i] = chrono::duration<double, nano>(Clock::now() - start).count();
+    }
+    for (int i = 0; i < samples; ++i) {
+        const double* x = &X[(size_t)i * p];
+        Clock::time_point start = Clock::now();
+        sink += model.predict(x);
+        folded[i] = chrono::duration<double, nano>(Clock::now() - start).count();
+    }
+    for (int i = 0; i < samples; ++i) {
+        const double* x = &X[(size_t)i * p];
+        Row r = {x[0], x[1], x[2], x[3], x[4], x[5]};
+        Clock::time_point start = Clock::now();
+        sink += legacyPredict(r, c, means, stddevs);
+        legacy[i] = chrono::duration<double, nano>(Clock::now() - start).count();
+    }
+    cout << "single row\tp50 ns\tp99 ns" << endl;
+    cout << "timer only\t" << percentile(timer, 0.5) << "\t" << percentile(timer, 0.99) << endl;
+    cout << "folded model\t" << percentile(folded, 0.5) << "\t" << percentile(folded, 0.99) << endl;
+    cout << "normalize+dot\t" << percentile(legacy, 0.5) << "\t" << percentile(legacy, 0.99) << endl << endl;
+
+    // Batches: the rows are read once, so the bound is memory bandwidth
+    double bytes = (double)m * p * sizeof(double);
+    vector<double> y(m);
+    model.predict(X.data(), m, p, y.data());   // warm up page tables
+    Clock::time_point start = Clock::now();
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;   // four chains so adds do not limit the read
+    size_t k = 0;
+    for (; k + 4 <= X.size(); k += 4) {
+        s0 += X[k];
+        s1 += X[k + 1];
+        s2 += X[k + 2];
+        s3 += X[k + 3];
+    }
+    for (; k < X.size(); ++k) s0 += X[k];
+    double sum = s0 + s1 + s2 + s3;
+    double readSeconds = secondsSince(start);
+    start = Clock::now();
+    model.predict(X.data(), m, p, y.data());
+    double batchSeconds = secondsSince(start);
+    sink += sum + y[m / 2];
+    start = Clock::now();
+    for (int i = 0; i < m; ++i) {
+        const double* x = &X[(size_t)i * p];
+        Row r = {x[0], x[1], x[2], x[3], x[4], x[5]};
+        y[i] = legacyPredict(r, c, means, stddevs);
+    }
+    double legacySeconds = secondsSince(start);
+    sink += y[m / 3];
+    cout << m << " rows\t\tns/row\tGB/s" << endl;
+    cout << "read only\t" << readSeconds * 1e9 / m << "\t" << bytes / readSeconds / 1e9 << endl;
+    cout << "folded batch\t" << batchSeconds * 1e9 / m << "\t" << bytes / batchSeconds / 1e9 << endl;
+    cout << "normalize+dot\t" << legacySeconds * 1e9 / m << "\t" << bytes / legacySeconds / 1e9 << endl << endl;
+
+    // CSV in, predictions out
+    string text;
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < p; ++j) {
+            text += to_string((int)X[(size_t)i * p + j]);
+            text += j + 1 < p ? ',' : '\n';
+        }
+    }
+    string out;
+    start = Clock::now();
+    model.score(text.data(), text.data() + text.size(), out);
+    double scoreSeconds = secondsSince(start);
+    cout << "CSV scoring: " << text.size() / scoreSeconds / 1e6 << " MB/s in, "
+         << m / scoreSeconds / 1e6 << " M rows/s" << endl;
+    return sink == 0.0 ? 1 : 0;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <MappedMatrix.h>
+#include <Matrix.h>
+#include <Vector.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Evict the file from the page cache so the next pass reads from disk
+static void dropCache(const string& path) {
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+// Sequential read bandwidth of the file with plain fread, for reference
+static double readFile(const string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    vector<char> buffer((size_t)8 << 20);
+    size_t total = 0, got = 0;
+    auto start = chrono::steady_clock::now();
+    while ((got = fread(buffer.data(), 1, buffer.size(), f)) > 0) {
+        total += got;
+    }
+    double seconds = secondsSince(start);
+    fclose(f);
+    return total / seconds / 1e9;
+}
+
+// Out-of-core GEMV/GEMM on a matrix file against fread bandwidth and the
+// in-memory kernels. Usage: bench_mapped [rows cols [file]]
+int main(int argc, char* argv[]) {
+    int rows = argc > 2 ? atoi(argv[1]) : 8192;
+    int cols = argc > 2 ? atoi(argv[2]) : 4096;
+    string path = argc > 3 ? argv[3] : "bench_mapped.mat";
+    double gigabytes = (double)rows * cols * sizeof(double) / 1e9;
+    cout << rows << " x " << cols << " matrix, " << gigabytes << " GB" << endl;
+
+    // Fill the file through a read-write mapping without a copy in memory
+    auto start = chrono::steady_clock::now();
+    MappedMatrix::create(path, rows, cols);
+    {
+        MappedMatrix file(path, MappedMatrix::Mode::ReadWrite);
+        MatrixView all = file.writableView();
+        for (int i = 1; i <= rows; ++i) {
+            VectorView row = all.row(i);
+            for (int j = 1; j <= cols; ++j) {
+                row(j) = ((i * 7 + j * 13) % 29) / 14.0 - 1.0;
+            }
+        }
+        file.flush();
+    }
+    cout << "create + fill + flush: " << secondsSince(start) << " s" << endl;
+
+    Vector x(cols);
+    for (int j = 1; j <= cols; ++j) {
+        x(j) = 1.0 / j;
+    }
+    Matrix B(cols, 8);
+    for (int i = 1; i <= cols; ++i) {
+        for (int j = 1; j <= 8; ++j) {
+            B(i, j) = 1.0 / (i + j);
+        }
+    }
+
+    dropCache(path);
+    cout << "fread (cold)\t" << readFile(path) << " GB/s" << endl;
+
+    MappedMatrix A(path);
+    dropCache(path);
+    start = chrono::steady_clock::now();
+    Vector y = A * x;
+    double cold = secondsSince(start);
+    cout << "GEMV mapped (cold)\t" << cold << " s\t" << gigabytes / cold << " GB/s" << endl;
+
+    start = chrono::steady_clock::now();
+    y = A * x;
+    double warm = secondsSince(start);
+    cout << "GEMV mapped (warm)\t" << warm << " s\t" << gigabytes / warm << " GB/s" << endl;
+
+    dropCache(path);
+    start = chrono::steady_clock::now();
+    Matrix C = A * B;
+    double gemm = secondsSince(start);
+    cout << "GEMM 8 columns (cold)\t" << gemm << " s\t" << gigabytes / gemm << " GB/s" << endl;
+
+    if (gigabytes < 2.0) {
+        Matrix inMemory = A.toMatrix();
+        start = chrono::steady_clock::now();
+        Vector z = inMemory * x;
+        double memory = secondsSince(start);
+        cout << "GEMV in memory\t\t" << memory << " s\t" << gigabytes / memory << " GB/s" << endl;
+    }
+
+    remove(path.c_str());
+    return 0;
+}
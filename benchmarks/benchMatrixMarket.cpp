@@ -0,0 +1,81 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <MatrixMarket.h>
+#include <Parallel.h>
+#include <SparseMatrix.h>
+
+using namespace std;
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Reference parser: the entries read one by one with istream extraction
+static size_t streamParse(const string& path) {
+    ifstream in(path);
+    string line;
+    while (getline(in, line) && !line.empty() && line[0] == '%') {}
+    size_t count = 0;
+    int row, col;
+    double value;
+    while (in >> row >> col >> value) {
+        ++count;
+    }
+    return count;
+}
+
+// Write and read a random sparse coordinate file: the parallel from_chars
+// reader on 1 and all threads against istream extraction.
+// Usage: bench_matrix_market [n entriesPerRow [file]]
+int main(int argc, char* argv[]) {
+    int n = argc > 2 ? atoi(argv[1]) : 200000;
+    int perRow = argc > 2 ? atoi(argv[2]) : 10;
+    string path = argc > 3 ? argv[3] : "bench_matrix_market.mtx";
+
+    vector<SparseMatrix::Triplet> entries;
+    entries.reserve((size_t)n * perRow);
+    unsigned state = 12345;
+    for (int i = 1; i <= n; ++i) {
+        for (int k = 0; k < perRow; ++k) {
+            state = state * 1664525u + 1013904223u;
+            int col = 1 + (int)(state % (unsigned)n);
+            entries.push_back({i, col, (state >> 8) / 16777216.0 - 0.5});
+        }
+    }
+    SparseMatrix A(n, n, entries);
+
+    auto start = chrono::steady_clock::now();
+    matrixmarket::write(path, A);
+    double writeSeconds = secondsSince(start);
+    ifstream sizeProbe(path, ios::binary | ios::ate);
+    double megabytes = sizeProbe.tellg() / 1e6;
+    cout << A.nonZeros() << " entries, " << megabytes << " MB" << endl;
+    cout << "write\t\t\t" << writeSeconds << " s\t" << megabytes / writeSeconds << " MB/s" << endl;
+
+    start = chrono::steady_clock::now();
+    size_t count = streamParse(path);
+    double streamSeconds = secondsSince(start);
+    cout << "istream >>\t\t" << streamSeconds << " s\t" << megabytes / streamSeconds << " MB/s ("
+         << count << " entries)" << endl;
+
+    vector<int> threadCounts = {1};
+    if (ThreadPool::instance().numThreads() > 1) {
+        threadCounts.push_back(ThreadPool::instance().numThreads());
+    }
+    for (int threads : threadCounts) {
+        ThreadPool::instance().setNumThreads(threads);
+        start = chrono::steady_clock::now();
+        SparseMatrix B = matrixmarket::readSparse(path);
+        double seconds = secondsSince(start);
+        cout << "readSparse, " << threads << " thread(s)\t" << seconds << " s\t" << megabytes / seconds
+             << " MB/s (" << B.nonZeros() << " entries)" << endl;
+    }
+
+    remove(path.c_str());
+    return 0;
+}
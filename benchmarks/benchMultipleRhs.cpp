@@ -0,0 +1,63 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <Vector.h>
+
+using namespace std;
+
+// Throughput of SolveMultiple() against looping over Solve() once per right-hand side.
+// Usage: bench_multi_rhs [n] [numRhs]
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 200;
+    int s = argc > 2 ? atoi(argv[2]) : 200;
+
+    srand(42);
+    Matrix A(n, n);
+    for (int i = 1; i <= n; ++i) {
+        for (int j = 1; j <= n; ++j) {
+            A(i, j) = (rand() % 2000 - 1000) / 1000.0;
+        }
+        A(i, i) += n;  // keep the system well conditioned
+    }
+
+    Matrix B(n, s);
+    for (int i = 1; i <= n; ++i) {
+        for (int j = 1; j <= s; ++j) {
+            B(i, j) = (rand() % 2000 - 1000) / 100.0;
+        }
+    }
+
+    cout << "n = " << n << ", right-hand sides = " << s << endl;
+
+    // One factorization, blocked triangular solves
+    auto start = chrono::steady_clock::now();
+    LinearSystem system(&A, &B);
+    Matrix X = system.SolveMultiple();
+    double blockedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // One factorization per right-hand side
+    double maxDiff = 0.0;
+    start = chrono::steady_clock::now();
+    for (int j = 1; j <= s; ++j) {
+        Vector b(n);
+        for (int i = 1; i <= n; ++i) {
+            b(i) = B(i, j);
+        }
+        LinearSystem single(&A, &b);
+        Vector x = single.Solve();
+        for (int i = 1; i <= n; ++i) {
+            maxDiff = fmax(maxDiff, fabs(x(i) - X(i, j)));
+        }
+    }
+    double loopSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "SolveMultiple(): " << blockedSeconds << " s, " << s / blockedSeconds << " RHS/s" << endl;
+    cout << "Solve() loop:    " << loopSeconds << " s, " << s / loopSeconds << " RHS/s" << endl;
+    cout << "Speedup:         " << loopSeconds / blockedSeconds << "x" << endl;
+    cout << "Max difference between methods: " << maxDiff << endl;
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <Kernels.h>
+#include <Matrix.h>
+#include <PolynomialFeatures.h>
+#include <Vector.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Expanded normal equations two ways: accumulated from the base rows without
+// storing the expansion, and by materializing the n x q expanded design (plus
+// its transpose) and multiplying them with GEMM.
+// Usage: bench_polynomial [rows]
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 200000;
+    const int p = 6;
+    srand(9);
+    Matrix X(n, p);
+    Vector y(n);
+    for (int i = 1; i <= n; ++i) {
+        for (int j = 1; j <= p; ++j) {
+            X(i, j) = (rand() % 2001 - 1000) / 1000.0;
+        }
+        y(i) = (rand() % 2001 - 1000) / 1000.0;
+    }
+
+    cout << n << " rows of " << p << " features" << endl;
+    cout << "expansion\t\tterms\timplicit (s)\tmaterialized (s)\texpanded MB\tmax difference" << endl;
+    struct Config { int degree; InteractionSet interactions; const char* name; };
+    Config configs[] = {{2, InteractionSet::None, "degree 2, powers  "},
+                        {2, InteractionSet::All, "degree 2, all     "},
+                        {3, InteractionSet::Pairwise, "degree 3, pairwise"},
+                        {3, InteractionSet::All, "degree 3, all     "}};
+    for (const Config& config : configs) {
+        PolynomialFeatures features(p, config.degree, config.interactions);
+        int q = features.numFeatures();
+
+        Matrix G(q, q);
+        Vector g(q);
+        Clock::time_point start = Clock::now();
+        features.normalEquations(X, y, G, g);
+        double implicitSeconds = secondsSince(start);
+
+        start = Clock::now();
+        vector<double> E((size_t)n * q), Et((size_t)q * n);
+        for (int i = 0; i < n; ++i) {
+            features.expandRow(X.data() + (size_t)i * p, &E[(size_t)i * q]);
+            for (int k = 0; k < q; ++k) {
+                Et[(size_t)k * n + i] = E[(size_t)i * q + k];
+            }
+        }
+        Matrix Gm(q, q);
+        kernels::gemm(q, q, n, 1.0, Et.data(), n, E.data(), q, 0.0, Gm.data(), q);
+        double materializedSeconds = secondsSince(start);
+
+        double difference = 0.0;
+        for (int a = 1; a <= q; ++a) {
+            for (int b = 1; b <= q; ++b) {
+                difference = fmax(difference, fabs(G(a, b) - Gm(a, b)) / sqrt(Gm(a, a) * Gm(b, b)));
+            }
+        }
+        cout << config.name << "\t" << q << "\t" << implicitSeconds << "\t\t" << materializedSeconds << "\t\t\t"
+             << 2.0 * n * q * sizeof(double) / 1e6 << "\t\t" << difference << endl;
+    }
+    return 0;
+}
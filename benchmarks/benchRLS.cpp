@@ -0,0 +1,141 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <Matrix.h>
+#include <RecursiveLeastSquares.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static const int NUM_FEATURES = 6;
+
+// MYCT..CHMAX (columns 3-8) as z-scores, PRP (column 9) as the target
+static void readMachineData(const string& filename, vector<double>& X, vector<double>& y) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file: " + filename);
+    }
+    string line;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string field;
+        vector<string> fields;
+        while (getline(ss, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 9) continue;
+        for (int j = 0; j < NUM_FEATURES; ++j) {
+            X.push_back(stod(fields[2 + j]));
+        }
+        y.push_back(stod(fields[8]));
+    }
+    int m = (int)y.size();
+    for (int j = 0; j < NUM_FEATURES; ++j) {
+        double mean = 0.0, var = 0.0;
+        for (int i = 0; i < m; ++i) mean += X[i * NUM_FEATURES + j];
+        mean /= m;
+        for (int i = 0; i < m; ++i) var += (X[i * NUM_FEATURES + j] - mean) * (X[i * NUM_FEATURES + j] - mean);
+        double sd = sqrt(var / m);
+        for (int i = 0; i < m; ++i) X[i * NUM_FEATURES + j] = (X[i * NUM_FEATURES + j] - mean) / sd;
+    }
+}
+
+static double percentile(vector<double>& samples, double q) {
+    size_t k = min(samples.size() - 1, (size_t)(q * samples.size()));
+    nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+static void report(const string& name, vector<double>& ns) {
+    double mean = 0.0;
+    for (double t : ns) mean += t;
+    mean /= ns.size();
+    double p50 = percentile(ns, 0.50);
+    double p99 = percentile(ns, 0.99);
+    cout << name << "\t" << mean << "\t" << p50 << "\t" << p99 << endl;
+}
+
+// Replays machine.data as a stream of arrivals and times each model update:
+// RLS on a growing fit, RLS on a sliding window (update + downdate), and a
+// TSQR refit of the window per arrival as the batch alternative.
+// Usage: bench_rls [passes] [window]
+int main(int argc, char* argv[]) {
+    int passes = argc > 1 ? atoi(argv[1]) : 200;
+    int window = argc > 2 ? atoi(argv[2]) : 100;
+    vector<double> X, y;
+    readMachineData("dataset/machine.data", X, y);
+    int m = (int)y.size();
+    long arrivals = (long)passes * m;
+    const int p = NUM_FEATURES;
+    cout << m << " rows replayed " << passes << " times, window " << window << endl;
+    cout << "model\t\tmean ns\tp50 ns\tp99 ns" << endl;
+
+    vector<double> ns;
+    ns.reserve(arrivals);
+    double sink = 0.0;
+
+    RecursiveLeastSquares growing(p);
+    for (long t = 0; t < arrivals; ++t) {
+        int i = (int)(t % m);
+        Clock::time_point start = Clock::now();
+        sink += growing.Update(&X[i * p], y[i]);
+        ns.push_back(chrono::duration<double, nano>(Clock::now() - start).count());
+    }
+    report("RLS update", ns);
+
+    ns.clear();
+    RecursiveLeastSquares sliding(p);
+    for (long t = 0; t < arrivals; ++t) {
+        int i = (int)(t % m);
+        Clock::time_point start = Clock::now();
+        sink += sliding.Update(&X[i * p], y[i]);
+        if (t >= window) {
+            int old = (int)((t - window) % m);
+            sink += sliding.Downdate(&X[old * p], y[old]);
+        }
+        ns.push_back(chrono::duration<double, nano>(Clock::now() - start).count());
+    }
+    report("RLS window", ns);
+
+    // Batch refit of the same window; fewer arrivals since each one costs O(window p²)
+    ns.clear();
+    long refits = min(arrivals, 20000L);
+    Matrix A(window, p);
+    Vector b(window);
+    for (long t = window; t < window + refits; ++t) {
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < window; ++r) {
+            int i = (int)((t - window + 1 + r) % m);
+            for (int j = 0; j < p; ++j) A.data()[r * p + j] = X[i * p + j];
+            b.data()[r] = y[i];
+        }
+        TallSkinnyQR tsqr(A, b, 1);
+        Vector x = tsqr.Solve();
+        sink += x.data()[0];
+        ns.push_back(chrono::duration<double, nano>(Clock::now() - start).count());
+    }
+    report("TSQR refit", ns);
+
+    // After every downdate the window fit must still agree with a batch fit of its rows
+    for (int r = 0; r < window; ++r) {
+        int i = (int)((arrivals - window + r) % m);
+        for (int j = 0; j < p; ++j) A.data()[r * p + j] = X[i * p + j];
+        b.data()[r] = y[i];
+    }
+    double diff = 0.0;
+    TallSkinnyQR last(A, b, 1);
+    Vector x = last.Solve();
+    for (int j = 0; j < p; ++j) {
+        diff = max(diff, fabs(x.data()[j] - sliding.Coefficients().data()[j]));
+    }
+    cout << "max |RLS window - TSQR| at the end: " << diff << endl;
+    return sink == 0.0 ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <Matrix.h>
+#include <RobustRegression.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+
+using namespace std;
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Mean time of the reweightings that updated the Gram matrix in place and of those that rebuilt it
+static void summarize(const string& name, const RobustRegression& fit, double seconds, double olsSeconds) {
+    double updated = 0.0, rebuilt = 0.0;
+    int numUpdated = 0, numRebuilt = 0, solverIterations = 0;
+    const vector<IrlsIteration>& history = fit.History();
+    for (size_t k = 0; k < history.size(); ++k) {
+        const IrlsIteration& it = history[k];
+        if (it.scale == 0.0) continue;   // the least-squares start
+        solverIterations += it.solverIterations;
+        if (it.rebuilt) {
+            rebuilt += it.seconds;
+            ++numRebuilt;
+        } else {
+            updated += it.seconds;
+            ++numUpdated;
+        }
+    }
+    cout << name << "\t" << fit.Iterations() << "\t\t" << seconds << "\t" << seconds / olsSeconds << "\t\t"
+         << (numUpdated > 0 ? to_string(updated / numUpdated * 1e3) : string("-")) << "\t\t"
+         << (numRebuilt > 0 ? to_string(rebuilt / numRebuilt * 1e3) : string("-")) << "\t\t"
+         << (double)solverIterations / max(fit.Iterations(), 1) << endl;
+}
+
+// IRLS against one least-squares fit on a tall design with gross outliers:
+// total cost, and the cost of an in-place updated iteration against a rebuilt one.
+// Usage: bench_robust [rows] [columns] [outlier percent]
+int main(int argc, char* argv[]) {
+    int m = argc > 1 ? atoi(argv[1]) : 1000000;
+    int p = argc > 2 ? atoi(argv[2]) : 8;
+    int percent = argc > 3 ? atoi(argv[3]) : 10;
+
+    srand(42);
+    Matrix A(m, p);
+    Vector b(m);
+    for (int i = 1; i <= m; ++i) {
+        double sum = 0.0;
+        for (int j = 1; j <= p; ++j) {
+            A(i, j) = j == 1 ? 1.0 : (rand() % 2001 - 1000) / 1000.0;
+            sum += A(i, j) * j;
+        }
+        b(i) = sum + (rand() % 2001 - 1000) / 10000.0;
+        if (rand() % 100 < percent) {
+            b(i) += 20.0 + rand() % 50;
+        }
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    TallSkinnyQR tsqr(A, b);
+    Vector ols = tsqr.Solve();
+    double olsSeconds = secondsSince(start);
+
+    RobustRegression huber(&A, &b, RobustLoss::Huber);
+    start = chrono::steady_clock::now();
+    Vector h = huber.Fit();
+    double huberSeconds = secondsSince(start);
+
+    RobustRegression tukey(&A, &b, RobustLoss::Tukey);
+    start = chrono::steady_clock::now();
+    Vector t = tukey.Fit(h);
+    double tukeySeconds = secondsSince(start);
+
+    double olsError = 0.0, huberError = 0.0, tukeyError = 0.0;
+    for (int j = 1; j <= p; ++j) {
+        olsError = fmax(olsError, fabs(ols(j) - j));
+        huberError = fmax(huberError, fabs(h(j) - j));
+        tukeyError = fmax(tukeyError, fabs(t(j) - j));
+    }
+
+    cout << "m = " << m << ", p = " << p << ", " << percent << "% outliers" << endl;
+    cout << "TSQR least squares: " << olsSeconds << " s, max coefficient error " << olsError << endl;
+    cout << "IRLS start (unit-weight Gram + CG): " << huber.History()[0].seconds << " s" << endl << endl;
+    cout << "loss\titerations\tseconds\tx least squares\tupdated ms/it\trebuilt ms/it\tCG its/it" << endl;
+    summarize("Huber", huber, huberSeconds, olsSeconds);
+    summarize("Tukey", tukey, tukeySeconds, olsSeconds);
+    cout << endl << "max coefficient error: Huber " << huberError << ", Tukey " << tukeyError << endl;
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <Parallel.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static atomic<long> gSink(0);
+
+double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+long fibTasks(int n, int cutoff, atomic<long>& tasks) {
+    if (n < cutoff) {
+        long a = 0, b = 1;
+        for (int i = 0; i < n; ++i) {
+            long t = a + b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+    long x = 0;
+    TaskGroup group;
+    tasks.fetch_add(1, memory_order_relaxed);
+    group.run([&x, n, cutoff, &tasks] { x = fibTasks(n - 1, cutoff, tasks); });
+    long y = fibTasks(n - 2, cutoff, tasks);
+    group.wait();
+    return x + y;
+}
+
+// Cost of scheduling: empty tasks, empty parallelFor chunks, a fork-join
+// recursion, and a std::thread per task for comparison.
+// Usage: bench_scheduler [tasks]
+int main(int argc, char* argv[]) {
+    int numTasks = argc > 1 ? atoi(argv[1]) : 200000;
+    int maxThreads = max(4, (int)thread::hardware_concurrency());
+    vector<int> threadCounts = {1, 2, 4};
+    if (maxThreads > 4) threadCounts.push_back(maxThreads);
+
+    cout << "tasks = " << numTasks << ", hardware threads = " << thread::hardware_concurrency() << endl;
+    cout << "threads\tTaskGroup ns/task\tparallelFor ns/call\tfork-join ns/task" << endl;
+    for (int threads : threadCounts) {
+        ThreadPool::instance().setNumThreads(threads);
+
+        Clock::time_point start = Clock::now();
+        {
+            TaskGroup group;
+            for (int i = 0; i < numTasks; ++i) {
+                group.run([] { gSink.fetch_add(1, memory_order_relaxed); });
+            }
+            group.wait();
+        }
+        double groupNs = secondsSince(start) * 1e9 / numTasks;
+
+        // One chunk per item, 4 x threads items: every call forks and joins
+        int calls = numTasks / 10;
+        start = Clock::now();
+        for (int c = 0; c < calls; ++c) {
+            parallelFor(0, 4 * threads, 1, [](int b, int e) { gSink.fetch_add(e - b, memory_order_relaxed); });
+        }
+        double forNs = secondsSince(start) * 1e9 / calls;
+
+        atomic<long> tasks(0);
+        start = Clock::now();
+        long f = fibTasks(27, 12, tasks);
+        double forkNs = secondsSince(start) * 1e9 / max(1L, tasks.load());
+        gSink.fetch_add(f, memory_order_relaxed);
+
+        cout << threads << "\t" << groupNs << "\t\t\t" << forNs << "\t\t\t" << forkNs << endl;
+    }
+
+    int spawned = min(numTasks, 5000);
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < spawned; ++i) {
+        thread t([] { gSink.fetch_add(1, memory_order_relaxed); });
+        t.join();
+    }
+    cout << "std::thread per task: " << secondsSince(start) * 1e9 / spawned << " ns/task" << endl;
+    return gSink.load() == 0 ? 1 : 0;
+}
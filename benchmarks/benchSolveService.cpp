@@ -0,0 +1,121 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <SolveService.h>
+#include <Vector.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+vector<shared_ptr<Matrix>> makeMatrices(int count, int n) {
+    srand(42);
+    vector<shared_ptr<Matrix>> matrices;
+    for (int k = 0; k < count; ++k) {
+        auto A = make_shared<Matrix>(n, n);
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= n; ++j) {
+                (*A)(i, j) = (rand() % 2000 - 1000) / 1000.0;
+            }
+            (*A)(i, i) += n;
+        }
+        matrices.push_back(A);
+    }
+    return matrices;
+}
+
+double percentile(vector<double> values, double p) {
+    sort(values.begin(), values.end());
+    size_t index = (size_t)(p * (values.size() - 1));
+    return values[index];
+}
+
+// A producer thread submits the requests as fast as backpressure lets it,
+// the main thread collects the results in submission order.
+void runService(const char* label, const vector<shared_ptr<Matrix>>& matrices, const Vector& b,
+                int count, int workers) {
+    SolveService::Options options;
+    options.numWorkers = workers;
+    options.maxPending = 256;
+    SolveService service(options);
+
+    vector<SolveTicket> tickets(count);
+    vector<Clock::time_point> submitted(count);
+    vector<double> latencies(count);
+    vector<bool> ready(count, false);
+    mutex readyMutex;
+    condition_variable readySignal;
+
+    Clock::time_point start = Clock::now();
+    thread producer([&]() {
+        for (int k = 0; k < count; ++k) {
+            Clock::time_point t = Clock::now();
+            SolveTicket ticket = service.submit(matrices[k % matrices.size()], b);
+            lock_guard<mutex> lock(readyMutex);
+            submitted[k] = t;
+            tickets[k] = move(ticket);
+            ready[k] = true;
+            readySignal.notify_one();
+        }
+    });
+
+    double checksum = 0.0;
+    for (int k = 0; k < count; ++k) {
+        {
+            unique_lock<mutex> lock(readyMutex);
+            readySignal.wait(lock, [&] { return ready[k]; });
+        }
+        Vector x = tickets[k].result.get();
+        latencies[k] = chrono::duration<double>(Clock::now() - submitted[k]).count();
+        checksum += x(1);
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+    producer.join();
+
+    SolveService::Stats stats = service.stats();
+    cout << label << ": " << count / seconds << " systems/s, latency p50 " << percentile(latencies, 0.5) * 1e3
+         << " ms, p90 " << percentile(latencies, 0.9) * 1e3 << " ms, p99 " << percentile(latencies, 0.99) * 1e3
+         << " ms, max " << percentile(latencies, 1.0) * 1e3 << " ms, " << (double)count / stats.batches
+         << " systems/batch (checksum " << checksum << ")" << endl;
+}
+
+// Throughput and latency of SolveService against synchronous Solve() calls.
+// Usage: bench_solve_service [n] [count] [batches in flight]
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 32;
+    int count = argc > 2 ? atoi(argv[2]) : 20000;
+    int workers = argc > 3 ? atoi(argv[3]) : SolveService::Options().numWorkers;
+
+    // 1000 matrices never repeat inside a batch; 8 matrices are shared by most of it
+    vector<shared_ptr<Matrix>> distinct = makeMatrices(1000, n);
+    vector<shared_ptr<Matrix>> shared(distinct.begin(), distinct.begin() + 8);
+    Vector b(n);
+    for (int i = 1; i <= n; ++i) {
+        b(i) = 1.0;
+    }
+
+    cout << "n = " << n << ", systems = " << count << ", workers = " << workers << endl;
+
+    Clock::time_point start = Clock::now();
+    double checksum = 0.0;
+    for (int k = 0; k < count; ++k) {
+        LinearSystem system(distinct[k % distinct.size()].get(), &b);
+        Vector x = system.Solve();
+        checksum += x(1);
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+    cout << "Synchronous Solve(): " << count / seconds << " systems/s, " << seconds / count * 1e3
+         << " ms per system (checksum " << checksum << ")" << endl;
+
+    runService("Service, distinct matrices", distinct, b, count, workers);
+    runService("Service, 8 shared matrices", shared, b, count, workers);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <Matrix.h>
+
+using namespace std;
+
+// Largest error over sampled entries, relative to (|A||B|)_ij, against a
+// long double reference
+static double sampledError(const Matrix& A, const Matrix& B, const Matrix& C) {
+    int n = A.numRows();
+    double worst = 0.0;
+    for (int s = 0; s < 64; ++s) {
+        int i = 1 + (s * 7919) % n;
+        int j = 1 + (s * 104729) % n;
+        long double exact = 0.0L;
+        long double scale = 0.0L;
+        for (int k = 1; k <= n; ++k) {
+            exact += (long double)A(i, k) * B(k, j);
+            scale += fabsl((long double)A(i, k) * B(k, j));
+        }
+        worst = fmax(worst, (double)(fabsl(C(i, j) - exact) / scale));
+    }
+    return worst;
+}
+
+// Classical blocked GEMM against Strassen-Winograd for several crossover
+// points. The crossover to use is the smallest block size at which the
+// Strassen timing beats the classical one.
+// Usage: bench_strassen [n ...]
+int main(int argc, char* argv[]) {
+    vector<int> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {512, 1024, 2048};
+    }
+    const int crossovers[] = {64, 128, 256, 512};
+
+    srand(42);
+    cout << "n\tkernel\t\tcrossover\tseconds\trel. error" << endl;
+    for (int n : sizes) {
+        Matrix A(n, n);
+        Matrix B(n, n);
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= n; ++j) {
+                A(i, j) = (rand() % 2000 - 1000) / 1000.0;
+                B(i, j) = (rand() % 2000 - 1000) / 1000.0;
+            }
+        }
+
+        auto start = chrono::steady_clock::now();
+        Matrix C = A * B;
+        double classical = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << n << "\tclassical\t-\t\t" << classical << "\t" << sampledError(A, B, C) << endl;
+
+        for (int crossover : crossovers) {
+            if (crossover >= n) continue;
+            start = chrono::steady_clock::now();
+            Matrix S = A.strassenProduct(B, crossover);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << n << "\tstrassen\t" << crossover << "\t\t" << seconds << "\t"
+                 << sampledError(A, B, S) << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+
+using namespace std;
+
+// TSQR least squares on an m x p regression design for 1..all threads,
+// against the normal equations through pseudoInverse().
+// Usage: bench_tsqr [rows] [features]
+int main(int argc, char* argv[]) {
+    int m = argc > 1 ? atoi(argv[1]) : 1000000;
+    int p = argc > 2 ? atoi(argv[2]) : 6;
+
+    Matrix A(m, p);
+    Vector b(m);
+    srand(42);
+    for (int i = 1; i <= m; ++i) {
+        double sum = 0.0;
+        for (int j = 1; j <= p; ++j) {
+            A(i, j) = (rand() % 2000 - 1000) / 1000.0;
+            sum += j * A(i, j);
+        }
+        b(i) = sum + (rand() % 200 - 100) / 1000.0;
+    }
+    cout << "rows = " << m << ", features = " << p << endl;
+
+    auto start = chrono::steady_clock::now();
+    Matrix Aplus = A.pseudoInverse();
+    Vector xRef = Aplus * b;
+    double normalSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "pseudoInverse():\t" << normalSeconds << " s" << endl;
+
+    int maxThreads = ThreadPool::instance().numThreads();
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (int threads : threadCounts) {
+        ThreadPool::instance().setNumThreads(threads);
+        start = chrono::steady_clock::now();
+        TallSkinnyQR tsqr(A, b);
+        Vector x = tsqr.Solve();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        double diff = 0.0;
+        for (int j = 1; j <= p; ++j) {
+            diff = fmax(diff, fabs(x(j) - xRef(j)));
+        }
+        cout << "TSQR, " << threads << " threads:\t" << seconds << " s, "
+             << m / seconds * 1e-6 << " Mrows/s, max |x - x_normal| = " << diff << endl;
+    }
+    ThreadPool::instance().setNumThreads(maxThreads);
+
+    return 0;
+}
@@ -3,40 +3,178 @@
 
 mkdir -p compile
 
+# PROFILE=1 ./compile.sh <target> builds with the hot-path profiler enabled
+PROFILE_FLAGS=""
+if [ "$PROFILE" = "1" ]; then
+    PROFILE_FLAGS="-DTINI_PROFILE"
+fi
+
 case "$1" in
     "main")
-        g++ -o compile/main src/main.cpp src/Matrix.cpp src/Vector.cpp src/LinearSystem.cpp -I./Header-Files
+        g++ $PROFILE_FLAGS -o compile/main src/main.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp src/LinearSystem.cpp -I./Header-Files -pthread
         echo "Compiled main program"
         ;;
     "vector")
-        g++ -o compile/test_vector tests/testVector.cpp src/Vector.cpp -I./Header-Files
+        g++ $PROFILE_FLAGS -o compile/test_vector tests/testVector.cpp src/Vector.cpp src/AllocationTracker.cpp src/Profiler.cpp -I./Header-Files -pthread
         echo "Compiled vector test"
         ;;
     "matrix")
-        g++ -o compile/test_matrix tests/testMatrix.cpp src/Matrix.cpp src/Vector.cpp -I./Header-Files
+        g++ $PROFILE_FLAGS -o compile/test_matrix tests/testMatrix.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
         echo "Compiled matrix test"
         ;;
     "linear")
-        g++ -o compile/test_linear tests/testLinear.cpp src/LinearSystem.cpp src/Matrix.cpp src/Vector.cpp -I./Header-Files
+        g++ $PROFILE_FLAGS -o compile/test_linear tests/testLinear.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
         echo "Compiled linear system test"
         ;;
     "illposed")
-        g++ -o compile/test_illposed tests/testIllposed.cpp src/Matrix.cpp src/Vector.cpp src/LinearSystem.cpp -I./Header-Files
+        g++ $PROFILE_FLAGS -o compile/test_illposed tests/testIllposed.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp src/LinearSystem.cpp src/RandomizedSVD.cpp -I./Header-Files -pthread
         echo "Compiled ill-posed test"
         ;;
     "pos-sym-lin-system")
-        g++ -o compile/test_pos_sym tests/testPosSymLinSystem.cpp src/PosSymLinSystem.cpp src/LinearSystem.cpp src/Matrix.cpp src/Vector.cpp -I./Header-Files
+        g++ $PROFILE_FLAGS -o compile/test_pos_sym tests/TestPosSymLinSystem.cpp src/PosSymLinSystem.cpp src/LinearOperator.cpp src/SparseMatrix.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
         echo "Compiled positive symmetric test"
         ;;
     "matrix-vector")
-        g++ -o compile/test_matrix_vector tests/testMaVec.cpp src/Matrix.cpp src/Vector.cpp -I./Header-Files
+        g++ $PROFILE_FLAGS -o compile/test_matrix_vector tests/testMaVec.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
         echo "Compiled matrix-vector multiplication test"
         ;;
     "regression")
-        g++ -o compile/cpu_regression src/cpuRegression.cpp src/Matrix.cpp src/Vector.cpp src/LinearSystem.cpp -I./Header-Files
+        g++ $PROFILE_FLAGS -o compile/cpu_regression src/cpuRegression.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp src/LinearSystem.cpp src/TallSkinnyQR.cpp src/RecursiveLeastSquares.cpp src/LinearModel.cpp src/PolynomialFeatures.cpp src/KrylovLeastSquares.cpp src/LinearOperator.cpp src/SparseMatrix.cpp src/RobustRegression.cpp src/GradientTrainer.cpp -I./Header-Files -pthread
         echo "Compiled CPU regression analysis"
         ;;
+    "tsqr")
+        g++ $PROFILE_FLAGS -o compile/test_tsqr tests/testTSQR.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled TSQR test"
+        ;;
+    "krylov")
+        g++ $PROFILE_FLAGS -o compile/test_krylov tests/testKrylov.cpp src/KrylovLinSystem.cpp src/GMRESLinSystem.cpp src/BiCGSTABLinSystem.cpp src/LinearOperator.cpp src/Preconditioner.cpp src/SparseMatrix.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled GMRES/BiCGSTAB test"
+        ;;
+    "banded")
+        g++ $PROFILE_FLAGS -o compile/test_banded tests/testBanded.cpp src/TridiagonalMatrix.cpp src/TridiagonalLinSystem.cpp src/BandedMatrix.cpp src/BandedLinSystem.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled banded and tridiagonal test"
+        ;;
+    "mapped")
+        g++ $PROFILE_FLAGS -o compile/test_mapped tests/testMapped.cpp src/MappedMatrix.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled memory-mapped matrix test"
+        ;;
+    "matrix-market")
+        g++ $PROFILE_FLAGS -o compile/test_matrix_market tests/testMatrixMarket.cpp src/MatrixMarket.cpp src/SparseMatrix.cpp src/LinearOperator.cpp src/PosSymLinSystem.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled Matrix Market test"
+        ;;
+    "profiler")
+        g++ -DTINI_PROFILE -o compile/test_profiler tests/testProfiler.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled profiler test"
+        ;;
+    "allocations")
+        g++ $PROFILE_FLAGS -o compile/test_allocation tests/testAllocation.cpp src/PosSymLinSystem.cpp src/LinearOperator.cpp src/SparseMatrix.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled allocation accounting test"
+        ;;
+    "solve-service")
+        g++ $PROFILE_FLAGS -o compile/test_solve_service tests/testSolveService.cpp src/SolveService.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled asynchronous solve service test"
+        ;;
+    "scheduler")
+        g++ $PROFILE_FLAGS -o compile/test_scheduler tests/testScheduler.cpp src/Parallel.cpp -I./Header-Files -pthread
+        echo "Compiled work-stealing scheduler test"
+        ;;
+    "rls")
+        g++ $PROFILE_FLAGS -o compile/test_rls tests/testRLS.cpp src/RecursiveLeastSquares.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled recursive least squares test"
+        ;;
+    "linear-model")
+        g++ $PROFILE_FLAGS -o compile/test_linear_model tests/testLinearModel.cpp src/LinearModel.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled linear model scoring test"
+        ;;
+    "polynomial")
+        g++ $PROFILE_FLAGS -o compile/test_polynomial tests/testPolynomialFeatures.cpp src/PolynomialFeatures.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled polynomial features test"
+        ;;
+    "least-squares")
+        g++ $PROFILE_FLAGS -o compile/test_least_squares tests/testKrylovLeastSquares.cpp src/KrylovLeastSquares.cpp src/LinearOperator.cpp src/SparseMatrix.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled LSQR and CGLS test"
+        ;;
+    "robust")
+        g++ $PROFILE_FLAGS -o compile/test_robust tests/testRobustRegression.cpp src/RobustRegression.cpp src/LinearSystem.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled robust regression test"
+        ;;
+    "gradient")
+        g++ $PROFILE_FLAGS -o compile/test_gradient tests/testGradientTrainer.cpp src/GradientTrainer.cpp src/LinearSystem.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled gradient trainer test"
+        ;;
+    "bench-multi-rhs")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_multi_rhs benchmarks/benchMultipleRhs.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled multiple right-hand-side benchmark"
+        ;;
+    "bench-lu")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_lu benchmarks/benchLU.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled LU factorization benchmark"
+        ;;
+    "bench-strassen")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_strassen benchmarks/benchStrassen.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled Strassen-Winograd benchmark"
+        ;;
+    "bench-tsqr")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_tsqr benchmarks/benchTSQR.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled TSQR benchmark"
+        ;;
+    "bench-krylov")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_krylov benchmarks/benchKrylov.cpp src/KrylovLinSystem.cpp src/GMRESLinSystem.cpp src/BiCGSTABLinSystem.cpp src/LinearOperator.cpp src/Preconditioner.cpp src/SparseMatrix.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled Krylov solver benchmark"
+        ;;
+    "bench-banded")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_banded benchmarks/benchBanded.cpp src/TridiagonalMatrix.cpp src/TridiagonalLinSystem.cpp src/BandedMatrix.cpp src/BandedLinSystem.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled banded solver benchmark"
+        ;;
+    "bench-mapped")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_mapped benchmarks/benchMapped.cpp src/MappedMatrix.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled out-of-core matrix benchmark"
+        ;;
+    "bench-matrix-market")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_matrix_market benchmarks/benchMatrixMarket.cpp src/MatrixMarket.cpp src/SparseMatrix.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled Matrix Market benchmark"
+        ;;
+    "bench-solve-service")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_solve_service benchmarks/benchSolveService.cpp src/SolveService.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled solve service load generator"
+        ;;
+    "bench-scheduler")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_scheduler benchmarks/benchScheduler.cpp src/Parallel.cpp -I./Header-Files -pthread
+        echo "Compiled scheduler overhead benchmark"
+        ;;
+    "bench-cg")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_cg benchmarks/benchCG.cpp src/PosSymLinSystem.cpp src/LinearOperator.cpp src/SparseMatrix.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled parallel CG benchmark"
+        ;;
+    "bench-block-cg")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_block_cg benchmarks/benchBlockCG.cpp src/PosSymLinSystem.cpp src/LinearOperator.cpp src/SparseMatrix.cpp src/LinearSystem.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled block CG benchmark"
+        ;;
+    "bench-rls")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_rls benchmarks/benchRLS.cpp src/RecursiveLeastSquares.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled recursive least squares benchmark"
+        ;;
+    "bench-linear-model")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_linear_model benchmarks/benchLinearModel.cpp src/LinearModel.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled linear model scoring benchmark"
+        ;;
+    "bench-polynomial")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_polynomial benchmarks/benchPolynomial.cpp src/PolynomialFeatures.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled polynomial features benchmark"
+        ;;
+    "bench-least-squares")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_least_squares benchmarks/benchLeastSquares.cpp src/KrylovLeastSquares.cpp src/LinearOperator.cpp src/SparseMatrix.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled LSQR and CGLS benchmark"
+        ;;
+    "bench-robust")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_robust benchmarks/benchRobust.cpp src/RobustRegression.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled robust regression benchmark"
+        ;;
+    "bench-gradient")
+        g++ -O2 $PROFILE_FLAGS -o compile/bench_gradient benchmarks/benchGradient.cpp src/GradientTrainer.cpp src/TallSkinnyQR.cpp src/Matrix.cpp src/Kernels.cpp src/Profiler.cpp src/Parallel.cpp src/Vector.cpp src/AllocationTracker.cpp -I./Header-Files -pthread
+        echo "Compiled gradient trainer benchmark"
+        ;;
     *)
-        echo "Usage: ./compile.sh [main|vector|matrix|linear|illposed|pos-sym-lin-system|matrix-vector|regression]"
+        echo "Usage: ./compile.sh [main|vector|matrix|linear|illposed|pos-sym-lin-system|matrix-vector|regression|tsqr|krylov|banded|mapped|matrix-market|profiler|allocations|solve-service|scheduler|rls|linear-model|polynomial|least-squares|robust|gradient|bench-multi-rhs|bench-lu|bench-strassen|bench-tsqr|bench-krylov|bench-banded|bench-mapped|bench-matrix-market|bench-solve-service|bench-scheduler|bench-cg|bench-block-cg|bench-rls|bench-linear-model|bench-polynomial|bench-least-squares|bench-robust|bench-gradient]"
         ;;
 esac
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace allocation {
+
+struct Counters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+};
+
+// Never destroyed, Matrix and Vector statics may be freed after main()
+struct Registry {
+    Counters kinds[2];
+    std::mutex mutex;
+    std::vector<SiteStats> sites;
+};
+
+static Registry& registry() {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+// Innermost open scope of the calling thread
+static thread_local Scope* tCurrentScope = nullptr;
+
+double* allocate(Kind kind, size_t count, bool zero) {
+    double* data = zero ? new double[count]() : new double[count];
+    int64_t bytes = (int64_t)(count * sizeof(double));
+
+    Counters& c = registry().kinds[(int)kind];
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.bytes.fetch_add((uint64_t)bytes, std::memory_order_relaxed);
+    int64_t live = c.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = c.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !c.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+
+    for (Scope* s = tCurrentScope; s != nullptr; s = s->mpParent) {
+        s->add(kind, bytes, true);
+    }
+    return data;
+}
+
+void release(Kind kind, double* data, size_t count) {
+    if (data == nullptr) return;
+    delete[] data;
+    int64_t bytes = (int64_t)(count * sizeof(double));
+
+    Counters& c = registry().kinds[(int)kind];
+    c.frees.fetch_add(1, std::memory_order_relaxed);
+    c.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+
+    for (Scope* s = tCurrentScope; s != nullptr; s = s->mpParent) {
+        s->add(kind, bytes, false);
+    }
+}
+
+Stats totals(Kind kind) {
+    const Counters& c = registry().kinds[(int)kind];
+    return {c.allocations.load(std::memory_order_relaxed), c.frees.load(std::memory_order_relaxed),
+            c.bytes.load(std::memory_order_relaxed), c.liveBytes.load(std::memory_order_relaxed),
+            c.peakBytes.load(std::memory_order_relaxed)};
+}
+
+std::vector<SiteStats> sites() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<SiteStats> result = r.sites;
+    std::sort(result.begin(), result.end(),
+              [](const SiteStats& a, const SiteStats& b) { return a.stats.bytes > b.stats.bytes; });
+    return result;
+}
+
+void reset() {
+    Registry& r = registry();
+    for (Counters& c : r.kinds) {
+        c.allocations.store(0, std::memory_order_relaxed);
+        c.frees.store(0, std::memory_order_relaxed);
+        c.bytes.store(0, std::memory_order_relaxed);
+        c.peakBytes.store(c.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.sites.clear();
+}
+
+void writeText(std::ostream& out) {
+    std::ostringstream table;
+    table << std::left << std::setw(40) << "type / site" << std::right << std::setw(10) << "scopes"
+          << std::setw(14) << "allocations" << std::setw(10) << "frees" << std::setw(14) << "bytes"
+          << std::setw(14) << "peak bytes" << "\n";
+    const char* names[2] = {"Matrix", "Vector"};
+    for (int k = 0; k < 2; ++k) {
+        Stats s = totals((Kind)k);
+        table << std::left << std::setw(40) << names[k] << std::right << std::setw(10) << "-"
+              << std::setw(14) << s.allocations << std::setw(10) << s.frees << std::setw(14) << s.bytes
+              << std::setw(14) << s.peakBytes << "\n";
+    }
+    for (const SiteStats& site : sites()) {
+        const Stats& s = site.stats;
+        table << std::left << std::setw(40) << site.site << std::right << std::setw(10) << site.scopes
+              << std::setw(14) << s.allocations << std::setw(10) << s.frees << std::setw(14) << s.bytes
+              << std::setw(14) << s.peakBytes << "\n";
+    }
+    out << table.str();
+}
+
+Scope::Scope(const char* site)
+    : mSite(site), mpParent(tCurrentScope), mStats(), mLiveBytes(0), mPeakBytes(0) {
+    tCurrentScope = this;
+}
+
+Scope::~Scope() {
+    tCurrentScope = mpParent;
+
+    Stats merged = {allocations(), frees(), bytes(), mLiveBytes, mPeakBytes};
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (SiteStats& site : r.sites) {
+        if (site.site == mSite) {
+            site.scopes += 1;
+            site.stats.allocations += merged.allocations;
+            site.stats.frees += merged.frees;
+            site.stats.bytes += merged.bytes;
+            site.stats.liveBytes += merged.liveBytes;
+            site.stats.peakBytes = std::max(site.stats.peakBytes, merged.peakBytes);
+            return;
+        }
+    }
+    r.sites.push_back({mSite, 1, merged});
+}
+
+void Scope::add(Kind kind, int64_t bytes, bool allocated) {
+    Stats& s = mStats[(int)kind];
+    if (allocated) {
+        s.allocations += 1;
+        s.bytes += (uint64_t)bytes;
+    } else {
+        s.frees += 1;
+        bytes = -bytes;
+    }
+    s.liveBytes += bytes;
+    s.peakBytes = std::max(s.peakBytes, s.liveBytes);
+    mLiveBytes += bytes;
+    mPeakBytes = std::max(mPeakBytes, mLiveBytes);
+}
+
+uint64_t Scope::allocations() const {
+    return mStats[0].allocations + mStats[1].allocations;
+}
+
+uint64_t Scope::frees() const {
+    return mStats[0].frees + mStats[1].frees;
+}
+
+uint64_t Scope::bytes() const {
+    return mStats[0].bytes + mStats[1].bytes;
+}
+
+int64_t Scope::peakBytes() const {
+    return mPeakBytes;
+}
+
+const Stats& Scope::stats(Kind kind) const {
+    return mStats[(int)kind];
+}
+
+}
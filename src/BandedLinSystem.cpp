@@ -0,0 +1,202 @@
+#include "BandedLinSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+static const double PIVOT_THRESHOLD = 1e-10;
+
+BandedLinSystem::BandedLinSystem(BandedMatrix* A, Vector* b)
+    : LinearSystem(A == nullptr ? 0 : A->size(), b), mpBanded(A) {
+    if (A == nullptr) {
+        throw invalid_argument("Matrix and Vector cannot be null");
+    }
+}
+
+BandedLinSystem::BandedLinSystem(BandedMatrix* A, Matrix* B)
+    : LinearSystem(A == nullptr ? 0 : A->size(), B), mpBanded(A) {
+    if (A == nullptr) {
+        throw invalid_argument("Matrix and right-hand sides cannot be null");
+    }
+}
+
+BandedLinSystem::~BandedLinSystem() {}
+
+void BandedLinSystem::LUSolve(Matrix& X) const {
+    int n = mSize;
+    int s = X.numCols();
+    int kl = mpBanded->lowerBandwidth();
+    int ku = mpBanded->upperBandwidth();
+    int kuFill = kl + ku;                 // superdiagonals of U after pivoting
+    int width = kl + kuFill + 1;
+    double* x = X.data();
+
+    // Working band: row i holds columns i-kl .. i+kl+ku
+    vector<double> lu((size_t)n * width, 0.0);
+    const double* a = mpBanded->data();
+    for (int i = 0; i < n; ++i) {
+        copy(a + (size_t)i * (kl + ku + 1), a + (size_t)(i + 1) * (kl + ku + 1),
+             lu.begin() + (size_t)i * width);
+    }
+    auto at = [&](int i, int j) -> double& { return lu[(size_t)i * width + (j - i + kl)]; };
+
+    for (int k = 0; k < n; ++k) {
+        int rowEnd = min(n - 1, k + kl);
+        int colEnd = min(n - 1, k + kuFill);
+
+        int p = k;
+        for (int i = k + 1; i <= rowEnd; ++i) {
+            if (fabs(at(i, k)) > fabs(at(p, k))) p = i;
+        }
+        if (fabs(at(p, k)) < PIVOT_THRESHOLD) {
+            throw runtime_error("Matrix is singular or nearly singular");
+        }
+        if (p != k) {
+            for (int j = k; j <= colEnd; ++j) {
+                swap(at(k, j), at(p, j));
+            }
+            swap_ranges(x + (size_t)k * s, x + (size_t)(k + 1) * s, x + (size_t)p * s);
+        }
+
+        // Eliminate below the pivot, applying L to the right-hand sides on the fly
+        double pivot = at(k, k);
+        for (int i = k + 1; i <= rowEnd; ++i) {
+            double l = at(i, k) / pivot;
+            if (l == 0.0) continue;
+            for (int j = k + 1; j <= colEnd; ++j) {
+                at(i, j) -= l * at(k, j);
+            }
+            double* xi = x + (size_t)i * s;
+            const double* xk = x + (size_t)k * s;
+            for (int c = 0; c < s; ++c) {
+                xi[c] -= l * xk[c];
+            }
+        }
+    }
+
+    // Back substitution with the widened U
+    for (int i = n - 1; i >= 0; --i) {
+        double* xi = x + (size_t)i * s;
+        int colEnd = min(n - 1, i + kuFill);
+        for (int j = i + 1; j <= colEnd; ++j) {
+            double u = at(i, j);
+            const double* xj = x + (size_t)j * s;
+            for (int c = 0; c < s; ++c) {
+                xi[c] -= u * xj[c];
+            }
+        }
+        double inv = 1.0 / at(i, i);
+        for (int c = 0; c < s; ++c) {
+            xi[c] *= inv;
+        }
+    }
+}
+
+void BandedLinSystem::CholeskySolve(Matrix& X) const {
+    int n = mSize;
+    int s = X.numCols();
+    int k = mpBanded->lowerBandwidth();
+    if (mpBanded->upperBandwidth() != k) {
+        throw invalid_argument("Matrix is not symmetric");
+    }
+    for (int i = 1; i <= n; ++i) {
+        for (int j = max(1, i - k); j < i; ++j) {
+            if (fabs((*mpBanded)(i, j) - (*mpBanded)(j, i)) > 1e-10) {
+                throw invalid_argument("Matrix is not symmetric");
+            }
+        }
+    }
+
+    // L keeps the lower band: row i holds columns i-k .. i
+    int width = k + 1;
+    vector<double> L((size_t)n * width, 0.0);
+    auto at = [&](int i, int j) -> double& { return L[(size_t)i * width + (j - i + k)]; };
+    const BandedMatrix& A = *mpBanded;
+
+    for (int i = 0; i < n; ++i) {
+        for (int j = max(0, i - k); j <= i; ++j) {
+            double sum = A(i + 1, j + 1);
+            for (int m = max(0, i - k); m < j; ++m) {
+                sum -= at(i, m) * at(j, m);
+            }
+            if (j == i) {
+                if (sum <= 0.0) {
+                    throw runtime_error("Matrix is not positive definite");
+                }
+                at(i, i) = sqrt(sum);
+            } else {
+                at(i, j) = sum / at(j, j);
+            }
+        }
+    }
+
+    double* x = X.data();
+    // LY = B
+    for (int i = 0; i < n; ++i) {
+        double* xi = x + (size_t)i * s;
+        for (int j = max(0, i - k); j < i; ++j) {
+            double l = at(i, j);
+            const double* xj = x + (size_t)j * s;
+            for (int c = 0; c < s; ++c) {
+                xi[c] -= l * xj[c];
+            }
+        }
+        double inv = 1.0 / at(i, i);
+        for (int c = 0; c < s; ++c) {
+            xi[c] *= inv;
+        }
+    }
+    // LᵀX = Y
+    for (int i = n - 1; i >= 0; --i) {
+        double* xi = x + (size_t)i * s;
+        double inv = 1.0 / at(i, i);
+        for (int c = 0; c < s; ++c) {
+            xi[c] *= inv;
+        }
+        for (int j = max(0, i - k); j < i; ++j) {
+            double l = at(i, j);
+            double* xj = x + (size_t)j * s;
+            for (int c = 0; c < s; ++c) {
+                xj[c] -= l * xi[c];
+            }
+        }
+    }
+}
+
+Vector BandedLinSystem::Solve() {
+    if (mpb == nullptr) {
+        throw logic_error("System has no right-hand side vector, use SolveMultiple()");
+    }
+
+    Matrix X = RhsMatrix();
+    LUSolve(X);
+
+    Vector solution(mSize);
+    for (int i = 1; i <= mSize; ++i) {
+        solution(i) = X(i, 1);
+    }
+    return solution;
+}
+
+Matrix BandedLinSystem::SolveMultiple() {
+    Matrix X = RhsMatrix();
+    LUSolve(X);
+    return X;
+}
+
+Vector BandedLinSystem::SolveCholesky() {
+    if (mpb == nullptr) {
+        throw logic_error("System has no right-hand side vector, use SolveMultiple()");
+    }
+
+    Matrix X = RhsMatrix();
+    CholeskySolve(X);
+
+    Vector solution(mSize);
+    for (int i = 1; i <= mSize; ++i) {
+        solution(i) = X(i, 1);
+    }
+    return solution;
+}
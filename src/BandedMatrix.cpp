@@ -0,0 +1,89 @@
+#include "BandedMatrix.h"
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+BandedMatrix::BandedMatrix(int size, int lowerBandwidth, int upperBandwidth)
+    : mSize(size), mLowerBandwidth(lowerBandwidth), mUpperBandwidth(upperBandwidth) {
+    if (size <= 0) {
+        throw std::invalid_argument("Matrix size must be positive");
+    }
+    if (lowerBandwidth < 0 || upperBandwidth < 0 || lowerBandwidth >= size || upperBandwidth >= size) {
+        throw std::invalid_argument("Bandwidths must lie in [0, size)");
+    }
+    mData.assign((size_t)size * (lowerBandwidth + upperBandwidth + 1), 0.0);
+}
+
+int BandedMatrix::size() const {
+    return mSize;
+}
+
+int BandedMatrix::lowerBandwidth() const {
+    return mLowerBandwidth;
+}
+
+int BandedMatrix::upperBandwidth() const {
+    return mUpperBandwidth;
+}
+
+bool BandedMatrix::inBand(int i, int j) const {
+    return j - i <= mUpperBandwidth && i - j <= mLowerBandwidth;
+}
+
+double& BandedMatrix::operator()(int i, int j) {
+    assert(i >= 1 && i <= mSize);
+    assert(j >= 1 && j <= mSize);
+    assert(inBand(i, j));
+    int width = mLowerBandwidth + mUpperBandwidth + 1;
+    return mData[(size_t)(i - 1) * width + (j - i + mLowerBandwidth)];
+}
+
+double BandedMatrix::operator()(int i, int j) const {
+    assert(i >= 1 && i <= mSize);
+    assert(j >= 1 && j <= mSize);
+    if (!inBand(i, j)) {
+        return 0.0;
+    }
+    int width = mLowerBandwidth + mUpperBandwidth + 1;
+    return mData[(size_t)(i - 1) * width + (j - i + mLowerBandwidth)];
+}
+
+void BandedMatrix::multiply(const double* x, double* y) const {
+    int kl = mLowerBandwidth;
+    int width = kl + mUpperBandwidth + 1;
+    for (int i = 0; i < mSize; ++i) {
+        const double* row = mData.data() + (size_t)i * width;
+        int jBegin = std::max(0, i - kl);
+        int jEnd = std::min(mSize - 1, i + mUpperBandwidth);
+        double sum = 0.0;
+        for (int j = jBegin; j <= jEnd; ++j) {
+            sum += row[j - i + kl] * x[j];
+        }
+        y[i] = sum;
+    }
+}
+
+Vector BandedMatrix::operator*(Vector& v) const {
+    if (v.size() != mSize) {
+        throw std::invalid_argument("Matrix and vector dimensions do not match for multiplication.");
+    }
+    Vector result(mSize);
+    multiply(v.data(), result.data());
+    return result;
+}
+
+Matrix BandedMatrix::toDense() const {
+    Matrix dense(mSize, mSize);
+    for (int i = 1; i <= mSize; ++i) {
+        int jBegin = std::max(1, i - mLowerBandwidth);
+        int jEnd = std::min(mSize, i + mUpperBandwidth);
+        for (int j = jBegin; j <= jEnd; ++j) {
+            dense(i, j) = (*this)(i, j);
+        }
+    }
+    return dense;
+}
+
+const double* BandedMatrix::data() const {
+    return mData.data();
+}
@@ -0,0 +1,76 @@
+#include "BiCGSTABLinSystem.h"
+#include "Kernels.h"
+#include "Profiler.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+BiCGSTABLinSystem::BiCGSTABLinSystem(Matrix* A, Vector* b) : KrylovLinSystem(A, b) {}
+
+BiCGSTABLinSystem::BiCGSTABLinSystem(SparseMatrix* A, Vector* b) : KrylovLinSystem(A, b) {}
+
+BiCGSTABLinSystem::BiCGSTABLinSystem(LinearOperator* A, Vector* b) : KrylovLinSystem(A, b) {}
+
+BiCGSTABLinSystem::~BiCGSTABLinSystem() {}
+
+Vector BiCGSTABLinSystem::Solve() {
+    PROFILE_SCOPE("BiCGSTAB solve");
+    int n = mSize;
+
+    vector<double> x(n, 0.0);
+    vector<double> r = RhsArray();
+    vector<double> rHat(r);
+    vector<double> p(n, 0.0), v(n, 0.0), s(n), t(n), pHat(n), sHat(n);
+
+    double bnorm = kernels::nrm2(n, r.data());
+    double target = mTolerance * (bnorm > 0.0 ? bnorm : 1.0);
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    mIterations = 0;
+    mResidualHistory.assign(1, bnorm);
+
+    while (mIterations < mMaxIterations && mResidualHistory.back() > target) {
+        double rhoNew = kernels::dot(n, rHat.data(), r.data());
+        if (rhoNew == 0.0 || omega == 0.0) {
+            cout << "Warning: BiCGSTAB breakdown after " << mIterations << " iterations" << endl;
+            break;
+        }
+
+        // p = r + β(p - ωv)
+        double beta = (rhoNew / rho) * (alpha / omega);
+        for (int i = 0; i < n; ++i) {
+            p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        }
+        rho = rhoNew;
+
+        ApplyPreconditioner(p.data(), pHat.data());
+        ApplyOperator(pHat.data(), v.data());
+        alpha = rho / kernels::dot(n, rHat.data(), v.data());
+
+        for (int i = 0; i < n; ++i) {
+            s[i] = r[i] - alpha * v[i];
+        }
+        ++mIterations;
+
+        double snorm = kernels::nrm2(n, s.data());
+        if (snorm <= target) {
+            kernels::axpy(n, alpha, pHat.data(), x.data());
+            mResidualHistory.push_back(snorm);
+            break;
+        }
+
+        ApplyPreconditioner(s.data(), sHat.data());
+        ApplyOperator(sHat.data(), t.data());
+        double tt = kernels::dot(n, t.data(), t.data());
+        omega = tt > 0.0 ? kernels::dot(n, t.data(), s.data()) / tt : 0.0;
+
+        for (int i = 0; i < n; ++i) {
+            x[i] += alpha * pHat[i] + omega * sHat[i];
+            r[i] = s[i] - omega * t[i];
+        }
+        mResidualHistory.push_back(kernels::nrm2(n, r.data()));
+    }
+
+    return Finish(x, mResidualHistory.back() <= target, "BiCGSTAB");
+}
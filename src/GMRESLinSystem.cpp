@@ -0,0 +1,122 @@
+#include "GMRESLinSystem.h"
+#include "Kernels.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+GMRESLinSystem::GMRESLinSystem(Matrix* A, Vector* b, int restart)
+    : KrylovLinSystem(A, b), mRestart(max(1, min(restart, mSize))) {}
+
+GMRESLinSystem::GMRESLinSystem(SparseMatrix* A, Vector* b, int restart)
+    : KrylovLinSystem(A, b), mRestart(max(1, min(restart, mSize))) {}
+
+GMRESLinSystem::GMRESLinSystem(LinearOperator* A, Vector* b, int restart)
+    : KrylovLinSystem(A, b), mRestart(max(1, min(restart, mSize))) {}
+
+GMRESLinSystem::~GMRESLinSystem() {}
+
+Vector GMRESLinSystem::Solve() {
+    PROFILE_SCOPE("GMRES solve");
+    int n = mSize;
+    int m = mRestart;
+
+    vector<double> b = RhsArray();
+    vector<double> x(n, 0.0);
+    vector<double> V((size_t)(m + 1) * n);       // Krylov basis, one vector per row
+    vector<double> H((size_t)(m + 1) * m, 0.0);  // Hessenberg matrix
+    vector<double> cs(m), sn(m), g(m + 1), y(m);
+    vector<double> w(n), z(n);
+
+    double bnorm = kernels::nrm2(n, b.data());
+    double target = mTolerance * (bnorm > 0.0 ? bnorm : 1.0);
+    mIterations = 0;
+    mResidualHistory.clear();
+
+    while (mIterations < mMaxIterations) {
+        // r = b - Ax starts the next cycle
+        double* v0 = V.data();
+        ApplyOperator(x.data(), v0);
+        for (int i = 0; i < n; ++i) {
+            v0[i] = b[i] - v0[i];
+        }
+        double beta = kernels::nrm2(n, v0);
+        if (mResidualHistory.empty()) mResidualHistory.push_back(beta);
+        if (beta <= target) break;
+
+        for (int i = 0; i < n; ++i) {
+            v0[i] /= beta;
+        }
+        fill(g.begin(), g.end(), 0.0);
+        g[0] = beta;
+
+        int k = 0;
+        bool converged = false;
+        for (int j = 0; j < m && mIterations < mMaxIterations; ++j) {
+            // w = A M⁻¹ v_j, orthogonalized against the basis
+            ApplyPreconditioner(V.data() + (size_t)j * n, z.data());
+            ApplyOperator(z.data(), w.data());
+            for (int i = 0; i <= j; ++i) {
+                const double* vi = V.data() + (size_t)i * n;
+                double h = kernels::dot(n, w.data(), vi);
+                H[(size_t)i * m + j] = h;
+                kernels::axpy(n, -h, vi, w.data());
+            }
+            double hNext = kernels::nrm2(n, w.data());
+            H[(size_t)(j + 1) * m + j] = hNext;
+            if (hNext > 0.0) {
+                double* vNext = V.data() + (size_t)(j + 1) * n;
+                for (int i = 0; i < n; ++i) {
+                    vNext[i] = w[i] / hNext;
+                }
+            }
+
+            // Previous rotations, then a new one that zeroes H(j+1, j)
+            for (int i = 0; i < j; ++i) {
+                double a = H[(size_t)i * m + j];
+                double c = H[(size_t)(i + 1) * m + j];
+                H[(size_t)i * m + j] = cs[i] * a + sn[i] * c;
+                H[(size_t)(i + 1) * m + j] = -sn[i] * a + cs[i] * c;
+            }
+            double a = H[(size_t)j * m + j];
+            double radius = hypot(a, hNext);
+            cs[j] = radius > 0.0 ? a / radius : 1.0;
+            sn[j] = radius > 0.0 ? hNext / radius : 0.0;
+            H[(size_t)j * m + j] = radius;
+            H[(size_t)(j + 1) * m + j] = 0.0;
+            g[j + 1] = -sn[j] * g[j];
+            g[j] = cs[j] * g[j];
+
+            ++mIterations;
+            k = j + 1;
+            double residual = fabs(g[j + 1]);
+            mResidualHistory.push_back(residual);
+            if (residual <= target || hNext == 0.0) {
+                converged = true;
+                break;
+            }
+        }
+
+        // y = H⁻¹g on the leading k x k triangle, x += M⁻¹ V y
+        for (int i = k - 1; i >= 0; --i) {
+            double sum = g[i];
+            for (int c = i + 1; c < k; ++c) {
+                sum -= H[(size_t)i * m + c] * y[c];
+            }
+            y[i] = sum / H[(size_t)i * m + i];
+        }
+        fill(w.begin(), w.end(), 0.0);
+        for (int i = 0; i < k; ++i) {
+            kernels::axpy(n, y[i], V.data() + (size_t)i * n, w.data());
+        }
+        ApplyPreconditioner(w.data(), z.data());
+        kernels::axpy(n, 1.0, z.data(), x.data());
+
+        if (converged) break;
+    }
+
+    return Finish(x, mResidualHistory.back() <= target, "GMRES");
+}
@@ -0,0 +1,308 @@
+#include "GradientTrainer.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+// Default batch: as many rows as fit in 128 KB, about the L2 share of one core
+static const int BATCH_CACHE_DOUBLES = 16384;
+
+// A batch longer than this is split into row chunks whose gradients are
+// computed in parallel and added in chunk order
+static const int GRADIENT_ROW_CHUNK = 1024;
+
+// Rows per task of the objective evaluation
+static const int OBJECTIVE_ROW_GRAIN = 8192;
+
+static const double ADAM_BETA2 = 0.999;
+static const double ADAM_EPSILON = 1e-8;
+
+GradientTrainer::GradientTrainer(const Matrix* A, const Vector* b)
+    : mpA(A), mpb(b), mMethod(GradientMethod::Adam), mUpdate(GradientUpdate::Reduction), mLearningRate(0.01),
+      mDecay(0.0), mMomentum(0.9), mL2(0.0), mBatchSize(0), mEpochs(20), mSeed(42) {
+    if (A == nullptr || b == nullptr) {
+        throw invalid_argument("Matrix and Vector cannot be null");
+    }
+    mNumRows = A->numRows();
+    mNumCols = A->numCols();
+    if (b->size() != mNumRows) {
+        throw invalid_argument("Right-hand side length does not match the matrix");
+    }
+    mpTheta = new Vector(mNumCols);
+    mShared.reset(new atomic<double>[mNumCols]);
+    mWork.assign((size_t)ThreadPool::instance().numThreads() * 4 * mNumCols, 0.0);
+}
+
+GradientTrainer::~GradientTrainer() {
+    delete mpTheta;
+}
+
+void GradientTrainer::SetMethod(GradientMethod method) {
+    mMethod = method;
+}
+
+void GradientTrainer::SetUpdate(GradientUpdate update) {
+    mUpdate = update;
+}
+
+void GradientTrainer::SetLearningRate(double learningRate) {
+    if (learningRate <= 0.0) {
+        throw invalid_argument("Learning rate must be positive");
+    }
+    mLearningRate = learningRate;
+}
+
+void GradientTrainer::SetDecay(double decay) {
+    mDecay = max(decay, 0.0);
+}
+
+void GradientTrainer::SetMomentum(double momentum) {
+    if (momentum < 0.0 || momentum >= 1.0) {
+        throw invalid_argument("Momentum must be in [0, 1)");
+    }
+    mMomentum = momentum;
+}
+
+void GradientTrainer::SetL2(double lambda) {
+    if (lambda < 0.0) {
+        throw invalid_argument("L2 penalty must not be negative");
+    }
+    mL2 = lambda;
+}
+
+void GradientTrainer::SetBatchSize(int batchSize) {
+    if (batchSize < 1) {
+        throw invalid_argument("Batch size must be at least 1");
+    }
+    mBatchSize = batchSize;
+}
+
+void GradientTrainer::SetEpochs(int epochs) {
+    mEpochs = max(epochs, 0);
+}
+
+void GradientTrainer::SetSeed(unsigned seed) {
+    mSeed = seed;
+}
+
+int GradientTrainer::BatchSize() const {
+    int batch = mBatchSize > 0 ? mBatchSize : max(1, BATCH_CACHE_DOUBLES / max(mNumCols, 1));
+    return min(batch, mNumRows);
+}
+
+const Vector& GradientTrainer::Coefficients() const {
+    return *mpTheta;
+}
+
+const std::vector<TrainingEpoch>& GradientTrainer::History() const {
+    return mHistory;
+}
+
+double GradientTrainer::Objective(const Vector& theta) const {
+    int p = mNumCols;
+    const double* A = mpA->data();
+    const double* b = mpb->data();
+    const double* x = theta.data();
+    double squares = parallelReduce(0, mNumRows, OBJECTIVE_ROW_GRAIN, 0.0, [=](int first, int last) {
+        double sum = 0.0;
+        for (int i = first; i < last; ++i) {
+            const double* a = A + (size_t)i * p;
+            double r = -b[i];
+            for (int j = 0; j < p; ++j) {
+                r += a[j] * x[j];
+            }
+            sum += r * r;
+        }
+        return sum;
+    }, [](double u, double v) { return u + v; });
+    double norm = 0.0;
+    for (int j = 0; j < p; ++j) {
+        norm += x[j] * x[j];
+    }
+    return 0.5 * squares / mNumRows + 0.5 * mL2 * norm;
+}
+
+double* GradientTrainer::ThreadWork(int thread) {
+    return mWork.data() + (size_t)thread * 4 * mNumCols;
+}
+
+const Vector& GradientTrainer::Train() {
+    Vector zero(mNumCols);
+    return Train(zero);
+}
+
+const Vector& GradientTrainer::Train(const Vector& start) {
+    PROFILE_SCOPE("GradientTrainer::Train");
+    if (start.size() != mNumCols) {
+        throw invalid_argument("Starting coefficients do not match the number of columns");
+    }
+    int p = mNumCols;
+    int threads = ThreadPool::instance().numThreads();
+    mWork.assign((size_t)threads * 4 * p, 0.0);   // also resets the moments
+    int batch = BatchSize();
+    int numBatches = (mNumRows + batch - 1) / batch;
+    int numChunks = (batch + GRADIENT_ROW_CHUNK - 1) / GRADIENT_ROW_CHUNK;
+    mPartials.assign(numChunks > 1 ? (size_t)numChunks * p : 0, 0.0);
+    mOrder.resize(numBatches);
+    iota(mOrder.begin(), mOrder.end(), 0);
+
+    copy(start.begin(), start.end(), mpTheta->begin());
+    for (int j = 0; j < p; ++j) {
+        mShared[j].store(start.data()[j], memory_order_relaxed);
+    }
+    mHistory.clear();
+    mHistory.push_back({0.0, Objective(*mpTheta)});
+
+    mt19937 random(mSeed);
+    long step = 0;
+    vector<long> steps(threads, 0);
+    double seconds = 0.0;
+    for (int epoch = 0; epoch < mEpochs; ++epoch) {
+        shuffle(mOrder.begin(), mOrder.end(), random);
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        if (mUpdate == GradientUpdate::Hogwild) {
+            RunEpochHogwild(epoch, steps);
+            for (int j = 0; j < p; ++j) {
+                (*mpTheta)(j + 1) = mShared[j].load(memory_order_relaxed);
+            }
+        } else {
+            RunEpochReduction(epoch, step);
+        }
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        mHistory.push_back({seconds, Objective(*mpTheta)});
+    }
+    return *mpTheta;
+}
+
+void GradientTrainer::RunEpochReduction(int epoch, long& step) {
+    PROFILE_SCOPE_WORK("GradientTrainer::epoch", 4.0 * mNumRows * mNumCols, 8.0 * mNumRows * (mNumCols + 1));
+    int p = mNumCols;
+    int batch = BatchSize();
+    double rate = mLearningRate / (1.0 + mDecay * epoch);
+    double* theta = mpTheta->data();
+    double* g = ThreadWork(0);
+    double* state = g + 2 * p;
+    double* partials = mPartials.data();
+
+    for (int k = 0; k < (int)mOrder.size(); ++k) {
+        int first = mOrder[k] * batch;
+        int last = min(first + batch, mNumRows);
+        int numChunks = (last - first + GRADIENT_ROW_CHUNK - 1) / GRADIENT_ROW_CHUNK;
+        if (numChunks == 1) {
+            BatchGradient(first, last, theta, g);
+        } else {
+            parallelFor(0, numChunks, 1, [this, first, last, theta, partials, p](int c0, int c1) {
+                for (int c = c0; c < c1; ++c) {
+                    int chunkFirst = first + c * GRADIENT_ROW_CHUNK;
+                    BatchGradient(chunkFirst, min(chunkFirst + GRADIENT_ROW_CHUNK, last), theta, partials + (size_t)c * p);
+                }
+            });
+            copy(partials, partials + p, g);
+            for (int c = 1; c < numChunks; ++c) {
+                for (int j = 0; j < p; ++j) {
+                    g[j] += partials[(size_t)c * p + j];
+                }
+            }
+        }
+        double scale = 1.0 / (last - first);
+        for (int j = 0; j < p; ++j) {
+            g[j] *= scale;
+        }
+        ApplyStep(g, theta, state, ++step, rate, theta, nullptr);
+    }
+}
+
+void GradientTrainer::RunEpochHogwild(int epoch, std::vector<long>& steps) {
+    PROFILE_SCOPE_WORK("GradientTrainer::epoch", 4.0 * mNumRows * mNumCols, 8.0 * mNumRows * (mNumCols + 1));
+    int p = mNumCols;
+    int batch = BatchSize();
+    int numBatches = (int)mOrder.size();
+    int workers = min((int)steps.size(), numBatches);
+    double rate = mLearningRate / (1.0 + mDecay * epoch);
+
+    // Worker w takes batches w, w + workers, ... of the shuffled order. It
+    // reads a snapshot of θ, computes its gradient and subtracts its step
+    // entry by entry; concurrent steps may overwrite each other's entries.
+    parallelFor(0, workers, 1, [&](int w0, int w1) {
+        for (int w = w0; w < w1; ++w) {
+            double* g = ThreadWork(w);
+            double* snapshot = g + p;
+            double* state = g + 2 * p;
+            for (int k = w; k < numBatches; k += workers) {
+                int first = mOrder[k] * batch;
+                int last = min(first + batch, mNumRows);
+                for (int j = 0; j < p; ++j) {
+                    snapshot[j] = mShared[j].load(memory_order_relaxed);
+                }
+                BatchGradient(first, last, snapshot, g);
+                double scale = 1.0 / (last - first);
+                for (int j = 0; j < p; ++j) {
+                    g[j] *= scale;
+                }
+                ApplyStep(g, snapshot, state, ++steps[w], rate, nullptr, mShared.get());
+            }
+        }
+    });
+}
+
+void GradientTrainer::BatchGradient(int first, int last, const double* theta, double* g) const {
+    int p = mNumCols;
+    const double* b = mpb->data();
+    fill(g, g + p, 0.0);
+    for (int i = first; i < last; ++i) {
+        const double* a = mpA->data() + (size_t)i * p;
+        // Four partial sums hide the add latency of the residual
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+        int j = 0;
+        for (; j + 4 <= p; j += 4) {
+            s0 += a[j] * theta[j];
+            s1 += a[j + 1] * theta[j + 1];
+            s2 += a[j + 2] * theta[j + 2];
+            s3 += a[j + 3] * theta[j + 3];
+        }
+        for (; j < p; ++j) {
+            s0 += a[j] * theta[j];
+        }
+        double r = (s0 + s1) + (s2 + s3) - b[i];
+        for (j = 0; j < p; ++j) {
+            g[j] += r * a[j];
+        }
+    }
+}
+
+void GradientTrainer::ApplyStep(double* g, const double* theta, double* state, long step, double rate,
+                                double* target, std::atomic<double>* shared) const {
+    int p = mNumCols;
+    double* first = state;
+    double* second = state + p;
+    double correction1 = 1.0, correction2 = 1.0;
+    if (mMethod == GradientMethod::Adam) {
+        correction1 = 1.0 - pow(mMomentum, (double)step);
+        correction2 = 1.0 - pow(ADAM_BETA2, (double)step);
+    }
+    for (int j = 0; j < p; ++j) {
+        double gradient = g[j] + mL2 * theta[j];
+        double delta;
+        if (mMethod == GradientMethod::SGD) {
+            delta = rate * gradient;
+        } else if (mMethod == GradientMethod::Momentum) {
+            first[j] = mMomentum * first[j] + gradient;
+            delta = rate * first[j];
+        } else {
+            first[j] = mMomentum * first[j] + (1.0 - mMomentum) * gradient;
+            second[j] = ADAM_BETA2 * second[j] + (1.0 - ADAM_BETA2) * gradient * gradient;
+            delta = rate * (first[j] / correction1) / (sqrt(second[j] / correction2) + ADAM_EPSILON);
+        }
+        if (shared != nullptr) {
+            shared[j].store(shared[j].load(memory_order_relaxed) - delta, memory_order_relaxed);
+        } else {
+            target[j] -= delta;
+        }
+    }
+}
@@ -0,0 +1,693 @@
+#include "Kernels.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace kernels {
+
+// GEMM blocking: rows of C per parallel task, depth of the A/B panels and
+// width of the B panel. A KC x NC panel of B stays in L2 while four rows of C
+// are updated from it.
+const int GEMM_ROW_TILE = 64;
+const int GEMM_KC = 256;
+const int GEMM_NC = 512;
+
+// Triangular solves process this many rows per diagonal block and hand the
+// rest of the work to gemm
+const int TRSM_BLOCK = 64;
+
+// Column panels of the right-hand side solved independently in parallel
+const int TRSM_COL_GRAIN = 64;
+
+// Recursive LU stops splitting at this panel width
+const int LU_BASE_COLS = 16;
+
+// Level 1 and 2 operations hand out about this many multiply-adds per task
+const int VECTOR_GRAIN = 16384;
+
+// Dot products sum blocks of this many terms serially and add the block sums
+// pairwise. The shape depends on n only, so results match for any thread count.
+const int DOT_BLOCK = 1024;
+
+// Shorter dot products run on the calling thread (same blocks, same result)
+const int DOT_PARALLEL_MIN = 4 * VECTOR_GRAIN;
+
+// C[i0:i1, j0:j1] += alpha * A[i0:i1, p0:p1] * B[p0:p1, j0:j1], four rows of C at a time
+static void gemmBlock(int i0, int i1, int j0, int j1, int p0, int p1, double alpha,
+                      const double* A, int lda, const double* B, int ldb, double* C, int ldc) {
+    int i = i0;
+    for (; i + 3 < i1; i += 4) {
+        double* __restrict c0 = C + (size_t)i * ldc;
+        double* __restrict c1 = c0 + ldc;
+        double* __restrict c2 = c1 + ldc;
+        double* __restrict c3 = c2 + ldc;
+        for (int p = p0; p < p1; ++p) {
+            double a0 = alpha * A[(size_t)i * lda + p];
+            double a1 = alpha * A[(size_t)(i + 1) * lda + p];
+            double a2 = alpha * A[(size_t)(i + 2) * lda + p];
+            double a3 = alpha * A[(size_t)(i + 3) * lda + p];
+            const double* __restrict b = B + (size_t)p * ldb;
+            for (int j = j0; j < j1; ++j) {
+                double bj = b[j];
+                c0[j] += a0 * bj;
+                c1[j] += a1 * bj;
+                c2[j] += a2 * bj;
+                c3[j] += a3 * bj;
+            }
+        }
+    }
+    for (; i < i1; ++i) {
+        double* __restrict c = C + (size_t)i * ldc;
+        for (int p = p0; p < p1; ++p) {
+            double a = alpha * A[(size_t)i * lda + p];
+            const double* __restrict b = B + (size_t)p * ldb;
+            for (int j = j0; j < j1; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+void gemm(int m, int n, int k, double alpha, const double* A, int lda,
+          const double* B, int ldb, double beta, double* C, int ldc) {
+    PROFILE_SCOPE_WORK("gemm", 2.0 * m * n * k, 8.0 * ((double)m * k + (double)k * n + 2.0 * m * n));
+    if (m <= 0 || n <= 0) return;
+
+    if (beta != 1.0) {
+        for (int i = 0; i < m; ++i) {
+            double* c = C + (size_t)i * ldc;
+            for (int j = 0; j < n; ++j) {
+                c[j] = (beta == 0.0) ? 0.0 : beta * c[j];
+            }
+        }
+    }
+    if (k <= 0 || alpha == 0.0) return;
+
+    parallelFor(0, m, GEMM_ROW_TILE, [&](int i0, int i1) {
+        for (int p0 = 0; p0 < k; p0 += GEMM_KC) {
+            int p1 = std::min(p0 + GEMM_KC, k);
+            for (int j0 = 0; j0 < n; j0 += GEMM_NC) {
+                int j1 = std::min(j0 + GEMM_NC, n);
+                gemmBlock(i0, i1, j0, j1, p0, p1, alpha, A, lda, B, ldb, C, ldc);
+            }
+        }
+    });
+}
+
+// Z = X + sign*Y on m x n blocks
+static void addBlocks(int m, int n, const double* X, int ldx, double sign, const double* Y, int ldy,
+                      double* Z, int ldz) {
+    for (int i = 0; i < m; ++i) {
+        const double* x = X + (size_t)i * ldx;
+        const double* y = Y + (size_t)i * ldy;
+        double* z = Z + (size_t)i * ldz;
+        for (int j = 0; j < n; ++j) {
+            z[j] = x[j] + sign * y[j];
+        }
+    }
+}
+
+static bool strassenBaseCase(int m, int n, int k, int crossover) {
+    return m <= crossover || n <= crossover || k <= crossover || crossover < 1;
+}
+
+size_t strassenWorkspace(int m, int n, int k, int crossover) {
+    if (strassenBaseCase(m, n, k, crossover)) return 0;
+    size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    return m2 * std::max(k2, n2) + k2 * n2 + strassenWorkspace(m2, n2, k2, crossover);
+}
+
+// Products involving the odd last row/column that the even-sized recursion leaves out
+static void strassenPeel(int m, int n, int k, const double* A, int lda, const double* B, int ldb,
+                         double* C, int ldc) {
+    int me = m & ~1, ne = n & ~1, ke = k & ~1;
+    if (k != ke) {
+        gemm(me, ne, 1, 1.0, A + ke, lda, B + (size_t)ke * ldb, ldb, 1.0, C, ldc);
+    }
+    if (n != ne) {
+        gemm(me, 1, k, 1.0, A, lda, B + ne, ldb, 0.0, C + ne, ldc);
+    }
+    if (m != me) {
+        gemm(1, n, k, 1.0, A + (size_t)me * lda, lda, B, ldb, 0.0, C + (size_t)me * ldc, ldc);
+    }
+}
+
+// Sequential recursion with two temporaries per level, X (m/2 x max(k/2, n/2))
+// and Y (k/2 x n/2), following the schedule of Boyer, Dumas, Pernet and Zhou.
+static void strassenSequential(int m, int n, int k, const double* A, int lda, const double* B,
+                               int ldb, double* C, int ldc, int crossover, double* work) {
+    if (strassenBaseCase(m, n, k, crossover)) {
+        gemm(m, n, k, 1.0, A, lda, B, ldb, 0.0, C, ldc);
+        return;
+    }
+
+    int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    double* X = work;
+    double* Y = X + (size_t)m2 * std::max(k2, n2);
+    double* next = Y + (size_t)k2 * n2;
+
+    const double* A11 = A;
+    const double* A12 = A + k2;
+    const double* A21 = A + (size_t)m2 * lda;
+    const double* A22 = A21 + k2;
+    const double* B11 = B;
+    const double* B12 = B + n2;
+    const double* B21 = B + (size_t)k2 * ldb;
+    const double* B22 = B21 + n2;
+    double* C11 = C;
+    double* C12 = C + n2;
+    double* C21 = C + (size_t)m2 * ldc;
+    double* C22 = C21 + n2;
+
+    addBlocks(m2, k2, A11, lda, -1.0, A21, lda, X, k2);            // S3 = A11 - A21
+    addBlocks(k2, n2, B22, ldb, -1.0, B12, ldb, Y, n2);            // T3 = B22 - B12
+    strassenSequential(m2, n2, k2, X, k2, Y, n2, C21, ldc, crossover, next);   // P7
+    addBlocks(m2, k2, A21, lda, 1.0, A22, lda, X, k2);             // S1 = A21 + A22
+    addBlocks(k2, n2, B12, ldb, -1.0, B11, ldb, Y, n2);            // T1 = B12 - B11
+    strassenSequential(m2, n2, k2, X, k2, Y, n2, C22, ldc, crossover, next);   // P5
+    addBlocks(m2, k2, X, k2, -1.0, A11, lda, X, k2);               // S2 = S1 - A11
+    addBlocks(k2, n2, B22, ldb, -1.0, Y, n2, Y, n2);               // T2 = B22 - T1
+    strassenSequential(m2, n2, k2, X, k2, Y, n2, C12, ldc, crossover, next);   // P6
+    addBlocks(m2, k2, A12, lda, -1.0, X, k2, X, k2);               // S4 = A12 - S2
+    strassenSequential(m2, n2, k2, X, k2, B22, ldb, C11, ldc, crossover, next); // P3
+    strassenSequential(m2, n2, k2, A11, lda, B11, ldb, X, n2, crossover, next); // P1
+    addBlocks(m2, n2, X, n2, 1.0, C12, ldc, C12, ldc);             // U2 = P1 + P6
+    addBlocks(m2, n2, C12, ldc, 1.0, C21, ldc, C21, ldc);          // U3 = U2 + P7
+    addBlocks(m2, n2, C12, ldc, 1.0, C22, ldc, C12, ldc);          // U4 = U2 + P5
+    addBlocks(m2, n2, C21, ldc, 1.0, C22, ldc, C22, ldc);          // U7 = U3 + P5 = C22
+    addBlocks(m2, n2, C12, ldc, 1.0, C11, ldc, C12, ldc);          // U5 = U4 + P3 = C12
+    addBlocks(k2, n2, Y, n2, -1.0, B21, ldb, Y, n2);               // T4 = T2 - B21
+    strassenSequential(m2, n2, k2, A22, lda, Y, n2, C11, ldc, crossover, next); // P4
+    addBlocks(m2, n2, C21, ldc, -1.0, C11, ldc, C21, ldc);         // U6 = U3 - P4 = C21
+    strassenSequential(m2, n2, k2, A12, lda, B21, ldb, C11, ldc, crossover, next); // P2
+    addBlocks(m2, n2, X, n2, 1.0, C11, ldc, C11, ldc);             // U1 = P1 + P2 = C11
+
+    strassenPeel(m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+// Top level with all operand sums formed up front so the seven products can
+// run as independent tasks; each task then recurses sequentially.
+static void strassenParallel(int m, int n, int k, const double* A, int lda, const double* B,
+                             int ldb, double* C, int ldc, int crossover) {
+    int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    size_t sizeS = (size_t)m2 * k2, sizeT = (size_t)k2 * n2, sizeP = (size_t)m2 * n2;
+    size_t sizeWork = strassenWorkspace(m2, n2, k2, crossover);
+    std::vector<double> buffer(4 * sizeS + 4 * sizeT + 3 * sizeP + 7 * sizeWork);
+
+    double* S[4];
+    double* T[4];
+    for (int i = 0; i < 4; ++i) {
+        S[i] = buffer.data() + i * sizeS;
+        T[i] = buffer.data() + 4 * sizeS + i * sizeT;
+    }
+    double* P1 = buffer.data() + 4 * sizeS + 4 * sizeT;
+    double* P2 = P1 + sizeP;
+    double* P4 = P2 + sizeP;
+    double* work = P4 + sizeP;
+
+    const double* A11 = A;
+    const double* A12 = A + k2;
+    const double* A21 = A + (size_t)m2 * lda;
+    const double* A22 = A21 + k2;
+    const double* B11 = B;
+    const double* B12 = B + n2;
+    const double* B21 = B + (size_t)k2 * ldb;
+    const double* B22 = B21 + n2;
+    double* C11 = C;
+    double* C12 = C + n2;
+    double* C21 = C + (size_t)m2 * ldc;
+    double* C22 = C21 + n2;
+
+    addBlocks(m2, k2, A21, lda, 1.0, A22, lda, S[0], k2);          // S1
+    addBlocks(m2, k2, S[0], k2, -1.0, A11, lda, S[1], k2);         // S2
+    addBlocks(m2, k2, A11, lda, -1.0, A21, lda, S[2], k2);         // S3
+    addBlocks(m2, k2, A12, lda, -1.0, S[1], k2, S[3], k2);         // S4
+    addBlocks(k2, n2, B12, ldb, -1.0, B11, ldb, T[0], n2);         // T1
+    addBlocks(k2, n2, B22, ldb, -1.0, T[0], n2, T[1], n2);         // T2
+    addBlocks(k2, n2, B22, ldb, -1.0, B12, ldb, T[2], n2);         // T3
+    addBlocks(k2, n2, T[1], n2, -1.0, B21, ldb, T[3], n2);         // T4
+
+    // P3, P5, P6 and P7 go straight into the quadrants of C
+    parallelFor(0, 7, 1, [&](int first, int last) {
+        for (int t = first; t < last; ++t) {
+            double* w = work + t * sizeWork;
+            switch (t) {
+                case 0: strassenSequential(m2, n2, k2, A11, lda, B11, ldb, P1, n2, crossover, w); break;
+                case 1: strassenSequential(m2, n2, k2, A12, lda, B21, ldb, P2, n2, crossover, w); break;
+                case 2: strassenSequential(m2, n2, k2, S[3], k2, B22, ldb, C11, ldc, crossover, w); break;
+                case 3: strassenSequential(m2, n2, k2, A22, lda, T[3], n2, P4, n2, crossover, w); break;
+                case 4: strassenSequential(m2, n2, k2, S[0], k2, T[0], n2, C22, ldc, crossover, w); break;
+                case 5: strassenSequential(m2, n2, k2, S[1], k2, T[1], n2, C12, ldc, crossover, w); break;
+                case 6: strassenSequential(m2, n2, k2, S[2], k2, T[2], n2, C21, ldc, crossover, w); break;
+            }
+        }
+    });
+
+    addBlocks(m2, n2, C12, ldc, 1.0, P1, n2, C12, ldc);            // U2 = P6 + P1
+    addBlocks(m2, n2, C21, ldc, 1.0, C12, ldc, C21, ldc);          // U3 = P7 + U2
+    addBlocks(m2, n2, C12, ldc, 1.0, C22, ldc, C12, ldc);          // U4 = U2 + P5
+    addBlocks(m2, n2, C22, ldc, 1.0, C21, ldc, C22, ldc);          // C22 = P5 + U3
+    addBlocks(m2, n2, C12, ldc, 1.0, C11, ldc, C12, ldc);          // C12 = U4 + P3
+    addBlocks(m2, n2, C21, ldc, -1.0, P4, n2, C21, ldc);           // C21 = U3 - P4
+    addBlocks(m2, n2, P1, n2, 1.0, P2, n2, C11, ldc);              // C11 = P1 + P2
+
+    strassenPeel(m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+void strassen(int m, int n, int k, const double* A, int lda, const double* B, int ldb,
+              double* C, int ldc, int crossover) {
+    PROFILE_SCOPE("strassen");
+    if (m <= 0 || n <= 0) return;
+    if (strassenBaseCase(m, n, k, crossover)) {
+        gemm(m, n, k, 1.0, A, lda, B, ldb, 0.0, C, ldc);
+        return;
+    }
+
+    if (ThreadPool::instance().numThreads() > 1) {
+        strassenParallel(m, n, k, A, lda, B, ldb, C, ldc, crossover);
+    } else {
+        std::vector<double> work(strassenWorkspace(m, n, k, crossover));
+        strassenSequential(m, n, k, A, lda, B, ldb, C, ldc, crossover, work.data());
+    }
+}
+
+void gemv(int m, int n, const double* A, int lda, const double* x, double* y) {
+    PROFILE_SCOPE_WORK("gemv", 2.0 * m * n, 8.0 * ((double)m * n + m + n));
+    // Each row is one serial sum, so splitting rows keeps results identical
+    parallelFor(0, m, std::max(1, VECTOR_GRAIN / std::max(n, 1)), [=](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            const double* a = A + (size_t)i * lda;
+            double sum = 0.0;
+            for (int j = 0; j < n; ++j) {
+                sum += a[j] * x[j];
+            }
+            y[i] = sum;
+        }
+    });
+}
+
+double dot(int n, const double* x, const double* y) {
+    PROFILE_SCOPE_WORK("dot", 2.0 * n, 16.0 * n);
+    auto block = [x, y](int i0, int i1) {
+        double sum = 0.0;
+        for (int i = i0; i < i1; ++i) {
+            sum += x[i] * y[i];
+        }
+        return sum;
+    };
+    auto add = [](double a, double b) { return a + b; };
+    if (n <= DOT_BLOCK) {
+        return block(0, n);
+    }
+    if (n < DOT_PARALLEL_MIN) {
+        SerialRegion serial;
+        return parallelReduce(0, n, DOT_BLOCK, 0.0, block, add);
+    }
+    return parallelReduce(0, n, DOT_BLOCK, 0.0, block, add);
+}
+
+// Same blocks and tree as dot, so each result equals the separate dot bit for bit
+void dot2(int n, const double* x, const double* y, const double* v, double* result) {
+    PROFILE_SCOPE_WORK("dot2", 4.0 * n, 24.0 * n);
+    struct Pair {
+        double xv, yv;
+    };
+    auto block = [x, y, v](int i0, int i1) {
+        Pair sum = {0.0, 0.0};
+        for (int i = i0; i < i1; ++i) {
+            sum.xv += x[i] * v[i];
+            sum.yv += y[i] * v[i];
+        }
+        return sum;
+    };
+    auto add = [](Pair a, Pair b) { return Pair{a.xv + b.xv, a.yv + b.yv}; };
+    Pair sum;
+    if (n <= DOT_BLOCK) {
+        sum = block(0, n);
+    } else if (n < DOT_PARALLEL_MIN) {
+        SerialRegion serial;
+        sum = parallelReduce(0, n, DOT_BLOCK, Pair{0.0, 0.0}, block, add);
+    } else {
+        sum = parallelReduce(0, n, DOT_BLOCK, Pair{0.0, 0.0}, block, add);
+    }
+    result[0] = sum.xv;
+    result[1] = sum.yv;
+}
+
+double nrm2(int n, const double* x) {
+    return std::sqrt(dot(n, x, x));
+}
+
+void axpy(int n, double alpha, const double* x, double* y) {
+    PROFILE_SCOPE_WORK("axpy", 2.0 * n, 24.0 * n);
+    parallelFor(0, n, VECTOR_GRAIN, [=](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            y[i] += alpha * x[i];
+        }
+    });
+}
+
+void axpby(int n, double alpha, const double* x, double beta, double* y) {
+    PROFILE_SCOPE_WORK("axpby", 3.0 * n, 24.0 * n);
+    parallelFor(0, n, VECTOR_GRAIN, [=](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            y[i] = alpha * x[i] + beta * y[i];
+        }
+    });
+}
+
+// Blocked forward substitution on one column panel of B
+static void trsmLowerPanel(int m, int n, const double* L, int ldl, bool unitDiagonal,
+                           double* B, int ldb) {
+    for (int kb = 0; kb < m; kb += TRSM_BLOCK) {
+        int ke = std::min(kb + TRSM_BLOCK, m);
+
+        for (int i = kb; i < ke; ++i) {
+            double* bi = B + (size_t)i * ldb;
+            for (int p = kb; p < i; ++p) {
+                double lip = L[(size_t)i * ldl + p];
+                const double* bp = B + (size_t)p * ldb;
+                for (int j = 0; j < n; ++j) {
+                    bi[j] -= lip * bp[j];
+                }
+            }
+            if (!unitDiagonal) {
+                double d = L[(size_t)i * ldl + i];
+                for (int j = 0; j < n; ++j) {
+                    bi[j] /= d;
+                }
+            }
+        }
+
+        if (ke < m) {
+            gemm(m - ke, n, ke - kb, -1.0, L + (size_t)ke * ldl + kb, ldl,
+                 B + (size_t)kb * ldb, ldb, 1.0, B + (size_t)ke * ldb, ldb);
+        }
+    }
+}
+
+// Blocked back substitution on one column panel of B
+static void trsmUpperPanel(int m, int n, const double* U, int ldu, double* B, int ldb) {
+    for (int ke = m; ke > 0; ke -= TRSM_BLOCK) {
+        int kb = std::max(ke - TRSM_BLOCK, 0);
+
+        for (int i = ke - 1; i >= kb; --i) {
+            double* bi = B + (size_t)i * ldb;
+            for (int p = i + 1; p < ke; ++p) {
+                double uip = U[(size_t)i * ldu + p];
+                const double* bp = B + (size_t)p * ldb;
+                for (int j = 0; j < n; ++j) {
+                    bi[j] -= uip * bp[j];
+                }
+            }
+            double d = U[(size_t)i * ldu + i];
+            for (int j = 0; j < n; ++j) {
+                bi[j] /= d;
+            }
+        }
+
+        if (kb > 0) {
+            gemm(kb, n, ke - kb, -1.0, U + kb, ldu, B + (size_t)kb * ldb, ldb, 1.0, B, ldb);
+        }
+    }
+}
+
+void trsmLower(int m, int n, const double* L, int ldl, bool unitDiagonal, double* B, int ldb) {
+    PROFILE_SCOPE_WORK("trsm", (double)m * m * n, 8.0 * (0.5 * m * m + 2.0 * m * n));
+    if (n <= TRSM_COL_GRAIN) {
+        trsmLowerPanel(m, n, L, ldl, unitDiagonal, B, ldb);
+        return;
+    }
+    parallelFor(0, n, TRSM_COL_GRAIN, [&](int j0, int j1) {
+        trsmLowerPanel(m, j1 - j0, L, ldl, unitDiagonal, B + j0, ldb);
+    });
+}
+
+void trsmUpper(int m, int n, const double* U, int ldu, double* B, int ldb) {
+    PROFILE_SCOPE_WORK("trsm", (double)m * m * n, 8.0 * (0.5 * m * m + 2.0 * m * n));
+    if (n <= TRSM_COL_GRAIN) {
+        trsmUpperPanel(m, n, U, ldu, B, ldb);
+        return;
+    }
+    parallelFor(0, n, TRSM_COL_GRAIN, [&](int j0, int j1) {
+        trsmUpperPanel(m, j1 - j0, U, ldu, B + j0, ldb);
+    });
+}
+
+void swapRows(double* A, int lda, int ncols, int k1, int k2, const int* piv) {
+    for (int i = k1; i < k2; ++i) {
+        if (piv[i] != i) {
+            std::swap_ranges(A + (size_t)i * lda, A + (size_t)i * lda + ncols,
+                             A + (size_t)piv[i] * lda);
+        }
+    }
+}
+
+// Apply H = I - tau v vᵀ (v from column j of A, v_j = 1) to rows j..m-1 of the
+// ncols-wide block B
+static void applyReflector(int m, int j, const double* A, int lda, double tau,
+                           int ncols, double* B, int ldb) {
+    if (tau == 0.0 || ncols <= 0) return;
+    std::vector<double> w(B + (size_t)j * ldb, B + (size_t)j * ldb + ncols);
+    for (int i = j + 1; i < m; ++i) {
+        double vi = A[(size_t)i * lda + j];
+        const double* bi = B + (size_t)i * ldb;
+        for (int c = 0; c < ncols; ++c) {
+            w[c] += vi * bi[c];
+        }
+    }
+    double* bj = B + (size_t)j * ldb;
+    for (int c = 0; c < ncols; ++c) {
+        bj[c] -= tau * w[c];
+    }
+    for (int i = j + 1; i < m; ++i) {
+        double vi = tau * A[(size_t)i * lda + j];
+        double* bi = B + (size_t)i * ldb;
+        for (int c = 0; c < ncols; ++c) {
+            bi[c] -= vi * w[c];
+        }
+    }
+}
+
+void householderQR(int m, int n, double* A, int lda, double* tau) {
+    PROFILE_SCOPE_WORK("householderQR", 2.0 * m * n * n - 2.0 * n * n * n / 3.0, 16.0 * m * n);
+    for (int j = 0; j < n; ++j) {
+        double alpha = A[(size_t)j * lda + j];
+        double normTail = 0.0;
+        for (int i = j + 1; i < m; ++i) {
+            double a = A[(size_t)i * lda + j];
+            normTail += a * a;
+        }
+
+        if (normTail == 0.0) {
+            tau[j] = 0.0;
+            continue;
+        }
+
+        double beta = -std::copysign(std::sqrt(alpha * alpha + normTail), alpha);
+        tau[j] = (beta - alpha) / beta;
+        double scale = 1.0 / (alpha - beta);
+        for (int i = j + 1; i < m; ++i) {
+            A[(size_t)i * lda + j] *= scale;
+        }
+        A[(size_t)j * lda + j] = beta;
+
+        applyReflector(m, j, A, lda, tau[j], n - j - 1, A + j + 1, lda);
+    }
+}
+
+void formQ(int m, int n, const double* A, int lda, const double* tau, double* Q, int ldq) {
+    for (int i = 0; i < m; ++i) {
+        for (int c = 0; c < n; ++c) {
+            Q[(size_t)i * ldq + c] = (i == c) ? 1.0 : 0.0;
+        }
+    }
+    // Q = H_0 H_1 ... H_{n-1} [I; 0], applied right to left
+    for (int j = n - 1; j >= 0; --j) {
+        applyReflector(m, j, A, lda, tau[j], n, Q, ldq);
+    }
+}
+
+void applyQt(int m, int n, const double* A, int lda, const double* tau, int nrhs, double* B, int ldb) {
+    for (int j = 0; j < n; ++j) {
+        applyReflector(m, j, A, lda, tau[j], nrhs, B, ldb);
+    }
+}
+
+// Right-looking elimination of a narrow panel
+static int luUnblocked(int m, int n, double* A, int lda, int* piv) {
+    int info = 0;
+    for (int j = 0; j < n; ++j) {
+        int p = j;
+        for (int i = j + 1; i < m; ++i) {
+            if (std::fabs(A[(size_t)i * lda + j]) > std::fabs(A[(size_t)p * lda + j])) {
+                p = i;
+            }
+        }
+        piv[j] = p;
+        if (p != j) {
+            std::swap_ranges(A + (size_t)j * lda, A + (size_t)j * lda + n, A + (size_t)p * lda);
+        }
+
+        double pivot = A[(size_t)j * lda + j];
+        if (pivot == 0.0) {
+            if (info == 0) info = j + 1;
+            continue;
+        }
+
+        const double* aj = A + (size_t)j * lda;
+        for (int i = j + 1; i < m; ++i) {
+            double* ai = A + (size_t)i * lda;
+            double factor = ai[j] / pivot;
+            ai[j] = factor;
+            for (int c = j + 1; c < n; ++c) {
+                ai[c] -= factor * aj[c];
+            }
+        }
+    }
+    return info;
+}
+
+// Split the panel in two column halves: factor the left half, update the
+// right half with a triangular solve and one GEMM, then factor what is left.
+static int luRecursive(int m, int n, double* A, int lda, int* piv) {
+    if (n <= LU_BASE_COLS) {
+        return luUnblocked(m, n, A, lda, piv);
+    }
+
+    int n1 = n / 2;
+    int n2 = n - n1;
+
+    int info = luRecursive(m, n1, A, lda, piv);
+
+    // A12 = L11⁻¹ P1 A12, A22 = A22 - A21 A12
+    swapRows(A + n1, lda, n2, 0, n1, piv);
+    trsmLower(n1, n2, A, lda, true, A + n1, lda);
+    gemm(m - n1, n2, n1, -1.0, A + (size_t)n1 * lda, lda, A + n1, lda,
+         1.0, A + (size_t)n1 * lda + n1, lda);
+
+    int info2 = luRecursive(m - n1, n2, A + (size_t)n1 * lda + n1, lda, piv + n1);
+    if (info == 0 && info2 != 0) info = info2 + n1;
+
+    // Make the lower half's pivots absolute and apply them to L21
+    for (int i = n1; i < n; ++i) {
+        piv[i] += n1;
+    }
+    swapRows(A, lda, n1, n1, n, piv);
+
+    return info;
+}
+
+int luFactor(int m, int n, double* A, int lda, int* piv) {
+    PROFILE_SCOPE_WORK("luFactor", (double)m * n * n - (double)n * n * n / 3.0, 16.0 * m * n);
+    return luRecursive(m, n, A, lda, piv);
+}
+
+void luSolve(int n, int nrhs, const double* LU, int lda, const int* piv, double* B, int ldb) {
+    PROFILE_SCOPE_WORK("luSolve", 2.0 * n * n * nrhs, 8.0 * ((double)n * n + 2.0 * n * nrhs));
+    swapRows(B, ldb, nrhs, 0, n, piv);
+    trsmLower(n, nrhs, LU, lda, true, B, ldb);
+    trsmUpper(n, nrhs, LU, lda, B, ldb);
+}
+
+// View overloads
+
+void gemm(double alpha, ConstMatrixView A, ConstMatrixView B, double beta, MatrixView C) {
+    assert(A.numCols() == B.numRows());
+    assert(A.numRows() == C.numRows() && B.numCols() == C.numCols());
+    gemm(C.numRows(), C.numCols(), A.numCols(), alpha, A.data(), A.ld(), B.data(), B.ld(),
+         beta, C.data(), C.ld());
+}
+
+void strassen(ConstMatrixView A, ConstMatrixView B, MatrixView C, int crossover) {
+    assert(A.numCols() == B.numRows());
+    assert(A.numRows() == C.numRows() && B.numCols() == C.numCols());
+    strassen(C.numRows(), C.numCols(), A.numCols(), A.data(), A.ld(), B.data(), B.ld(),
+             C.data(), C.ld(), crossover);
+}
+
+void gemv(ConstMatrixView A, ConstVectorView x, VectorView y) {
+    assert(A.numCols() == x.size() && A.numRows() == y.size());
+    if (x.stride() == 1 && y.stride() == 1) {
+        gemv(A.numRows(), A.numCols(), A.data(), A.ld(), x.data(), y.data());
+        return;
+    }
+    for (int i = 0; i < A.numRows(); ++i) {
+        y.data()[(size_t)i * y.stride()] = dot(A.row(i + 1), x);
+    }
+}
+
+double dot(ConstVectorView x, ConstVectorView y) {
+    assert(x.size() == y.size());
+    if (x.stride() == 1 && y.stride() == 1) {
+        return dot(x.size(), x.data(), y.data());
+    }
+    const double* px = x.data();
+    const double* py = y.data();
+    double sum = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+        sum += px[(size_t)i * x.stride()] * py[(size_t)i * y.stride()];
+    }
+    return sum;
+}
+
+double nrm2(ConstVectorView x) {
+    return std::sqrt(dot(x, x));
+}
+
+void axpy(double alpha, ConstVectorView x, VectorView y) {
+    assert(x.size() == y.size());
+    if (x.stride() == 1 && y.stride() == 1) {
+        axpy(x.size(), alpha, x.data(), y.data());
+        return;
+    }
+    const double* px = x.data();
+    double* py = y.data();
+    for (int i = 0; i < x.size(); ++i) {
+        py[(size_t)i * y.stride()] += alpha * px[(size_t)i * x.stride()];
+    }
+}
+
+void trsmLower(ConstMatrixView L, bool unitDiagonal, MatrixView B) {
+    assert(L.numRows() == L.numCols() && L.numRows() == B.numRows());
+    trsmLower(B.numRows(), B.numCols(), L.data(), L.ld(), unitDiagonal, B.data(), B.ld());
+}
+
+void trsmUpper(ConstMatrixView U, MatrixView B) {
+    assert(U.numRows() == U.numCols() && U.numRows() == B.numRows());
+    trsmUpper(B.numRows(), B.numCols(), U.data(), U.ld(), B.data(), B.ld());
+}
+
+void swapRows(MatrixView A, int k1, int k2, const int* piv) {
+    swapRows(A.data(), A.ld(), A.numCols(), k1, k2, piv);
+}
+
+void householderQR(MatrixView A, double* tau) {
+    assert(A.numRows() >= A.numCols());
+    householderQR(A.numRows(), A.numCols(), A.data(), A.ld(), tau);
+}
+
+void formQ(ConstMatrixView A, const double* tau, MatrixView Q) {
+    assert(Q.numRows() == A.numRows() && Q.numCols() == A.numCols());
+    formQ(A.numRows(), A.numCols(), A.data(), A.ld(), tau, Q.data(), Q.ld());
+}
+
+void applyQt(ConstMatrixView A, const double* tau, MatrixView B) {
+    assert(B.numRows() == A.numRows());
+    applyQt(A.numRows(), A.numCols(), A.data(), A.ld(), tau, B.numCols(), B.data(), B.ld());
+}
+
+int luFactor(MatrixView A, int* piv) {
+    assert(A.numRows() >= A.numCols());
+    return luFactor(A.numRows(), A.numCols(), A.data(), A.ld(), piv);
+}
+
+void luSolve(ConstMatrixView LU, const int* piv, MatrixView B) {
+    assert(LU.numRows() == LU.numCols() && LU.numRows() == B.numRows());
+    luSolve(LU.numRows(), B.numCols(), LU.data(), LU.ld(), piv, B.data(), B.ld());
+}
+
+}
@@ -0,0 +1,256 @@
+#include "KrylovLeastSquares.h"
+#include "Kernels.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+KrylovLeastSquares::KrylovLeastSquares(const Matrix* A, const Vector* b)
+    : mpOperator(nullptr), mOwnsOperator(true), mpb(b) {
+    if (A == nullptr || b == nullptr) {
+        throw invalid_argument("Matrix and Vector cannot be null");
+    }
+    mpOperator = new DenseOperator(A);
+    Initialize();
+}
+
+KrylovLeastSquares::KrylovLeastSquares(const SparseMatrix* A, const Vector* b)
+    : mpOperator(nullptr), mOwnsOperator(true), mpb(b) {
+    if (A == nullptr || b == nullptr) {
+        throw invalid_argument("Matrix and Vector cannot be null");
+    }
+    mpOperator = new SparseOperator(A);
+    Initialize();
+}
+
+KrylovLeastSquares::KrylovLeastSquares(LinearOperator* A, const Vector* b)
+    : mpOperator(A), mOwnsOperator(false), mpb(b) {
+    if (A == nullptr || b == nullptr) {
+        throw invalid_argument("Operator and Vector cannot be null");
+    }
+    if (!A->hasTranspose()) {
+        throw invalid_argument("Least-squares solvers need an operator with a transpose product");
+    }
+    Initialize();
+}
+
+void KrylovLeastSquares::Initialize() {
+    mNumRows = mpOperator->numRows();
+    mNumCols = mpOperator->numCols();
+    if (mpb->size() != mNumRows) {
+        if (mOwnsOperator) delete mpOperator;
+        throw invalid_argument("Right-hand side length does not match the operator");
+    }
+    mMethod = LeastSquaresMethod::LSQR;
+    mDamping = 0.0;
+    mTolerance = 1e-10;
+    mMaxIterations = max(2 * mNumCols, 100);
+    mIterations = 0;
+    mConverged = false;
+    mResidualNorm = 0.0;
+    mNormalResidualNorm = 0.0;
+    mWork.assign(2 * (size_t)mNumRows + 3 * (size_t)mNumCols, 0.0);
+}
+
+KrylovLeastSquares::~KrylovLeastSquares() {
+    if (mOwnsOperator) {
+        delete mpOperator;
+    }
+}
+
+Vector KrylovLeastSquares::Solve() {
+    PROFILE_SCOPE("KrylovLeastSquares::Solve");
+    Vector x(mNumCols);
+    mIterations = 0;
+    mConverged = false;
+    if (mMethod == LeastSquaresMethod::LSQR) {
+        SolveLSQR(x.data());
+    } else {
+        SolveCGLS(x.data());
+    }
+
+    // True residual of the result, in the first m-vector of the workspace
+    double* r = mWork.data();
+    mpOperator->apply(x.data(), r);
+    kernels::axpby(mNumRows, 1.0, mpb->data(), -1.0, r);
+    mResidualNorm = kernels::nrm2(mNumRows, r);
+
+    if (!mConverged) {
+        cout << "Warning: " << (mMethod == LeastSquaresMethod::LSQR ? "LSQR" : "CGLS")
+             << " did not converge within " << mMaxIterations << " iterations" << endl;
+    }
+    return x;
+}
+
+// Paige and Saunders' tests: a compatible system is solved once
+// ||r|| <= tol (||b|| + ||A|| ||x||), an incompatible one once the normal
+// equations hold relative to ||A|| ||r||. The second test is independent of
+// the scaling of b and does not square the condition number, unlike a test
+// relative to ||Aᵀb||. With damping, r is the augmented residual [b - Ax; -λx]
+// and only the second test applies.
+bool KrylovLeastSquares::Stop(double residual, double normalResidual, double aNorm, double bNorm,
+                              double xNorm) const {
+    if (mDamping == 0.0 && residual <= mTolerance * (bNorm + aNorm * xNorm)) {
+        return true;
+    }
+    return normalResidual <= mTolerance * aNorm * residual;
+}
+
+// Golub-Kahan bidiagonalization: beta₁u₁ = b, alpha₁v₁ = Aᵀu₁, then
+//   beta u = A v - alpha u,   alpha v = Aᵀu - beta v
+// The damping row is eliminated by one extra plane rotation per step.
+void KrylovLeastSquares::SolveLSQR(double* x) {
+    int m = mNumRows;
+    int n = mNumCols;
+    double* u = mWork.data();
+    double* Av = u + m;
+    double* v = Av + m;
+    double* w = v + n;
+    double* Atu = w + n;
+    const double* b = mpb->data();
+
+    copy(b, b + m, u);
+    double bNorm = kernels::nrm2(m, u);
+    double beta = bNorm;
+    fill(x, x + n, 0.0);
+    if (beta == 0.0) {
+        mConverged = true;
+        return;
+    }
+    kernels::axpby(m, 0.0, u, 1.0 / beta, u);
+    mpOperator->applyTranspose(u, v);
+    double alpha = kernels::nrm2(n, v);
+    mNormalResidualNorm = alpha * beta;   // ||Aᵀb||
+    if (alpha == 0.0) {
+        mConverged = true;
+        return;
+    }
+    kernels::axpby(n, 0.0, v, 1.0 / alpha, v);
+    copy(v, v + n, w);
+
+    double phiBar = beta;
+    double rhoBar = alpha;
+    double dampedResidual = 0.0;   // Σ ψ², the part of the residual in the damping rows
+    double aNorm2 = alpha * alpha; // Frobenius norm² of the bidiagonal matrix so far, estimates ||A||²
+    while (mIterations < mMaxIterations) {
+        ++mIterations;
+        mpOperator->apply(v, Av);
+        kernels::axpby(m, 1.0, Av, -alpha, u);
+        beta = kernels::nrm2(m, u);
+        if (beta > 0.0) {
+            kernels::axpby(m, 0.0, u, 1.0 / beta, u);
+            mpOperator->applyTranspose(u, Atu);
+            kernels::axpby(n, 1.0, Atu, -beta, v);
+            alpha = kernels::nrm2(n, v);
+            if (alpha > 0.0) {
+                kernels::axpby(n, 0.0, v, 1.0 / alpha, v);
+            }
+        } else {
+            alpha = 0.0;
+        }
+
+        // Rotation eliminating the damping, then the one eliminating beta
+        double rhoBar1 = sqrt(rhoBar * rhoBar + mDamping * mDamping);
+        double c1 = rhoBar / rhoBar1;
+        double s1 = mDamping / rhoBar1;
+        double psi = s1 * phiBar;
+        phiBar = c1 * phiBar;
+
+        double rho = sqrt(rhoBar1 * rhoBar1 + beta * beta);
+        double c = rhoBar1 / rho;
+        double s = beta / rho;
+        double theta = s * alpha;
+        rhoBar = -c * alpha;
+        double phi = c * phiBar;
+        phiBar = s * phiBar;
+
+        kernels::axpy(n, phi / rho, w, x);
+        kernels::axpby(n, 1.0, v, -theta / rho, w);
+
+        // ||[b - Ax; -damping x]|| is sqrt(phiBar² + Σψ²) and the
+        // normal-equation residual is alpha |s phi|
+        dampedResidual += psi * psi;
+        aNorm2 += beta * beta + alpha * alpha + mDamping * mDamping;
+        double residual = sqrt(phiBar * phiBar + dampedResidual);
+        mNormalResidualNorm = alpha * fabs(s * phi);
+        if (Stop(residual, mNormalResidualNorm, sqrt(aNorm2), bNorm, kernels::nrm2(n, x)) || alpha == 0.0) {
+            mConverged = true;
+            return;
+        }
+    }
+}
+
+// CG on (AᵀA + damping² I) x = Aᵀb with the residual r = b - Ax kept
+// instead of the normal-equation residual, so AᵀA is applied as Aᵀ(A p)
+void KrylovLeastSquares::SolveCGLS(double* x) {
+    int m = mNumRows;
+    int n = mNumCols;
+    double* r = mWork.data();
+    double* q = r + m;
+    double* s = q + m;
+    double* p = s + n;
+    const double* b = mpb->data();
+    double damping2 = mDamping * mDamping;
+
+    fill(x, x + n, 0.0);
+    copy(b, b + m, r);
+    double bNorm = kernels::nrm2(m, r);
+    mpOperator->applyTranspose(r, s);
+    copy(s, s + n, p);
+    double gamma = kernels::dot(n, s, s);
+    mNormalResidualNorm = sqrt(gamma);
+    double aNorm = 0.0;   // max ||Ap|| / ||p||, a lower bound on ||A||
+    if (bNorm == 0.0 || gamma == 0.0) {
+        mConverged = true;
+        return;
+    }
+
+    while (mIterations < mMaxIterations) {
+        ++mIterations;
+        mpOperator->apply(p, q);
+        double qq = kernels::dot(m, q, q);
+        double pp = kernels::dot(n, p, p);
+        double delta = qq + damping2 * pp;
+        aNorm = max(aNorm, sqrt(qq / pp));
+        double step = gamma / delta;
+        kernels::axpy(n, step, p, x);
+        kernels::axpy(m, -step, q, r);
+
+        // s = Aᵀr - damping² x
+        mpOperator->applyTranspose(r, s);
+        if (damping2 != 0.0) {
+            kernels::axpy(n, -damping2, x, s);
+        }
+        double gammaNew = kernels::dot(n, s, s);
+        mNormalResidualNorm = sqrt(gammaNew);
+        double xNorm = kernels::nrm2(n, x);
+        double rNorm = kernels::nrm2(m, r);
+        double residual = sqrt(rNorm * rNorm + damping2 * xNorm * xNorm);
+        if (Stop(residual, mNormalResidualNorm, aNorm, bNorm, xNorm)) {
+            mConverged = true;
+            return;
+        }
+        kernels::axpby(n, 1.0, s, gammaNew / gamma, p);
+        gamma = gammaNew;
+    }
+}
+
+void KrylovLeastSquares::SetMethod(LeastSquaresMethod method) { mMethod = method; }
+
+void KrylovLeastSquares::SetDamping(double damping) {
+    if (damping < 0.0) {
+        throw invalid_argument("Damping must not be negative");
+    }
+    mDamping = damping;
+}
+
+void KrylovLeastSquares::SetTolerance(double tolerance) { mTolerance = tolerance; }
+void KrylovLeastSquares::SetMaxIterations(int maxIterations) { mMaxIterations = maxIterations; }
+
+int KrylovLeastSquares::Iterations() const { return mIterations; }
+bool KrylovLeastSquares::Converged() const { return mConverged; }
+double KrylovLeastSquares::ResidualNorm() const { return mResidualNorm; }
+double KrylovLeastSquares::NormalResidualNorm() const { return mNormalResidualNorm; }
@@ -0,0 +1,87 @@
+#include "KrylovLinSystem.h"
+#include "Kernels.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+KrylovLinSystem::KrylovLinSystem(Matrix* A, Vector* b)
+    : LinearSystem(A, b), mpOperator(new DenseOperator(A)), mOwnsOperator(true),
+      mpPreconditioner(nullptr), mTolerance(1e-10), mMaxIterations(max(2 * mSize, 100)),
+      mIterations(0), mResidualNorm(0.0) {}
+
+KrylovLinSystem::KrylovLinSystem(SparseMatrix* A, Vector* b)
+    : LinearSystem(A == nullptr ? 0 : A->numRows(), b), mpOperator(nullptr), mOwnsOperator(true),
+      mpPreconditioner(nullptr), mTolerance(1e-10), mMaxIterations(max(2 * mSize, 100)),
+      mIterations(0), mResidualNorm(0.0) {
+    if (A == nullptr) {
+        throw invalid_argument("Matrix and Vector cannot be null");
+    }
+    if (A->numRows() != A->numCols()) {
+        throw invalid_argument("Matrix is not square");
+    }
+    mpOperator = new SparseOperator(A);
+}
+
+KrylovLinSystem::KrylovLinSystem(LinearOperator* A, Vector* b)
+    : LinearSystem(A == nullptr ? 0 : A->numRows(), b), mpOperator(A), mOwnsOperator(false),
+      mpPreconditioner(nullptr), mTolerance(1e-10), mMaxIterations(max(2 * mSize, 100)),
+      mIterations(0), mResidualNorm(0.0) {
+    if (A == nullptr) {
+        throw invalid_argument("Operator and Vector cannot be null");
+    }
+    if (A->numRows() != A->numCols()) {
+        throw invalid_argument("Operator is not square");
+    }
+}
+
+KrylovLinSystem::~KrylovLinSystem() {
+    if (mOwnsOperator) {
+        delete mpOperator;
+    }
+}
+
+void KrylovLinSystem::ApplyOperator(const double* x, double* y) const {
+    mpOperator->apply(x, y);
+}
+
+void KrylovLinSystem::ApplyPreconditioner(const double* r, double* z) const {
+    if (mpPreconditioner != nullptr) {
+        mpPreconditioner->Apply(r, z);
+    } else {
+        copy(r, r + mSize, z);
+    }
+}
+
+vector<double> KrylovLinSystem::RhsArray() const {
+    return vector<double>(mpb->begin(), mpb->end());
+}
+
+Vector KrylovLinSystem::Finish(const vector<double>& x, bool converged, const char* method) {
+    vector<double> b = RhsArray();
+    vector<double> r(mSize);
+    ApplyOperator(x.data(), r.data());
+    for (int i = 0; i < mSize; ++i) {
+        r[i] = b[i] - r[i];
+    }
+    mResidualNorm = kernels::nrm2(mSize, r.data());
+
+    if (!converged) {
+        cout << "Warning: " << method << " did not converge within "
+             << mMaxIterations << " iterations" << endl;
+    }
+
+    Vector solution(mSize);
+    for (int i = 1; i <= mSize; ++i) {
+        solution(i) = x[i - 1];
+    }
+    return solution;
+}
+
+void KrylovLinSystem::SetTolerance(double tolerance) { mTolerance = tolerance; }
+void KrylovLinSystem::SetMaxIterations(int maxIterations) { mMaxIterations = maxIterations; }
+void KrylovLinSystem::SetPreconditioner(Preconditioner* preconditioner) { mpPreconditioner = preconditioner; }
+
+int KrylovLinSystem::Iterations() const { return mIterations; }
+double KrylovLinSystem::ResidualNorm() const { return mResidualNorm; }
+const vector<double>& KrylovLinSystem::ResidualHistory() const { return mResidualHistory; }
@@ -0,0 +1,196 @@
+#include "LinearModel.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+static const char MAGIC[8] = {'T', 'I', 'N', 'I', 'M', 'D', 'L', '\0'};
+static const uint32_t VERSION = 1;
+
+static_assert(sizeof(LinearModel::FileHeader) == 32, "Model file header must be 32 bytes");
+
+// Rows per parallel chunk of batch prediction and of CSV scoring
+static const int PREDICT_ROW_GRAIN = 16384;
+static const int SCORE_LINE_GRAIN = 4096;
+
+// Longest output of std::to_chars for a double, plus the newline
+static const int PREDICTION_CHARS = 32;
+
+LinearModel::LinearModel() : mNumFeatures(0), mIntercept(0.0) {}
+
+LinearModel::LinearModel(const Vector& coefficients, const Vector& means, const Vector& stddevs)
+    : mNumFeatures(coefficients.size()), mIntercept(0.0) {
+    if (mNumFeatures <= 0 || means.size() != mNumFeatures || stddevs.size() != mNumFeatures) {
+        throw std::invalid_argument("Coefficients and normalization statistics must have the same size");
+    }
+    mMeans.assign(means.begin(), means.end());
+    mStddevs.assign(stddevs.begin(), stddevs.end());
+    mCoefficients.assign(coefficients.begin(), coefficients.end());
+    mWeights.resize(mNumFeatures);
+    for (int j = 0; j < mNumFeatures; ++j) {
+        if (!(mStddevs[j] > 0.0)) {
+            throw std::invalid_argument("Standard deviations must be positive");
+        }
+        mWeights[j] = mCoefficients[j] / mStddevs[j];
+        mIntercept -= mWeights[j] * mMeans[j];
+    }
+}
+
+void LinearModel::save(const std::string& path) const {
+    FileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.numFeatures = mNumFeatures;
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) {
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+    size_t p = mNumFeatures;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1
+              && std::fwrite(mMeans.data(), sizeof(double), p, f) == p
+              && std::fwrite(mStddevs.data(), sizeof(double), p, f) == p
+              && std::fwrite(mCoefficients.data(), sizeof(double), p, f) == p
+              && std::fwrite(mWeights.data(), sizeof(double), p, f) == p
+              && std::fwrite(&mIntercept, sizeof(double), 1, f) == 1;
+    if (std::fclose(f) != 0 || !ok) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+LinearModel LinearModel::load(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (f == nullptr) {
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+    FileHeader h;
+    if (std::fread(&h, sizeof(h), 1, f) != 1 || std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        std::fclose(f);
+        throw std::runtime_error("Not a model file");
+    }
+    if (h.version != VERSION || h.numFeatures == 0 || h.numFeatures > (1u << 20)) {
+        std::fclose(f);
+        throw std::runtime_error("Unsupported model file version");
+    }
+
+    LinearModel model;
+    size_t p = h.numFeatures;
+    model.mNumFeatures = (int)p;
+    model.mMeans.resize(p);
+    model.mStddevs.resize(p);
+    model.mCoefficients.resize(p);
+    model.mWeights.resize(p);
+    bool ok = std::fread(model.mMeans.data(), sizeof(double), p, f) == p
+              && std::fread(model.mStddevs.data(), sizeof(double), p, f) == p
+              && std::fread(model.mCoefficients.data(), sizeof(double), p, f) == p
+              && std::fread(model.mWeights.data(), sizeof(double), p, f) == p
+              && std::fread(&model.mIntercept, sizeof(double), 1, f) == 1;
+    bool trailing = std::fgetc(f) != EOF;
+    std::fclose(f);
+    if (!ok || trailing) {
+        throw std::runtime_error("Model file is corrupt or truncated");
+    }
+    return model;
+}
+
+int LinearModel::numFeatures() const { return mNumFeatures; }
+double LinearModel::intercept() const { return mIntercept; }
+const std::vector<double>& LinearModel::weights() const { return mWeights; }
+const std::vector<double>& LinearModel::coefficients() const { return mCoefficients; }
+const std::vector<double>& LinearModel::means() const { return mMeans; }
+const std::vector<double>& LinearModel::stddevs() const { return mStddevs; }
+
+void LinearModel::predict(const double* X, int numRows, int ldx, double* y) const {
+    PROFILE_SCOPE_WORK("LinearModel::predict", 2.0 * numRows * mNumFeatures,
+                       8.0 * numRows * (mNumFeatures + 1));
+    parallelFor(0, numRows, PREDICT_ROW_GRAIN, [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            y[i] = predict(X + (size_t)i * ldx);
+        }
+    });
+}
+
+// Parses one line into x; returns false if it is not a row of p numbers
+// or a machine.data record
+static bool parseRow(const char* begin, const char* end, int p, double* x) {
+    // Count the fields to tell bare rows from records
+    int fields = 1 + (int)std::count(begin, end, ',');
+    const char* cursor = begin;
+    if (fields >= p + 2) {
+        for (int skip = 0; skip < 2; ++skip) {
+            cursor = static_cast<const char*>(std::memchr(cursor, ',', end - cursor)) + 1;
+        }
+    } else if (fields != p) {
+        return false;
+    }
+    for (int j = 0; j < p; ++j) {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t')) ++cursor;
+        std::from_chars_result r = std::from_chars(cursor, end, x[j]);
+        if (r.ec != std::errc()) return false;
+        cursor = r.ptr;
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) ++cursor;
+        if (j + 1 < p) {
+            if (cursor == end || *cursor != ',') return false;
+            ++cursor;
+        }
+    }
+    return fields > p || cursor == end;
+}
+
+void LinearModel::score(const char* begin, const char* end, std::string& out) const {
+    PROFILE_SCOPE_WORK("LinearModel::score", 0, end - begin);
+    // Line boundaries serially, skipping blank lines; memchr runs at memory speed
+    std::vector<const char*> lineBegin, lineEnd;
+    for (const char* cursor = begin; cursor < end;) {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        const char* stop = newline != nullptr ? newline : end;
+        const char* last = stop;
+        if (last > cursor && last[-1] == '\r') --last;
+        if (last > cursor) {
+            lineBegin.push_back(cursor);
+            lineEnd.push_back(last);
+        }
+        cursor = stop + 1;
+    }
+    int numLines = (int)lineBegin.size();
+    int p = mNumFeatures;
+
+    // Parse, predict and format each block of lines into its own slice of the
+    // output; slices are then packed together in order
+    size_t offset = out.size();
+    out.resize(offset + (size_t)numLines * PREDICTION_CHARS);
+    std::vector<int> lengths(numLines);
+    std::vector<int> badLines((numLines + SCORE_LINE_GRAIN - 1) / SCORE_LINE_GRAIN, -1);
+    parallelFor(0, numLines, SCORE_LINE_GRAIN, [&](int first, int last) {
+        std::vector<double> x(p);
+        for (int i = first; i < last; ++i) {
+            if (!parseRow(lineBegin[i], lineEnd[i], p, x.data())) {
+                badLines[first / SCORE_LINE_GRAIN] = i;
+                return;
+            }
+            char* slot = &out[offset + (size_t)i * PREDICTION_CHARS];
+            char* stop = std::to_chars(slot, slot + PREDICTION_CHARS - 1, predict(x.data())).ptr;
+            *stop++ = '\n';
+            lengths[i] = (int)(stop - slot);
+        }
+    });
+    for (int bad : badLines) {
+        if (bad >= 0) {
+            out.resize(offset);
+            throw std::invalid_argument("Cannot parse input row " + std::to_string(bad + 1) + ": "
+                                        + std::string(lineBegin[bad], lineEnd[bad]));
+        }
+    }
+
+    size_t packed = offset;
+    for (int i = 0; i < numLines; ++i) {
+        std::memmove(&out[packed], &out[offset + (size_t)i * PREDICTION_CHARS], lengths[i]);
+        packed += lengths[i];
+    }
+    out.resize(packed);
+}
@@ -0,0 +1,208 @@
+#include "LinearOperator.h"
+#include "Kernels.h"
+#include "Parallel.h"
+#include <stdexcept>
+
+// Columns of a dense Aᵀx per parallel task
+static const int TRANSPOSE_COL_GRAIN = 256;
+
+void LinearOperator::applyBlock(int s, const double* X, int ldx, double* Y, int ldy) const {
+    std::vector<double> x(numCols());
+    std::vector<double> y(numRows());
+    for (int j = 0; j < s; ++j) {
+        for (int i = 0; i < numCols(); ++i) {
+            x[i] = X[(size_t)i * ldx + j];
+        }
+        apply(x.data(), y.data());
+        for (int i = 0; i < numRows(); ++i) {
+            Y[(size_t)i * ldy + j] = y[i];
+        }
+    }
+}
+
+bool LinearOperator::hasDiagonal() const {
+    return false;
+}
+
+void LinearOperator::diagonal(double*) const {
+    throw std::logic_error("Operator does not provide its diagonal");
+}
+
+bool LinearOperator::hasTranspose() const {
+    return false;
+}
+
+void LinearOperator::applyTranspose(const double*, double*) const {
+    throw std::logic_error("Operator does not provide a transpose product");
+}
+
+// DenseOperator
+DenseOperator::DenseOperator(const Matrix* A) : mpA(A) {
+    if (A == nullptr) {
+        throw std::invalid_argument("Matrix cannot be null");
+    }
+}
+
+int DenseOperator::numRows() const { return mpA->numRows(); }
+int DenseOperator::numCols() const { return mpA->numCols(); }
+
+void DenseOperator::apply(const double* x, double* y) const {
+    kernels::gemv(mpA->numRows(), mpA->numCols(), mpA->data(), mpA->numCols(), x, y);
+}
+
+void DenseOperator::applyBlock(int s, const double* X, int ldx, double* Y, int ldy) const {
+    kernels::gemm(mpA->numRows(), s, mpA->numCols(), 1.0, mpA->data(), mpA->numCols(), X, ldx, 0.0, Y, ldy);
+}
+
+bool DenseOperator::hasDiagonal() const { return true; }
+
+void DenseOperator::diagonal(double* d) const {
+    int n = std::min(mpA->numRows(), mpA->numCols());
+    for (int i = 1; i <= n; ++i) {
+        d[i - 1] = (*mpA)(i, i);
+    }
+}
+
+bool DenseOperator::hasTranspose() const { return true; }
+
+void DenseOperator::applyTranspose(const double* x, double* y) const {
+    int m = mpA->numRows();
+    int n = mpA->numCols();
+    const double* a = mpA->data();
+    // Column panels in parallel, each sweeping all rows in order, so every
+    // y[j] is summed the same way for any thread count
+    parallelFor(0, n, TRANSPOSE_COL_GRAIN, [=](int j0, int j1) {
+        for (int j = j0; j < j1; ++j) {
+            y[j] = 0.0;
+        }
+        for (int i = 0; i < m; ++i) {
+            double xi = x[i];
+            const double* __restrict row = a + (size_t)i * n;
+            for (int j = j0; j < j1; ++j) {
+                y[j] += xi * row[j];
+            }
+        }
+    });
+}
+
+// SparseOperator
+SparseOperator::SparseOperator(const SparseMatrix* A) : mpA(A) {
+    if (A == nullptr) {
+        throw std::invalid_argument("Matrix cannot be null");
+    }
+}
+
+int SparseOperator::numRows() const { return mpA->numRows(); }
+int SparseOperator::numCols() const { return mpA->numCols(); }
+
+void SparseOperator::apply(const double* x, double* y) const {
+    mpA->multiply(x, y);
+}
+
+void SparseOperator::applyBlock(int s, const double* X, int ldx, double* Y, int ldy) const {
+    mpA->multiply(s, X, ldx, Y, ldy);
+}
+
+bool SparseOperator::hasDiagonal() const { return true; }
+
+void SparseOperator::diagonal(double* d) const {
+    std::vector<double> diag = mpA->diagonal();
+    std::copy(diag.begin(), diag.end(), d);
+}
+
+bool SparseOperator::hasTranspose() const { return true; }
+
+void SparseOperator::applyTranspose(const double* x, double* y) const {
+    const std::vector<int>& rowStart = mpA->rowStart();
+    const std::vector<int>& colIndex = mpA->colIndex();
+    const std::vector<double>& values = mpA->values();
+    for (int j = 0; j < mpA->numCols(); ++j) {
+        y[j] = 0.0;
+    }
+    for (int i = 0; i < mpA->numRows(); ++i) {
+        for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+            y[colIndex[k]] += values[k] * x[i];
+        }
+    }
+}
+
+// FunctionOperator
+FunctionOperator::FunctionOperator(int numRows, int numCols, ApplyFunction apply,
+                                   ApplyFunction applyTranspose,
+                                   const std::vector<double>& diagonal)
+    : mNumRows(numRows), mNumCols(numCols), mApply(apply),
+      mApplyTranspose(applyTranspose), mDiagonal(diagonal) {
+    if (!mApply) {
+        throw std::invalid_argument("Operator needs an apply function");
+    }
+    if (!mDiagonal.empty() && (int)mDiagonal.size() != std::min(numRows, numCols)) {
+        throw std::invalid_argument("Diagonal has the wrong length");
+    }
+}
+
+int FunctionOperator::numRows() const { return mNumRows; }
+int FunctionOperator::numCols() const { return mNumCols; }
+
+void FunctionOperator::apply(const double* x, double* y) const {
+    mApply(x, y);
+}
+
+bool FunctionOperator::hasDiagonal() const { return !mDiagonal.empty(); }
+
+void FunctionOperator::diagonal(double* d) const {
+    if (mDiagonal.empty()) {
+        LinearOperator::diagonal(d);
+    }
+    std::copy(mDiagonal.begin(), mDiagonal.end(), d);
+}
+
+bool FunctionOperator::hasTranspose() const { return static_cast<bool>(mApplyTranspose); }
+
+void FunctionOperator::applyTranspose(const double* x, double* y) const {
+    if (!mApplyTranspose) {
+        LinearOperator::applyTranspose(x, y);
+    }
+    mApplyTranspose(x, y);
+}
+
+// GramOperator
+GramOperator::GramOperator(const LinearOperator* A, double shift)
+    : mpA(A), mShift(shift), mWorkInUse(false) {
+    if (A == nullptr) {
+        throw std::invalid_argument("Operator cannot be null");
+    }
+    if (!A->hasTranspose()) {
+        throw std::invalid_argument("Gram operator needs a transpose product");
+    }
+    mWork.resize(A->numRows());
+}
+
+int GramOperator::numRows() const { return mpA->numCols(); }
+int GramOperator::numCols() const { return mpA->numCols(); }
+
+void GramOperator::apply(const double* x, double* y) const {
+    if (mWorkInUse.exchange(true, std::memory_order_acquire)) {
+        // Another thread is in apply(): work in a buffer of our own
+        std::vector<double> work(mpA->numRows());
+        mpA->apply(x, work.data());
+        mpA->applyTranspose(work.data(), y);
+    } else {
+        try {
+            mpA->apply(x, mWork.data());
+            mpA->applyTranspose(mWork.data(), y);
+        } catch (...) {
+            mWorkInUse.store(false, std::memory_order_release);
+            throw;
+        }
+        mWorkInUse.store(false, std::memory_order_release);
+    }
+    if (mShift != 0.0) {
+        kernels::axpy(mpA->numCols(), mShift, x, y);
+    }
+}
+
+bool GramOperator::hasTranspose() const { return true; }
+
+void GramOperator::applyTranspose(const double* x, double* y) const {
+    apply(x, y);
+}
@@ -1,8 +1,25 @@
 #include "LinearSystem.h"
+#include "Kernels.h"
+#include "Profiler.h"
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 using namespace std;
 
+// Factor LU = PA in place with the recursive blocked LU
+static void factorizeOrThrow(Matrix& LU, vector<int>& piv) {
+    int n = LU.numRows();
+    kernels::luFactor(n, n, LU.data(), n, piv.data());
+
+    // Check for singular matrix
+    for (int i = 1; i <= n; ++i) {
+        if (fabs(LU(i, i)) < 1e-10) {
+            throw runtime_error("Matrix is singular or nearly singular");
+        }
+    }
+}
+
 // Constructor
 LinearSystem::LinearSystem(Matrix* A, Vector* b) {
     if (A == nullptr || b == nullptr) {
@@ -19,101 +36,119 @@ LinearSystem::LinearSystem(Matrix* A, Vector* b) {
     
     mpA = A;
     mpb = b;
+    mpB = nullptr;
     mSize = A->numRows();
 }
 
-// Destructor
-LinearSystem::~LinearSystem() {}
-
-Vector LinearSystem::Solve() {
-    int n = mSize;
-    Matrix augmented(n, n + 1);
+// Constructor for several right-hand sides
+LinearSystem::LinearSystem(Matrix* A, Matrix* B) {
+    if (A == nullptr || B == nullptr) {
+        throw invalid_argument("Matrix and right-hand sides cannot be null");
+    }
 
-    // Fill the augmented matrix [A|b]
-    for (int i = 1; i <= n; ++i) {
-        for (int j = 1; j <= n; ++j) {
-            augmented(i, j) = (*mpA)(i, j);
-        }
-        augmented(i, n + 1) = (*mpb)(i);
+    if (A->numRows() != A->numCols()) {
+        throw invalid_argument("Matrix is not square");
     }
 
-    // Print the initial augmented matrix for debugging
-    cout << "Initial augmented matrix:" << endl;
-    for (int i = 1; i <= n; ++i) {
-        for (int j = 1; j <= n+1; ++j) {
-            cout << augmented(i, j) << " ";
-        }
-        cout << endl;
+    if (A->numRows() != B->numRows()) {
+        throw invalid_argument("Matrix and right-hand side sizes do not match");
     }
 
-    // Forward elimination
-    for (int i = 1; i <= n; ++i) {
-        // Find pivot with largest absolute value
-        int maxRow = i;
-        for (int k = i + 1; k <= n; ++k) {
-            if (fabs(augmented(k, i)) > fabs(augmented(maxRow, i))) {
-                maxRow = k;
-            }
-        }
-        
-        // Swap rows if needed
-        if (maxRow != i) {
-            for (int j = 1; j <= n + 1; ++j) {
-                double temp = augmented(i, j);
-                augmented(i, j) = augmented(maxRow, j);
-                augmented(maxRow, j) = temp;
-            }
-        }
-        
-        // Check for singular matrix
-        if (fabs(augmented(i, i)) < 1e-10) {
-            throw runtime_error("Matrix is singular or nearly singular");
-        }
+    mpA = A;
+    mpb = nullptr;
+    mpB = B;
+    mSize = A->numRows();
+}
 
-        // Elimination
-        for (int k = i + 1; k <= n; ++k) {
-            double factor = augmented(k, i) / augmented(i, i);
-            for (int j = i; j <= n + 1; ++j) {
-                augmented(k, j) -= factor * augmented(i, j);
-            }
-        }
+// Constructor for operator-based systems
+LinearSystem::LinearSystem(int size, Vector* b) {
+    if (b == nullptr) {
+        throw invalid_argument("Vector cannot be null");
     }
 
-    // Print the matrix after elimination for debugging
-    cout << "Matrix after elimination:" << endl;
-    for (int i = 1; i <= n; ++i) {
-        for (int j = 1; j <= n+1; ++j) {
-            cout << augmented(i, j) << " ";
-        }
-        cout << endl;
+    if (size != b->size()) {
+        throw invalid_argument("Matrix and vector sizes do not match");
     }
 
-    // Back substitution
-    Vector solution(n);
-    for (int i = n; i >= 1; --i) {
-        double sum = 0.0;
-        for (int j = i + 1; j <= n; ++j) {
-            sum += augmented(i, j) * solution(j);
-        }
-        solution(i) = (augmented(i, n + 1) - sum) / augmented(i, i);
-        
-        // Print each step of back substitution for debugging
-        cout << "Set solution(" << i << ") = (" << augmented(i, n + 1) 
-             << " - " << sum << ") / " << augmented(i, i) 
-             << " = " << solution(i) << endl;
+    mpA = nullptr;
+    mpb = b;
+    mpB = nullptr;
+    mSize = size;
+}
+
+LinearSystem::LinearSystem(int size, Matrix* B) {
+    if (B == nullptr) {
+        throw invalid_argument("Right-hand sides cannot be null");
     }
 
-    // Print final solution for debugging
-    cout << "Final solution: ";
-    for (int i = 1; i <= n; ++i) {
-        cout << solution(i) << " ";
+    if (size != B->numRows()) {
+        throw invalid_argument("Matrix and right-hand side sizes do not match");
     }
-    cout << endl;
 
+    mpA = nullptr;
+    mpb = nullptr;
+    mpB = B;
+    mSize = size;
+}
+
+// Destructor
+LinearSystem::~LinearSystem() {}
+
+Vector LinearSystem::Solve() {
+    if (mpb == nullptr) {
+        throw logic_error("System has no right-hand side vector, use SolveMultiple()");
+    }
+    PROFILE_SCOPE("LU solve");
+
+    int n = mSize;
+    Matrix LU(*mpA);
+    vector<int> piv(n);
+    factorizeOrThrow(LU, piv);
+
+    // Solve in place in a copy of b
+    Vector solution(*mpb);
+    kernels::luSolve(n, 1, LU.data(), n, piv.data(), solution.data(), 1);
     return solution;
 }
 
+Matrix LinearSystem::SolveMultiple() {
+    PROFILE_SCOPE("LU solve multiple");
+    int n = mSize;
+    Matrix LU(*mpA);
+    vector<int> piv(n);
+    factorizeOrThrow(LU, piv);
+
+    // Permute the right-hand sides, then solve LY = PB and UX = Y
+    Matrix X = RhsMatrix();
+    kernels::swapRows(X.view(), 0, n, piv.data());
+    ForwardSubstitution(LU, X, true);
+    BackSubstitution(LU, X);
+
+    return X;
+}
+
+Matrix LinearSystem::RhsMatrix() const {
+    if (mpB != nullptr) {
+        return *mpB;
+    }
+
+    Matrix B(mSize, 1);
+    for (int i = 1; i <= mSize; ++i) {
+        B(i, 1) = (*mpb)(i);
+    }
+    return B;
+}
+
+void LinearSystem::ForwardSubstitution(const Matrix& L, Matrix& X, bool unitDiagonal) {
+    kernels::trsmLower(L.view(), unitDiagonal, X.view());
+}
+
+void LinearSystem::BackSubstitution(const Matrix& U, Matrix& X) {
+    kernels::trsmUpper(U.view(), X.view());
+}
+
 // Accessor methods
 int LinearSystem::Size() const { return mSize; }
 Matrix* LinearSystem::GetMatrix() const { return mpA; }
 Vector* LinearSystem::GetVector() const { return mpb; }
+Matrix* LinearSystem::GetRhsMatrix() const { return mpB; }
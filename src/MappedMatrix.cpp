@@ -0,0 +1,459 @@
+#include "MappedMatrix.h"
+#include "Kernels.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Payload starts on a page boundary so the mapped doubles are page aligned
+static const int64_t PAYLOAD_OFFSET = 4096;
+
+// Bytes of a row-major A handled per streaming step of the out-of-core products
+static size_t gStreamPanelBytes = (size_t)32 << 20;
+
+// Rows per parallel chunk of the streamed GEMV
+static const int GEMV_ROW_GRAIN = 256;
+
+static const char MAGIC[8] = {'T', 'I', 'N', 'I', 'M', 'A', 'T', '\0'};
+static const uint32_t VERSION = 1;
+
+static_assert(sizeof(MappedMatrix::FileHeader) == 64, "Matrix file header must be 64 bytes");
+
+static int64_t ceilDiv(int64_t a, int64_t b) {
+    return (a + b - 1) / b;
+}
+
+// Evaluated in double when validating a header read from disk, where the
+// product of untrusted dimensions may not fit in int64
+template <typename T = int64_t>
+static T payloadBytes(const MappedMatrix::FileHeader& h) {
+    if (h.layout == 0) {
+        return (T)h.numRows * (T)h.stride * (T)sizeof(double);
+    }
+    return (T)ceilDiv(h.numRows, h.stride) * (T)ceilDiv(h.numCols, h.stride) * (T)h.stride
+           * (T)h.stride * (T)sizeof(double);
+}
+
+static MappedMatrix::FileHeader makeHeader(int numRows, int numCols, MappedMatrix::Layout layout,
+                                           int tileSize) {
+    if (numRows <= 0 || numCols <= 0) {
+        throw std::invalid_argument("Matrix dimensions must be positive");
+    }
+    if (layout == MappedMatrix::Layout::Tiled && tileSize <= 0) {
+        throw std::invalid_argument("Tile size must be positive");
+    }
+    MappedMatrix::FileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.layout = (layout == MappedMatrix::Layout::RowMajor) ? 0 : 1;
+    h.numRows = numRows;
+    h.numCols = numCols;
+    h.stride = (layout == MappedMatrix::Layout::RowMajor) ? ceilDiv(numCols, 8) * 8 : tileSize;
+    h.payloadOffset = PAYLOAD_OFFSET;
+    return h;
+}
+
+static void checkHeader(const MappedMatrix::FileHeader& h, int64_t fileBytes) {
+    if (fileBytes < (int64_t)sizeof(h) || std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a matrix file");
+    }
+    if (h.version != VERSION || h.layout > 1) {
+        throw std::runtime_error("Unsupported matrix file version or layout");
+    }
+    // The counts are narrowed to int once the file is open
+    if (h.numRows < 1 || h.numRows > INT_MAX || h.numCols < 1 || h.numCols > INT_MAX
+        || h.stride < 1 || h.stride > INT_MAX) {
+        throw std::runtime_error("Matrix file dimensions are out of range");
+    }
+    if (h.payloadOffset < (int64_t)sizeof(h) || (h.layout == 0 && h.stride < h.numCols)
+        || (double)h.payloadOffset + payloadBytes<double>(h) > (double)fileBytes) {
+        throw std::runtime_error("Matrix file is corrupt or truncated");
+    }
+}
+
+static FILE* openForWriting(const std::string& path, const MappedMatrix::FileHeader& h) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) {
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+    std::vector<char> head(PAYLOAD_OFFSET, 0);
+    std::memcpy(head.data(), &h, sizeof(h));
+    if (std::fwrite(head.data(), 1, head.size(), f) != head.size()) {
+        std::fclose(f);
+        throw std::runtime_error("Cannot write " + path);
+    }
+    return f;
+}
+
+static void closeAfterWriting(FILE* f, const std::string& path) {
+    if (std::fclose(f) != 0) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+void MappedMatrix::write(const std::string& path, const Matrix& A, Layout layout, int tileSize) {
+    FileHeader h = makeHeader(A.numRows(), A.numCols(), layout, tileSize);
+    FILE* f = openForWriting(path, h);
+    bool ok = true;
+
+    if (layout == Layout::RowMajor) {
+        std::vector<double> row(h.stride, 0.0);
+        for (int i = 1; i <= A.numRows() && ok; ++i) {
+            ConstVectorView source = A.row(i);
+            std::copy(source.data(), source.data() + source.size(), row.begin());
+            ok = std::fwrite(row.data(), sizeof(double), row.size(), f) == row.size();
+        }
+    } else {
+        int T = tileSize;
+        std::vector<double> tileBuffer((size_t)T * T);
+        for (int r0 = 1; r0 <= A.numRows() && ok; r0 += T) {
+            int rows = std::min(T, A.numRows() - r0 + 1);
+            for (int c0 = 1; c0 <= A.numCols() && ok; c0 += T) {
+                int cols = std::min(T, A.numCols() - c0 + 1);
+                std::fill(tileBuffer.begin(), tileBuffer.end(), 0.0);
+                MatrixView(tileBuffer.data(), rows, cols, T).assign(A.block(r0, c0, rows, cols));
+                ok = std::fwrite(tileBuffer.data(), sizeof(double), tileBuffer.size(), f) == tileBuffer.size();
+            }
+        }
+    }
+
+    if (!ok) {
+        std::fclose(f);
+        throw std::runtime_error("Cannot write " + path);
+    }
+    closeAfterWriting(f, path);
+}
+
+void MappedMatrix::create(const std::string& path, int numRows, int numCols, Layout layout, int tileSize) {
+    FileHeader h = makeHeader(numRows, numCols, layout, tileSize);
+    FILE* f = openForWriting(path, h);
+    closeAfterWriting(f, path);
+
+    // Extend to the full size; on most file systems the payload stays sparse
+    int64_t total = h.payloadOffset + payloadBytes(h);
+#ifdef _WIN32
+    FILE* g = std::fopen(path.c_str(), "r+b");
+    bool ok = g != nullptr && _fseeki64(g, total - 1, SEEK_SET) == 0 && std::fputc(0, g) != EOF;
+    if (g != nullptr) std::fclose(g);
+    if (!ok) {
+        throw std::runtime_error("Cannot extend " + path);
+    }
+#else
+    if (truncate(path.c_str(), (off_t)total) != 0) {
+        throw std::runtime_error("Cannot extend " + path + ": " + std::strerror(errno));
+    }
+#endif
+}
+
+MappedMatrix::MappedMatrix(const std::string& path, Mode mode)
+    : mNumRows(0), mNumCols(0), mLayout(Layout::RowMajor), mStride(0), mMode(mode),
+      mBase(nullptr), mMappedBytes(0), mData(nullptr) {
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    int64_t fileBytes = (int64_t)in.tellg();
+    in.seekg(0);
+    mBase = new char[(size_t)std::max<int64_t>(fileBytes, 1)];
+    mMappedBytes = (size_t)fileBytes;
+    if (!in.read(mBase, fileBytes)) {
+        delete[] mBase;
+        throw std::runtime_error("Cannot read " + path);
+    }
+    mPath = path;
+#else
+    int fd = open(path.c_str(), mode == Mode::ReadWrite ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        throw std::runtime_error("Not a matrix file");
+    }
+    int64_t fileBytes = st.st_size;
+    int prot = (mode == Mode::ReadOnly) ? PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = (mode == Mode::CopyOnWrite) ? MAP_PRIVATE : MAP_SHARED;
+    void* base = mmap(nullptr, (size_t)fileBytes, prot, flags, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("Cannot map " + path + ": " + std::strerror(errno));
+    }
+    mBase = static_cast<char*>(base);
+    mMappedBytes = (size_t)fileBytes;
+#endif
+
+    FileHeader h;
+    std::memcpy(&h, mBase, std::min(sizeof(h), mMappedBytes));
+    try {
+        checkHeader(h, fileBytes);
+    } catch (...) {
+#ifdef _WIN32
+        delete[] mBase;
+#else
+        munmap(mBase, mMappedBytes);
+#endif
+        throw;
+    }
+    mNumRows = (int)h.numRows;
+    mNumCols = (int)h.numCols;
+    mLayout = (h.layout == 0) ? Layout::RowMajor : Layout::Tiled;
+    mStride = (int)h.stride;
+    mData = reinterpret_cast<double*>(mBase + h.payloadOffset);
+}
+
+MappedMatrix::~MappedMatrix() {
+#ifdef _WIN32
+    if (mMode == Mode::ReadWrite) {
+        try { flush(); } catch (...) {}
+    }
+    delete[] mBase;
+#else
+    munmap(mBase, mMappedBytes);
+#endif
+}
+
+int MappedMatrix::numRows() const { return mNumRows; }
+int MappedMatrix::numCols() const { return mNumCols; }
+MappedMatrix::Layout MappedMatrix::layout() const { return mLayout; }
+MappedMatrix::Mode MappedMatrix::mode() const { return mMode; }
+int MappedMatrix::tileSize() const { return mLayout == Layout::Tiled ? mStride : 0; }
+
+int MappedMatrix::numTileRows() const {
+    return mLayout == Layout::Tiled ? (int)ceilDiv(mNumRows, mStride) : 0;
+}
+
+int MappedMatrix::numTileCols() const {
+    return mLayout == Layout::Tiled ? (int)ceilDiv(mNumCols, mStride) : 0;
+}
+
+const double* MappedMatrix::tileData(int ti, int tj) const {
+    size_t tileDoubles = (size_t)mStride * mStride;
+    return mData + ((size_t)(ti - 1) * numTileCols() + (tj - 1)) * tileDoubles;
+}
+
+double MappedMatrix::operator()(int i, int j) const {
+    assert(i >= 1 && i <= mNumRows);
+    assert(j >= 1 && j <= mNumCols);
+    if (mLayout == Layout::RowMajor) {
+        return mData[(size_t)(i - 1) * mStride + (j - 1)];
+    }
+    int T = mStride;
+    const double* t = tileData((i - 1) / T + 1, (j - 1) / T + 1);
+    return t[(size_t)((i - 1) % T) * T + (j - 1) % T];
+}
+
+ConstMatrixView MappedMatrix::view() const {
+    if (mLayout != Layout::RowMajor) {
+        throw std::logic_error("Only row-major matrix files can be viewed as a whole");
+    }
+    return ConstMatrixView(mData, mNumRows, mNumCols, mStride);
+}
+
+ConstMatrixView MappedMatrix::tile(int ti, int tj) const {
+    if (mLayout != Layout::Tiled) {
+        throw std::logic_error("Matrix file is not tiled");
+    }
+    assert(ti >= 1 && ti <= numTileRows());
+    assert(tj >= 1 && tj <= numTileCols());
+    int rows = std::min(mStride, mNumRows - (ti - 1) * mStride);
+    int cols = std::min(mStride, mNumCols - (tj - 1) * mStride);
+    return ConstMatrixView(tileData(ti, tj), rows, cols, mStride);
+}
+
+static void requireWritable(MappedMatrix::Mode mode) {
+    if (mode == MappedMatrix::Mode::ReadOnly) {
+        throw std::logic_error("Matrix file is mapped read-only");
+    }
+}
+
+void MappedMatrix::set(int i, int j, double value) {
+    requireWritable(mMode);
+    assert(i >= 1 && i <= mNumRows);
+    assert(j >= 1 && j <= mNumCols);
+    if (mLayout == Layout::RowMajor) {
+        mData[(size_t)(i - 1) * mStride + (j - 1)] = value;
+        return;
+    }
+    int T = mStride;
+    double* t = const_cast<double*>(tileData((i - 1) / T + 1, (j - 1) / T + 1));
+    t[(size_t)((i - 1) % T) * T + (j - 1) % T] = value;
+}
+
+MatrixView MappedMatrix::writableView() {
+    requireWritable(mMode);
+    ConstMatrixView v = view();
+    return MatrixView(mData, v.numRows(), v.numCols(), v.ld());
+}
+
+MatrixView MappedMatrix::writableTile(int ti, int tj) {
+    requireWritable(mMode);
+    ConstMatrixView t = tile(ti, tj);
+    return MatrixView(const_cast<double*>(t.data()), t.numRows(), t.numCols(), t.ld());
+}
+
+Matrix MappedMatrix::toMatrix() const {
+    Matrix result(mNumRows, mNumCols);
+    if (mLayout == Layout::RowMajor) {
+        result.view().assign(view());
+        return result;
+    }
+    for (int ti = 1; ti <= numTileRows(); ++ti) {
+        for (int tj = 1; tj <= numTileCols(); ++tj) {
+            ConstMatrixView t = tile(ti, tj);
+            result.block((ti - 1) * mStride + 1, (tj - 1) * mStride + 1, t.numRows(), t.numCols()).assign(t);
+        }
+    }
+    return result;
+}
+
+void MappedMatrix::advise(const double* begin, size_t bytes, bool willNeed) const {
+#ifdef _WIN32
+    (void)begin; (void)bytes; (void)willNeed;
+#else
+    if (bytes == 0) return;
+    // Dropping pages of a private mapping would discard copy-on-write changes
+    if (!willNeed && mMode == Mode::CopyOnWrite) return;
+
+    static const uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = reinterpret_cast<uintptr_t>(begin) & ~(pageSize - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(begin) + bytes;
+    madvise(reinterpret_cast<void*>(start), end - start, willNeed ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+}
+
+void MappedMatrix::multiply(const double* x, double* y) const {
+    if (mLayout == Layout::RowMajor) {
+        size_t rowBytes = (size_t)mStride * sizeof(double);
+        int panelRows = (int)std::max<size_t>(1, gStreamPanelBytes / rowBytes);
+        advise(mData, (size_t)std::min(panelRows, mNumRows) * rowBytes, true);
+        for (int r0 = 0; r0 < mNumRows; r0 += panelRows) {
+            int rows = std::min(panelRows, mNumRows - r0);
+            const double* panel = mData + (size_t)r0 * mStride;
+            if (r0 + rows < mNumRows) {
+                int nextRows = std::min(panelRows, mNumRows - r0 - rows);
+                advise(panel + (size_t)rows * mStride, (size_t)nextRows * rowBytes, true);
+            }
+            parallelFor(0, rows, GEMV_ROW_GRAIN, [&](int i0, int i1) {
+                kernels::gemv(i1 - i0, mNumCols, panel + (size_t)i0 * mStride, mStride, x, y + r0 + i0);
+            });
+            advise(panel, (size_t)rows * rowBytes, false);
+        }
+        return;
+    }
+
+    int T = mStride;
+    size_t tileRowBytes = (size_t)numTileCols() * T * T * sizeof(double);
+    std::vector<double> partial(T);
+    advise(tileData(1, 1), tileRowBytes, true);
+    for (int ti = 1; ti <= numTileRows(); ++ti) {
+        if (ti < numTileRows()) {
+            advise(tileData(ti + 1, 1), tileRowBytes, true);
+        }
+        int r0 = (ti - 1) * T;
+        int rows = std::min(T, mNumRows - r0);
+        std::fill(y + r0, y + r0 + rows, 0.0);
+        for (int tj = 1; tj <= numTileCols(); ++tj) {
+            ConstMatrixView t = tile(ti, tj);
+            kernels::gemv(t.numRows(), t.numCols(), t.data(), t.ld(), x + (tj - 1) * T, partial.data());
+            kernels::axpy(rows, 1.0, partial.data(), y + r0);
+        }
+        advise(tileData(ti, 1), tileRowBytes, false);
+    }
+}
+
+void MappedMatrix::multiply(ConstMatrixView B, MatrixView C) const {
+    if (B.numRows() != mNumCols || C.numRows() != mNumRows || C.numCols() != B.numCols()) {
+        throw std::invalid_argument("Matrix dimensions do not match for multiplication.");
+    }
+    int n = B.numCols();
+
+    if (mLayout == Layout::RowMajor) {
+        size_t rowBytes = (size_t)mStride * sizeof(double);
+        int panelRows = (int)std::max<size_t>(1, gStreamPanelBytes / rowBytes);
+        advise(mData, (size_t)std::min(panelRows, mNumRows) * rowBytes, true);
+        for (int r0 = 0; r0 < mNumRows; r0 += panelRows) {
+            int rows = std::min(panelRows, mNumRows - r0);
+            const double* panel = mData + (size_t)r0 * mStride;
+            if (r0 + rows < mNumRows) {
+                int nextRows = std::min(panelRows, mNumRows - r0 - rows);
+                advise(panel + (size_t)rows * mStride, (size_t)nextRows * rowBytes, true);
+            }
+            kernels::gemm(rows, n, mNumCols, 1.0, panel, mStride, B.data(), B.ld(), 0.0,
+                          C.data() + (size_t)r0 * C.ld(), C.ld());
+            advise(panel, (size_t)rows * rowBytes, false);
+        }
+        return;
+    }
+
+    int T = mStride;
+    size_t tileRowBytes = (size_t)numTileCols() * T * T * sizeof(double);
+    advise(tileData(1, 1), tileRowBytes, true);
+    for (int ti = 1; ti <= numTileRows(); ++ti) {
+        if (ti < numTileRows()) {
+            advise(tileData(ti + 1, 1), tileRowBytes, true);
+        }
+        int r0 = (ti - 1) * T;
+        for (int tj = 1; tj <= numTileCols(); ++tj) {
+            ConstMatrixView t = tile(ti, tj);
+            kernels::gemm(1.0, t, B.block((tj - 1) * T + 1, 1, t.numCols(), n),
+                          tj == 1 ? 0.0 : 1.0, C.block(r0 + 1, 1, t.numRows(), n));
+        }
+        advise(tileData(ti, 1), tileRowBytes, false);
+    }
+}
+
+void MappedMatrix::setStreamPanelBytes(size_t bytes) {
+    gStreamPanelBytes = std::max<size_t>(bytes, 1);
+}
+
+size_t MappedMatrix::streamPanelBytes() {
+    return gStreamPanelBytes;
+}
+
+Vector MappedMatrix::operator*(Vector& v) const {
+    if (v.size() != mNumCols) {
+        throw std::invalid_argument("Matrix and vector dimensions do not match for multiplication.");
+    }
+    Vector result(mNumRows);
+    multiply(v.data(), result.data());
+    return result;
+}
+
+Matrix MappedMatrix::operator*(const Matrix& B) const {
+    Matrix C(mNumRows, B.numCols());
+    multiply(B.view(), C.view());
+    return C;
+}
+
+void MappedMatrix::flush() {
+    if (mMode != Mode::ReadWrite) {
+        return;
+    }
+#ifdef _WIN32
+    std::ofstream out(mPath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!out.write(mBase, (std::streamsize)mMappedBytes)) {
+        throw std::runtime_error("Cannot write " + mPath);
+    }
+#else
+    if (msync(mBase, mMappedBytes, MS_SYNC) != 0) {
+        throw std::runtime_error(std::string("Cannot flush matrix file: ") + std::strerror(errno));
+    }
+#endif
+}
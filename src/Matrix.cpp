@@ -1,39 +1,40 @@
 #include "Matrix.h"
 #include "Vector.h"
+#include "Kernels.h"
+#include "AllocationTracker.h"
+#include "Profiler.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <cmath>
 #include <stdexcept> 
+#include <vector>
 
 const double threshold = 1e-9;
 
+// Strassen-Winograd crossover used by operator*, 0 when disabled
+static int gStrassenCrossover = 0;
+
 Matrix::Matrix(const Matrix& other) : mNumRows(other.mNumRows), mNumCols(other.mNumCols) {
     assert(mNumRows > 0 && mNumCols > 0);
-    mData = new double*[mNumRows];
-    for (int i = 0; i < mNumRows; ++i) {
-        mData[i] = new double[mNumCols];
-        for (int j = 0; j < mNumCols; ++j) {
-            mData[i][j] = other.mData[i][j];
-        }
-    }
+    mData = allocation::allocate(allocation::Kind::Matrix, (size_t)mNumRows * mNumCols, false);
+    std::copy(other.mData, other.mData + (size_t)mNumRows * mNumCols, mData);
 }
 
 Matrix::Matrix(int numRows, int numCols) : mNumRows(numRows), mNumCols(numCols) {
-    mData = new double*[mNumRows];
-    for (int i = 0; i < mNumRows; ++i) {
-        mData[i] = new double[mNumCols](); // initialize to zero --> double[...]() --> 0.0
-    }
+    mData = allocation::allocate(allocation::Kind::Matrix, (size_t)mNumRows * mNumCols, true);
+}
+
+Matrix::Matrix(ConstMatrixView view) : mNumRows(view.numRows()), mNumCols(view.numCols()) {
+    assert(mNumRows > 0 && mNumCols > 0);
+    mData = allocation::allocate(allocation::Kind::Matrix, (size_t)mNumRows * mNumCols, false);
+    this->view().assign(view);
 }
 
 
 Matrix::~Matrix() {
-    if (mData != nullptr) {
-        for (int i = 0; i < mNumRows; ++i) {
-            delete[] mData[i];
-        }
-        delete[] mData;
-        mData = nullptr;
-    }
+    allocation::release(allocation::Kind::Matrix, mData, (size_t)mNumRows * mNumCols);
+    mData = nullptr;
 }
 
 int Matrix::numRows() const {
@@ -44,43 +45,62 @@ int Matrix::numCols() const {
     return mNumCols;
 }
 
+double* Matrix::data() {
+    return mData;
+}
+
+const double* Matrix::data() const {
+    return mData;
+}
+
+
+MatrixView Matrix::view() {
+    return MatrixView(mData, mNumRows, mNumCols, mNumCols);
+}
+
+ConstMatrixView Matrix::view() const {
+    return ConstMatrixView(mData, mNumRows, mNumCols, mNumCols);
+}
+
+MatrixView Matrix::block(int i, int j, int rows, int cols) {
+    return view().block(i, j, rows, cols);
+}
+
+ConstMatrixView Matrix::block(int i, int j, int rows, int cols) const {
+    return view().block(i, j, rows, cols);
+}
 
-double& Matrix::operator()(int i, int j) {
-    assert(i >= 1 && i <= mNumRows);
-    assert(j >= 1 && j <= mNumCols);
-    return mData[i - 1][j - 1];
+VectorView Matrix::row(int i) {
+    return view().row(i);
 }
 
-double Matrix::operator()(int i, int j) const {
-    assert(i >= 1 && i <= mNumRows);
-    assert(j >= 1 && j <= mNumCols);
-    return mData[i - 1][j - 1];
+ConstVectorView Matrix::row(int i) const {
+    return view().row(i);
+}
+
+VectorView Matrix::col(int j) {
+    return view().col(j);
+}
+
+ConstVectorView Matrix::col(int j) const {
+    return view().col(j);
 }
 
 Matrix& Matrix::operator=(const Matrix& other) {
     if (this != &other) {
-        // Deallocate existing memory
-        for (int i = 0; i < mNumRows; ++i) {
-            delete[] mData[i];
+        // Reallocate only when the number of elements changes
+        size_t size = (size_t)other.mNumRows * other.mNumCols;
+        if (size != (size_t)mNumRows * mNumCols) {
+            allocation::release(allocation::Kind::Matrix, mData, (size_t)mNumRows * mNumCols);
+            mData = allocation::allocate(allocation::Kind::Matrix, size, false);
         }
-        delete[] mData;
 
         // Copy dimensions
         mNumRows = other.mNumRows;
         mNumCols = other.mNumCols;
 
-        // Allocate new memory
-        mData = new double*[mNumRows];
-        for (int i = 0; i < mNumRows; ++i) {
-            mData[i] = new double[mNumCols];
-        }
-
         // Copy data
-        for (int i = 0; i < mNumRows; ++i) {
-            for (int j = 0; j < mNumCols; ++j) {
-                mData[i][j] = other.mData[i][j];
-            }
-        }
+        std::copy(other.mData, other.mData + size, mData);
     }
     return *this;
 }
@@ -129,34 +149,41 @@ Vector Matrix::operator*(Vector& v) const {
     }
     
     Vector result(mNumRows);
-    
-    for (int i = 1; i <= mNumRows; i++) {
-        double sum = 0.0;
-        for (int j = 1; j <= mNumCols; j++) {
-            sum += (*this)(i, j) * v(j);
-        }
-        result(i) = sum;
-    }
-    
+    kernels::gemv(mNumRows, mNumCols, mData, mNumCols, v.data(), result.data());
     return result;
 }
 
 Matrix Matrix::operator*(const Matrix& other) const {
     assert(mNumCols == other.mNumRows);
+    if (gStrassenCrossover > 0 && mNumRows > gStrassenCrossover &&
+        mNumCols > gStrassenCrossover && other.mNumCols > gStrassenCrossover) {
+        return strassenProduct(other, gStrassenCrossover);
+    }
+
     Matrix newMatrix(mNumRows, other.mNumCols);
 
-    for(int i = 1; i <= mNumRows; i++) {
-        for(int j = 1; j <= other.mNumCols; j++) {
-            double temp = 0.0;
-            for(int k = 1; k <= mNumCols; k++) {
-                temp += (*this)(i, k) * other(k, j);
-            }
-            newMatrix(i, j) = temp;
-        }
-    }
+    kernels::gemm(mNumRows, other.mNumCols, mNumCols, 1.0, mData, mNumCols,
+                  other.mData, other.mNumCols, 0.0, newMatrix.mData, other.mNumCols);
+    return newMatrix;
+}
+
+Matrix Matrix::strassenProduct(const Matrix& other, int crossover) const {
+    assert(mNumCols == other.mNumRows);
+    Matrix newMatrix(mNumRows, other.mNumCols);
+
+    kernels::strassen(mNumRows, other.mNumCols, mNumCols, mData, mNumCols,
+                      other.mData, other.mNumCols, newMatrix.mData, other.mNumCols, crossover);
     return newMatrix;
 }
 
+void Matrix::setStrassenCrossover(int crossover) {
+    gStrassenCrossover = crossover > 0 ? crossover : 0;
+}
+
+int Matrix::strassenCrossover() {
+    return gStrassenCrossover;
+}
+
 Matrix Matrix::operator*(double scalar) const {
     Matrix result(*this);
     for(int i = 1; i <= mNumRows; i++) {
@@ -168,144 +195,69 @@ Matrix Matrix::operator*(double scalar) const {
 }
 
 double Matrix::determinant() const {
+    PROFILE_SCOPE("determinant");
     assert(mNumCols == mNumRows);
     int n = mNumCols;
 
-    double** matrix = new double*[n];
-    for(int i = 0; i < n; i++) {
-        matrix[i] = new double[n];
-        for(int j = 0; j < n; j++) {
-            matrix[i][j] = mData[i][j];
-        }
-    }
+    Matrix LU(*this);
+    std::vector<int> piv(n);
+    kernels::luFactor(n, n, LU.mData, n, piv.data());
 
-    int swapCount = 0;
+    // det(A) = det(P)⁻¹ * prod(U(i,i)), each row swap flips the sign
+    double det = 1.0;
     for (int i = 0; i < n; ++i) {
-        int pivotRow = i;
-
-        // Find the maximum element in the current column
-        for (int j = i + 1; j < n; ++j) {
-            if (fabs(matrix[j][i]) > fabs(matrix[pivotRow][i])) {
-                pivotRow = j;
-            }
-        }
-
-        if (fabs(matrix[pivotRow][i]) < threshold) {
-            // Free memory before returning 0 to prevent memory leak
-            for(int k = 0; k < n; k++) {
-                delete[] matrix[k];
-            }
-            delete[] matrix;
+        double pivot = LU.mData[(size_t)i * n + i];
+        if (fabs(pivot) < threshold) {
             return 0;
         }
-
-        // Swap rows if necessary
-        if (i != pivotRow) {
-            for(int k = 0; k < n; k++) {
-                double temp = matrix[i][k];
-                matrix[i][k] = matrix[pivotRow][k];
-                matrix[pivotRow][k] = temp;
-            }
-            swapCount++;
-        }
-
-        // Gaussian elimination
-        for (int j = i + 1; j < n; ++j) {
-            double factor = matrix[j][i] / matrix[i][i];
-            for (int k = i; k < n; ++k) {
-                matrix[j][k] -= factor * matrix[i][k];
-            }
-        }
-    }
-
-    // Calculate determinant
-    double det = (swapCount % 2 == 0) ? 1 : -1;
-    for (int i = 0; i < n; ++i) {
-        det *= matrix[i][i];
+        det *= (piv[i] != i) ? -pivot : pivot;
     }
 
-    for(int i = 0; i < n; i++) {
-        delete[] matrix[i];
-    }
-    delete[] matrix;
-
     return det;
 }
 
 
 Matrix Matrix::inverse() const {
+    PROFILE_SCOPE("inverse");
     assert(mNumCols == mNumRows); // Ensure it's a square matrix
     int n = mNumRows;
 
-    // Check if matrix is invertible
-    if (fabs(determinant()) < threshold) {
-        throw std::runtime_error("Matrix is not invertible.");
-    }
-
-    Matrix augmented(n, 2*n);
-
-    // Populate augmented matrix
-    for(int i = 0; i < n; i++) {
-        for(int j = 0; j < n; j++) {
-            augmented(i+1,j+1) = mData[i][j];
-        }
-        augmented(i+1,i+n+1) = 1.0; // Identity part
-    }
-
-    // Gauss-Jordan elimination
-    for(int i = 0; i < n; i++) {
-        int pivotRow = i;
-        for(int j = i + 1; j < n; j++) {
-            if(fabs(augmented(j+1,i+1)) > fabs(augmented(pivotRow+1,i+1))) {
-                pivotRow = j;
-            }
-        }
-
-        if(pivotRow != i) {
-            for(int j = 0; j < 2*n; j++) {
-                double temp = augmented(i+1,j+1);
-                augmented(i+1,j+1) = augmented(pivotRow+1,j+1);
-                augmented(pivotRow+1,j+1) = temp;
-            }
-        }
+    Matrix LU(*this);
+    std::vector<int> piv(n);
+    kernels::luFactor(n, n, LU.mData, n, piv.data());
 
-        double pivot = augmented(i+1,i+1);
+    // Check if matrix is invertible (same test as determinant())
+    double det = 1.0;
+    for (int i = 0; i < n; ++i) {
+        double pivot = LU.mData[(size_t)i * n + i];
         if (fabs(pivot) < threshold) {
-             throw std::runtime_error("Zero pivot during inverse calculation. Matrix is singular.");
-        }
-
-        for(int j = 0; j < 2*n; j++) {
-            augmented(i+1,j+1) /= pivot;
-        }
-
-        // Eliminate column (make other elements in the column zero)
-        for(int j = 0; j < n; j++) {
-            if(j != i) { // Exclude the pivot row
-                double factor = augmented(j+1,i+1);
-                for(int k = 0; k < 2*n; k++) {
-                    augmented(j+1,k+1) -= factor * augmented(i+1,k+1);
-                }
-            }
+            det = 0.0;
+            break;
         }
+        det *= pivot;
+    }
+    if (fabs(det) < threshold) {
+        throw std::runtime_error("Matrix is not invertible.");
     }
 
+    // Solve A X = I column block by column block
     Matrix inverse(n, n);
-    for(int i = 0; i < n; i++) {
-        for(int j = 0; j < n; j++) {
-            inverse(i+1,j+1) = augmented(i+1,j+n+1); // Extract the inverse part
-        }
+    for (int i = 0; i < n; i++) {
+        inverse.mData[(size_t)i * n + i] = 1.0;
     }
+    kernels::luSolve(n, n, LU.mData, n, piv.data(), inverse.mData, n);
 
     return inverse;
 }
 
 Matrix Matrix::pseudoInverse() const {
+    PROFILE_SCOPE("pseudoInverse");
 
     Matrix transpose(mNumCols, mNumRows);
     // Create transpose
     for(int i = 0; i < mNumRows; i++) {
         for(int j = 0; j < mNumCols; j++) {
-            transpose(j+1,i+1) = mData[i][j];
+            transpose(j+1,i+1) = mData[(size_t)i * mNumCols + j];
         }
     }
 
@@ -0,0 +1,397 @@
+#include "MatrixMarket.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace matrixmarket {
+
+// Smallest chunk of the data section parsed by one task
+static const size_t PARSE_CHUNK_BYTES = (size_t)1 << 20;
+
+struct ParsedFile {
+    Header header;
+    std::string text;
+    size_t dataBegin;          // offset of the first entry line
+};
+
+static std::string lowercase(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return s;
+}
+
+static void fail(const std::string& path, const std::string& what) {
+    throw std::runtime_error("Matrix Market file " + path + ": " + what);
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    std::string text((size_t)in.tellg(), '\0');
+    in.seekg(0);
+    if (!in.read(&text[0], (std::streamsize)text.size())) {
+        throw std::runtime_error("Cannot read " + path);
+    }
+    return text;
+}
+
+// Banner, comments and the size line
+static Header parseHeader(const std::string& path, const std::string& text, size_t& pos) {
+    size_t lineEnd = text.find('\n');
+    std::istringstream banner(text.substr(0, lineEnd));
+    std::string tag, object, format, field, symmetry;
+    banner >> tag >> object >> format >> field >> symmetry;
+    if (tag != "%%MatrixMarket" || lowercase(object) != "matrix") {
+        fail(path, "missing %%MatrixMarket matrix banner");
+    }
+
+    Header h;
+    format = lowercase(format);
+    field = lowercase(field);
+    symmetry = lowercase(symmetry);
+    if (format == "coordinate") h.format = Format::Coordinate;
+    else if (format == "array") h.format = Format::Array;
+    else fail(path, "unknown format '" + format + "'");
+
+    if (field == "real" || field == "double") h.field = Field::Real;
+    else if (field == "integer") h.field = Field::Integer;
+    else if (field == "pattern" && h.format == Format::Coordinate) h.field = Field::Pattern;
+    else fail(path, "unsupported field '" + field + "'");
+
+    if (symmetry == "general") h.symmetry = Symmetry::General;
+    else if (symmetry == "symmetric") h.symmetry = Symmetry::Symmetric;
+    else fail(path, "unsupported symmetry '" + symmetry + "'");
+
+    // Skip comments and blank lines up to the size line
+    pos = (lineEnd == std::string::npos) ? text.size() : lineEnd + 1;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) end = text.size();
+        size_t first = text.find_first_not_of(" \t\r", pos);
+        if (first < end && text[first] != '%') {
+            std::istringstream sizes(text.substr(pos, end - pos));
+            long long rows = 0, cols = 0, entries = 0;
+            sizes >> rows >> cols;
+            if (h.format == Format::Coordinate) {
+                sizes >> entries;
+            }
+            if (!sizes || rows <= 0 || cols <= 0 || entries < 0) {
+                fail(path, "malformed size line");
+            }
+            if (rows > INT_MAX || cols > INT_MAX) {
+                fail(path, "dimensions exceed the int range");
+            }
+            if (h.symmetry == Symmetry::Symmetric && rows != cols) {
+                fail(path, "symmetric matrix is not square");
+            }
+            // With int-sized dimensions the element count fits in long long
+            if (h.format == Format::Array) {
+                entries = (h.symmetry == Symmetry::Symmetric) ? rows * (rows + 1) / 2 : rows * cols;
+            }
+            h.numRows = (int)rows;
+            h.numCols = (int)cols;
+            h.numEntries = entries;
+            pos = std::min(end + 1, text.size());
+            return h;
+        }
+        pos = end + 1;
+    }
+    fail(path, "missing size line");
+    return h;
+}
+
+static ParsedFile openFile(const std::string& path) {
+    ParsedFile file;
+    file.text = readFile(path);
+    file.header = parseHeader(path, file.text, file.dataBegin);
+    return file;
+}
+
+Header readHeader(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    // The header is the banner, the comments and the size line
+    std::string text, line;
+    bool banner = true;
+    while (std::getline(in, line)) {
+        text += line;
+        text += '\n';
+        if (banner) {
+            banner = false;
+            continue;
+        }
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first != std::string::npos && line[first] != '%') break;
+    }
+    size_t pos = 0;
+    return parseHeader(path, text, pos);
+}
+
+static const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+static const char* parseNumber(const char* p, const char* end, int& value) {
+    p = skipBlanks(p, end);
+    std::from_chars_result r = std::from_chars(p, end, value);
+    return r.ec == std::errc() ? r.ptr : nullptr;
+}
+
+static const char* parseNumber(const char* p, const char* end, double& value) {
+    p = skipBlanks(p, end);
+    if (p < end && *p == '+') ++p;
+#if defined(__cpp_lib_to_chars)
+    std::from_chars_result r = std::from_chars(p, end, value);
+    return r.ec == std::errc() ? r.ptr : nullptr;
+#else
+    // strtod needs a terminated token
+    char token[64];
+    size_t n = 0;
+    while (p + n < end && n < sizeof(token) - 1 && p[n] != ' ' && p[n] != '\t' && p[n] != '\r' && p[n] != '\n') {
+        token[n] = p[n];
+        ++n;
+    }
+    token[n] = '\0';
+    char* stop = nullptr;
+    value = std::strtod(token, &stop);
+    return (n > 0 && stop == token + n) ? p + n : nullptr;
+#endif
+}
+
+// Chunks of the data section that start and end on line boundaries
+static std::vector<std::pair<size_t, size_t>> splitLines(const std::string& text, size_t begin) {
+    size_t bytes = text.size() - begin;
+    size_t target = std::max(PARSE_CHUNK_BYTES, bytes / (4 * (size_t)ThreadPool::instance().numThreads()) + 1);
+    std::vector<std::pair<size_t, size_t>> chunks;
+    size_t pos = begin;
+    while (pos < text.size()) {
+        size_t end = std::min(pos + target, text.size());
+        if (end < text.size()) {
+            end = text.find('\n', end);
+            end = (end == std::string::npos) ? text.size() : end + 1;
+        }
+        chunks.push_back(std::make_pair(pos, end));
+        pos = end;
+    }
+    return chunks;
+}
+
+// Parse every entry line of a chunk. Coordinate lines give row, col and
+// (unless pattern) a value; array lines give one value.
+static bool parseChunk(const Header& h, const char* p, const char* end,
+                       std::vector<SparseMatrix::Triplet>& triplets, std::vector<double>& values) {
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) lineEnd = end;
+        const char* q = skipBlanks(p, lineEnd);
+        if (q < lineEnd && *q != '%') {
+            if (h.format == Format::Coordinate) {
+                SparseMatrix::Triplet t;
+                t.value = 1.0;
+                q = parseNumber(q, lineEnd, t.row);
+                if (q != nullptr) q = parseNumber(q, lineEnd, t.col);
+                if (q != nullptr && h.field != Field::Pattern) q = parseNumber(q, lineEnd, t.value);
+                if (q == nullptr) return false;
+                triplets.push_back(t);
+            } else {
+                double value = 0.0;
+                q = parseNumber(q, lineEnd, value);
+                if (q == nullptr) return false;
+                values.push_back(value);
+            }
+            if (skipBlanks(q, lineEnd) != lineEnd) return false;
+        }
+        p = (lineEnd == end) ? end : lineEnd + 1;
+    }
+    return true;
+}
+
+// All entries of the file as one-based triplets, the stored triangle of
+// symmetric files mirrored
+static std::vector<SparseMatrix::Triplet> readEntries(const std::string& path, const ParsedFile& file) {
+    const Header& h = file.header;
+    std::vector<std::pair<size_t, size_t>> chunks = splitLines(file.text, file.dataBegin);
+    std::vector<std::vector<SparseMatrix::Triplet>> chunkTriplets(chunks.size());
+    std::vector<std::vector<double>> chunkValues(chunks.size());
+    std::vector<char> chunkOk(chunks.size(), 1);
+
+    parallelFor(0, (int)chunks.size(), 1, [&](int c0, int c1) {
+        for (int c = c0; c < c1; ++c) {
+            const char* base = file.text.data();
+            chunkOk[c] = parseChunk(h, base + chunks[c].first, base + chunks[c].second,
+                                    chunkTriplets[c], chunkValues[c]);
+        }
+    });
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (!chunkOk[c]) fail(path, "malformed entry line");
+    }
+
+    std::vector<SparseMatrix::Triplet> entries;
+    if (h.format == Format::Coordinate) {
+        size_t total = 0;
+        for (const auto& part : chunkTriplets) total += part.size();
+        if ((long long)total != h.numEntries) {
+            fail(path, "has " + std::to_string(total) + " entries, header says " + std::to_string(h.numEntries));
+        }
+        entries.reserve(h.symmetry == Symmetry::Symmetric ? 2 * total : total);
+        for (const auto& part : chunkTriplets) {
+            entries.insert(entries.end(), part.begin(), part.end());
+        }
+        for (const SparseMatrix::Triplet& t : entries) {
+            if (t.row < 1 || t.row > h.numRows || t.col < 1 || t.col > h.numCols) {
+                fail(path, "entry (" + std::to_string(t.row) + ", " + std::to_string(t.col) + ") out of range");
+            }
+            if (h.symmetry == Symmetry::Symmetric && t.col > t.row) {
+                fail(path, "symmetric file has an entry above the diagonal");
+            }
+        }
+    } else {
+        size_t total = 0;
+        for (const auto& part : chunkValues) total += part.size();
+        if ((long long)total != h.numEntries) {
+            fail(path, "has " + std::to_string(total) + " entries, header says " + std::to_string(h.numEntries));
+        }
+        // Column-major order; symmetric files hold the lower triangle column by column
+        entries.reserve(total);
+        int row = 1, col = 1;
+        for (const auto& part : chunkValues) {
+            for (double value : part) {
+                entries.push_back({row, col, value});
+                if (++row > h.numRows) {
+                    ++col;
+                    row = (h.symmetry == Symmetry::Symmetric) ? col : 1;
+                }
+            }
+        }
+    }
+
+    if (h.symmetry == Symmetry::Symmetric) {
+        size_t stored = entries.size();
+        for (size_t k = 0; k < stored; ++k) {
+            const SparseMatrix::Triplet t = entries[k];
+            if (t.row != t.col) entries.push_back({t.col, t.row, t.value});
+        }
+    }
+    return entries;
+}
+
+Matrix readDense(const std::string& path) {
+    ParsedFile file = openFile(path);
+    std::vector<SparseMatrix::Triplet> entries = readEntries(path, file);
+    Matrix A(file.header.numRows, file.header.numCols);
+    for (const SparseMatrix::Triplet& t : entries) {
+        A(t.row, t.col) += t.value;
+    }
+    return A;
+}
+
+SparseMatrix readSparse(const std::string& path) {
+    ParsedFile file = openFile(path);
+    std::vector<SparseMatrix::Triplet> entries = readEntries(path, file);
+    if (file.header.format == Format::Array) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const SparseMatrix::Triplet& t) { return t.value == 0.0; }),
+                      entries.end());
+    }
+    return SparseMatrix(file.header.numRows, file.header.numCols, entries);
+}
+
+// Appends the shortest round-trip text of value
+static void appendNumber(std::string& out, double value) {
+    char buffer[32];
+#if defined(__cpp_lib_to_chars)
+    std::to_chars_result r = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, r.ptr);
+#else
+    int n = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    out.append(buffer, n);
+#endif
+}
+
+static void appendNumber(std::string& out, int value) {
+    char buffer[16];
+    std::to_chars_result r = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, r.ptr);
+}
+
+static void writeText(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(text.data(), (std::streamsize)text.size())) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+static const char* symmetryName(Symmetry symmetry) {
+    return symmetry == Symmetry::Symmetric ? "symmetric" : "general";
+}
+
+void write(const std::string& path, const Matrix& A, Symmetry symmetry) {
+    int m = A.numRows();
+    int n = A.numCols();
+    if (symmetry == Symmetry::Symmetric && m != n) {
+        throw std::invalid_argument("Symmetric Matrix Market files need a square matrix");
+    }
+    std::string text = std::string("%%MatrixMarket matrix array real ") + symmetryName(symmetry) + "\n";
+    appendNumber(text, m);
+    text += ' ';
+    appendNumber(text, n);
+    text += '\n';
+    for (int j = 1; j <= n; ++j) {
+        for (int i = (symmetry == Symmetry::Symmetric ? j : 1); i <= m; ++i) {
+            appendNumber(text, A(i, j));
+            text += '\n';
+        }
+    }
+    writeText(path, text);
+}
+
+void write(const std::string& path, const SparseMatrix& A, Symmetry symmetry) {
+    if (symmetry == Symmetry::Symmetric && A.numRows() != A.numCols()) {
+        throw std::invalid_argument("Symmetric Matrix Market files need a square matrix");
+    }
+    const std::vector<int>& rowStart = A.rowStart();
+    const std::vector<int>& colIndex = A.colIndex();
+    const std::vector<double>& values = A.values();
+
+    int stored = 0;
+    for (int i = 0; i < A.numRows(); ++i) {
+        for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+            if (symmetry == Symmetry::General || colIndex[k] <= i) ++stored;
+        }
+    }
+
+    std::string text = std::string("%%MatrixMarket matrix coordinate real ") + symmetryName(symmetry) + "\n";
+    appendNumber(text, A.numRows());
+    text += ' ';
+    appendNumber(text, A.numCols());
+    text += ' ';
+    appendNumber(text, stored);
+    text += '\n';
+    for (int i = 0; i < A.numRows(); ++i) {
+        for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+            if (symmetry == Symmetry::Symmetric && colIndex[k] > i) continue;
+            appendNumber(text, i + 1);
+            text += ' ';
+            appendNumber(text, colIndex[k] + 1);
+            text += ' ';
+            appendNumber(text, values[k]);
+            text += '\n';
+        }
+    }
+    writeText(path, text);
+}
+
+}
@@ -0,0 +1,256 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+// Index of the pool worker running on this thread, -1 for other threads
+static thread_local int tWorkerIndex = -1;
+
+// Set while a SerialRegion is alive on this thread
+static thread_local bool tSerial = false;
+
+struct ThreadPool::Task {
+    std::function<void()> work;
+    TaskGroup* group;
+
+    // Runs the work and reports to the group; the task deletes itself
+    void run() {
+        std::exception_ptr error;
+        try {
+            work();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        TaskGroup* owner = group;
+        delete this;
+        owner->finish(error);
+    }
+};
+
+struct ThreadPool::Worker {
+    std::deque<Task*> tasks;
+    std::mutex mutex;
+};
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool() : mQueued(0), mStop(false) {
+    int threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    const char* configured = std::getenv("TINI_NUM_THREADS");
+    if (configured != nullptr && std::atoi(configured) > 0) {
+        threads = std::atoi(configured);
+    }
+    startWorkers(threads - 1);  // the calling thread is the last worker
+}
+
+ThreadPool::~ThreadPool() {
+    stopWorkers();
+}
+
+int ThreadPool::numThreads() const {
+    return static_cast<int>(mWorkers.size()) + 1;
+}
+
+void ThreadPool::setNumThreads(int numThreads) {
+    stopWorkers();
+    startWorkers(std::max(numThreads, 1) - 1);
+}
+
+void ThreadPool::startWorkers(int numWorkers) {
+    mStop = false;
+    for (int i = 0; i < numWorkers; ++i) {
+        mWorkers.emplace_back(new Worker);
+    }
+    for (int i = 0; i < numWorkers; ++i) {
+        mThreads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+void ThreadPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+    mThreads.clear();
+    mWorkers.clear();
+}
+
+void ThreadPool::submit(Task* task) {
+    int self = tWorkerIndex;
+    if (self >= 0 && self < (int)mWorkers.size()) {
+        std::lock_guard<std::mutex> lock(mWorkers[self]->mutex);
+        mWorkers[self]->tasks.push_back(task);
+    } else {
+        std::lock_guard<std::mutex> lock(mInjectedMutex);
+        mInjected.push_back(task);
+    }
+    mQueued.fetch_add(1);
+    {
+        // Pairs with the predicate check of a worker going to sleep
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+    }
+    mWake.notify_one();
+}
+
+// Own deque newest first, then the injection queue, then the oldest task of another worker
+ThreadPool::Task* ThreadPool::findTask(int self) {
+    if (mQueued.load() == 0) return nullptr;
+    int numWorkers = (int)mWorkers.size();
+    Task* task = nullptr;
+
+    if (self >= 0 && self < numWorkers) {
+        Worker& own = *mWorkers[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+        }
+    }
+    if (task == nullptr) {
+        std::lock_guard<std::mutex> lock(mInjectedMutex);
+        if (!mInjected.empty()) {
+            task = mInjected.front();
+            mInjected.pop_front();
+        }
+    }
+    for (int k = 1; task == nullptr && k <= numWorkers; ++k) {
+        int victim = ((self < 0 ? 0 : self) + k) % numWorkers;
+        if (victim == self) continue;
+        Worker& other = *mWorkers[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = other.tasks.front();
+            other.tasks.pop_front();
+        }
+    }
+
+    if (task != nullptr) {
+        mQueued.fetch_sub(1);
+    }
+    return task;
+}
+
+bool ThreadPool::runOneTask() {
+    Task* task = findTask(tWorkerIndex);
+    if (task == nullptr) return false;
+    task->run();
+    return true;
+}
+
+void ThreadPool::workerLoop(int index) {
+    tWorkerIndex = index;
+    while (true) {
+        Task* task = findTask(index);
+        if (task != nullptr) {
+            task->run();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mWake.wait(lock, [this] { return mStop || mQueued.load() > 0; });
+        if (mStop) return;
+    }
+}
+
+void ThreadPool::parallelFor(int begin, int end, int grain,
+                             const std::function<void(int, int)>& body) {
+    if (end <= begin) return;
+    grain = std::max(grain, 1);
+    int count = end - begin;
+
+    if (tSerial || mWorkers.empty() || count <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    // Chunks are uniform except the last; the body receives the clipped range
+    int numChunks = std::min((count + grain - 1) / grain, 4 * numThreads());
+    int chunkSize = (count + numChunks - 1) / numChunks;
+    numChunks = (count + chunkSize - 1) / chunkSize;
+
+    // Fork every chunk but the first, run that one here, then join
+    TaskGroup group;
+    for (int c = 1; c < numChunks; ++c) {
+        int chunkBegin = begin + c * chunkSize;
+        group.run([&body, chunkBegin, chunkSize, end] { body(chunkBegin, std::min(chunkBegin + chunkSize, end)); });
+    }
+    std::exception_ptr error;
+    try {
+        body(begin, std::min(begin + chunkSize, end));
+    } catch (...) {
+        error = std::current_exception();
+    }
+    group.wait();
+    if (error) std::rethrow_exception(error);
+}
+
+TaskGroup::TaskGroup() : mPending(0) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> work) {
+    ThreadPool& pool = ThreadPool::instance();
+    if (tSerial || pool.numThreads() == 1) {
+        try {
+            work();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mError) mError = std::current_exception();
+        }
+        return;
+    }
+    mPending.fetch_add(1);
+    pool.submit(new ThreadPool::Task{std::move(work), this});
+}
+
+void TaskGroup::finish(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (error && !mError) mError = error;
+    if (mPending.fetch_sub(1) == 1) {
+        mDone.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    ThreadPool& pool = ThreadPool::instance();
+    // Help with queued work until the group is done. With nothing to run,
+    // yield a few times (the tasks are usually about to finish), then sleep.
+    int idle = 0;
+    while (mPending.load() > 0) {
+        if (pool.runOneTask()) {
+            idle = 0;
+        } else if (++idle <= 64) {
+            std::this_thread::yield();
+        } else {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait_for(lock, std::chrono::microseconds(100), [this] { return mPending.load() == 0; });
+        }
+    }
+    // The last finish() has released the mutex once this lock is taken
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        error = mError;
+        mError = nullptr;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+SerialRegion::SerialRegion() : mPrevious(tSerial) {
+    tSerial = true;
+}
+
+SerialRegion::~SerialRegion() {
+    tSerial = mPrevious;
+}
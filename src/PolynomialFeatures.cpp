@@ -0,0 +1,181 @@
+#include "PolynomialFeatures.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+// Rows per parallel chunk of the Gram accumulation. Each chunk owns a private
+// Gram matrix; the chunks are added along parallelReduce's fixed tree, so the
+// result does not depend on the thread count.
+static const int GRAM_ROW_GRAIN = 4096;
+
+// Expanded rows held at once: the Gram update is a rank-4 update, so each
+// entry of G is loaded and stored once per four rows
+static const int GRAM_ROW_BLOCK = 4;
+
+PolynomialFeatures::PolynomialFeatures(int numBase, int degree, InteractionSet interactions, bool intercept)
+    : mNumBase(numBase), mDegree(degree), mInteractions(interactions), mIntercept(intercept) {
+    if (numBase <= 0 || degree <= 0) {
+        throw std::invalid_argument("Polynomial features need at least one base feature and degree 1");
+    }
+
+    std::map<std::vector<int>, int> index;
+    if (intercept) {
+        index[{}] = 0;
+        mTerms.push_back({});
+        mParent.push_back(-1);
+        mFactor.push_back(-1);
+    }
+
+    // Terms of degree d extend those of degree d - 1 by a factor no smaller
+    // than their last one, which enumerates each monomial once
+    int allowed = interactions == InteractionSet::None ? 1
+                  : interactions == InteractionSet::Pairwise ? 2 : degree;
+    std::vector<std::vector<int>> previous = {{}};
+    for (int d = 1; d <= degree; ++d) {
+        std::vector<std::vector<int>> current;
+        for (const std::vector<int>& parent : previous) {
+            for (int j = parent.empty() ? 0 : parent.back(); j < numBase; ++j) {
+                std::vector<int> term = parent;
+                term.push_back(j);
+                std::vector<int> variables = term;
+                variables.erase(std::unique(variables.begin(), variables.end()), variables.end());
+                if ((int)variables.size() > allowed) continue;
+
+                auto found = index.find(parent);
+                index[term] = (int)mTerms.size();
+                mTerms.push_back(term);
+                mParent.push_back(found == index.end() ? -1 : found->second);
+                mFactor.push_back(j);
+                current.push_back(term);
+            }
+        }
+        previous.swap(current);
+    }
+}
+
+int PolynomialFeatures::numBase() const { return mNumBase; }
+int PolynomialFeatures::degree() const { return mDegree; }
+InteractionSet PolynomialFeatures::interactions() const { return mInteractions; }
+bool PolynomialFeatures::hasIntercept() const { return mIntercept; }
+int PolynomialFeatures::numFeatures() const { return (int)mTerms.size(); }
+
+const std::vector<int>& PolynomialFeatures::term(int k) const {
+    return mTerms.at(k);
+}
+
+std::string PolynomialFeatures::termName(int k, const std::vector<std::string>& baseNames) const {
+    const std::vector<int>& t = mTerms.at(k);
+    if (t.empty()) return "1";
+    std::string name;
+    for (size_t i = 0; i < t.size();) {
+        size_t j = i;
+        while (j < t.size() && t[j] == t[i]) ++j;
+        if (!name.empty()) name += "*";
+        name += t[i] < (int)baseNames.size() ? baseNames[t[i]] : "x" + std::to_string(t[i] + 1);
+        if (j - i > 1) name += "^" + std::to_string(j - i);
+        i = j;
+    }
+    return name;
+}
+
+void PolynomialFeatures::expandRow(const double* x, double* out) const {
+    int q = (int)mTerms.size();
+    for (int k = 0; k < q; ++k) {
+        int parent = mParent[k];
+        int factor = mFactor[k];
+        out[k] = factor < 0 ? 1.0 : (parent < 0 ? x[factor] : out[parent] * x[factor]);
+    }
+}
+
+double PolynomialFeatures::predict(const Vector& coefficients, const double* x) const {
+    int q = (int)mTerms.size();
+    if (coefficients.size() != q) {
+        throw std::invalid_argument("Coefficient count does not match the expanded features");
+    }
+    std::vector<double> row(q);
+    expandRow(x, row.data());
+    double sum = 0.0;
+    for (int k = 0; k < q; ++k) {
+        sum += coefficients.data()[k] * row[k];
+    }
+    return sum;
+}
+
+// Upper triangle of G += EᵀE and g += Eᵀy for a block of up to four expanded rows E
+static void gramBlock(int q, int rows, const double* E, const double* y, double* G, double* g) {
+    if (rows == GRAM_ROW_BLOCK) {
+        const double* __restrict e0 = E;
+        const double* __restrict e1 = E + q;
+        const double* __restrict e2 = E + 2 * q;
+        const double* __restrict e3 = E + 3 * q;
+        for (int a = 0; a < q; ++a) {
+            double a0 = e0[a], a1 = e1[a], a2 = e2[a], a3 = e3[a];
+            double* __restrict row = G + (size_t)a * q;
+            for (int b = a; b < q; ++b) {
+                row[b] += a0 * e0[b] + a1 * e1[b] + a2 * e2[b] + a3 * e3[b];
+            }
+            g[a] += a0 * y[0] + a1 * y[1] + a2 * y[2] + a3 * y[3];
+        }
+        return;
+    }
+    for (int r = 0; r < rows; ++r) {
+        const double* __restrict e = E + (size_t)r * q;
+        for (int a = 0; a < q; ++a) {
+            double* __restrict row = G + (size_t)a * q;
+            for (int b = a; b < q; ++b) {
+                row[b] += e[a] * e[b];
+            }
+            g[a] += e[a] * y[r];
+        }
+    }
+}
+
+void PolynomialFeatures::accumulate(const double* X, int numRows, int ldx, const double* y,
+                                    double* G, double* Xty) const {
+    int q = (int)mTerms.size();
+    PROFILE_SCOPE_WORK("PolynomialFeatures::accumulate", (double)numRows * q * (q + 3),
+                       8.0 * numRows * (mNumBase + 1));
+
+    // Each chunk returns its upper triangle followed by its Xᵀy
+    size_t size = (size_t)q * q + q;
+    std::vector<double> sums = parallelReduce(0, numRows, GRAM_ROW_GRAIN, std::vector<double>(size, 0.0),
+        [&](int first, int last) {
+            std::vector<double> partial(size, 0.0);
+            std::vector<double> E((size_t)GRAM_ROW_BLOCK * q);
+            for (int i = first; i < last; i += GRAM_ROW_BLOCK) {
+                int rows = std::min(GRAM_ROW_BLOCK, last - i);
+                for (int r = 0; r < rows; ++r) {
+                    expandRow(X + (size_t)(i + r) * ldx, &E[(size_t)r * q]);
+                }
+                gramBlock(q, rows, E.data(), y + i, partial.data(), partial.data() + (size_t)q * q);
+            }
+            return partial;
+        },
+        [size](std::vector<double> left, const std::vector<double>& right) {
+            for (size_t k = 0; k < size; ++k) {
+                left[k] += right[k];
+            }
+            return left;
+        });
+
+    for (int a = 0; a < q; ++a) {
+        for (int b = a; b < q; ++b) {
+            double value = sums[(size_t)a * q + b];
+            G[(size_t)a * q + b] += value;
+            if (b != a) G[(size_t)b * q + a] += value;
+        }
+        Xty[a] += sums[(size_t)q * q + a];
+    }
+}
+
+void PolynomialFeatures::normalEquations(const Matrix& X, const Vector& y, Matrix& G, Vector& Xty) const {
+    if (X.numCols() != mNumBase || X.numRows() != y.size()) {
+        throw std::invalid_argument("Design and targets do not match the base features");
+    }
+    int q = numFeatures();
+    G = Matrix(q, q);
+    Xty = Vector(q);
+    accumulate(X.data(), X.numRows(), mNumBase, y.data(), G.data(), Xty.data());
+}
@@ -1,20 +1,227 @@
 #include <PosSymLinSystem.h>
 #include <Matrix.h>
 #include <Vector.h>
+#include <Profiler.h>
+#include <Kernels.h>
+#include <Parallel.h>
 #include <math.h>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
+// Vector elements per task in the fused update of pipelined CG
+static const int PIPELINED_UPDATE_GRAIN = 8192;
+
+// Rows per task in the row-wise loops of block CG
+static const int BLOCK_INNER_ROWS = 1024;
+
+// Block CG drops a new search direction whose component outside the kept
+// ones has a squared norm below this fraction of its own
+static const double BLOCK_DROP_TOLERANCE = 1e-12;
+
+// G = XᵀY for the n x kx block X and the n x ky block Y (row-major). X is
+// transposed first so that the product is one GEMM, which splits over rows
+// of G only and therefore gives the same result on any number of threads.
+static vector<double> innerBlock(int n, int kx, const double* X, int ldx, int ky, const double* Y, int ldy) {
+    vector<double> Xt((size_t)kx * n);
+    parallelFor(0, n, BLOCK_INNER_ROWS, [&](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            for (int p = 0; p < kx; ++p) {
+                Xt[(size_t)p * n + i] = X[(size_t)i * ldx + p];
+            }
+        }
+    });
+    vector<double> G((size_t)kx * ky);
+    kernels::gemm(kx, ky, n, 1.0, Xt.data(), n, Y, ldy, 0.0, G.data(), ky);
+    return G;
+}
+
+// Cholesky G = LLᵀ of a k x k matrix in place (lower triangle), false if G is not positive definite
+static bool choleskyInPlace(int k, double* G) {
+    for (int j = 0; j < k; ++j) {
+        double d = G[j * k + j];
+        for (int t = 0; t < j; ++t) {
+            d -= G[j * k + t] * G[j * k + t];
+        }
+        if (d <= 0.0) {
+            return false;
+        }
+        G[j * k + j] = sqrt(d);
+        for (int i = j + 1; i < k; ++i) {
+            double sum = G[i * k + j];
+            for (int t = 0; t < j; ++t) {
+                sum -= G[i * k + t] * G[j * k + t];
+            }
+            G[i * k + j] = sum / G[j * k + j];
+        }
+    }
+    return true;
+}
+
+// Solve LLᵀ Y = B in place of the k x m block B
+static void choleskySolve(int k, const double* L, int m, double* B) {
+    kernels::trsmLower(k, m, L, k, false, B, m);
+    for (int i = k - 1; i >= 0; --i) {
+        double* bi = B + (size_t)i * m;
+        for (int t = i + 1; t < k; ++t) {
+            double lti = L[t * k + i];
+            const double* bt = B + (size_t)t * m;
+            for (int j = 0; j < m; ++j) {
+                bi[j] -= lti * bt[j];
+            }
+        }
+        for (int j = 0; j < m; ++j) {
+            bi[j] /= L[i * k + i];
+        }
+    }
+}
+
+// P = Z L⁻ᵀ, row by row, for the n x k block Z and the k x k factor L
+static void solveRowsLower(int n, int k, const double* L, const double* Z, int ldz, double* P) {
+    parallelFor(0, n, BLOCK_INNER_ROWS, [=](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            const double* z = Z + (size_t)i * ldz;
+            double* row = P + (size_t)i * k;
+            for (int q = 0; q < k; ++q) {
+                double sum = z[q];
+                for (int t = 0; t < q; ++t) {
+                    sum -= L[q * k + t] * row[t];
+                }
+                row[q] = sum / L[q * k + q];
+            }
+        }
+    });
+}
+
+// Orthonormal basis P (n x k, k <= m) of the columns of the n x m block Z by
+// Cholesky QR. Columns that are numerically dependent on the ones before them
+// are dropped. One pass leaves P orthonormal up to about eps * cond(Z)², which
+// is all block CG needs: P only has to be a well-conditioned basis. Returns k.
+static int orthonormalize(int n, int m, const vector<double>& Z, vector<double>& P) {
+    vector<double> G = innerBlock(n, m, Z.data(), m, m, Z.data(), m);
+
+    // Cholesky over the kept columns only
+    vector<int> kept;
+    vector<double> L;
+    for (int j = 0; j < m; ++j) {
+        int k = (int)kept.size();
+        vector<double> row(k + 1, 0.0);
+        double d = G[(size_t)j * m + j];
+        for (int q = 0; q < k; ++q) {
+            double sum = G[(size_t)j * m + kept[q]];
+            for (int t = 0; t < q; ++t) {
+                sum -= row[t] * L[(size_t)q * m + t];
+            }
+            row[q] = sum / L[(size_t)q * m + q];
+            d -= row[q] * row[q];
+        }
+        if (G[(size_t)j * m + j] > 0.0 && d > BLOCK_DROP_TOLERANCE * G[(size_t)j * m + j]) {
+            row[k] = sqrt(d);
+            L.resize((size_t)(k + 1) * m, 0.0);
+            for (int t = 0; t <= k; ++t) {
+                L[(size_t)k * m + t] = row[t];
+            }
+            kept.push_back(j);
+        }
+    }
+    int k = (int)kept.size();
+    if (k == 0) {
+        P.clear();
+        return 0;
+    }
+
+    // Kept columns of Z, then P = Zk L⁻ᵀ with L repacked as k x k
+    vector<double> Zk((size_t)n * k);
+    for (int i = 0; i < n; ++i) {
+        for (int q = 0; q < k; ++q) {
+            Zk[(size_t)i * k + q] = Z[(size_t)i * m + kept[q]];
+        }
+    }
+    vector<double> Lk((size_t)k * k, 0.0);
+    for (int q = 0; q < k; ++q) {
+        for (int t = 0; t <= q; ++t) {
+            Lk[q * k + t] = L[(size_t)q * m + t];
+        }
+    }
+    P.assign((size_t)n * k, 0.0);
+    solveRowsLower(n, k, Lk.data(), Zk.data(), k, P.data());
+    return k;
+}
+
+// Euclidean norm of each column of the n x m block R (fixed row blocks added pairwise)
+static vector<double> columnNorms(int n, int m, const vector<double>& R) {
+    const double* data = R.data();
+    auto rows = [=](int i0, int i1) {
+        vector<double> sums(m, 0.0);
+        for (int i = i0; i < i1; ++i) {
+            const double* r = data + (size_t)i * m;
+            for (int j = 0; j < m; ++j) {
+                sums[j] += r[j] * r[j];
+            }
+        }
+        return sums;
+    };
+    auto add = [](vector<double> x, const vector<double>& y) {
+        for (size_t j = 0; j < x.size(); ++j) {
+            x[j] += y[j];
+        }
+        return x;
+    };
+    vector<double> norms = parallelReduce(0, n, BLOCK_INNER_ROWS, vector<double>(m, 0.0), rows, add);
+    for (int j = 0; j < m; ++j) {
+        norms[j] = sqrt(norms[j]);
+    }
+    return norms;
+}
+
 // Constructor
-PosSymLinSystem::PosSymLinSystem(Matrix* A, Vector* b) : LinearSystem(A, b) {
+PosSymLinSystem::PosSymLinSystem(Matrix* A, Vector* b, bool checkSymmetry)
+    : LinearSystem(A, b), mpOperator(nullptr), mOwnsOperator(true),
+      mVariant(CGVariant::Classic), mReplacementInterval(50), mIterations(0), mReplacements(0) {
+    if (checkSymmetry && !isSymmetric(*A)) {
+        throw invalid_argument("Matrix is not symmetric");
+    }
+    mpOperator = new DenseOperator(A);
+}
+
+PosSymLinSystem::PosSymLinSystem(Matrix* A, Matrix* B)
+    : LinearSystem(A, B), mpOperator(nullptr), mOwnsOperator(true),
+      mVariant(CGVariant::Classic), mReplacementInterval(50), mIterations(0), mReplacements(0) {
     if (!isSymmetric(*A)) {
         throw invalid_argument("Matrix is not symmetric");
     }
+    mpOperator = new DenseOperator(A);
+}
+
+PosSymLinSystem::PosSymLinSystem(LinearOperator* A, Vector* b)
+    : LinearSystem(A == nullptr ? 0 : A->numRows(), b), mpOperator(A), mOwnsOperator(false),
+      mVariant(CGVariant::Classic), mReplacementInterval(50), mIterations(0), mReplacements(0) {
+    if (A == nullptr) {
+        throw invalid_argument("Operator and Vector cannot be null");
+    }
+    if (A->numRows() != A->numCols()) {
+        throw invalid_argument("Operator is not square");
+    }
+}
+
+PosSymLinSystem::PosSymLinSystem(LinearOperator* A, Matrix* B)
+    : LinearSystem(A == nullptr ? 0 : A->numRows(), B), mpOperator(A), mOwnsOperator(false),
+      mVariant(CGVariant::Classic), mReplacementInterval(50), mIterations(0), mReplacements(0) {
+    if (A == nullptr) {
+        throw invalid_argument("Operator and right-hand sides cannot be null");
+    }
+    if (A->numRows() != A->numCols()) {
+        throw invalid_argument("Operator is not square");
+    }
 }
 
 // Destructor
-PosSymLinSystem::~PosSymLinSystem() {}
+PosSymLinSystem::~PosSymLinSystem() {
+    if (mOwnsOperator) {
+        delete mpOperator;
+    }
+}
 
 // Check if the matrix is symmetric
 bool PosSymLinSystem::isSymmetric(const Matrix& A) {
@@ -31,34 +238,49 @@ bool PosSymLinSystem::isSymmetric(const Matrix& A) {
 
 // Solve method
 Vector PosSymLinSystem::Solve() {
+    if (mpb == nullptr) {
+        throw logic_error("System has no right-hand side vector, use SolveMultiple()");
+    }
+    return mVariant == CGVariant::Pipelined ? SolvePipelined() : SolveClassic();
+}
+
+Vector PosSymLinSystem::SolveClassic() {
+    PROFILE_SCOPE("CG solve");
+
+    // The four work vectors are the only allocations, iterations update in
+    // place. Products, dots and updates run on the thread pool; the dots have
+    // a fixed summation shape, so the iterates do not depend on the thread count.
     int n = mSize;
     Vector x(n);
-    Vector r(n);
-    r = *mpb;
-    Vector p(n);
-    p = r;
-    
+    Vector r(*mpb);
+    Vector p(r);
+    Vector Ap(n);
+
     // Store r dot r for convergence check
-    double rsold = r.dot(r);
+    double rsold = kernels::dot(n, r.data(), r.data());
     
     // Convergence parameters
     const double tolerance = 1e-10;
     const int maxIterations = n * 2;
     
     cout << "Starting Conjugate Gradient method..." << endl;
+    mIterations = 0;
+    mReplacements = 0;
     
     for (int iter = 0; iter < maxIterations; ++iter) {
-        // Matrix-vector product A*p
-        Vector Ap(n);
-        Ap = (*mpA) * p;
+        PROFILE_SCOPE("CG iteration");
+        mIterations = iter + 1;
+
+        // Operator product A*p
+        mpOperator->apply(p.data(), Ap.data());
 
         // Compute alpha
-        double alpha = rsold / p.dot(Ap);
+        double alpha = rsold / kernels::dot(n, p.data(), Ap.data());
         
-        x = x + p * alpha;
-        r = r - Ap * alpha;
+        kernels::axpy(n, alpha, p.data(), x.data());
+        kernels::axpy(n, -alpha, Ap.data(), r.data());
         
-        double rsnew = r.dot(r);
+        double rsnew = kernels::dot(n, r.data(), r.data());
         
         double error = sqrt(rsnew);
         cout << "Iteration " << iter + 1 << ", Error = " << error << endl;
@@ -69,7 +291,7 @@ Vector PosSymLinSystem::Solve() {
         }
         
         double beta = rsnew / rsold;
-        p = r + p * beta;
+        kernels::axpby(n, 1.0, r.data(), beta, p.data());
         rsold = rsnew;
         
         if (iter == maxIterations - 1) {
@@ -87,3 +309,294 @@ Vector PosSymLinSystem::Solve() {
     return x;
 }
 
+// Pipelined CG without preconditioner: u = r, m = w = Ar, n = q = Aw.
+// Each iteration computes gamma = (r, r) and delta = (w, r) in one pass while
+// q = Aw runs, then updates all six vectors in a single sweep.
+Vector PosSymLinSystem::SolvePipelined() {
+    PROFILE_SCOPE("Pipelined CG solve");
+
+    int n = mSize;
+    Vector x(n);
+    Vector r(*mpb);
+    Vector w(n);
+    Vector p(n);
+    Vector s(n);
+    Vector z(n);
+    Vector q(n);
+    mpOperator->apply(r.data(), w.data());
+
+    const double tolerance = 1e-10;
+    const int maxIterations = n * 2;
+
+    cout << "Starting pipelined Conjugate Gradient method..." << endl;
+    mIterations = 0;
+    mReplacements = 0;
+
+    double gammaOld = 0.0;
+    double alphaOld = 0.0;
+    int sinceReplacement = 0;   // r and w are exact right after a replacement
+
+    while (true) {
+        PROFILE_SCOPE("Pipelined CG iteration");
+
+        // The fused reduction overlaps with the operator product
+        double dots[2];
+        {
+            TaskGroup reduction;
+            reduction.run([&] { kernels::dot2(n, r.data(), w.data(), r.data(), dots); });
+            mpOperator->apply(w.data(), q.data());
+            reduction.wait();
+        }
+        double gamma = dots[0];
+        double delta = dots[1];
+
+        double error = sqrt(gamma);
+        if (mIterations > 0) {
+            cout << "Iteration " << mIterations << ", Error = " << error << endl;
+        }
+
+        if (error < tolerance) {
+            if (sinceReplacement == 0) {
+                cout << "Pipelined Conjugate Gradient converged after " << mIterations << " iterations" << endl;
+                break;
+            }
+            // The recursive residual may have drifted from b - Ax, check the true one
+            ReplaceResidual(x.data(), p.data(), r.data(), w.data(), s.data(), z.data());
+            sinceReplacement = 0;
+            continue;
+        }
+        if (mIterations == maxIterations) {
+            cout << "Warning: Pipelined Conjugate Gradient did not converge within "
+                 << maxIterations << " iterations" << endl;
+            break;
+        }
+
+        double beta = 0.0;
+        double alpha = gamma / delta;
+        if (mIterations > 0) {
+            beta = gamma / gammaOld;
+            alpha = gamma / (delta - beta * gamma / alphaOld);
+        }
+
+        double* px = x.data();
+        double* pr = r.data();
+        double* pw = w.data();
+        double* pp = p.data();
+        double* ps = s.data();
+        double* pz = z.data();
+        const double* pq = q.data();
+        parallelFor(0, n, PIPELINED_UPDATE_GRAIN, [=](int i0, int i1) {
+            for (int i = i0; i < i1; ++i) {
+                pz[i] = pq[i] + beta * pz[i];
+                ps[i] = pw[i] + beta * ps[i];
+                pp[i] = pr[i] + beta * pp[i];
+                px[i] += alpha * pp[i];
+                pr[i] -= alpha * ps[i];
+                pw[i] -= alpha * pz[i];
+            }
+        });
+
+        gammaOld = gamma;
+        alphaOld = alpha;
+        ++mIterations;
+        ++sinceReplacement;
+
+        if (mReplacementInterval > 0 && sinceReplacement >= mReplacementInterval) {
+            ReplaceResidual(x.data(), p.data(), r.data(), w.data(), s.data(), z.data());
+            sinceReplacement = 0;
+        }
+    }
+
+    cout << "Final solution: ";
+    for (int i = 1; i <= n; ++i) {
+        cout << x(i) << " ";
+    }
+    cout << endl;
+
+    return x;
+}
+
+// r = b - Ax, w = Ar, s = Ap and z = As from scratch (four operator products)
+void PosSymLinSystem::ReplaceResidual(const double* x, const double* p, double* r, double* w,
+                                      double* s, double* z) {
+    int n = mSize;
+    const double* b = mpb->data();
+    mpOperator->apply(x, r);
+    kernels::axpby(n, 1.0, b, -1.0, r);
+    mpOperator->apply(r, w);
+    mpOperator->apply(p, s);
+    mpOperator->apply(s, z);
+    ++mReplacements;
+}
+
+// Breakdown-free block CG (Ji and Li): the search directions P are kept
+// orthonormal and rank-revealing, so dependent directions are dropped instead
+// of breaking the k x k solves. Each iteration costs one product of A with
+// the whole block. Right-hand sides whose residual falls below the tolerance
+// leave the block (their columns of X are final) and the rest go on.
+Matrix PosSymLinSystem::SolveBlockCG() {
+    PROFILE_SCOPE("Block CG solve");
+
+    Matrix B = RhsMatrix();
+    int n = mSize;
+    int numRhs = B.numCols();
+    Matrix X(n, numRhs);
+
+    const double tolerance = 1e-10;
+    const int maxIterations = n * 2;
+
+    cout << "Starting block Conjugate Gradient method with " << numRhs << " right-hand sides..." << endl;
+    mIterations = 0;
+    mReplacements = 0;
+
+    // Active right-hand sides, with compact n x a copies of their X and R
+    vector<int> active;
+    vector<double> bNorms = columnNorms(n, numRhs, vector<double>(B.data(), B.data() + (size_t)n * numRhs));
+    for (int j = 0; j < numRhs; ++j) {
+        if (bNorms[j] >= tolerance) {
+            active.push_back(j);
+        }
+    }
+    int a = (int)active.size();
+    vector<double> R((size_t)n * a);
+    vector<double> Xa((size_t)n * a, 0.0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < a; ++j) {
+            R[(size_t)i * a + j] = B.data()[(size_t)i * numRhs + active[j]];
+        }
+    }
+
+    vector<double> P;
+    vector<double> Q;
+    int k = a > 0 ? orthonormalize(n, a, R, P) : 0;
+
+    while (a > 0 && k > 0) {
+        PROFILE_SCOPE("Block CG iteration");
+
+        // Q = AP, one pass over A for all k directions
+        Q.resize((size_t)n * k);
+        mpOperator->applyBlock(k, P.data(), k, Q.data(), k);
+        vector<double> PtQ = innerBlock(n, k, P.data(), k, k, Q.data(), k);
+        if (!choleskyInPlace(k, PtQ.data())) {
+            cout << "Warning: block Conjugate Gradient broke down, the operator is not positive definite" << endl;
+            break;
+        }
+
+        // alpha = (PᵀQ)⁻¹ PᵀR, X += P alpha, R -= Q alpha
+        vector<double> alpha = innerBlock(n, k, P.data(), k, a, R.data(), a);
+        choleskySolve(k, PtQ.data(), a, alpha.data());
+        kernels::gemm(n, a, k, 1.0, P.data(), k, alpha.data(), a, 1.0, Xa.data(), a);
+        kernels::gemm(n, a, k, -1.0, Q.data(), k, alpha.data(), a, 1.0, R.data(), a);
+        ++mIterations;
+
+        vector<double> norms = columnNorms(n, a, R);
+        double error = 0.0;
+        for (int j = 0; j < a; ++j) {
+            error = fmax(error, norms[j]);
+        }
+        cout << "Iteration " << mIterations << ", Error = " << error << ", active right-hand sides = " << a << endl;
+
+        // Deflation: converged columns leave the block
+        vector<int> remaining;
+        for (int j = 0; j < a; ++j) {
+            if (norms[j] < tolerance) {
+                for (int i = 0; i < n; ++i) {
+                    X.data()[(size_t)i * numRhs + active[j]] = Xa[(size_t)i * a + j];
+                }
+            } else {
+                remaining.push_back(j);
+            }
+        }
+        if ((int)remaining.size() < a) {
+            int left = (int)remaining.size();
+            vector<double> R2((size_t)n * left);
+            vector<double> X2((size_t)n * left);
+            vector<int> active2(left);
+            for (int q = 0; q < left; ++q) {
+                active2[q] = active[remaining[q]];
+            }
+            for (int i = 0; i < n; ++i) {
+                for (int q = 0; q < left; ++q) {
+                    R2[(size_t)i * left + q] = R[(size_t)i * a + remaining[q]];
+                    X2[(size_t)i * left + q] = Xa[(size_t)i * a + remaining[q]];
+                }
+            }
+            R.swap(R2);
+            Xa.swap(X2);
+            active.swap(active2);
+            a = left;
+        }
+        if (a == 0) {
+            cout << "Block Conjugate Gradient converged after " << mIterations << " iterations" << endl;
+            break;
+        }
+        if (mIterations == maxIterations) {
+            cout << "Warning: block Conjugate Gradient did not converge within "
+                 << maxIterations << " iterations" << endl;
+            break;
+        }
+
+        // Z = R + P beta with beta = -(PᵀQ)⁻¹ QᵀR, then P = orth(Z)
+        vector<double> beta = innerBlock(n, k, Q.data(), k, a, R.data(), a);
+        choleskySolve(k, PtQ.data(), a, beta.data());
+        vector<double> Z(R);
+        kernels::gemm(n, a, k, -1.0, P.data(), k, beta.data(), a, 1.0, Z.data(), a);
+        k = orthonormalize(n, a, Z, P);
+    }
+
+    // Columns still active after a breakdown or the iteration limit
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < a; ++j) {
+            X.data()[(size_t)i * numRhs + active[j]] = Xa[(size_t)i * a + j];
+        }
+    }
+    return X;
+}
+
+void PosSymLinSystem::SetVariant(CGVariant variant) { mVariant = variant; }
+void PosSymLinSystem::SetReplacementInterval(int interval) { mReplacementInterval = interval; }
+
+int PosSymLinSystem::Iterations() const { return mIterations; }
+int PosSymLinSystem::Replacements() const { return mReplacements; }
+
+// Solve AX = B with one Cholesky factorization and two blocked triangular solves
+Matrix PosSymLinSystem::SolveMultiple() {
+    if (mpA == nullptr) {
+        return SolveBlockCG();
+    }
+
+    int n = mSize;
+    Matrix L(n, n);
+
+    for (int j = 1; j <= n; ++j) {
+        double diag = (*mpA)(j, j);
+        for (int k = 1; k < j; ++k) {
+            diag -= L(j, k) * L(j, k);
+        }
+        if (diag <= 0.0) {
+            throw runtime_error("Matrix is not positive definite");
+        }
+        L(j, j) = sqrt(diag);
+
+        for (int i = j + 1; i <= n; ++i) {
+            double sum = (*mpA)(i, j);
+            for (int k = 1; k < j; ++k) {
+                sum -= L(i, k) * L(j, k);
+            }
+            L(i, j) = sum / L(j, j);
+        }
+    }
+
+    // Lᵀ for the backward sweep
+    Matrix Lt(n, n);
+    for (int i = 1; i <= n; ++i) {
+        for (int j = 1; j <= i; ++j) {
+            Lt(j, i) = L(i, j);
+        }
+    }
+
+    Matrix X = RhsMatrix();
+    ForwardSubstitution(L, X, false);
+    BackSubstitution(Lt, X);
+    return X;
+}
@@ -0,0 +1,44 @@
+#include "Preconditioner.h"
+#include <stdexcept>
+
+JacobiPreconditioner::JacobiPreconditioner(const std::vector<double>& diagonal)
+    : mInverseDiagonal(diagonal.size()) {
+    for (size_t i = 0; i < diagonal.size(); ++i) {
+        if (diagonal[i] == 0.0) {
+            throw std::invalid_argument("Jacobi preconditioner needs a nonzero diagonal");
+        }
+        mInverseDiagonal[i] = 1.0 / diagonal[i];
+    }
+}
+
+static std::vector<double> denseDiagonal(const Matrix& A) {
+    std::vector<double> diag(A.numRows());
+    for (int i = 1; i <= A.numRows(); ++i) {
+        diag[i - 1] = A(i, i);
+    }
+    return diag;
+}
+
+JacobiPreconditioner::JacobiPreconditioner(const Matrix& A)
+    : JacobiPreconditioner(denseDiagonal(A)) {}
+
+JacobiPreconditioner::JacobiPreconditioner(const SparseMatrix& A)
+    : JacobiPreconditioner(A.diagonal()) {}
+
+static std::vector<double> operatorDiagonal(const LinearOperator& A) {
+    if (!A.hasDiagonal()) {
+        throw std::invalid_argument("Jacobi preconditioner needs the operator diagonal");
+    }
+    std::vector<double> diag(A.numRows());
+    A.diagonal(diag.data());
+    return diag;
+}
+
+JacobiPreconditioner::JacobiPreconditioner(const LinearOperator& A)
+    : JacobiPreconditioner(operatorDiagonal(A)) {}
+
+void JacobiPreconditioner::Apply(const double* r, double* z) const {
+    for (size_t i = 0; i < mInverseDiagonal.size(); ++i) {
+        z[i] = mInverseDiagonal[i] * r[i];
+    }
+}
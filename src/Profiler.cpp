@@ -0,0 +1,182 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace profiler {
+
+const int MAX_REGIONS = 256;
+
+// Counters of one thread. Only the owning thread writes them; relaxed
+// atomics let a report read them while the thread keeps running.
+struct Counter {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> nanoseconds;
+    std::atomic<double> flops;
+    std::atomic<double> bytes;
+};
+
+struct ThreadCounters {
+    Counter regions[MAX_REGIONS];
+
+    ThreadCounters() {
+        for (Counter& c : regions) {
+            c.calls.store(0, std::memory_order_relaxed);
+            c.nanoseconds.store(0, std::memory_order_relaxed);
+            c.flops.store(0.0, std::memory_order_relaxed);
+            c.bytes.store(0.0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Region names and the counters of every thread that ever recorded. Never
+// destroyed, so the exit report can still read it, and counters of threads
+// that have finished are kept.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<ThreadCounters>> threads;
+};
+
+static Registry& registry() {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+static ThreadCounters& threadCounters() {
+    thread_local ThreadCounters* counters = nullptr;
+    if (counters == nullptr) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threads.emplace_back(new ThreadCounters);
+        counters = r.threads.back().get();
+    }
+    return *counters;
+}
+
+int registerRegion(const char* name) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (size_t i = 0; i < r.names.size(); ++i) {
+        if (r.names[i] == name) return (int)i;
+    }
+    if ((int)r.names.size() == MAX_REGIONS) {
+        throw std::logic_error("Too many profiler regions");
+    }
+    r.names.push_back(name);
+    return (int)r.names.size() - 1;
+}
+
+void record(int region, uint64_t nanoseconds, double flops, double bytes) {
+    Counter& c = threadCounters().regions[region];
+    c.calls.store(c.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    c.nanoseconds.store(c.nanoseconds.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+    c.flops.store(c.flops.load(std::memory_order_relaxed) + flops, std::memory_order_relaxed);
+    c.bytes.store(c.bytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+}
+
+std::vector<RegionStats> collect() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<RegionStats> stats;
+    for (size_t i = 0; i < r.names.size(); ++i) {
+        RegionStats s = {r.names[i], 0, 0.0, 0.0, 0.0};
+        for (const auto& t : r.threads) {
+            const Counter& c = t->regions[i];
+            s.calls += c.calls.load(std::memory_order_relaxed);
+            s.seconds += c.nanoseconds.load(std::memory_order_relaxed) * 1e-9;
+            s.flops += c.flops.load(std::memory_order_relaxed);
+            s.bytes += c.bytes.load(std::memory_order_relaxed);
+        }
+        if (s.calls > 0) stats.push_back(s);
+    }
+    std::sort(stats.begin(), stats.end(),
+              [](const RegionStats& a, const RegionStats& b) { return a.seconds > b.seconds; });
+    return stats;
+}
+
+void reset() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto& t : r.threads) {
+        for (Counter& c : t->regions) {
+            c.calls.store(0, std::memory_order_relaxed);
+            c.nanoseconds.store(0, std::memory_order_relaxed);
+            c.flops.store(0.0, std::memory_order_relaxed);
+            c.bytes.store(0.0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void writeText(std::ostream& out) {
+    std::vector<RegionStats> stats = collect();
+    std::ostringstream table;
+    table << std::left << std::setw(28) << "region" << std::right << std::setw(12) << "calls"
+          << std::setw(12) << "total ms" << std::setw(12) << "mean us" << std::setw(10) << "GFLOP/s"
+          << std::setw(10) << "GB/s" << "\n";
+    table << std::fixed;
+    for (const RegionStats& s : stats) {
+        double seconds = s.seconds > 0.0 ? s.seconds : 1e-12;
+        table << std::left << std::setw(28) << s.name << std::right << std::setw(12) << s.calls
+              << std::setw(12) << std::setprecision(3) << s.seconds * 1e3
+              << std::setw(12) << std::setprecision(3) << s.seconds * 1e6 / s.calls
+              << std::setw(10) << std::setprecision(2) << s.flops / seconds * 1e-9
+              << std::setw(10) << std::setprecision(2) << s.bytes / seconds * 1e-9 << "\n";
+    }
+    out << table.str();
+}
+
+static std::string jsonString(const std::string& s) {
+    std::string quoted = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+void writeJson(std::ostream& out) {
+    std::vector<RegionStats> stats = collect();
+    std::ostringstream json;
+    json << std::setprecision(9) << "{\"regions\": [";
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const RegionStats& s = stats[i];
+        json << (i == 0 ? "\n" : ",\n") << "  {\"name\": " << jsonString(s.name) << ", \"calls\": " << s.calls
+             << ", \"seconds\": " << s.seconds << ", \"flops\": " << s.flops << ", \"bytes\": " << s.bytes << "}";
+    }
+    json << "\n]}\n";
+    out << json.str();
+}
+
+#ifdef TINI_PROFILE
+// Writes the report when the program exits
+struct ExitReport {
+    ~ExitReport() {
+        const char* format = std::getenv("TINI_PROFILE_FORMAT");
+        std::string f = format ? format : "text";
+        if (f == "off" || collect().empty()) return;
+
+        const char* path = std::getenv("TINI_PROFILE_OUTPUT");
+        std::ofstream file;
+        if (path != nullptr && *path != '\0') file.open(path);
+        std::ostream& out = file.is_open() ? static_cast<std::ostream&>(file) : std::cerr;
+        if (f == "json") {
+            writeJson(out);
+        } else {
+            out << "\n==== Profile ====\n";
+            writeText(out);
+        }
+    }
+};
+
+static ExitReport exitReport;
+#endif
+
+}
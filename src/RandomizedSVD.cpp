@@ -0,0 +1,215 @@
+#include "RandomizedSVD.h"
+#include "Kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+const int JACOBI_MAX_SWEEPS = 60;
+
+static Matrix transposeOf(const Matrix& A) {
+    int m = A.numRows(), n = A.numCols();
+    Matrix T(n, m);
+    const double* a = A.data();
+    double* t = T.data();
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            t[(size_t)j * m + i] = a[(size_t)i * n + j];
+        }
+    }
+    return T;
+}
+
+// Replace the columns of Y by an orthonormal basis of their span
+static void orthonormalize(Matrix& Y) {
+    int m = Y.numRows(), l = Y.numCols();
+    vector<double> tau(l);
+    Matrix R(Y);
+    kernels::householderQR(m, l, R.data(), l, tau.data());
+    kernels::formQ(m, l, R.data(), l, tau.data(), Y.data(), l);
+}
+
+// One-sided Jacobi on the rows of B (l x n): rotations G from the left make the
+// rows of GB orthogonal, so B = Gᵀ Σ Vᵀ. On return B holds Σ Vᵀ and G the
+// accumulated rotations.
+static void jacobiRows(Matrix& B, Matrix& G) {
+    int l = B.numRows(), n = B.numCols();
+    double* b = B.data();
+    double* g = G.data();
+    const double eps = 1e-15;
+
+    for (int sweep = 0; sweep < JACOBI_MAX_SWEEPS; ++sweep) {
+        bool rotated = false;
+        for (int p = 0; p < l - 1; ++p) {
+            for (int q = p + 1; q < l; ++q) {
+                double* bp = b + (size_t)p * n;
+                double* bq = b + (size_t)q * n;
+                double alpha = 0.0, beta = 0.0, gamma = 0.0;
+                for (int j = 0; j < n; ++j) {
+                    alpha += bp[j] * bp[j];
+                    beta += bq[j] * bq[j];
+                    gamma += bp[j] * bq[j];
+                }
+                if (fabs(gamma) <= eps * sqrt(alpha * beta) || gamma == 0.0) continue;
+                rotated = true;
+
+                double zeta = (beta - alpha) / (2.0 * gamma);
+                double t = copysign(1.0, zeta) / (fabs(zeta) + sqrt(1.0 + zeta * zeta));
+                double c = 1.0 / sqrt(1.0 + t * t);
+                double s = c * t;
+                for (int j = 0; j < n; ++j) {
+                    double x = bp[j], y = bq[j];
+                    bp[j] = c * x - s * y;
+                    bq[j] = s * x + c * y;
+                }
+                double* gp = g + (size_t)p * l;
+                double* gq = g + (size_t)q * l;
+                for (int j = 0; j < l; ++j) {
+                    double x = gp[j], y = gq[j];
+                    gp[j] = c * x - s * y;
+                    gq[j] = s * x + c * y;
+                }
+            }
+        }
+        if (!rotated) break;
+    }
+}
+
+RandomizedSVD::RandomizedSVD(const Matrix& A, int rank, double rankTolerance,
+                             int oversampling, int powerIterations, unsigned seed)
+    : mRank(0), mpU(nullptr), mpSigma(nullptr), mpV(nullptr) {
+    int m = A.numRows();
+    int n = A.numCols();
+    int maxRank = min(m, n);
+    if (rank <= 0 || rank > maxRank) rank = maxRank;
+    int l = min(rank + max(oversampling, 0), maxRank);
+
+    // Gaussian test matrix and sample of the range, Y = AΩ
+    mt19937 rng(seed);
+    normal_distribution<double> normal(0.0, 1.0);
+    Matrix Omega(n, l);
+    double* omega = Omega.data();
+    for (size_t i = 0; i < (size_t)n * l; ++i) {
+        omega[i] = normal(rng);
+    }
+
+    Matrix Y = A * Omega;
+    orthonormalize(Y);
+
+    // Power iterations sharpen the spectrum: Q = orth(A orth(AᵀQ))
+    Matrix At = transposeOf(A);
+    for (int it = 0; it < powerIterations; ++it) {
+        Matrix Z = At * Y;
+        orthonormalize(Z);
+        Y = A * Z;
+        orthonormalize(Y);
+    }
+
+    // Project onto the basis, B = QᵀA (l x n), and take its SVD
+    Matrix B = transposeOf(Y) * A;
+    Matrix G(l, l);
+    for (int i = 1; i <= l; ++i) {
+        G(i, i) = 1.0;
+    }
+    jacobiRows(B, G);
+
+    vector<double> sigma(l);
+    for (int i = 0; i < l; ++i) {
+        const double* bi = B.data() + (size_t)i * n;
+        double sum = 0.0;
+        for (int j = 0; j < n; ++j) {
+            sum += bi[j] * bi[j];
+        }
+        sigma[i] = sqrt(sum);
+    }
+    vector<int> order(l);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](int a, int b) { return sigma[a] > sigma[b]; });
+
+    double cutoff = rankTolerance * (l > 0 ? sigma[order[0]] : 0.0);
+    while (mRank < rank && sigma[order[mRank]] > cutoff && sigma[order[mRank]] > 0.0) {
+        ++mRank;
+    }
+    if (mRank == 0) {
+        throw runtime_error("Matrix has no singular values above the rank tolerance");
+    }
+
+    // U = Q Gᵀ (restricted to the kept rows of G), V = rows of ΣVᵀ scaled by 1/σ
+    Matrix Gk(l, mRank);
+    mpSigma = new Vector(mRank);
+    mpV = new Matrix(n, mRank);
+    for (int r = 0; r < mRank; ++r) {
+        int src = order[r];
+        (*mpSigma)(r + 1) = sigma[src];
+        for (int j = 0; j < l; ++j) {
+            Gk(j + 1, r + 1) = G(src + 1, j + 1);
+        }
+        for (int j = 0; j < n; ++j) {
+            (*mpV)(j + 1, r + 1) = B(src + 1, j + 1) / sigma[src];
+        }
+    }
+    mpU = new Matrix(Y * Gk);
+}
+
+RandomizedSVD::~RandomizedSVD() {
+    delete mpU;
+    delete mpSigma;
+    delete mpV;
+}
+
+int RandomizedSVD::Rank() const { return mRank; }
+const Matrix& RandomizedSVD::U() const { return *mpU; }
+const Vector& RandomizedSVD::SingularValues() const { return *mpSigma; }
+const Matrix& RandomizedSVD::V() const { return *mpV; }
+
+Matrix RandomizedSVD::PseudoInverse() const {
+    int m = mpU->numRows();
+    Matrix VS(*mpV);
+    for (int r = 1; r <= mRank; ++r) {
+        double inv = 1.0 / (*mpSigma)(r);
+        for (int j = 1; j <= VS.numRows(); ++j) {
+            VS(j, r) *= inv;
+        }
+    }
+    Matrix Ut(mRank, m);
+    for (int i = 1; i <= m; ++i) {
+        for (int r = 1; r <= mRank; ++r) {
+            Ut(r, i) = (*mpU)(i, r);
+        }
+    }
+    return VS * Ut;
+}
+
+Vector RandomizedSVD::Solve(Vector& b) const {
+    int m = mpU->numRows();
+    int n = mpV->numRows();
+    if (b.size() != m) {
+        throw invalid_argument("Matrix and vector sizes do not match");
+    }
+
+    // c = Σ⁻¹ Uᵀ b, then x = V c
+    vector<double> c(mRank, 0.0);
+    for (int i = 1; i <= m; ++i) {
+        double bi = b(i);
+        for (int r = 1; r <= mRank; ++r) {
+            c[r - 1] += (*mpU)(i, r) * bi;
+        }
+    }
+    for (int r = 1; r <= mRank; ++r) {
+        c[r - 1] /= (*mpSigma)(r);
+    }
+
+    Vector x(n);
+    for (int j = 1; j <= n; ++j) {
+        double sum = 0.0;
+        for (int r = 1; r <= mRank; ++r) {
+            sum += (*mpV)(j, r) * c[r - 1];
+        }
+        x(j) = sum;
+    }
+    return x;
+}
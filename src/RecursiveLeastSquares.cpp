@@ -0,0 +1,125 @@
+#include "RecursiveLeastSquares.h"
+#include "Profiler.h"
+#include <stdexcept>
+
+using namespace std;
+
+RecursiveLeastSquares::RecursiveLeastSquares(int numFeatures, double forgetting, double priorVariance)
+    : mNumFeatures(numFeatures), mForgetting(forgetting), mCount(0),
+      mpP(nullptr), mpTheta(nullptr), mpWork(nullptr) {
+    if (numFeatures <= 0) {
+        throw invalid_argument("RLS needs at least one feature");
+    }
+    if (forgetting <= 0.0 || forgetting > 1.0) {
+        throw invalid_argument("Forgetting factor must be in (0, 1]");
+    }
+    if (priorVariance <= 0.0) {
+        throw invalid_argument("Prior variance must be positive");
+    }
+    mpP = new Matrix(numFeatures, numFeatures);
+    mpTheta = new Vector(numFeatures);
+    mpWork = new Vector(numFeatures);
+    for (int i = 1; i <= numFeatures; ++i) {
+        (*mpP)(i, i) = priorVariance;
+    }
+}
+
+RecursiveLeastSquares::~RecursiveLeastSquares() {
+    delete mpP;
+    delete mpTheta;
+    delete mpWork;
+}
+
+double RecursiveLeastSquares::MultiplyP(const double* x) {
+    int p = mNumFeatures;
+    const double* P = mpP->data();
+    double* u = mpWork->data();
+    double xPx = 0.0;
+    for (int i = 0; i < p; ++i) {
+        const double* row = P + (size_t)i * p;
+        double sum = 0.0;
+        for (int j = 0; j < p; ++j) {
+            sum += row[j] * x[j];
+        }
+        u[i] = sum;
+        xPx += x[i] * sum;
+    }
+    return xPx;
+}
+
+// Sherman-Morrison with u = Px:
+//   θ ← θ + u e / (λ + xᵀu),   P ← (P - u uᵀ / (λ + xᵀu)) / λ
+// u_i u_j / den is the same product for (i, j) and (j, i), so P stays exactly symmetric.
+double RecursiveLeastSquares::Update(const double* x, double y) {
+    PROFILE_SCOPE_WORK("RLS update", 4.0 * mNumFeatures * mNumFeatures, 8.0 * mNumFeatures * mNumFeatures);
+    int p = mNumFeatures;
+    double* P = mpP->data();
+    double* theta = mpTheta->data();
+    const double* u = mpWork->data();
+
+    double error = y - Predict(x);
+    double denominator = mForgetting + MultiplyP(x);
+    double gain = error / denominator;
+    double inverse = 1.0 / denominator;
+    double scale = 1.0 / mForgetting;
+    for (int i = 0; i < p; ++i) {
+        theta[i] += u[i] * gain;
+        double* row = P + (size_t)i * p;
+        for (int j = 0; j < p; ++j) {
+            row[j] = (row[j] - u[i] * u[j] * inverse) * scale;
+        }
+    }
+    ++mCount;
+    return error;
+}
+
+// Removing a row adds it back with a negative sign:
+//   P ← P + u uᵀ / (1 - xᵀu),   θ ← θ - P x (y - xᵀθ)   (with the new P)
+double RecursiveLeastSquares::Downdate(const double* x, double y) {
+    PROFILE_SCOPE_WORK("RLS downdate", 4.0 * mNumFeatures * mNumFeatures, 8.0 * mNumFeatures * mNumFeatures);
+    int p = mNumFeatures;
+    double* P = mpP->data();
+    double* theta = mpTheta->data();
+    const double* u = mpWork->data();
+
+    double error = y - Predict(x);
+    double denominator = 1.0 - MultiplyP(x);
+    if (denominator <= 0.0) {
+        throw runtime_error("RLS downdate of a row that is not in the fit");
+    }
+    // P_new x = u / (1 - xᵀu), so θ moves along u
+    double gain = error / denominator;
+    double inverse = 1.0 / denominator;
+    for (int i = 0; i < p; ++i) {
+        theta[i] -= u[i] * gain;
+        double* row = P + (size_t)i * p;
+        for (int j = 0; j < p; ++j) {
+            row[j] += u[i] * u[j] * inverse;
+        }
+    }
+    --mCount;
+    return error;
+}
+
+void RecursiveLeastSquares::UpdateRows(const Matrix& A, const Vector& b) {
+    if (A.numCols() != mNumFeatures || A.numRows() != b.size()) {
+        throw invalid_argument("Rows and targets do not match the model");
+    }
+    for (int i = 0; i < A.numRows(); ++i) {
+        Update(A.data() + (size_t)i * mNumFeatures, b.data()[i]);
+    }
+}
+
+double RecursiveLeastSquares::Predict(const double* x) const {
+    const double* theta = mpTheta->data();
+    double sum = 0.0;
+    for (int i = 0; i < mNumFeatures; ++i) {
+        sum += theta[i] * x[i];
+    }
+    return sum;
+}
+
+const Vector& RecursiveLeastSquares::Coefficients() const { return *mpTheta; }
+const Matrix& RecursiveLeastSquares::InverseGram() const { return *mpP; }
+int RecursiveLeastSquares::NumFeatures() const { return mNumFeatures; }
+long RecursiveLeastSquares::Count() const { return mCount; }
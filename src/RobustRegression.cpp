@@ -0,0 +1,309 @@
+#include "RobustRegression.h"
+#include "Kernels.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+// Rows per Gram accumulation chunk. Every chunk owns one slot of mPartials and
+// the slots are added in chunk order, so the sums do not depend on the thread count.
+static const int GRAM_ROW_CHUNK = 8192;
+
+// 1 / Φ⁻¹(3/4): median|r| of standard normal residuals times this is 1
+static const double MAD_CONSISTENCY = 1.482602218505602;
+
+RobustRegression::RobustRegression(const Matrix* A, const Vector* b, RobustLoss loss, double tuning)
+    : mpA(A), mpb(b), mLoss(loss), mTolerance(1e-8), mMaxIterations(50), mScale(0.0), mConverged(false), mIterations(0) {
+    if (A == nullptr || b == nullptr) {
+        throw invalid_argument("Matrix and Vector cannot be null");
+    }
+    mNumRows = A->numRows();
+    mNumCols = A->numCols();
+    if (b->size() != mNumRows) {
+        throw invalid_argument("Right-hand side length does not match the matrix");
+    }
+    if (mNumRows <= mNumCols) {
+        throw invalid_argument("Robust regression needs more rows than coefficients");
+    }
+    mTuning = tuning > 0.0 ? tuning : (loss == RobustLoss::Huber ? 1.345 : 4.685);
+
+    mpGram = new Matrix(mNumCols, mNumCols);
+    mpRhs = new Vector(mNumCols);
+    mpTheta = new Vector(mNumCols);
+    mpWeights = new Vector(mNumRows);
+    mpResiduals = new Vector(mNumRows);
+    mpScratch = new Vector(mNumRows);
+    mpSolverWork = new Vector(5 * mNumCols);
+    int numChunks = (mNumRows + GRAM_ROW_CHUNK - 1) / GRAM_ROW_CHUNK;
+    mPartials.assign((size_t)numChunks * (mNumCols * (mNumCols + 1) / 2 + mNumCols), 0.0);
+    mHistory.reserve(mMaxIterations + 1);
+}
+
+RobustRegression::~RobustRegression() {
+    delete mpGram;
+    delete mpRhs;
+    delete mpTheta;
+    delete mpWeights;
+    delete mpResiduals;
+    delete mpScratch;
+    delete mpSolverWork;
+}
+
+void RobustRegression::SetTolerance(double tolerance) {
+    mTolerance = tolerance;
+}
+
+void RobustRegression::SetMaxIterations(int maxIterations) {
+    mMaxIterations = max(maxIterations, 1);
+    mHistory.reserve(mMaxIterations + 1);
+}
+
+const Vector& RobustRegression::Fit() {
+    PROFILE_SCOPE("RobustRegression::Fit");
+    mHistory.clear();
+    mConverged = false;
+    mIterations = 0;
+
+    // Iteration 0 is ordinary least squares: unit weights, CG from zero
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    fill(mpWeights->begin(), mpWeights->end(), 1.0);
+    fill(mpTheta->begin(), mpTheta->end(), 0.0);
+    Accumulate(mpWeights->data(), true);
+    int solverIterations = SolveWeighted();
+    mHistory.push_back({chrono::duration<double>(chrono::steady_clock::now() - start).count(), 0.0, mNumRows, true,
+                        solverIterations, 1.0});
+    Iterate();
+    return *mpTheta;
+}
+
+const Vector& RobustRegression::Fit(const Vector& start) {
+    PROFILE_SCOPE("RobustRegression::Fit");
+    if (start.size() != mNumCols) {
+        throw invalid_argument("Starting coefficients do not match the number of columns");
+    }
+    mHistory.clear();
+    mConverged = false;
+    mIterations = 0;
+
+    // The first reweighting sees every row as changed and rebuilds
+    copy(start.begin(), start.end(), mpTheta->begin());
+    fill(mpWeights->begin(), mpWeights->end(), 0.0);
+    fill(mpGram->data(), mpGram->data() + (size_t)mNumCols * mNumCols, 0.0);
+    fill(mpRhs->begin(), mpRhs->end(), 0.0);
+    Iterate();
+    return *mpTheta;
+}
+
+void RobustRegression::Iterate() {
+    double* theta = mpTheta->data();
+    double* previous = mpSolverWork->data() + 4 * mNumCols;
+    const double* w = mpWeights->data();
+    double* next = mpScratch->data();
+
+    while (mIterations < mMaxIterations) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ComputeResiduals();
+        mScale = EstimateScale();
+        if (mScale == 0.0) {
+            // More than half of the rows are fitted exactly; the fit cannot move
+            mConverged = true;
+            return;
+        }
+
+        // New weights into the scratch buffer
+        const double* r = mpResiduals->data();
+        double c = mTuning;
+        double inverseScale = 1.0 / mScale;
+        int changed = 0;
+        for (int i = 0; i < mNumRows; ++i) {
+            double u = fabs(r[i] * inverseScale);
+            double weight;
+            if (mLoss == RobustLoss::Huber) {
+                weight = u <= c ? 1.0 : c / u;
+            } else {
+                double t = u / c;
+                weight = t < 1.0 ? (1.0 - t * t) * (1.0 - t * t) : 0.0;
+            }
+            next[i] = weight;
+            changed += weight != w[i];
+        }
+
+        bool rebuild = 2 * changed > mNumRows;
+        if (rebuild) {
+            Accumulate(next, true);
+        } else {
+            // The residuals are spent; their buffer takes the weight changes
+            double* delta = mpResiduals->data();
+            for (int i = 0; i < mNumRows; ++i) {
+                delta[i] = next[i] - w[i];
+            }
+            Accumulate(delta, false);
+        }
+        copy(next, next + mNumRows, mpWeights->begin());
+
+        copy(theta, theta + mNumCols, previous);
+        int solverIterations = SolveWeighted();
+        double difference = 0.0, size = 0.0;
+        for (int j = 0; j < mNumCols; ++j) {
+            difference = max(difference, fabs(theta[j] - previous[j]));
+            size = max(size, fabs(theta[j]));
+        }
+        double step = size > 0.0 ? difference / size : difference;
+        mHistory.push_back({chrono::duration<double>(chrono::steady_clock::now() - start).count(), mScale, changed,
+                            rebuild, solverIterations, step});
+        ++mIterations;
+        if (step <= mTolerance) {
+            mConverged = true;
+            return;
+        }
+    }
+}
+
+void RobustRegression::ComputeResiduals() {
+    PROFILE_SCOPE_WORK("RobustRegression::residuals", 2.0 * mNumRows * mNumCols,
+                       8.0 * ((double)mNumRows * mNumCols + 2.0 * mNumRows));
+    double* r = mpResiduals->data();
+    const double* b = mpb->data();
+    kernels::gemv(mNumRows, mNumCols, mpA->data(), mNumCols, mpTheta->data(), r);
+    for (int i = 0; i < mNumRows; ++i) {
+        r[i] = b[i] - r[i];
+    }
+}
+
+double RobustRegression::EstimateScale() {
+    double* magnitudes = mpScratch->data();
+    const double* r = mpResiduals->data();
+    for (int i = 0; i < mNumRows; ++i) {
+        magnitudes[i] = fabs(r[i]);
+    }
+    // Upper median; the scale only has to be consistent between iterations
+    double* middle = magnitudes + mNumRows / 2;
+    nth_element(magnitudes, middle, magnitudes + mNumRows);
+    return MAD_CONSISTENCY * *middle;
+}
+
+void RobustRegression::Accumulate(const double* c, bool reset) {
+    int p = mNumCols;
+    size_t triangle = (size_t)p * (p + 1) / 2;
+    size_t slot = triangle + p;
+    int numChunks = (mNumRows + GRAM_ROW_CHUNK - 1) / GRAM_ROW_CHUNK;
+    const double* A = mpA->data();
+    const double* b = mpb->data();
+    double* partials = mPartials.data();
+    int numRows = mNumRows;
+    PROFILE_SCOPE_WORK("RobustRegression::accumulate", (double)mNumRows * (p + 1) * (p + 2),
+                       8.0 * ((double)mNumRows * (p + 2)));
+
+    parallelFor(0, numChunks, 1, [=](int first, int last) {
+        for (int chunk = first; chunk < last; ++chunk) {
+            double* G = partials + chunk * slot;
+            double* g = G + triangle;
+            fill(G, G + slot, 0.0);
+            int end = min((chunk + 1) * GRAM_ROW_CHUNK, numRows);
+            for (int i = chunk * GRAM_ROW_CHUNK; i < end; ++i) {
+                if (c[i] == 0.0) continue;   // Unchanged rows of an update, rejected rows of Tukey
+                const double* a = A + (size_t)i * p;
+                double* T = G;
+                for (int j = 0; j < p; ++j) {
+                    double ca = c[i] * a[j];
+                    for (int k = j; k < p; ++k) {
+                        T[k - j] += ca * a[k];
+                    }
+                    T += p - j;
+                    g[j] += ca * b[i];
+                }
+            }
+        }
+    });
+
+    // Chunk sums in order, then into the symmetric Gram matrix
+    double* gram = mpGram->data();
+    double* rhs = mpRhs->data();
+    if (reset) {
+        fill(gram, gram + (size_t)p * p, 0.0);
+        fill(rhs, rhs + p, 0.0);
+    }
+    for (int chunk = 0; chunk < numChunks; ++chunk) {
+        const double* T = partials + chunk * slot;
+        for (int j = 0; j < p; ++j) {
+            for (int k = j; k < p; ++k) {
+                gram[(size_t)j * p + k] += *T++;
+            }
+        }
+        for (int j = 0; j < p; ++j) {
+            rhs[j] += T[j];
+        }
+    }
+    for (int j = 0; j < p; ++j) {
+        for (int k = j + 1; k < p; ++k) {
+            gram[(size_t)k * p + j] = gram[(size_t)j * p + k];
+        }
+    }
+}
+
+int RobustRegression::SolveWeighted() {
+    // Jacobi-preconditioned CG on the p x p weighted normal equations, from the current θ
+    int p = mNumCols;
+    const double* G = mpGram->data();
+    const double* g = mpRhs->data();
+    double* x = mpTheta->data();
+    double* r = mpSolverWork->data();
+    double* z = r + p;
+    double* d = z + p;
+    double* q = d + p;
+
+    kernels::gemv(p, p, G, p, x, q);
+    for (int j = 0; j < p; ++j) {
+        r[j] = g[j] - q[j];
+        z[j] = G[(size_t)j * p + j] > 0.0 ? r[j] / G[(size_t)j * p + j] : r[j];
+        d[j] = z[j];
+    }
+    double rz = kernels::dot(p, r, z);
+    double target = 1e-14 * kernels::nrm2(p, g);
+    int iterations = 0;
+    int maxIterations = 2 * p + 10;
+    while (kernels::nrm2(p, r) > target && iterations < maxIterations) {
+        kernels::gemv(p, p, G, p, d, q);
+        double dq = kernels::dot(p, d, q);
+        if (dq <= 0.0) break;   // Singular weighted Gram matrix: keep what we have
+        double alpha = rz / dq;
+        kernels::axpy(p, alpha, d, x);
+        kernels::axpy(p, -alpha, q, r);
+        for (int j = 0; j < p; ++j) {
+            z[j] = G[(size_t)j * p + j] > 0.0 ? r[j] / G[(size_t)j * p + j] : r[j];
+        }
+        double rzNext = kernels::dot(p, r, z);
+        kernels::axpby(p, 1.0, z, rzNext / rz, d);
+        rz = rzNext;
+        ++iterations;
+    }
+    return iterations;
+}
+
+const Vector& RobustRegression::Coefficients() const {
+    return *mpTheta;
+}
+
+const Vector& RobustRegression::Weights() const {
+    return *mpWeights;
+}
+
+double RobustRegression::Scale() const {
+    return mScale;
+}
+
+bool RobustRegression::Converged() const {
+    return mConverged;
+}
+
+int RobustRegression::Iterations() const {
+    return mIterations;
+}
+
+const std::vector<IrlsIteration>& RobustRegression::History() const {
+    return mHistory;
+}
@@ -0,0 +1,253 @@
+#include "SolveService.h"
+#include "Parallel.h"
+#include <algorithm>
+
+struct SolveService::Request {
+    uint64_t id;
+    int size;
+    std::shared_ptr<Matrix> A;               // null for prebuilt systems
+    std::unique_ptr<Vector> b;
+    std::shared_ptr<LinearSystem> system;
+    std::promise<Vector> promise;
+};
+
+SolveService::Options::Options()
+    : numWorkers(ThreadPool::instance().numThreads()), maxPending(1024), maxBatch(32) {}
+
+SolveService::SolveService(const Options& options)
+    : mOptions(options), mRunning(0), mStop(false), mNextId(1), mStats() {
+    mOptions.numWorkers = std::max(mOptions.numWorkers, 1);
+    mOptions.maxPending = std::max<size_t>(mOptions.maxPending, 1);
+    mOptions.maxBatch = std::max(mOptions.maxBatch, 1);
+    mDispatcher = std::thread(&SolveService::dispatchLoop, this);
+}
+
+SolveService::~SolveService() {
+    shutdown();
+}
+
+SolveTicket SolveService::submit(const Matrix& A, const Vector& b) {
+    return submit(std::make_shared<Matrix>(A), b);
+}
+
+static void checkSystem(const Matrix* A, const Vector& b) {
+    if (A == nullptr) {
+        throw invalid_argument("Matrix cannot be null");
+    }
+    if (A->numRows() != A->numCols()) {
+        throw invalid_argument("Matrix is not square");
+    }
+    if (A->numRows() != b.size()) {
+        throw invalid_argument("Matrix and Vector dimensions do not match");
+    }
+}
+
+SolveTicket SolveService::submit(std::shared_ptr<Matrix> A, const Vector& b) {
+    checkSystem(A.get(), b);
+    std::unique_ptr<Request> request(new Request);
+    request->size = b.size();
+    request->A = std::move(A);
+    request->b.reset(new Vector(b));
+    return enqueue(std::move(request), true, nullptr);
+}
+
+SolveTicket SolveService::submit(std::shared_ptr<LinearSystem> system) {
+    if (system == nullptr) {
+        throw invalid_argument("System cannot be null");
+    }
+    std::unique_ptr<Request> request(new Request);
+    request->size = system->Size();
+    request->system = std::move(system);
+    return enqueue(std::move(request), true, nullptr);
+}
+
+bool SolveService::trySubmit(std::shared_ptr<Matrix> A, const Vector& b, SolveTicket& ticket) {
+    checkSystem(A.get(), b);
+    std::unique_ptr<Request> request(new Request);
+    request->size = b.size();
+    request->A = std::move(A);
+    request->b.reset(new Vector(b));
+    bool accepted = true;
+    SolveTicket queued = enqueue(std::move(request), false, &accepted);
+    if (accepted) {
+        ticket = std::move(queued);
+    }
+    return accepted;
+}
+
+SolveTicket SolveService::enqueue(std::unique_ptr<Request> request, bool block, bool* accepted) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (!mStop && mQueue.size() >= mOptions.maxPending) {
+        if (!block) {
+            *accepted = false;
+            return SolveTicket{0, std::future<Vector>()};
+        }
+        mSpace.wait(lock, [this] { return mStop || mQueue.size() < mOptions.maxPending; });
+    }
+    if (mStop) {
+        throw logic_error("SolveService has been shut down");
+    }
+
+    SolveTicket ticket{mNextId++, request->promise.get_future()};
+    request->id = ticket.id;
+    mQueue.push_back(std::move(request));
+    mStats.submitted += 1;
+    lock.unlock();
+    mWork.notify_one();
+    return ticket;
+}
+
+bool SolveService::cancel(uint64_t id) {
+    std::unique_ptr<Request> request;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = std::find_if(mQueue.begin(), mQueue.end(),
+                               [id](const std::unique_ptr<Request>& r) { return r->id == id; });
+        if (it == mQueue.end()) {
+            return false;
+        }
+        request = std::move(*it);
+        mQueue.erase(it);
+        mStats.cancelled += 1;
+    }
+    mSpace.notify_one();
+    request->promise.set_exception(std::make_exception_ptr(SolveCancelled()));
+    return true;
+}
+
+void SolveService::shutdown() {
+    std::deque<std::unique_ptr<Request>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mStop && !mDispatcher.joinable()) {
+            return;
+        }
+        mStop = true;
+        dropped.swap(mQueue);
+        mStats.cancelled += dropped.size();
+    }
+    mWork.notify_all();
+    mSpace.notify_all();
+    for (auto& request : dropped) {
+        request->promise.set_exception(std::make_exception_ptr(SolveCancelled()));
+    }
+    mDispatcher.join();
+}
+
+size_t SolveService::pending() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mQueue.size();
+}
+
+SolveService::Stats SolveService::stats() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+void SolveService::dispatchLoop() {
+    // Batches run as pool tasks; with a single-threaded pool run() executes
+    // them inline on this thread
+    TaskGroup batches;
+    while (true) {
+        auto batch = std::make_shared<std::vector<std::unique_ptr<Request>>>();
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWork.wait(lock, [this] { return mStop || (!mQueue.empty() && mRunning < mOptions.numWorkers); });
+            if (mStop) {
+                break;
+            }
+
+            // The oldest request and the next queued ones of the same size
+            int size = mQueue.front()->size;
+            for (auto it = mQueue.begin(); it != mQueue.end() && (int)batch->size() < mOptions.maxBatch;) {
+                if ((*it)->size == size) {
+                    batch->push_back(std::move(*it));
+                    it = mQueue.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            mStats.batches += 1;
+            mRunning += 1;
+        }
+        mSpace.notify_all();
+        batches.run([this, batch] {
+            {
+                // Systems are solved concurrently, so each one runs its kernels serially
+                SerialRegion serial;
+                runBatch(*batch);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mRunning -= 1;
+            }
+            mWork.notify_one();
+        });
+    }
+    batches.wait();
+}
+
+void SolveService::runBatch(std::vector<std::unique_ptr<Request>>& batch) {
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+
+    for (size_t first = 0; first < batch.size(); ++first) {
+        if (batch[first] == nullptr) continue;
+
+        // Prebuilt systems run on their own
+        if (batch[first]->system != nullptr) {
+            try {
+                batch[first]->promise.set_value(batch[first]->system->Solve());
+                completed += 1;
+            } catch (...) {
+                batch[first]->promise.set_exception(std::current_exception());
+                failed += 1;
+            }
+            batch[first].reset();
+            continue;
+        }
+
+        // All requests of the batch with this matrix share its factorization
+        std::vector<std::unique_ptr<Request>> group;
+        Matrix* A = batch[first]->A.get();
+        for (size_t k = first; k < batch.size(); ++k) {
+            if (batch[k] != nullptr && batch[k]->system == nullptr && batch[k]->A.get() == A) {
+                group.push_back(std::move(batch[k]));
+            }
+        }
+
+        // Results can be delivered before a later one fails (e.g. allocating
+        // the last column), so only the undelivered promises get the exception
+        size_t delivered = 0;
+        try {
+            if (group.size() == 1) {
+                LinearSystem system(A, group[0]->b.get());
+                group[0]->promise.set_value(system.Solve());
+                delivered = 1;
+            } else {
+                int n = A->numRows();
+                int count = (int)group.size();
+                Matrix B(n, count);
+                for (int j = 1; j <= count; ++j) {
+                    B.col(j).assign(group[j - 1]->b->view());
+                }
+                LinearSystem system(A, &B);
+                Matrix X = system.SolveMultiple();
+                for (int j = 1; j <= count; ++j) {
+                    group[j - 1]->promise.set_value(Vector(X.col(j)));
+                    delivered = j;
+                }
+            }
+        } catch (...) {
+            for (size_t k = delivered; k < group.size(); ++k) {
+                group[k]->promise.set_exception(std::current_exception());
+            }
+            failed += group.size() - delivered;
+        }
+        completed += delivered;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats.completed += completed;
+    mStats.failed += failed;
+}
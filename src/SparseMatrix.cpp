@@ -0,0 +1,141 @@
+#include "SparseMatrix.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <stdexcept>
+
+SparseMatrix::SparseMatrix(int numRows, int numCols, const std::vector<Triplet>& entries)
+    : mNumRows(numRows), mNumCols(numCols), mRowStart(numRows + 1, 0) {
+    for (const Triplet& t : entries) {
+        if (t.row < 1 || t.row > numRows || t.col < 1 || t.col > numCols) {
+            throw std::invalid_argument("Sparse matrix entry out of bounds");
+        }
+    }
+
+    // Sort by (row, col) and merge duplicates
+    std::vector<Triplet> sorted(entries);
+    std::sort(sorted.begin(), sorted.end(), [](const Triplet& a, const Triplet& b) {
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+
+    mColIndex.reserve(sorted.size());
+    mValues.reserve(sorted.size());
+    for (size_t k = 0; k < sorted.size(); ++k) {
+        const Triplet& t = sorted[k];
+        if (k > 0 && sorted[k - 1].row == t.row && sorted[k - 1].col == t.col) {
+            mValues.back() += t.value;
+            continue;
+        }
+        mColIndex.push_back(t.col - 1);
+        mValues.push_back(t.value);
+        mRowStart[t.row]++;
+    }
+    for (int i = 0; i < numRows; ++i) {
+        mRowStart[i + 1] += mRowStart[i];
+    }
+}
+
+SparseMatrix::SparseMatrix(const Matrix& dense)
+    : mNumRows(dense.numRows()), mNumCols(dense.numCols()), mRowStart(dense.numRows() + 1, 0) {
+    const double* a = dense.data();
+    for (int i = 0; i < mNumRows; ++i) {
+        for (int j = 0; j < mNumCols; ++j) {
+            double value = a[(size_t)i * mNumCols + j];
+            if (value != 0.0) {
+                mColIndex.push_back(j);
+                mValues.push_back(value);
+            }
+        }
+        mRowStart[i + 1] = static_cast<int>(mValues.size());
+    }
+}
+
+int SparseMatrix::numRows() const {
+    return mNumRows;
+}
+
+int SparseMatrix::numCols() const {
+    return mNumCols;
+}
+
+int SparseMatrix::nonZeros() const {
+    return static_cast<int>(mValues.size());
+}
+
+double SparseMatrix::operator()(int i, int j) const {
+    auto first = mColIndex.begin() + mRowStart[i - 1];
+    auto last = mColIndex.begin() + mRowStart[i];
+    auto it = std::lower_bound(first, last, j - 1);
+    if (it != last && *it == j - 1) {
+        return mValues[it - mColIndex.begin()];
+    }
+    return 0.0;
+}
+
+// Rows per SpMV task, small matrices stay on the calling thread
+static const int SPMV_ROW_GRAIN = 2048;
+
+void SparseMatrix::multiply(const double* x, double* y) const {
+    parallelFor(0, mNumRows, SPMV_ROW_GRAIN, [&](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            double sum = 0.0;
+            for (int k = mRowStart[i]; k < mRowStart[i + 1]; ++k) {
+                sum += mValues[k] * x[mColIndex[k]];
+            }
+            y[i] = sum;
+        }
+    });
+}
+
+// Each stored value is loaded once for all s columns
+void SparseMatrix::multiply(int s, const double* X, int ldx, double* Y, int ldy) const {
+    const int* rowStart = mRowStart.data();
+    const int* colIndex = mColIndex.data();
+    const double* values = mValues.data();
+    parallelFor(0, mNumRows, std::max(1, SPMV_ROW_GRAIN / std::max(s, 1)), [=](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            double* __restrict y = Y + (size_t)i * ldy;
+            for (int j = 0; j < s; ++j) {
+                y[j] = 0.0;
+            }
+            for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+                double a = values[k];
+                const double* __restrict x = X + (size_t)colIndex[k] * ldx;
+                for (int j = 0; j < s; ++j) {
+                    y[j] += a * x[j];
+                }
+            }
+        }
+    });
+}
+
+Vector SparseMatrix::operator*(Vector& v) const {
+    if (mNumCols != v.size()) {
+        throw std::invalid_argument("Matrix-Vector multiplication: dimensions don't match");
+    }
+    Vector result(mNumRows);
+    multiply(v.data(), result.data());
+    return result;
+}
+
+std::vector<double> SparseMatrix::diagonal() const {
+    std::vector<double> diag(std::min(mNumRows, mNumCols), 0.0);
+    for (int i = 0; i < (int)diag.size(); ++i) {
+        diag[i] = (*this)(i + 1, i + 1);
+    }
+    return diag;
+}
+
+Matrix SparseMatrix::toDense() const {
+    Matrix dense(mNumRows, mNumCols);
+    double* a = dense.data();
+    for (int i = 0; i < mNumRows; ++i) {
+        for (int k = mRowStart[i]; k < mRowStart[i + 1]; ++k) {
+            a[(size_t)i * mNumCols + mColIndex[k]] = mValues[k];
+        }
+    }
+    return dense;
+}
+
+const std::vector<int>& SparseMatrix::rowStart() const { return mRowStart; }
+const std::vector<int>& SparseMatrix::colIndex() const { return mColIndex; }
+const std::vector<double>& SparseMatrix::values() const { return mValues; }
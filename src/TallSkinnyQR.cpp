@@ -0,0 +1,149 @@
+#include "TallSkinnyQR.h"
+#include "Kernels.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+// Blocks shorter than this are not worth a task of their own
+const int TSQR_MIN_BLOCK_ROWS = 256;
+
+// Upper triangle of a factored block: min(rows, cols) x cols, row-major
+struct TriangularFactor {
+    int rows;
+    vector<double> data;
+};
+
+// QR-factor the rows x cols block in place and keep only its R
+static TriangularFactor reduceBlock(int rows, int cols, vector<double>& block) {
+    vector<double> tau(min(rows, cols));
+    kernels::householderQR(rows, min(rows, cols), block.data(), cols, tau.data());
+    if (rows < cols) {
+        // Fewer rows than columns: the trailing columns were not touched by
+        // the reflectors above, apply them now
+        kernels::applyQt(rows, rows, block.data(), cols, tau.data(), cols - rows,
+                         block.data() + rows, cols);
+    }
+
+    TriangularFactor R;
+    R.rows = min(rows, cols);
+    R.data.assign((size_t)R.rows * cols, 0.0);
+    for (int i = 0; i < R.rows; ++i) {
+        for (int j = i; j < cols; ++j) {
+            R.data[(size_t)i * cols + j] = block[(size_t)i * cols + j];
+        }
+    }
+    return R;
+}
+
+TallSkinnyQR::TallSkinnyQR(const Matrix& A, const Vector& b, int numBlocks)
+    : mNumRows(A.numRows()), mNumCols(A.numCols()), mpR(nullptr) {
+    int m = mNumRows;
+    int p = mNumCols;
+    int cols = p + 1;
+
+    if (b.size() != m) {
+        throw invalid_argument("Matrix and vector sizes do not match");
+    }
+    if (m < cols) {
+        throw invalid_argument("TSQR needs more rows than unknowns");
+    }
+
+    if (numBlocks <= 0) {
+        numBlocks = ThreadPool::instance().numThreads();
+    }
+    numBlocks = max(1, min(numBlocks, m / TSQR_MIN_BLOCK_ROWS));
+    int blockRows = (m + numBlocks - 1) / numBlocks;
+    numBlocks = (m + blockRows - 1) / blockRows;
+
+    // Leaves: factor each block of [A | b] on its own thread
+    const double* a = A.data();
+    const double* rhs = b.data();
+    vector<TriangularFactor> factors(numBlocks);
+    parallelFor(0, numBlocks, 1, [&](int first, int last) {
+        for (int blk = first; blk < last; ++blk) {
+            int r0 = blk * blockRows;
+            int rows = min(blockRows, m - r0);
+            vector<double> block((size_t)rows * cols);
+            for (int i = 0; i < rows; ++i) {
+                copy(a + (size_t)(r0 + i) * p, a + (size_t)(r0 + i + 1) * p,
+                     block.begin() + (size_t)i * cols);
+                block[(size_t)i * cols + p] = rhs[r0 + i];
+            }
+            factors[blk] = reduceBlock(rows, cols, block);
+        }
+    });
+
+    // Binary reduction tree: stack neighbouring R factors and re-factor
+    for (int stride = 1; stride < numBlocks; stride *= 2) {
+        int pairs = (numBlocks + 2 * stride - 1) / (2 * stride);
+        parallelFor(0, pairs, 1, [&](int first, int last) {
+            for (int pr = first; pr < last; ++pr) {
+                int left = pr * 2 * stride;
+                int right = left + stride;
+                if (right >= numBlocks) continue;
+                TriangularFactor& top = factors[left];
+                TriangularFactor& bottom = factors[right];
+                int rows = top.rows + bottom.rows;
+                vector<double> stacked(top.data);
+                stacked.insert(stacked.end(), bottom.data.begin(), bottom.data.end());
+                top = reduceBlock(rows, cols, stacked);
+                bottom.data.clear();
+            }
+        });
+    }
+
+    mpR = new Matrix(cols, cols);
+    const TriangularFactor& root = factors[0];
+    for (int i = 0; i < root.rows; ++i) {
+        for (int j = i; j < cols; ++j) {
+            (*mpR)(i + 1, j + 1) = root.data[(size_t)i * cols + j];
+        }
+    }
+}
+
+TallSkinnyQR::~TallSkinnyQR() {
+    delete mpR;
+}
+
+Vector TallSkinnyQR::Solve() const {
+    PROFILE_SCOPE("TSQR solve");
+    int p = mNumCols;
+    double maxDiag = 0.0;
+    for (int i = 1; i <= p; ++i) {
+        maxDiag = max(maxDiag, fabs((*mpR)(i, i)));
+    }
+
+    // Back substitution R x = (Qᵀb)(1:p)
+    Vector x(p);
+    for (int i = p; i >= 1; --i) {
+        if (fabs((*mpR)(i, i)) <= 1e-12 * maxDiag) {
+            throw runtime_error("Matrix is rank deficient");
+        }
+        double sum = (*mpR)(i, p + 1);
+        for (int j = i + 1; j <= p; ++j) {
+            sum -= (*mpR)(i, j) * x(j);
+        }
+        x(i) = sum / (*mpR)(i, i);
+    }
+    return x;
+}
+
+Matrix TallSkinnyQR::R() const {
+    int p = mNumCols;
+    Matrix R(p, p);
+    for (int i = 1; i <= p; ++i) {
+        for (int j = i; j <= p; ++j) {
+            R(i, j) = (*mpR)(i, j);
+        }
+    }
+    return R;
+}
+
+double TallSkinnyQR::ResidualNorm() const {
+    return fabs((*mpR)(mNumCols + 1, mNumCols + 1));
+}
@@ -0,0 +1,170 @@
+#include "TridiagonalLinSystem.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+// Equations per chunk of one cyclic reduction level
+static const int CR_GRAIN = 2048;
+
+static const double PIVOT_THRESHOLD = 1e-10;
+
+TridiagonalLinSystem::TridiagonalLinSystem(TridiagonalMatrix* A, Vector* b)
+    : LinearSystem(A == nullptr ? 0 : A->size(), b), mpTridiagonal(A) {
+    if (A == nullptr) {
+        throw invalid_argument("Matrix and Vector cannot be null");
+    }
+}
+
+TridiagonalLinSystem::TridiagonalLinSystem(TridiagonalMatrix* A, Matrix* B)
+    : LinearSystem(A == nullptr ? 0 : A->size(), B), mpTridiagonal(A) {
+    if (A == nullptr) {
+        throw invalid_argument("Matrix and right-hand sides cannot be null");
+    }
+}
+
+TridiagonalLinSystem::~TridiagonalLinSystem() {}
+
+void TridiagonalLinSystem::ThomasSweep(Matrix& X) const {
+    int n = mSize;
+    int s = X.numCols();
+    const vector<double>& a = mpTridiagonal->lowerDiagonal();
+    const vector<double>& b = mpTridiagonal->mainDiagonal();
+    const vector<double>& c = mpTridiagonal->upperDiagonal();
+    double* x = X.data();
+
+    // Forward elimination, keeping the modified superdiagonal
+    vector<double> cp(n);
+    double pivot = b[0];
+    for (int i = 0; i < n; ++i) {
+        if (i > 0) {
+            pivot = b[i] - a[i] * cp[i - 1];
+        }
+        if (fabs(pivot) < PIVOT_THRESHOLD) {
+            throw runtime_error("Matrix is singular or nearly singular");
+        }
+        cp[i] = c[i] / pivot;
+
+        double* xi = x + (size_t)i * s;
+        if (i > 0) {
+            const double* xPrev = xi - s;
+            for (int k = 0; k < s; ++k) {
+                xi[k] -= a[i] * xPrev[k];
+            }
+        }
+        for (int k = 0; k < s; ++k) {
+            xi[k] /= pivot;
+        }
+    }
+
+    // Back substitution
+    for (int i = n - 2; i >= 0; --i) {
+        double* xi = x + (size_t)i * s;
+        const double* xNext = xi + s;
+        for (int k = 0; k < s; ++k) {
+            xi[k] -= cp[i] * xNext[k];
+        }
+    }
+}
+
+Vector TridiagonalLinSystem::Solve() {
+    if (mpb == nullptr) {
+        throw logic_error("System has no right-hand side vector, use SolveMultiple()");
+    }
+
+    Matrix X = RhsMatrix();
+    ThomasSweep(X);
+
+    Vector solution(mSize);
+    for (int i = 1; i <= mSize; ++i) {
+        solution(i) = X(i, 1);
+    }
+    return solution;
+}
+
+Matrix TridiagonalLinSystem::SolveMultiple() {
+    Matrix X = RhsMatrix();
+    ThomasSweep(X);
+    return X;
+}
+
+Vector TridiagonalLinSystem::SolveCyclicReduction() {
+    if (mpb == nullptr) {
+        throw logic_error("System has no right-hand side vector, use SolveMultiple()");
+    }
+
+    int n = mSize;
+    vector<double> a(mpTridiagonal->lowerDiagonal());
+    vector<double> b(mpTridiagonal->mainDiagonal());
+    vector<double> c(mpTridiagonal->upperDiagonal());
+    vector<double> d(mpb->data(), mpb->data() + n);
+    vector<double> x(n);
+
+    // Reduction: at stride s equation i = 2s-1, 4s-1, ... absorbs its
+    // neighbours i-s and i+s, which are untouched at this level
+    int stride = 1;
+    for (; 2 * stride <= n; stride *= 2) {
+        int s = stride;
+        int count = n / (2 * s);
+        atomic<bool> singular(false);
+        parallelFor(0, count, CR_GRAIN, [&, s](int begin, int end) {
+            for (int k = begin; k < end; ++k) {
+                int i = (2 * k + 2) * s - 1;
+                if (fabs(b[i - s]) < PIVOT_THRESHOLD) {
+                    singular = true;
+                    return;
+                }
+                double alpha = -a[i] / b[i - s];
+                double gamma = 0.0;
+                if (i + s < n) {
+                    if (fabs(b[i + s]) < PIVOT_THRESHOLD) {
+                        singular = true;
+                        return;
+                    }
+                    gamma = -c[i] / b[i + s];
+                }
+                b[i] += alpha * c[i - s];
+                d[i] += alpha * d[i - s];
+                a[i] = alpha * a[i - s];
+                if (i + s < n) {
+                    b[i] += gamma * a[i + s];
+                    d[i] += gamma * d[i + s];
+                    c[i] = gamma * c[i + s];
+                } else {
+                    c[i] = 0.0;
+                }
+            }
+        });
+        if (singular) {
+            throw runtime_error("Matrix is singular or nearly singular");
+        }
+    }
+
+    // The last reduced equation (i = stride-1) couples to nothing
+    if (fabs(b[stride - 1]) < PIVOT_THRESHOLD) {
+        throw runtime_error("Matrix is singular or nearly singular");
+    }
+    x[stride - 1] = d[stride - 1] / b[stride - 1];
+
+    // Back substitution: unknowns i = s-1, 3s-1, ... from their solved neighbours
+    for (int s = stride / 2; s >= 1; s /= 2) {
+        int count = (n + s) / (2 * s);
+        parallelFor(0, count, CR_GRAIN, [&, s](int begin, int end) {
+            for (int k = begin; k < end; ++k) {
+                int i = (2 * k + 1) * s - 1;
+                double rhs = d[i];
+                if (i - s >= 0) rhs -= a[i] * x[i - s];
+                if (i + s < n) rhs -= c[i] * x[i + s];
+                x[i] = rhs / b[i];
+            }
+        });
+    }
+
+    Vector solution(n);
+    copy(x.begin(), x.end(), solution.begin());
+    return solution;
+}
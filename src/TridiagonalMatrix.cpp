@@ -0,0 +1,83 @@
+#include "TridiagonalMatrix.h"
+#include <cassert>
+#include <stdexcept>
+
+TridiagonalMatrix::TridiagonalMatrix(int size)
+    : mSize(size), mLower(size > 0 ? size : 0, 0.0), mDiagonal(size > 0 ? size : 0, 0.0),
+      mUpper(size > 0 ? size : 0, 0.0) {
+    if (size <= 0) {
+        throw std::invalid_argument("Matrix size must be positive");
+    }
+}
+
+int TridiagonalMatrix::size() const {
+    return mSize;
+}
+
+double& TridiagonalMatrix::lower(int i) {
+    assert(i >= 2 && i <= mSize);
+    return mLower[i - 1];
+}
+
+double& TridiagonalMatrix::diagonal(int i) {
+    assert(i >= 1 && i <= mSize);
+    return mDiagonal[i - 1];
+}
+
+double& TridiagonalMatrix::upper(int i) {
+    assert(i >= 1 && i < mSize);
+    return mUpper[i - 1];
+}
+
+double TridiagonalMatrix::operator()(int i, int j) const {
+    assert(i >= 1 && i <= mSize);
+    assert(j >= 1 && j <= mSize);
+    if (j == i) return mDiagonal[i - 1];
+    if (j == i - 1) return mLower[i - 1];
+    if (j == i + 1) return mUpper[i - 1];
+    return 0.0;
+}
+
+void TridiagonalMatrix::multiply(const double* x, double* y) const {
+    int n = mSize;
+    if (n == 1) {
+        y[0] = mDiagonal[0] * x[0];
+        return;
+    }
+    y[0] = mDiagonal[0] * x[0] + mUpper[0] * x[1];
+    for (int i = 1; i < n - 1; ++i) {
+        y[i] = mLower[i] * x[i - 1] + mDiagonal[i] * x[i] + mUpper[i] * x[i + 1];
+    }
+    y[n - 1] = mLower[n - 1] * x[n - 2] + mDiagonal[n - 1] * x[n - 1];
+}
+
+Vector TridiagonalMatrix::operator*(Vector& v) const {
+    if (v.size() != mSize) {
+        throw std::invalid_argument("Matrix and vector dimensions do not match for multiplication.");
+    }
+    Vector result(mSize);
+    multiply(v.data(), result.data());
+    return result;
+}
+
+Matrix TridiagonalMatrix::toDense() const {
+    Matrix dense(mSize, mSize);
+    for (int i = 1; i <= mSize; ++i) {
+        dense(i, i) = mDiagonal[i - 1];
+        if (i > 1) dense(i, i - 1) = mLower[i - 1];
+        if (i < mSize) dense(i, i + 1) = mUpper[i - 1];
+    }
+    return dense;
+}
+
+const std::vector<double>& TridiagonalMatrix::lowerDiagonal() const {
+    return mLower;
+}
+
+const std::vector<double>& TridiagonalMatrix::mainDiagonal() const {
+    return mDiagonal;
+}
+
+const std::vector<double>& TridiagonalMatrix::upperDiagonal() const {
+    return mUpper;
+}
@@ -1,32 +1,56 @@
+#include <algorithm>
 #include <iostream>
 #include <Vector.h>
+#include <AllocationTracker.h>
+#include <Profiler.h>
 using namespace std;
 
 // Constructor
 Vector::Vector(int size) : mSize(size) {
     if (size <= 0) mSize = 1;
-    mData = new double[mSize]();
+    mData = allocation::allocate(allocation::Kind::Vector, mSize, true);
 }
 
 // Copy Constructor
 Vector::Vector(const Vector& other) : mSize(other.mSize) {
-    mData = new double[mSize];
+    mData = allocation::allocate(allocation::Kind::Vector, mSize, false);
     for (int i = 0; i < mSize; ++i) {
         mData[i] = other.mData[i];
     }
 }
 
+// Copy of the elements a view refers to
+Vector::Vector(ConstVectorView view) : mSize(view.size()) {
+    if (mSize <= 0) mSize = 1;
+    mData = allocation::allocate(allocation::Kind::Vector, mSize, true);
+    for (int i = 1; i <= view.size(); ++i) {
+        mData[i - 1] = view(i);
+    }
+}
+
+#if __cplusplus >= 202002L
+// Copy of a contiguous range
+Vector::Vector(std::span<const double> values) : mSize((int)values.size()) {
+    if (mSize <= 0) mSize = 1;
+    mData = allocation::allocate(allocation::Kind::Vector, mSize, true);
+    std::copy(values.begin(), values.end(), mData);
+}
+#endif
+
 // Destructor
 Vector::~Vector() {
-    delete[] mData;
+    allocation::release(allocation::Kind::Vector, mData, mSize);
 }
 
 // Assignment Operator
 Vector& Vector::operator=(const Vector& other) {
     if (this != &other) {
-        delete[] mData;
-        mSize = other.mSize;
-        mData = new double[mSize];
+        // Reallocate only when the size changes
+        if (mSize != other.mSize) {
+            allocation::release(allocation::Kind::Vector, mData, mSize);
+            mSize = other.mSize;
+            mData = allocation::allocate(allocation::Kind::Vector, mSize, false);
+        }
         for (int i = 0; i < mSize; ++i) {
             mData[i] = other.mData[i];
         }
@@ -45,11 +69,12 @@ Vector Vector::operator-() const {
 
 // Binary Operator Overloads
 Vector Vector::operator+(const Vector& other) const {
+    // One named result on every path, so it is constructed in place
+    Vector result(mSize);
     if (mSize != other.mSize) {
         cout << "Error: Vector sizes don't match for addition" << endl;
-        return Vector(mSize);
+        return result;
     }
-    Vector result(mSize);
     for (int i = 0; i < mSize; ++i) {
         result.mData[i] = mData[i] + other.mData[i];
     }
@@ -57,11 +82,12 @@ Vector Vector::operator+(const Vector& other) const {
 }
 
 Vector Vector::operator-(const Vector& other) const {
+    // One named result on every path, so it is constructed in place
+    Vector result(mSize);
     if (mSize != other.mSize) {
         cout << "Error: Vector sizes don't match for subtraction" << endl;
-        return Vector(mSize);
+        return result;
     }
-    Vector result(mSize);
     for (int i = 0; i < mSize; ++i) {
         result.mData[i] = mData[i] - other.mData[i];
     }
@@ -76,12 +102,40 @@ Vector Vector::operator*(double scalar) const {
     return result;
 }
 
+// In-place updates
+Vector& Vector::operator+=(const Vector& other) {
+    return addScaled(1.0, other);
+}
+
+Vector& Vector::operator-=(const Vector& other) {
+    return addScaled(-1.0, other);
+}
+
+Vector& Vector::operator*=(double scalar) {
+    for (int i = 0; i < mSize; ++i) {
+        mData[i] *= scalar;
+    }
+    return *this;
+}
+
+Vector& Vector::addScaled(double alpha, const Vector& x) {
+    if (mSize != x.mSize) {
+        cout << "Error: Vector sizes don't match for in-place update" << endl;
+        return *this;
+    }
+    for (int i = 0; i < mSize; ++i) {
+        mData[i] += alpha * x.mData[i];
+    }
+    return *this;
+}
+
 // Dot Product
 double Vector::dot(const Vector& other) const {
     if (mSize != other.mSize) {
         cout << "Error: Vector sizes don't match for dot product" << endl;
         return 0.0;
     }
+    PROFILE_SCOPE_WORK("Vector dot", 2.0 * mSize, 16.0 * mSize);
     double sum = 0.0;
     for (int i = 0; i < mSize; ++i) {
         sum += mData[i] * other.mData[i];
@@ -89,22 +143,10 @@ double Vector::dot(const Vector& other) const {
     return sum;
 }
 
-// Square Bracket Operator Overload for index checking
-double& Vector::operator[](int index) {
-    if (index < 0 || index >= mSize) {
-        cout << "Error: Index out of bounds for operator[]" << endl;
-        return mData[0];
-    }
-    return mData[index];
-}
-
-// Round Bracket Operator Overload for one-based indexing
-double& Vector::operator()(int index) {
-    if (index <= 0 || index > mSize) {
-        cout << "Error: Index out of bounds for operator()" << endl;
-        return mData[0];
-    }
-    return mData[index - 1];
+// Out-of-range element access (debug builds only)
+double& Vector::outOfBounds(const char* op) const {
+    cout << "Error: Index out of bounds for " << op << endl;
+    return mData[0];
 }
 
 // Get size of the vector
@@ -112,3 +154,21 @@ int Vector::size() const {
     return mSize;
 }
 
+
+// Contiguous storage, zero-based
+double* Vector::data() {
+    return mData;
+}
+
+const double* Vector::data() const {
+    return mData;
+}
+
+// View of the whole vector
+VectorView Vector::view() {
+    return VectorView(mData, mSize, 1);
+}
+
+ConstVectorView Vector::view() const {
+    return ConstVectorView(mData, mSize, 1);
+}
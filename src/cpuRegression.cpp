@@ -5,9 +5,20 @@
 #include <string>
 #include <random>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include "Matrix.h"
 #include "Vector.h"
 #include "LinearSystem.h"
+#include "TallSkinnyQR.h"
+#include "RecursiveLeastSquares.h"
+#include "LinearModel.h"
+#include "PolynomialFeatures.h"
+#include "KrylovLeastSquares.h"
+#include "RobustRegression.h"
+#include "GradientTrainer.h"
+#include "Parallel.h"
+#include "Profiler.h"
 
 // Function to solve ill-posed problems using pseudoinverse
 Vector solvePseudoinverse(Matrix& A, Vector& b) {
@@ -42,6 +53,12 @@ struct DataPoint {
     std::string model;
 };
 
+// Lines parsed per scheduler task
+const int CSV_LINE_GRAIN = 256;
+
+// Largest block of input rows scored at once in --score mode
+const size_t SCORE_CHUNK_BYTES = (size_t)1 << 20;
+
 std::vector<DataPoint> readDataset(const std::string& filename) {
     std::vector<DataPoint> dataset;
     std::ifstream file(filename);
@@ -50,36 +67,43 @@ std::vector<DataPoint> readDataset(const std::string& filename) {
         throw std::runtime_error("Failed to open file: " + filename);
     }
     
+    // Read the lines serially, then parse blocks of them on the scheduler
+    std::vector<std::string> lines;
     std::string line;
     while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        DataPoint dp;
-        std::string token;
-        
-        // Read vendor name and model
-        std::getline(iss, dp.vendor, ',');
-        std::getline(iss, dp.model, ',');
-        
-        // Read numerical attributes
-        std::getline(iss, token, ','); 
-        dp.myct = std::stod(token);
-        std::getline(iss, token, ','); 
-        dp.mmin = std::stod(token);
-        std::getline(iss, token, ','); 
-        dp.mmax = std::stod(token);
-        std::getline(iss, token, ','); 
-        dp.cach = std::stod(token);
-        std::getline(iss, token, ','); 
-        dp.chmin = std::stod(token);
-        std::getline(iss, token, ','); 
-        dp.chmax = std::stod(token);
-        std::getline(iss, token, ','); 
-        dp.prp = std::stod(token);
-        std::getline(iss, token, ','); 
-        dp.erp = std::stod(token);
-        
-        dataset.push_back(dp);
+        lines.push_back(line);
     }
+    dataset.resize(lines.size());
+
+    parallelFor(0, (int)lines.size(), CSV_LINE_GRAIN, [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            std::istringstream iss(lines[i]);
+            DataPoint& dp = dataset[i];
+            std::string token;
+
+            // Read vendor name and model
+            std::getline(iss, dp.vendor, ',');
+            std::getline(iss, dp.model, ',');
+
+            // Read numerical attributes
+            std::getline(iss, token, ',');
+            dp.myct = std::stod(token);
+            std::getline(iss, token, ',');
+            dp.mmin = std::stod(token);
+            std::getline(iss, token, ',');
+            dp.mmax = std::stod(token);
+            std::getline(iss, token, ',');
+            dp.cach = std::stod(token);
+            std::getline(iss, token, ',');
+            dp.chmin = std::stod(token);
+            std::getline(iss, token, ',');
+            dp.chmax = std::stod(token);
+            std::getline(iss, token, ',');
+            dp.prp = std::stod(token);
+            std::getline(iss, token, ',');
+            dp.erp = std::stod(token);
+        }
+    });
     
     return dataset;
 }
@@ -131,9 +155,274 @@ void setupLinearRegressionSystem(
     }
 }
 
-Vector solveLinearRegression(Matrix& A,  Vector& b) {
-    // Use the Moore-Penrose pseudoinverse for the overdetermined system
-    return solvePseudoinverse(A, b);
+// Least-squares solvers available to solveLinearRegression
+enum class RegressionSolver {
+    Pseudoinverse,  // Moore-Penrose pseudoinverse through the normal equations
+    TSQR,           // Tall-skinny QR, factored in parallel over row blocks
+    LSQR,           // Golub-Kahan bidiagonalization, products with A and Aᵀ only
+    CGLS            // CG on the normal equations without forming AᵀA
+};
+
+// damping is the ridge parameter of LSQR and CGLS; the direct solvers ignore it
+Vector solveLinearRegression(Matrix& A,  Vector& b,
+                             RegressionSolver solver = RegressionSolver::TSQR, double damping = 0.0) {
+    PROFILE_SCOPE("solveLinearRegression");
+    if (solver == RegressionSolver::Pseudoinverse) {
+        // Use the Moore-Penrose pseudoinverse for the overdetermined system
+        return solvePseudoinverse(A, b);
+    }
+    if (solver == RegressionSolver::LSQR || solver == RegressionSolver::CGLS) {
+        KrylovLeastSquares krylov(&A, &b);
+        krylov.SetMethod(solver == RegressionSolver::LSQR ? LeastSquaresMethod::LSQR : LeastSquaresMethod::CGLS);
+        krylov.SetDamping(damping);
+        Vector x = krylov.Solve();
+        std::cout << (solver == RegressionSolver::LSQR ? "LSQR" : "CGLS") << ": "
+                  << krylov.Iterations() << " iterations, residual norm " << krylov.ResidualNorm() << "\n";
+        return x;
+    }
+
+    // QR of the design avoids squaring its condition number
+    TallSkinnyQR tsqr(A, b);
+    return tsqr.Solve();
+}
+
+// Streams the rows of A through recursive least squares as if they arrived
+// one at a time; the mean time per update is returned through secondsPerUpdate
+Vector solveOnlineRegression(Matrix& A, Vector& b, double forgetting, double& secondsPerUpdate) {
+    PROFILE_SCOPE("solveOnlineRegression");
+    RecursiveLeastSquares rls(A.numCols(), forgetting);
+    auto start = std::chrono::steady_clock::now();
+    rls.UpdateRows(A, b);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    secondsPerUpdate = seconds / std::max(A.numRows(), 1);
+    return rls.Coefficients();
+}
+
+struct RegressionOptions {
+    RegressionSolver solver = RegressionSolver::TSQR;
+    bool online = false;        // Recursive least squares, one row at a time
+    double forgetting = 1.0;    // RLS forgetting factor in (0, 1]
+    std::string saveModel;      // Write the fitted model here
+    std::string scoreModel;     // Score rows with this model instead of fitting
+    std::string input;          // Rows to score; empty reads stdin
+    double damping = 0.0;       // Ridge parameter for --solver=lsqr|cgls
+    int degree = 1;             // Polynomial degree of the implicit feature expansion
+    InteractionSet interactions = InteractionSet::All;
+    bool robust = false;        // IRLS with the loss below instead of least squares
+    RobustLoss loss = RobustLoss::Huber;
+    bool gradient = false;      // Mini-batch gradient descent instead of a direct solve
+    GradientMethod method = GradientMethod::Adam;
+    GradientUpdate update = GradientUpdate::Reduction;
+    int epochs = 200;
+    int batch = 16;
+    double learningRate = 0.0; // 0 picks 0.05 for SGD, 0.005 for momentum and 1 for Adam
+    double l2 = 0.0;            // Penalty λ||θ||²/2 on the mean squared error
+};
+
+RegressionOptions parseOptions(int argc, char* argv[]) {
+    RegressionOptions options;
+    std::string solverFlag;       // --solver as given; the other fitting modes have their own solver
+    std::string gradientTuning;   // Last trainer setting seen; only --gradient selects the trainer
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--solver=pinv") {
+            options.solver = RegressionSolver::Pseudoinverse;
+            solverFlag = arg;
+        } else if (arg == "--solver=tsqr") {
+            options.solver = RegressionSolver::TSQR;
+            solverFlag = arg;
+        } else if (arg == "--solver=lsqr") {
+            options.solver = RegressionSolver::LSQR;
+            solverFlag = arg;
+        } else if (arg == "--solver=cgls") {
+            options.solver = RegressionSolver::CGLS;
+            solverFlag = arg;
+        } else if (arg.rfind("--damping=", 0) == 0) {
+            options.damping = std::stod(arg.substr(10));
+            if (options.damping < 0.0) {
+                throw std::invalid_argument("Damping must not be negative: " + arg);
+            }
+        } else if (arg == "--online") {
+            options.online = true;
+        } else if (arg.rfind("--forget=", 0) == 0) {
+            options.online = true;
+            options.forgetting = std::stod(arg.substr(9));
+            if (options.forgetting <= 0.0 || options.forgetting > 1.0) {
+                throw std::invalid_argument("Forgetting factor must be in (0, 1]: " + arg);
+            }
+        } else if (arg.rfind("--save-model=", 0) == 0) {
+            options.saveModel = arg.substr(13);
+        } else if (arg.rfind("--score=", 0) == 0) {
+            options.scoreModel = arg.substr(8);
+        } else if (arg.rfind("--input=", 0) == 0) {
+            options.input = arg.substr(8);
+        } else if (arg.rfind("--degree=", 0) == 0) {
+            options.degree = std::stoi(arg.substr(9));
+            if (options.degree < 1) {
+                throw std::invalid_argument("Degree must be at least 1: " + arg);
+            }
+        } else if (arg == "--interactions=none") {
+            options.interactions = InteractionSet::None;
+        } else if (arg == "--interactions=pairwise") {
+            options.interactions = InteractionSet::Pairwise;
+        } else if (arg == "--interactions=all") {
+            options.interactions = InteractionSet::All;
+        } else if (arg == "--robust=huber") {
+            options.robust = true;
+            options.loss = RobustLoss::Huber;
+        } else if (arg == "--robust=tukey") {
+            options.robust = true;
+            options.loss = RobustLoss::Tukey;
+        } else if (arg == "--gradient=sgd" || arg == "--gradient=momentum" || arg == "--gradient=adam") {
+            options.gradient = true;
+            options.method = arg == "--gradient=sgd" ? GradientMethod::SGD
+                           : arg == "--gradient=momentum" ? GradientMethod::Momentum : GradientMethod::Adam;
+        } else if (arg == "--hogwild") {
+            gradientTuning = arg;
+            options.update = GradientUpdate::Hogwild;
+        } else if (arg.rfind("--epochs=", 0) == 0) {
+            gradientTuning = arg;
+            options.epochs = std::stoi(arg.substr(9));
+        } else if (arg.rfind("--batch=", 0) == 0) {
+            gradientTuning = arg;
+            options.batch = std::stoi(arg.substr(8));
+            if (options.batch < 1) {
+                throw std::invalid_argument("Batch size must be at least 1: " + arg);
+            }
+        } else if (arg.rfind("--learning-rate=", 0) == 0) {
+            gradientTuning = arg;
+            options.learningRate = std::stod(arg.substr(16));
+            if (options.learningRate <= 0.0) {
+                throw std::invalid_argument("Learning rate must be positive: " + arg);
+            }
+        } else if (arg.rfind("--l2=", 0) == 0) {
+            gradientTuning = arg;
+            options.l2 = std::stod(arg.substr(5));
+            if (options.l2 < 0.0) {
+                throw std::invalid_argument("L2 penalty must not be negative: " + arg);
+            }
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg +
+                                        " (use --solver=pinv|tsqr|lsqr|cgls, --damping=<lambda>, --online, --forget=<lambda>,"
+                                        " --save-model=<file>, --score=<model> [--input=<file>],"
+                                        " --degree=<d>, --interactions=none|pairwise|all, --robust=huber|tukey,"
+                                        " --gradient=sgd|momentum|adam [--epochs=<n>] [--batch=<rows>] [--learning-rate=<eta>]"
+                                        " [--l2=<lambda>] [--hogwild])");
+        }
+    }
+    if (options.damping > 0.0 && options.solver != RegressionSolver::LSQR
+        && options.solver != RegressionSolver::CGLS) {
+        throw std::invalid_argument("--damping needs --solver=lsqr or --solver=cgls");
+    }
+    if (options.degree > 1 && (options.online || !options.saveModel.empty())) {
+        throw std::invalid_argument("--degree applies to the batch fit only, without --online or --save-model");
+    }
+    if (!solverFlag.empty() && (options.degree > 1 || options.online || options.robust || options.gradient)) {
+        throw std::invalid_argument(solverFlag + " picks the batch least-squares solver; --degree, --online, --robust"
+                                    " and --gradient fit with their own and cannot be combined with it");
+    }
+    if (options.robust && (options.online || options.degree > 1 || options.damping > 0.0)) {
+        throw std::invalid_argument("--robust cannot be combined with --online, --degree or --damping");
+    }
+    if (!gradientTuning.empty() && !options.gradient) {
+        throw std::invalid_argument(gradientTuning + " only applies to gradient training; add --gradient=sgd|momentum|adam");
+    }
+    if (options.gradient && (options.online || options.degree > 1 || options.robust || options.damping > 0.0)) {
+        throw std::invalid_argument("--gradient cannot be combined with --online, --degree, --robust or --damping");
+    }
+    return options;
+}
+
+static void printIrlsHistory(const std::string& name, const RobustRegression& fit) {
+    std::cout << name << " IRLS: " << fit.Iterations() << " iterations, "
+              << (fit.Converged() ? "converged" : "not converged") << "\n"
+              << "iter\tms\tscale\treweighted\tGram\tCG its\tstep\n";
+    const std::vector<IrlsIteration>& history = fit.History();
+    for (size_t k = 0; k < history.size(); ++k) {
+        const IrlsIteration& it = history[k];
+        std::cout << k << "\t" << it.seconds * 1e3 << "\t" << it.scale << "\t" << it.reweightedRows << "\t\t"
+                  << (it.rebuilt ? "rebuilt" : "updated") << "\t" << it.solverIterations << "\t" << it.step << "\n";
+    }
+}
+
+// Robust fit by IRLS with a per-iteration timing table. Tukey's loss is not
+// convex, so its fit starts from the Huber fit rather than least squares.
+Vector solveRobustRegression(Matrix& A, Vector& b, RobustLoss loss) {
+    PROFILE_SCOPE("solveRobustRegression");
+    RobustRegression huber(&A, &b, RobustLoss::Huber);
+    huber.Fit();
+    std::cout << "\n";
+    printIrlsHistory("Huber", huber);
+    if (loss == RobustLoss::Huber) {
+        return huber.Coefficients();
+    }
+    RobustRegression tukey(&A, &b, RobustLoss::Tukey);
+    tukey.Fit(huber.Coefficients());
+    std::cout << "\n";
+    printIrlsHistory("Tukey", tukey);
+    int rejected = (int)std::count(tukey.Weights().begin(), tukey.Weights().end(), 0.0);
+    std::cout << rejected << " of " << A.numRows() << " training rows rejected\n";
+    return tukey.Coefficients();
+}
+
+// Trains by mini-batch gradient descent and prints the objective against
+// time next to the direct TSQR fit, the reference for how far it has come
+Vector solveGradientRegression(Matrix& A, Vector& b, const RegressionOptions& options) {
+    PROFILE_SCOPE("solveGradientRegression");
+    auto start = std::chrono::steady_clock::now();
+    TallSkinnyQR tsqr(A, b);
+    Vector direct = tsqr.Solve();
+    double directSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    GradientTrainer trainer(&A, &b);
+    trainer.SetMethod(options.method);
+    trainer.SetUpdate(options.update);
+    trainer.SetEpochs(options.epochs);
+    trainer.SetBatchSize(options.batch);
+    double learningRate = options.learningRate;
+    if (learningRate == 0.0) {
+        // The targets are raw PRP values, so Adam's per-coefficient steps have to be large
+        learningRate = options.method == GradientMethod::SGD ? 0.05
+                     : options.method == GradientMethod::Momentum ? 0.005 : 1.0;
+    }
+    trainer.SetLearningRate(learningRate);
+    trainer.SetL2(options.l2);
+    Vector coefficients = trainer.Train();
+
+    // The penalized optimum differs from least squares; the gap is only exact for --l2=0
+    double optimum = trainer.Objective(direct);
+    std::cout << "\nDirect TSQR fit: " << directSeconds * 1e3 << " ms, objective " << optimum << "\n"
+              << "epoch\tms\tobjective\trelative gap\n";
+    const std::vector<TrainingEpoch>& history = trainer.History();
+    for (size_t epoch = 0; epoch < history.size(); ++epoch) {
+        // Powers of two and the last epoch are enough to see the curve
+        if ((epoch & (epoch - 1)) != 0 && epoch + 1 != history.size()) continue;
+        std::cout << epoch << "\t" << history[epoch].seconds * 1e3 << "\t" << history[epoch].objective << "\t"
+                  << history[epoch].objective / optimum - 1.0 << "\n";
+    }
+    return coefficients;
+}
+
+// Fits the polynomial expansion of the six features through its normal
+// equations, accumulated from the base design without forming the expanded one
+Vector solvePolynomialRegression(Matrix& A, Vector& b, const PolynomialFeatures& features) {
+    PROFILE_SCOPE("solvePolynomialRegression");
+    Matrix G(features.numFeatures(), features.numFeatures());
+    Vector Xty(features.numFeatures());
+    features.normalEquations(A, b, G, Xty);
+    LinearSystem system(&G, &Xty);
+    return system.Solve();
+}
+
+double calculatePolynomialRMSE(const std::vector<DataPoint>& testData, const PolynomialFeatures& features,
+                               const Vector& coefficients) {
+    double sumSquaredError = 0.0;
+    for (const DataPoint& dp : testData) {
+        double x[6] = {dp.myct, dp.mmin, dp.mmax, dp.cach, dp.chmin, dp.chmax};
+        double error = features.predict(coefficients, x) - dp.prp;
+        sumSquaredError += error * error;
+    }
+    return std::sqrt(sumSquaredError / testData.size());
 }
 
 double calculateRMSE(
@@ -165,7 +454,53 @@ double calculateRMSE(
     return std::sqrt(sumSquaredError / n);
 }
 
-void normalizeData(std::vector<DataPoint>& trainData, std::vector<DataPoint>& testData) {
+// Scores the rows of in in chunks and writes each chunk's predictions as
+// soon as it is done. A chunk ends at SCORE_CHUNK_BYTES or when no more
+// input is ready, so a pipe fed one row at a time gets one answer per row
+// while a file is scored in large parallel blocks.
+static void scoreStream(const LinearModel& model, std::istream& in) {
+    std::string chunk, line, predictions;
+    auto flushChunk = [&]() {
+        predictions.clear();
+        model.score(chunk.data(), chunk.data() + chunk.size(), predictions);
+        std::fwrite(predictions.data(), 1, predictions.size(), stdout);
+        std::fflush(stdout);
+        chunk.clear();
+    };
+    while (std::getline(in, line)) {
+        chunk += line;
+        chunk += '\n';
+        if (chunk.size() >= SCORE_CHUNK_BYTES || in.rdbuf()->in_avail() <= 0) {
+            flushChunk();
+        }
+    }
+    if (!chunk.empty()) {
+        flushChunk();
+    }
+}
+
+// Scores every row of the input (stdin by default) with a saved model and
+// writes one prediction per line to stdout
+void scoreRows(const std::string& modelPath, const std::string& inputPath) {
+    LinearModel model = LinearModel::load(modelPath);
+    if (inputPath.empty()) {
+        // Unsynchronized, std::cin buffers the pipe itself and in_avail()
+        // reports what is ready without blocking
+        std::ios::sync_with_stdio(false);
+        scoreStream(model, std::cin);
+    } else {
+        std::ifstream file(inputPath, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + inputPath);
+        }
+        scoreStream(model, file);
+    }
+}
+
+// Normalizes both sets with the training statistics, which are returned in
+// means and stddevs (MYCT, MMIN, MMAX, CACH, CHMIN, CHMAX)
+void normalizeData(std::vector<DataPoint>& trainData, std::vector<DataPoint>& testData,
+                   Vector& means, Vector& stddevs) {
     // Calculate mean and standard deviation for each feature from training data
     double myct_mean = 0, mmin_mean = 0, mmax_mean = 0, cach_mean = 0, chmin_mean = 0, chmax_mean = 0;
     double myct_std = 0, mmin_std = 0, mmax_std = 0, cach_std = 0, chmin_std = 0, chmax_std = 0;
@@ -204,6 +539,13 @@ void normalizeData(std::vector<DataPoint>& trainData, std::vector<DataPoint>& te
     cach_std = std::sqrt(cach_std / n);
     chmin_std = std::sqrt(chmin_std / n);
     chmax_std = std::sqrt(chmax_std / n);
+
+    means = Vector(6);
+    stddevs = Vector(6);
+    means(1) = myct_mean; means(2) = mmin_mean; means(3) = mmax_mean;
+    means(4) = cach_mean; means(5) = chmin_mean; means(6) = chmax_mean;
+    stddevs(1) = myct_std; stddevs(2) = mmin_std; stddevs(3) = mmax_std;
+    stddevs(4) = cach_std; stddevs(5) = chmin_std; stddevs(6) = chmax_std;
     
     // Normalize training data
     for (auto& dp : trainData) {
@@ -226,8 +568,14 @@ void normalizeData(std::vector<DataPoint>& trainData, std::vector<DataPoint>& te
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        RegressionOptions options = parseOptions(argc, argv);
+        if (!options.scoreModel.empty()) {
+            scoreRows(options.scoreModel, options.input);
+            return 0;
+        }
+
         // Read the dataset
         std::string filename = "dataset/machine.data";
         std::vector<DataPoint> data = readDataset(filename);
@@ -240,15 +588,43 @@ int main() {
         std::cout << "Testing set: " << testData.size() << " instances\n";
         
         // Optional: Normalize the data
-        normalizeData(trainData, testData);
+        Vector means(6);
+        Vector stddevs(6);
+        normalizeData(trainData, testData, means, stddevs);
         
         // Set up linear regression system
         Matrix A(trainData.size(), 6);  // Initialize with proper dimensions
         Vector b(trainData.size());     // Initialize with proper dimensions
         setupLinearRegressionSystem(trainData, A, b);
+
+        if (options.degree > 1) {
+            PolynomialFeatures features(6, options.degree, options.interactions);
+            Vector coefficients = solvePolynomialRegression(A, b, features);
+            std::vector<std::string> names = {"MYCT", "MMIN", "MMAX", "CACH", "CHMIN", "CHMAX"};
+            std::cout << "\nPolynomial model of degree " << options.degree << " with "
+                      << features.numFeatures() << " terms: PRP = ";
+            for (int k = 0; k < features.numFeatures(); ++k) {
+                std::cout << (k > 0 ? " + " : "") << coefficients(k + 1);
+                if (!features.term(k).empty()) std::cout << "*" << features.termName(k, names);
+            }
+            std::cout << "\nRMSE on test set: " << calculatePolynomialRMSE(testData, features, coefficients) << "\n";
+            return 0;
+        }
         
         // Solve the system to find the regression coefficients
-        Vector coefficients = solveLinearRegression(A, b);
+        Vector coefficients(6);
+        if (options.online) {
+            double secondsPerUpdate = 0.0;
+            coefficients = solveOnlineRegression(A, b, options.forgetting, secondsPerUpdate);
+            std::cout << "\nOnline fit (recursive least squares, forgetting " << options.forgetting << "): "
+                      << secondsPerUpdate * 1e9 << " ns per row\n";
+        } else if (options.robust) {
+            coefficients = solveRobustRegression(A, b, options.loss);
+        } else if (options.gradient) {
+            coefficients = solveGradientRegression(A, b, options);
+        } else {
+            coefficients = solveLinearRegression(A, b, options.solver, options.damping);
+        }
         
         // Display the coefficients
         std::cout << "\nLinear regression model: PRP = ";
@@ -270,6 +646,11 @@ int main() {
         }
         erpRMSE = std::sqrt(erpRMSE / testData.size());
         std::cout << "Original article's ERP RMSE: " << erpRMSE << "\n";
+
+        if (!options.saveModel.empty()) {
+            LinearModel(coefficients, means, stddevs).save(options.saveModel);
+            std::cout << "Model saved to " << options.saveModel << "\n";
+        }
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
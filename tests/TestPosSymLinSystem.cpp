@@ -1,9 +1,13 @@
 #include <iostream>
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
+#include <LinearOperator.h>
 #include <LinearSystem.h>
 #include <PosSymLinSystem.h>
 #include <Matrix.h>
+#include <Parallel.h>
+#include <SparseMatrix.h>
 #include <Vector.h>
 using namespace std;
 
@@ -56,6 +60,15 @@ void createSPDMatrix(Matrix& A, int n) {
     }
 }
 
+// Solve with a given pool size, discarding the per-iteration output
+Vector solveWithThreads(PosSymLinSystem& system, int threads) {
+    ThreadPool::instance().setNumThreads(threads);
+    streambuf* saved = cout.rdbuf(nullptr);
+    Vector x = system.Solve();
+    cout.rdbuf(saved);
+    return x;
+}
+
 int main() {
     try {
         cout << "===== Testing PosSymLinSystem with Conjugate Gradient Method =====" << endl << endl;
@@ -143,6 +156,203 @@ int main() {
             cout << "Correctly caught exception: " << e.what() << endl << endl;
         }
         
+        // Test case 5: Several right-hand sides with one Cholesky factorization
+        cout << "Test Case 5: Multiple Right-Hand Sides" << endl;
+        Matrix B5(n, 4);
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= 4; ++j) {
+                B5(i, j) = rand() % 20 - 10;
+            }
+        }
+        printMatrix(B5, "Right-hand sides B");
+
+        PosSymLinSystem system5(&A3, &B5);
+        Matrix X5 = system5.SolveMultiple();
+        printMatrix(X5, "Solutions X");
+
+        Matrix R5 = B5 - A3 * X5;
+        double maxResidual = 0.0;
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= 4; ++j) {
+                maxResidual = fmax(maxResidual, fabs(R5(i, j)));
+            }
+        }
+        cout << "Max residual |B-AX|: " << maxResidual << endl << endl;
+        if (maxResidual > 1e-8) {
+            cerr << "ERROR: Multiple right-hand-side solve has a large residual" << endl;
+            return 1;
+        }
+
+        // Test case 6: Matrix-free 1D Laplacian stencil, never stored
+        cout << "Test Case 6: Matrix-free Operator" << endl;
+        const int m = 40;
+        FunctionOperator laplacian(m, m, [m](const double* x, double* y) {
+            for (int i = 0; i < m; ++i) {
+                y[i] = 2.0 * x[i];
+                if (i > 0) y[i] -= x[i - 1];
+                if (i < m - 1) y[i] -= x[i + 1];
+            }
+        });
+        Vector b6(m);
+        Matrix A6(m, m);
+        for (int i = 1; i <= m; ++i) {
+            b6(i) = 1.0;
+            A6(i, i) = 2.0;
+            if (i > 1) A6(i, i - 1) = -1.0;
+            if (i < m) A6(i, i + 1) = -1.0;
+        }
+        PosSymLinSystem system6(&laplacian, &b6);
+        Vector x6 = system6.Solve();
+
+        LinearSystem direct6(&A6, &b6);
+        Vector xRef6 = direct6.Solve();
+        double maxError = 0.0;
+        for (int i = 1; i <= m; ++i) {
+            maxError = fmax(maxError, fabs(x6(i) - xRef6(i)));
+        }
+        cout << "Max difference to the dense solve: " << maxError << endl << endl;
+        if (maxError > 1e-8) {
+            cerr << "ERROR: Matrix-free CG solution is wrong" << endl;
+            return 1;
+        }
+
+        // Test case 7: parallel CG gives bitwise identical iterates on 1, 2 and 4 threads
+        cout << "Test Case 7: Thread-count Independent CG" << endl;
+        const int n7 = 100000;
+        vector<SparseMatrix::Triplet> entries;
+        for (int i = 1; i <= n7; ++i) {
+            entries.push_back({i, i, 3.0});
+            if (i > 1) entries.push_back({i, i - 1, -1.0});
+            if (i < n7) entries.push_back({i, i + 1, -1.0});
+        }
+        SparseMatrix S7(n7, n7, entries);
+        SparseOperator op7(&S7);
+        Vector b7(n7);
+        for (int i = 1; i <= n7; ++i) {
+            b7(i) = sin(0.001 * i);
+        }
+        PosSymLinSystem sparse7(&op7, &b7);
+
+        Matrix A7(300, 300);
+        createSPDMatrix(A7, 300);
+        Vector c7(300);
+        for (int i = 1; i <= 300; ++i) {
+            c7(i) = 1.0;
+        }
+        PosSymLinSystem dense7(&A7, &c7);
+
+        int original = ThreadPool::instance().numThreads();
+        Vector xs1 = solveWithThreads(sparse7, 1);
+        Vector xd1 = solveWithThreads(dense7, 1);
+        bool identical = true;
+        for (int threads : {2, 4}) {
+            Vector xs = solveWithThreads(sparse7, threads);
+            Vector xd = solveWithThreads(dense7, threads);
+            identical = identical && equal(xs.begin(), xs.end(), xs1.begin()) &&
+                        equal(xd.begin(), xd.end(), xd1.begin());
+        }
+        ThreadPool::instance().setNumThreads(original);
+
+        Vector r7 = S7 * xs1;
+        double residual7 = 0.0;
+        for (int i = 1; i <= n7; ++i) {
+            residual7 = fmax(residual7, fabs(r7(i) - b7(i)));
+        }
+        cout << "Sparse residual: " << residual7 << ", identical across thread counts: "
+             << (identical ? "yes" : "no") << endl << endl;
+        if (!identical || residual7 > 1e-8) {
+            cerr << "ERROR: Parallel CG depends on the thread count or is wrong" << endl;
+            return 1;
+        }
+
+        // Test case 8: pipelined CG matches classic CG and is thread-count independent too
+        cout << "Test Case 8: Pipelined CG" << endl;
+        int classicIterations = sparse7.Iterations();
+        sparse7.SetVariant(CGVariant::Pipelined);
+        sparse7.SetReplacementInterval(10);
+        Vector xp1 = solveWithThreads(sparse7, 1);
+        Vector xp4 = solveWithThreads(sparse7, 4);
+        ThreadPool::instance().setNumThreads(original);
+        bool pipelinedIdentical = equal(xp1.begin(), xp1.end(), xp4.begin());
+
+        dense7.SetVariant(CGVariant::Pipelined);
+        Vector xpd = solveWithThreads(dense7, original);
+        double maxDiff8 = 0.0;
+        for (int i = 1; i <= n7; ++i) {
+            maxDiff8 = fmax(maxDiff8, fabs(xp1(i) - xs1(i)));
+        }
+        for (int i = 1; i <= 300; ++i) {
+            maxDiff8 = fmax(maxDiff8, fabs(xpd(i) - xd1(i)));
+        }
+        cout << "Iterations: classic " << classicIterations << ", pipelined " << sparse7.Iterations()
+             << " with " << sparse7.Replacements() << " residual replacements" << endl;
+        cout << scientific << "Max difference to classic CG: " << maxDiff8 << fixed << endl << endl;
+        if (!pipelinedIdentical || maxDiff8 > 1e-9 || sparse7.Replacements() == 0 ||
+            abs(sparse7.Iterations() - classicIterations) > 2) {
+            cerr << "ERROR: Pipelined CG is wrong" << endl;
+            return 1;
+        }
+
+        // Test case 9: block CG with deflation against Cholesky and single-vector CG
+        cout << "Test Case 9: Block CG" << endl;
+        const int s9 = 12;
+        Matrix B9(300, s9);
+        for (int i = 1; i <= 300; ++i) {
+            for (int j = 1; j <= s9; ++j) {
+                B9(i, j) = j == s9 ? B9(i, 1) : sin(0.01 * i * j);   // last column repeats the first
+            }
+        }
+        PosSymLinSystem dense9(&A7, &B9);
+        Matrix X9 = dense9.SolveMultiple();
+        streambuf* saved9 = cout.rdbuf(nullptr);
+        Matrix Y9 = dense9.SolveBlockCG();
+        cout.rdbuf(saved9);
+        double maxDiff9 = 0.0;
+        for (int i = 1; i <= 300; ++i) {
+            for (int j = 1; j <= s9; ++j) {
+                maxDiff9 = fmax(maxDiff9, fabs(X9(i, j) - Y9(i, j)));
+            }
+        }
+        int blockIterations = dense9.Iterations();
+
+        // Sparse, matrix-free: SolveMultiple() runs block CG, compare with CG per column
+        const int n9 = 20000;
+        vector<SparseMatrix::Triplet> entries9;
+        for (int i = 1; i <= n9; ++i) {
+            entries9.push_back({i, i, 3.0});
+            if (i > 1) entries9.push_back({i, i - 1, -1.0});
+            if (i < n9) entries9.push_back({i, i + 1, -1.0});
+        }
+        SparseMatrix S9(n9, n9, entries9);
+        SparseOperator op9(&S9);
+        Matrix B9s(n9, 4);
+        for (int i = 1; i <= n9; ++i) {
+            for (int j = 1; j <= 4; ++j) {
+                B9s(i, j) = cos(0.0003 * i * j);
+            }
+        }
+        PosSymLinSystem sparse9(&op9, &B9s);
+        saved9 = cout.rdbuf(nullptr);
+        Matrix Y9s = sparse9.SolveMultiple();
+        cout.rdbuf(saved9);
+        for (int j = 1; j <= 4; ++j) {
+            Vector bj(n9);
+            for (int i = 1; i <= n9; ++i) {
+                bj(i) = B9s(i, j);
+            }
+            PosSymLinSystem single(&op9, &bj);
+            Vector xj = solveWithThreads(single, original);
+            for (int i = 1; i <= n9; ++i) {
+                maxDiff9 = fmax(maxDiff9, fabs(xj(i) - Y9s(i, j)));
+            }
+        }
+        cout << "Block iterations: dense " << blockIterations << ", sparse " << sparse9.Iterations() << endl;
+        cout << scientific << "Max difference to Cholesky and single CG: " << maxDiff9 << fixed << endl << endl;
+        if (maxDiff9 > 1e-8) {
+            cerr << "ERROR: Block CG solution is wrong" << endl;
+            return 1;
+        }
+
     } catch (const exception& e) {
         cerr << "Unexpected exception: " << e.what() << endl;
         return 1;
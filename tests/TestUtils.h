@@ -0,0 +1,53 @@
+# pragma once
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <Matrix.h>
+#include <Vector.h>
+
+// Helpers shared by the test executables
+
+// Prints the message when the condition does not hold, returns the condition
+inline bool check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cout << "ERROR: " << message << std::endl;
+    }
+    return condition;
+}
+
+inline void printVector(const Vector& v, const std::string& label) {
+    std::cout << label << " = [";
+    for (int i = 0; i < v.size(); ++i) {
+        std::cout << v.data()[i];
+        if (i + 1 < v.size()) std::cout << ", ";
+    }
+    std::cout << "]" << std::endl;
+}
+
+inline double maxDifference(const Vector& x, const Vector& y) {
+    double diff = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+        diff = std::fmax(diff, std::fabs(x.data()[i] - y.data()[i]));
+    }
+    return diff;
+}
+
+// Regression-shaped design with known coefficients plus deterministic noise
+// in [-noise, noise]: A(i, j) = sin(frequency·r·j + j) + ((7r + 13j) mod 17) / 17
+// for row r = i + offset, so consecutive calls with growing offsets continue
+// one stream of rows.
+inline void buildProblem(Matrix& A, Vector& b, const Vector& coefficients, double noise,
+                         double frequency = 0.01, int offset = 0) {
+    int m = A.numRows();
+    int p = A.numCols();
+    for (int i = 1; i <= m; ++i) {
+        int row = i + offset;
+        double sum = 0.0;
+        for (int j = 1; j <= p; ++j) {
+            A(i, j) = std::sin(frequency * row * j + j) + ((row * 7 + j * 13) % 17) / 17.0;
+            sum += A(i, j) * coefficients.data()[j - 1];
+        }
+        b(i) = sum + noise * (((row * 31) % 101) / 50.0 - 1.0);
+    }
+}
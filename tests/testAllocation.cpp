@@ -0,0 +1,164 @@
+#include <iostream>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <AllocationTracker.h>
+#include <LinearOperator.h>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <PosSymLinSystem.h>
+#include <Vector.h>
+
+using namespace std;
+
+bool check(bool condition, const string& message) {
+    if (!condition) {
+        cout << "ERROR: " << message << endl;
+    }
+    return condition;
+}
+
+// Symmetric positive definite tridiagonal [-1 2 -1] matrix
+Matrix laplacian(int n) {
+    Matrix A(n, n);
+    for (int i = 1; i <= n; ++i) {
+        A(i, i) = 2.0;
+        if (i > 1) A(i, i - 1) = -1.0;
+        if (i < n) A(i, i + 1) = -1.0;
+    }
+    return A;
+}
+
+// Allocations of one CG solve of size n
+uint64_t cgAllocations(int n) {
+    Matrix A = laplacian(n);
+    Vector b(n);
+    for (int i = 1; i <= n; ++i) {
+        b(i) = 1.0;
+    }
+    PosSymLinSystem system(&A, &b);
+
+    streambuf* previous = cout.rdbuf();
+    ostringstream discard;
+    cout.rdbuf(discard.rdbuf());
+    allocation::Scope scope("CG solve");
+    Vector x = system.Solve();
+    cout.rdbuf(previous);
+    uint64_t allocations = scope.allocations();
+
+    Vector residual = A * x - b;
+    cout << "n = " << n << ": " << allocations << " allocations, residual = "
+         << sqrt(residual.dot(residual)) << endl;
+    return allocations;
+}
+
+int main() {
+    cout << "===== Testing allocation accounting =====" << endl << endl;
+    bool ok = true;
+
+    try {
+        // Test 1: per-type counts, bytes and peak
+        cout << "Test 1: Matrix and Vector counters" << endl;
+        {
+            allocation::Scope scope("test 1");
+            Matrix A(10, 20);
+            Vector v(100);
+            {
+                Matrix B(A);
+                Matrix C(5, 5);
+            }
+            const allocation::Stats& m = scope.stats(allocation::Kind::Matrix);
+            const allocation::Stats& vs = scope.stats(allocation::Kind::Vector);
+            cout << "Matrix: " << m.allocations << " allocations, " << m.frees << " frees, peak "
+                 << m.peakBytes << " bytes" << endl;
+            ok = check(m.allocations == 3 && m.frees == 2, "three matrices allocated, two freed") && ok;
+            ok = check(m.bytes == 8 * (200 + 200 + 25), "matrix bytes are wrong") && ok;
+            ok = check(m.peakBytes == 8 * (200 + 200 + 25) && m.liveBytes == 8 * 200, "matrix peak is wrong") && ok;
+            ok = check(vs.allocations == 1 && vs.bytes == 800, "one vector of 800 bytes") && ok;
+            ok = check(scope.peakBytes() == 8 * (200 + 100 + 200 + 25), "scope peak should combine both types") && ok;
+        }
+        cout << endl;
+
+        // Test 2: hidden copies
+        cout << "Test 2: temporaries and in-place updates" << endl;
+        {
+            Vector x(50), y(50), z(50);
+            Matrix A(8, 8), B(8, 8);
+            allocation::Scope scope("test 2");
+            x = y;
+            A = B;
+            x += y;
+            x -= z;
+            x *= 2.0;
+            x.addScaled(0.5, y);
+            ok = check(scope.allocations() == 0, "same-size assignment and in-place updates should not allocate") && ok;
+
+            x = x + y * 2.0;
+            cout << "x = x + y * 2.0 allocates " << scope.allocations() << " times" << endl;
+            ok = check(scope.allocations() == 2, "y * 2.0 and the sum are the only temporaries") && ok;
+        }
+        cout << endl;
+
+        // Test 3: a CG solve allocates its four work vectors, whatever the iteration count
+        cout << "Test 3: CG solve" << endl;
+        ok = check(cgAllocations(10) == 4, "CG with 10 unknowns should allocate 4 vectors") && ok;
+        ok = check(cgAllocations(60) == 4, "CG with 60 unknowns should allocate 4 vectors") && ok;
+        cout << endl;
+
+        // Test 4: LU solve copies the matrix once and allocates the solution
+        cout << "Test 4: LU solve" << endl;
+        {
+            Matrix A = laplacian(30);
+            Vector b(30);
+            b(1) = 1.0;
+            LinearSystem system(&A, &b);
+            allocation::Scope scope("LU solve");
+            Vector x = system.Solve();
+            const allocation::Stats& m = scope.stats(allocation::Kind::Matrix);
+            const allocation::Stats& v = scope.stats(allocation::Kind::Vector);
+            cout << "Matrix allocations = " << m.allocations << ", Vector allocations = " << v.allocations << endl;
+            ok = check(m.allocations == 1 && m.bytes == 8 * 30 * 30, "LU should copy the matrix once") && ok;
+            ok = check(v.allocations == 1, "LU should only allocate the solution vector") && ok;
+        }
+        cout << endl;
+
+        // Test 5: nested scopes, sites and the report
+        cout << "Test 5: sites and report" << endl;
+        allocation::reset();
+        {
+            allocation::Scope outer("outer");
+            for (int i = 0; i < 3; ++i) {
+                ALLOCATION_SITE();
+                Vector v(10);
+            }
+            Matrix A(2, 2);
+            ok = check(outer.allocations() == 4, "outer scope should include nested ones") && ok;
+        }
+        ok = check(allocation::totals(allocation::Kind::Vector).allocations == 3, "totals count every vector") && ok;
+        bool foundOuter = false, foundSite = false;
+        for (const allocation::SiteStats& site : allocation::sites()) {
+            if (site.site == "outer") {
+                foundOuter = site.scopes == 1 && site.stats.allocations == 4;
+            } else if (site.site.find("testAllocation.cpp:") != string::npos) {
+                foundSite = site.scopes == 3 && site.stats.allocations == 3 && site.stats.peakBytes == 80;
+            }
+        }
+        ok = check(foundOuter, "outer site should be recorded once with 4 allocations") && ok;
+        ok = check(foundSite, "file:line site should be recorded three times") && ok;
+        ostringstream report;
+        allocation::writeText(report);
+        cout << report.str();
+        ok = check(report.str().find("peak bytes") != string::npos, "report should have a header") && ok;
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "ERROR: allocation counts are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
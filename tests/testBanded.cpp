@@ -0,0 +1,194 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <BandedLinSystem.h>
+#include <BandedMatrix.h>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <TridiagonalLinSystem.h>
+#include <TridiagonalMatrix.h>
+#include <Vector.h>
+
+using namespace std;
+
+double maxDifference(Vector& x, Vector& y) {
+    double diff = 0.0;
+    for (int i = 1; i <= x.size(); ++i) {
+        diff = fmax(diff, fabs(x(i) - y(i)));
+    }
+    return diff;
+}
+
+// 1D diffusion with a varying coefficient: -k(i-1) x(i-1) + (k(i-1)+k(i)+h) x(i) - k(i) x(i+1)
+TridiagonalMatrix diffusion(int n) {
+    TridiagonalMatrix T(n);
+    for (int i = 1; i <= n; ++i) {
+        double left = 1.0 + 0.5 * sin(0.1 * i);
+        double right = 1.0 + 0.5 * sin(0.1 * (i + 1));
+        T.diagonal(i) = left + right + 0.01;
+        if (i > 1) T.lower(i) = -left;
+        if (i < n) T.upper(i) = -right;
+    }
+    return T;
+}
+
+Vector denseSolve(Matrix A, Vector& b) {
+    LinearSystem system(&A, &b);
+    return system.Solve();
+}
+
+int main() {
+    cout << "===== Testing banded and tridiagonal solvers =====" << endl << endl;
+    bool ok = true;
+    srand(7);
+
+    // Test 1: Thomas algorithm and cyclic reduction against dense LU
+    cout << "Test 1: Tridiagonal diffusion systems" << endl;
+    int sizes[] = {1, 2, 3, 7, 64, 200, 1000};
+    for (int n : sizes) {
+        TridiagonalMatrix T = diffusion(n);
+        Vector b(n);
+        for (int i = 1; i <= n; ++i) {
+            b(i) = rand() % 11 - 5;
+        }
+        Vector xRef = denseSolve(T.toDense(), b);
+
+        TridiagonalLinSystem system(&T, &b);
+        Vector xThomas = system.Solve();
+        Vector xCR = system.SolveCyclicReduction();
+        double errThomas = maxDifference(xThomas, xRef);
+        double errCR = maxDifference(xCR, xRef);
+        cout << "n = " << n << ": Thomas error " << errThomas << ", cyclic reduction error " << errCR << endl;
+        ok = ok && errThomas < 1e-8 && errCR < 1e-8;
+    }
+
+    // Cyclic reduction is unchanged when the levels run on several threads
+    int previousThreads = ThreadPool::instance().numThreads();
+    ThreadPool::instance().setNumThreads(4);
+    {
+        int n = 100000;
+        TridiagonalMatrix T = diffusion(n);
+        Vector b(n);
+        for (int i = 1; i <= n; ++i) {
+            b(i) = 1.0;
+        }
+        TridiagonalLinSystem system(&T, &b);
+        Vector xThomas = system.Solve();
+        Vector xCR = system.SolveCyclicReduction();
+        Vector r = T * xCR;
+        double residual = maxDifference(r, b);
+        cout << "n = " << n << " on 4 threads: Thomas vs cyclic reduction " << maxDifference(xThomas, xCR)
+             << ", residual " << residual << endl;
+        ok = ok && maxDifference(xThomas, xCR) < 1e-8 && residual < 1e-8;
+    }
+    ThreadPool::instance().setNumThreads(previousThreads);
+
+    // Several right-hand sides share one sweep
+    {
+        int n = 50;
+        TridiagonalMatrix T = diffusion(n);
+        Matrix B(n, 3);
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= 3; ++j) {
+                B(i, j) = rand() % 7 - 3;
+            }
+        }
+        TridiagonalLinSystem system(&T, &B);
+        Matrix X = system.SolveMultiple();
+        Matrix R = T.toDense() * X - B;
+        double maxResidual = 0.0;
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= 3; ++j) {
+                maxResidual = fmax(maxResidual, fabs(R(i, j)));
+            }
+        }
+        cout << "Multiple right-hand sides residual: " << maxResidual << endl << endl;
+        ok = ok && maxResidual < 1e-10;
+    }
+
+    // Test 2: Band LU needs row swaps when the diagonal is small
+    cout << "Test 2: Nonsymmetric band LU with pivoting (kl = 2, ku = 3)" << endl;
+    {
+        int n = 120;
+        BandedMatrix A(n, 2, 3);
+        for (int i = 1; i <= n; ++i) {
+            for (int j = max(1, i - 2); j <= min(n, i + 3); ++j) {
+                A(i, j) = (rand() % 200 - 100) / 50.0;
+            }
+            A(i, i) = 1e-3 * (i % 3);
+        }
+        Vector b(n);
+        for (int i = 1; i <= n; ++i) {
+            b(i) = rand() % 11 - 5;
+        }
+        Vector xRef = denseSolve(A.toDense(), b);
+        BandedLinSystem system(&A, &b);
+        Vector x = system.Solve();
+        Vector r = A * x;
+        double err = maxDifference(x, xRef);
+        cout << "Error vs dense LU: " << err << ", residual " << maxDifference(r, b) << endl << endl;
+        ok = ok && maxDifference(r, b) < 1e-8;
+    }
+
+    // Test 3: Band Cholesky of an SPD pentadiagonal matrix
+    cout << "Test 3: SPD band Cholesky (bandwidth 2)" << endl;
+    {
+        int n = 300;
+        BandedMatrix A(n, 2, 2);
+        for (int i = 1; i <= n; ++i) {
+            A(i, i) = 6.0 + (i % 4);
+            if (i > 1) { A(i, i - 1) = -1.5; A(i - 1, i) = -1.5; }
+            if (i > 2) { A(i, i - 2) = -1.0; A(i - 2, i) = -1.0; }
+        }
+        Vector b(n);
+        for (int i = 1; i <= n; ++i) {
+            b(i) = sin(0.05 * i);
+        }
+        Vector xRef = denseSolve(A.toDense(), b);
+        BandedLinSystem system(&A, &b);
+        Vector xChol = system.SolveCholesky();
+        Vector xLU = system.Solve();
+        cout << "Cholesky error " << maxDifference(xChol, xRef) << ", LU error "
+             << maxDifference(xLU, xRef) << endl << endl;
+        ok = ok && maxDifference(xChol, xRef) < 1e-10 && maxDifference(xLU, xRef) < 1e-10;
+    }
+
+    // Test 4: Error handling
+    cout << "Test 4: Singular and indefinite matrices" << endl;
+    {
+        TridiagonalMatrix T(3);
+        T.diagonal(1) = 1.0; T.upper(1) = 1.0;
+        T.lower(2) = 1.0; T.diagonal(2) = 1.0;
+        T.diagonal(3) = 1.0;
+        Vector b(3);
+        TridiagonalLinSystem system(&T, &b);
+        try {
+            system.Solve();
+            cout << "ERROR: Should have thrown for a singular tridiagonal matrix" << endl;
+            ok = false;
+        } catch (const runtime_error& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+        }
+
+        BandedMatrix A(3, 1, 1);
+        A(1, 1) = 1.0; A(1, 2) = 2.0;
+        A(2, 1) = 2.0; A(2, 2) = 1.0; A(2, 3) = 0.0;
+        A(3, 3) = 1.0;
+        BandedLinSystem banded(&A, &b);
+        try {
+            banded.SolveCholesky();
+            cout << "ERROR: Should have thrown for an indefinite matrix" << endl;
+            ok = false;
+        } catch (const runtime_error& e) {
+            cout << "Correctly caught exception: " << e.what() << endl << endl;
+        }
+    }
+
+    if (!ok) {
+        cerr << "ERROR: Banded solver results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
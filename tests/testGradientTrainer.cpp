@@ -0,0 +1,203 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <GradientTrainer.h>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+
+using namespace std;
+
+bool check(bool condition, const string& message) {
+    if (!condition) {
+        cout << "ERROR: " << message << endl;
+    }
+    return condition;
+}
+
+// Well-conditioned design with an intercept column and deterministic noise
+void buildProblem(Matrix& A, Vector& b) {
+    int m = A.numRows();
+    int p = A.numCols();
+    for (int i = 1; i <= m; ++i) {
+        double sum = 0.0;
+        for (int j = 1; j <= p; ++j) {
+            A(i, j) = j == 1 ? 1.0 : sin(0.37 * i * j + j);
+            sum += A(i, j) * (j - 3.5);
+        }
+        b(i) = sum + 0.1 * (((i * 31) % 101) / 50.0 - 1.0);
+    }
+}
+
+double maxDifference(const Vector& x, const Vector& y) {
+    double diff = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+        diff = fmax(diff, fabs(x.data()[i] - y.data()[i]));
+    }
+    return diff;
+}
+
+int main() {
+    cout << "===== Testing mini-batch gradient trainer =====" << endl << endl;
+    bool ok = true;
+    const int m = 20000;
+    const int p = 8;
+
+    try {
+        Matrix A(m, p);
+        Vector b(m);
+        buildProblem(A, b);
+        TallSkinnyQR tsqr(A, b);
+        Vector direct = tsqr.Solve();
+
+        // Scaled normal equations G = A^T A / m, g = A^T b / m of the mean squared loss
+        Matrix G(p, p);
+        Vector g(p);
+        for (int i = 1; i <= m; ++i) {
+            for (int j = 1; j <= p; ++j) {
+                g(j) += A(i, j) * b(i) / m;
+                for (int k = 1; k <= p; ++k) {
+                    G(j, k) += A(i, j) * A(i, k) / m;
+                }
+            }
+        }
+
+        // Test 1: full-batch gradient descent reaches the least-squares solution
+        cout << "Test 1: full-batch gradient descent" << endl;
+        // Full-batch descent contracts for any step below 2 / lambda_max(G).
+        // The Gershgorin bound on lambda_max is near 1 for this design (the
+        // intercept has unit variance, the sine columns about 1/2 and nearly
+        // no correlation), so the step 1 / bound is safe and still fast.
+        double gershgorin = 0.0;
+        for (int j = 1; j <= p; ++j) {
+            double rowSum = 0.0;
+            for (int k = 1; k <= p; ++k) {
+                rowSum += fabs(G(j, k));
+            }
+            gershgorin = max(gershgorin, rowSum);
+        }
+        cout << "Gershgorin bound on lambda_max = " << gershgorin << endl;
+        ok = check(gershgorin < 1.5, "the design should stay well conditioned") && ok;
+        GradientTrainer full(&A, &b);
+        full.SetMethod(GradientMethod::SGD);
+        full.SetBatchSize(m);
+        full.SetLearningRate(1.0 / gershgorin);
+        full.SetEpochs(200);
+        Vector x = full.Train();
+        cout << "max difference to TSQR = " << maxDifference(x, direct) << endl;
+        ok = check(maxDifference(x, direct) < 1e-8, "full-batch descent should converge to the direct solution") && ok;
+        cout << endl;
+
+        // Test 2: mini-batch Adam and momentum get close to the optimum
+        cout << "Test 2: mini-batch methods" << endl;
+        double optimum = full.Objective(direct);
+        GradientTrainer adam(&A, &b);
+        adam.SetBatchSize(64);
+        adam.SetDecay(0.5);
+        adam.SetEpochs(20);
+        adam.Train();
+        GradientTrainer momentum(&A, &b);
+        momentum.SetMethod(GradientMethod::Momentum);
+        momentum.SetBatchSize(64);
+        momentum.SetLearningRate(0.02);
+        momentum.SetDecay(0.5);
+        momentum.SetEpochs(20);
+        momentum.Train();
+        double adamGap = adam.History().back().objective / optimum - 1.0;
+        double momentumGap = momentum.History().back().objective / optimum - 1.0;
+        cout << "optimum f = " << optimum << ", relative gap: Adam " << adamGap << ", momentum " << momentumGap << endl;
+        cout << "max difference to TSQR: Adam " << maxDifference(adam.Coefficients(), direct) << ", momentum "
+             << maxDifference(momentum.Coefficients(), direct) << endl;
+        ok = check(adamGap < 1e-2 && momentumGap < 1e-2, "mini-batch methods should reach the optimum to 1e-2") && ok;
+        ok = check(maxDifference(adam.Coefficients(), direct) < 1e-2 && maxDifference(momentum.Coefficients(), direct) < 1e-2,
+                   "mini-batch coefficients should be within 1e-2 of the direct solution") && ok;
+        ok = check(adam.History().size() == 21 && adam.History()[0].seconds == 0.0,
+                   "history should hold the start and every epoch") && ok;
+        cout << endl;
+
+        // Test 3: the L2 penalty gives the ridge solution
+        cout << "Test 3: L2 penalty" << endl;
+        const double lambda = 0.5;
+        Matrix ridgeG(G);
+        for (int j = 1; j <= p; ++j) {
+            ridgeG(j, j) += lambda;
+        }
+        LinearSystem ridgeSystem(&ridgeG, &g);
+        Vector ridge = ridgeSystem.Solve();
+        full.SetL2(lambda);
+        Vector penalized = full.Train();
+        cout << "max difference to the ridge solution = " << maxDifference(penalized, ridge) << endl;
+        ok = check(maxDifference(penalized, ridge) < 1e-8, "L2 descent should converge to the ridge solution") && ok;
+        cout << endl;
+
+        // Test 4: reduction updates do not depend on the thread count
+        cout << "Test 4: deterministic reduction" << endl;
+        GradientTrainer large(&A, &b);
+        large.SetBatchSize(4096);   // several row chunks per batch
+        large.SetEpochs(3);
+        ThreadPool::instance().setNumThreads(1);
+        Vector one = large.Train();
+        ThreadPool::instance().setNumThreads(4);
+        Vector four = large.Train();
+        ok = check(equal(one.begin(), one.end(), four.begin()), "1 and 4 threads should agree bitwise") && ok;
+        cout << endl;
+
+        // Test 5: Hogwild
+        cout << "Test 5: Hogwild" << endl;
+        GradientTrainer hogwild(&A, &b);
+        hogwild.SetUpdate(GradientUpdate::Hogwild);
+        hogwild.SetBatchSize(64);
+        hogwild.SetDecay(0.5);
+        hogwild.SetEpochs(20);
+        hogwild.Train();
+        double hogwildGap = hogwild.History().back().objective / optimum - 1.0;
+        cout << "4 threads: relative gap " << hogwildGap << ", max difference to TSQR "
+             << maxDifference(hogwild.Coefficients(), direct) << endl;
+        ok = check(hogwildGap < 1e-2, "Hogwild should reach the optimum to 1e-2") && ok;
+        ThreadPool::instance().setNumThreads(1);
+        Vector sequential = hogwild.Train();
+        Vector reduced = adam.Train();
+        ok = check(equal(sequential.begin(), sequential.end(), reduced.begin()),
+                   "Hogwild on one thread should equal the reduction") && ok;
+        cout << endl;
+
+        // Test 6: default batch size and invalid arguments
+        cout << "Test 6: batch size and invalid arguments" << endl;
+        GradientTrainer defaults(&A, &b);
+        cout << "default batch for p = " << p << ": " << defaults.BatchSize() << " rows" << endl;
+        ok = check(defaults.BatchSize() == 2048, "the default batch should fill 128 KB") && ok;
+        bool caught = false;
+        try {
+            defaults.SetBatchSize(0);
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "a zero batch size should throw") && ok;
+        caught = false;
+        try {
+            Vector shortB(m - 1);
+            GradientTrainer bad(&A, &shortB);
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "mismatched sizes should throw") && ok;
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "ERROR: gradient trainer results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
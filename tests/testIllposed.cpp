@@ -1,5 +1,6 @@
 #include <iostream>
 #include <LinearSystem.h>
+#include <RandomizedSVD.h>
 #include <Vector.h>
 #include <Matrix.h>
 #include <cmath>
@@ -115,12 +116,106 @@ void solveMoorePenrose() {
     testPseudoinverse(A2, b2, "Example 2: Overdetermined system (5 equations, 3 unknowns)");
 }
 
+// Truncated-SVD solve of the same system; returns false if it disagrees with x
+bool compareTruncatedSVD(Matrix& A, Vector& b, Vector& x) {
+    RandomizedSVD svd(A);
+    Vector xSvd = svd.Solve(b);
+    printVector(xSvd, "Truncated-SVD solution x");
+
+    Vector diff = xSvd - x;
+    double error = vectorNorm(diff);
+    std::cout << "||x_svd - x_pinv|| = " << error << std::endl;
+    return error < 1e-8;
+}
+
+bool solveTruncatedSVD() {
+    std::cout << "\n===== Randomized Truncated-SVD Solutions =====" << std::endl;
+    bool ok = true;
+
+    // Examples 1 and 2 again: full rank, so both methods must agree
+    Matrix A1(3, 5);
+    A1(1, 1) = 1.0; A1(1, 2) = 2.0; A1(1, 3) = 3.0; A1(1, 4) = 4.0; A1(1, 5) = 5.0;
+    A1(2, 1) = 0.1; A1(2, 2) = 0.4; A1(2, 3) = 0.9; A1(2, 4) = 1.6; A1(2, 5) = 2.5;
+    A1(3, 1) = 2.0; A1(3, 2) = 1.0; A1(3, 3) = 1.0; A1(3, 4) = 2.0; A1(3, 5) = 3.0;
+    Vector b1(3);
+    b1(1) = 15.0; b1(2) = 5.5; b1(3) = 9.0;
+    Vector x1 = solvePseudoinverse(A1, b1);
+    ok = compareTruncatedSVD(A1, b1, x1) && ok;
+
+    Matrix A2(5, 3);
+    A2(1, 1) = 1.0; A2(1, 2) = 0.0; A2(1, 3) = 0.0;
+    A2(2, 1) = 1.0; A2(2, 2) = 1.0; A2(2, 3) = 0.0;
+    A2(3, 1) = 1.0; A2(3, 2) = 0.0; A2(3, 3) = 1.0;
+    A2(4, 1) = 1.0; A2(4, 2) = 1.0; A2(4, 3) = 1.0;
+    A2(5, 1) = 0.0; A2(5, 2) = 0.0; A2(5, 3) = 1.0;
+    Vector b2(5);
+    b2(1) = 1.1; b2(2) = 2.2; b2(3) = 1.9; b2(4) = 4.0; b2(5) = 1.1;
+    Vector x2 = solvePseudoinverse(A2, b2);
+    ok = compareTruncatedSVD(A2, b2, x2) && ok;
+
+    // Example 3: rank-deficient (column 3 = column 1 + column 2), pseudoInverse() throws
+    std::cout << "\nExample 3: Rank-deficient system (4 equations, 3 unknowns, rank 2)" << std::endl;
+    Matrix A3(4, 3);
+    A3(1, 1) = 1.0; A3(1, 2) = 2.0; A3(1, 3) = 3.0;
+    A3(2, 1) = 2.0; A3(2, 2) = 1.0; A3(2, 3) = 3.0;
+    A3(3, 1) = 0.0; A3(3, 2) = 1.0; A3(3, 3) = 1.0;
+    A3(4, 1) = 1.0; A3(4, 2) = 1.0; A3(4, 3) = 2.0;
+    Vector b3(4);
+    b3(1) = 6.0; b3(2) = 6.0; b3(3) = 2.0; b3(4) = 4.0;
+
+    try {
+        A3.pseudoInverse();
+        std::cout << "Note: pseudoInverse() did not detect the rank deficiency" << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "pseudoInverse() failed as expected: " << e.what() << std::endl;
+    }
+
+    RandomizedSVD svd3(A3, 0, 1e-10);
+    Vector x3 = svd3.Solve(b3);
+    printVector(x3, "Truncated-SVD solution x");
+    Vector Ax3 = matrixVectorMultiply(A3, x3);
+    Vector r3 = Ax3 - b3;
+    std::cout << "Numerical rank = " << svd3.Rank() << std::endl;
+    std::cout << "Residual norm ||Ax - b|| = " << vectorNorm(r3) << std::endl;
+    // The system is consistent, so the residual must vanish, and the minimum-norm
+    // solution has no component along the null space [1, 1, -1]
+    double nullComponent = x3(1) + x3(2) - x3(3);
+    std::cout << "Null-space component = " << nullComponent << std::endl;
+    ok = ok && svd3.Rank() == 2 && vectorNorm(r3) < 1e-8 && std::fabs(nullComponent) < 1e-8;
+
+    // Example 4: larger low-rank system, only the leading triplets are computed
+    std::cout << "\nExample 4: 400 x 300 system of rank 5" << std::endl;
+    int m = 400, n = 300, k = 5;
+    Matrix L(m, k), R(k, n);
+    for (int i = 1; i <= m; i++) {
+        for (int j = 1; j <= k; j++) L(i, j) = std::sin(0.37 * i * j + j);
+    }
+    for (int i = 1; i <= k; i++) {
+        for (int j = 1; j <= n; j++) R(i, j) = std::cos(0.11 * i * j - i);
+    }
+    Matrix A4 = L * R;
+    Vector xTrue(n);
+    for (int j = 1; j <= n; j++) xTrue(j) = std::cos(0.05 * j);
+    Vector b4 = matrixVectorMultiply(A4, xTrue);
+
+    RandomizedSVD svd4(A4, 10, 1e-10);
+    Vector x4 = svd4.Solve(b4);
+    Vector r4 = matrixVectorMultiply(A4, x4) - b4;
+    std::cout << "Numerical rank = " << svd4.Rank() << std::endl;
+    std::cout << "Relative residual = " << vectorNorm(r4) / vectorNorm(b4) << std::endl;
+    ok = ok && svd4.Rank() == k && vectorNorm(r4) / vectorNorm(b4) < 1e-8;
+
+    std::cout << (ok ? "Truncated-SVD solutions VERIFIED!" : "ERROR: Truncated-SVD solution is wrong!") << std::endl;
+    return ok;
+}
+
 int main() {
     std::cout << "Solving Ill-Posed Linear Systems with Moore-Penrose Pseudoinverse" << std::endl;
     std::cout << "=========================================================" << std::endl;
     
     try {
         solveMoorePenrose();
+        if (!solveTruncatedSVD()) return 1;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
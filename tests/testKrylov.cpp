@@ -0,0 +1,192 @@
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <BiCGSTABLinSystem.h>
+#include <GMRESLinSystem.h>
+#include <LinearOperator.h>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <Preconditioner.h>
+#include <SparseMatrix.h>
+#include <Vector.h>
+
+using namespace std;
+
+void printVector(Vector& v, const string& label) {
+    cout << label << " = [";
+    for (int i = 1; i <= v.size(); ++i) {
+        cout << v(i);
+        if (i < v.size()) cout << ", ";
+    }
+    cout << "]" << endl;
+}
+
+double maxDifference(Vector& x, Vector& y) {
+    double diff = 0.0;
+    for (int i = 1; i <= x.size(); ++i) {
+        diff = fmax(diff, fabs(x(i) - y(i)));
+    }
+    return diff;
+}
+
+// Upwind convection-diffusion on an N x N grid: nonsymmetric, diagonally dominant
+SparseMatrix convectionDiffusion(int N, double convection) {
+    vector<SparseMatrix::Triplet> entries;
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            int row = i * N + j + 1;
+            entries.push_back({row, row, 4.0 + convection});
+            if (i > 0) entries.push_back({row, row - N, -1.0 - convection});
+            if (i < N - 1) entries.push_back({row, row + N, -1.0});
+            if (j > 0) entries.push_back({row, row - 1, -1.0});
+            if (j < N - 1) entries.push_back({row, row + 1, -1.0});
+        }
+    }
+    return SparseMatrix(N * N, N * N, entries);
+}
+
+int main() {
+    cout << "===== Testing GMRES and BiCGSTAB =====" << endl << endl;
+    bool ok = true;
+
+    // Test 1: Small dense nonsymmetric system, compared with Gaussian elimination
+    cout << "Test 1: 3x3 nonsymmetric dense system" << endl;
+    Matrix A1(3, 3);
+    A1(1, 1) = 4.0; A1(1, 2) = -1.0; A1(1, 3) = 2.0;
+    A1(2, 1) = 1.0; A1(2, 2) = 5.0;  A1(2, 3) = -1.0;
+    A1(3, 1) = -2.0; A1(3, 2) = 1.0; A1(3, 3) = 6.0;
+    Vector b1(3);
+    b1(1) = 7.0; b1(2) = 4.0; b1(3) = 11.0;
+
+    LinearSystem direct1(&A1, &b1);
+    Vector xDirect = direct1.Solve();
+
+    GMRESLinSystem gmres1(&A1, &b1);
+    Vector xGmres = gmres1.Solve();
+    BiCGSTABLinSystem bicg1(&A1, &b1);
+    Vector xBicg = bicg1.Solve();
+
+    printVector(xDirect, "Direct");
+    printVector(xGmres, "GMRES");
+    printVector(xBicg, "BiCGSTAB");
+    cout << "GMRES iterations: " << gmres1.Iterations()
+         << ", BiCGSTAB iterations: " << bicg1.Iterations() << endl << endl;
+    ok = ok && maxDifference(xGmres, xDirect) < 1e-8 && maxDifference(xBicg, xDirect) < 1e-8;
+
+    // Test 2: Sparse convection-diffusion, restarted GMRES and BiCGSTAB with Jacobi
+    cout << "Test 2: 400 unknown convection-diffusion system" << endl;
+    SparseMatrix S = convectionDiffusion(20, 2.0);
+    Vector b2(S.numRows());
+    for (int i = 1; i <= b2.size(); ++i) {
+        b2(i) = 1.0 + (i % 5);
+    }
+    Matrix dense = S.toDense();
+    LinearSystem direct2(&dense, &b2);
+    Vector xRef = direct2.Solve();
+
+    JacobiPreconditioner jacobi(S);
+
+    GMRESLinSystem gmres2(&S, &b2, 20);
+    gmres2.SetPreconditioner(&jacobi);
+    Vector xg = gmres2.Solve();
+    cout << "GMRES(20): " << gmres2.Iterations() << " iterations, residual "
+         << gmres2.ResidualNorm() << ", error " << maxDifference(xg, xRef) << endl;
+    ok = ok && maxDifference(xg, xRef) < 1e-7;
+
+    BiCGSTABLinSystem bicg2(&S, &b2);
+    bicg2.SetPreconditioner(&jacobi);
+    Vector xb = bicg2.Solve();
+    cout << "BiCGSTAB: " << bicg2.Iterations() << " iterations, residual "
+         << bicg2.ResidualNorm() << ", error " << maxDifference(xb, xRef) << endl;
+    ok = ok && maxDifference(xb, xRef) < 1e-7;
+
+    // Dense operator gives the same answer as the sparse one
+    GMRESLinSystem gmres3(&dense, &b2, 20);
+    Vector xd = gmres3.Solve();
+    cout << "GMRES(20) on the dense copy: " << gmres3.Iterations() << " iterations, error "
+         << maxDifference(xd, xRef) << endl << endl;
+    ok = ok && maxDifference(xd, xRef) < 1e-7;
+
+    // Test 3: Iteration cap is respected and reported
+    cout << "Test 3: Iteration limit" << endl;
+    GMRESLinSystem limited(&S, &b2, 5);
+    limited.SetMaxIterations(3);
+    limited.Solve();
+    cout << "Iterations performed: " << limited.Iterations() << endl << endl;
+    ok = ok && limited.Iterations() == 3;
+
+    // Test 4: Matrix-free stencil with the diagonal for Jacobi, and transpose products
+    cout << "Test 4: Matrix-free operator" << endl;
+    const int N = 20;
+    FunctionOperator stencil(N * N, N * N, [N](const double* x, double* y) {
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                int k = i * N + j;
+                y[k] = 6.0 * x[k];
+                if (i > 0) y[k] -= 3.0 * x[k - N];
+                if (i < N - 1) y[k] -= x[k + N];
+                if (j > 0) y[k] -= x[k - 1];
+                if (j < N - 1) y[k] -= x[k + 1];
+            }
+        }
+    }, FunctionOperator::ApplyFunction(), vector<double>(N * N, 6.0));
+
+    JacobiPreconditioner stencilJacobi(stencil);
+    GMRESLinSystem gmres4(&stencil, &b2, 20);
+    gmres4.SetPreconditioner(&stencilJacobi);
+    Vector xf = gmres4.Solve();
+    BiCGSTABLinSystem bicg4(&stencil, &b2);
+    Vector xfb = bicg4.Solve();
+    cout << "GMRES(20): " << gmres4.Iterations() << " iterations, error "
+         << maxDifference(xf, xRef) << "; BiCGSTAB: " << bicg4.Iterations()
+         << " iterations, error " << maxDifference(xfb, xRef) << endl;
+    ok = ok && maxDifference(xf, xRef) < 1e-7 && maxDifference(xfb, xRef) < 1e-7;
+
+    // Aᵀx from the sparse and dense adapters agrees with the explicit transpose
+    SparseOperator sparseOp(&S);
+    DenseOperator denseOp(&dense);
+    Matrix denseT(N * N, N * N);
+    for (int i = 1; i <= N * N; ++i) {
+        for (int j = 1; j <= N * N; ++j) {
+            denseT(j, i) = dense(i, j);
+        }
+    }
+    vector<double> ys(N * N), yd(N * N), yt(N * N);
+    sparseOp.applyTranspose(b2.data(), ys.data());
+    denseOp.applyTranspose(b2.data(), yd.data());
+    DenseOperator(&denseT).apply(b2.data(), yt.data());
+    double transposeError = 0.0;
+    for (int i = 0; i < N * N; ++i) {
+        transposeError = fmax(transposeError, fmax(fabs(ys[i] - yt[i]), fabs(yd[i] - yt[i])));
+    }
+    cout << "Transpose product error: " << transposeError << endl << endl;
+    ok = ok && transposeError < 1e-12;
+
+    // Test 5: one Gram operator applied from several threads at once
+    cout << "Test 5: Concurrent Gram operator products" << endl;
+    GramOperator gram(&sparseOp, 0.5);
+    vector<double> gramRef(N * N);
+    gram.apply(b2.data(), gramRef.data());
+    const int calls = 16;
+    vector<vector<double>> gramOut(calls, vector<double>(N * N));
+    ThreadPool::instance().setNumThreads(4);
+    parallelFor(0, calls, 1, [&](int first, int last) {
+        for (int k = first; k < last; ++k) {
+            gram.apply(b2.data(), gramOut[k].data());
+        }
+    });
+    bool sameProducts = true;
+    for (int k = 0; k < calls; ++k) {
+        sameProducts = sameProducts && gramOut[k] == gramRef;
+    }
+    cout << calls << " concurrent products " << (sameProducts ? "match" : "DIFFER FROM") << " the serial one" << endl << endl;
+    ok = ok && sameProducts;
+
+    if (!ok) {
+        cerr << "ERROR: Krylov solver results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <KrylovLeastSquares.h>
+#include <LinearOperator.h>
+#include <Matrix.h>
+#include <SparseMatrix.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+
+using namespace std;
+
+bool check(bool condition, const string& message) {
+    if (!condition) {
+        cout << "ERROR: " << message << endl;
+    }
+    return condition;
+}
+
+double maxDifference(const Vector& x, const Vector& y) {
+    double diff = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+        diff = fmax(diff, fabs(x.data()[i] - y.data()[i]));
+    }
+    return diff;
+}
+
+// Solves with the given method and reports iterations and the residual
+Vector solve(KrylovLeastSquares& solver, LeastSquaresMethod method, const string& label) {
+    solver.SetMethod(method);
+    Vector x = solver.Solve();
+    cout << label << ": " << solver.Iterations() << " iterations, ||b - Ax|| = " << solver.ResidualNorm()
+         << ", ||Aᵀr|| = " << solver.NormalResidualNorm() << endl;
+    return x;
+}
+
+int main() {
+    cout << "===== Testing LSQR and CGLS =====" << endl << endl;
+    bool ok = true;
+    srand(17);
+
+    try {
+        // Test 1: dense regression-shaped design against TSQR
+        cout << "Test 1: dense 2000 x 6 noisy system" << endl;
+        Matrix A1(2000, 6);
+        Vector b1(2000);
+        for (int i = 1; i <= 2000; ++i) {
+            double sum = 0.0;
+            for (int j = 1; j <= 6; ++j) {
+                A1(i, j) = sin(0.001 * i * j + j) + ((i * 7 + j * 13) % 17) / 17.0;
+                sum += A1(i, j) * (j - 3.5);
+            }
+            b1(i) = sum + 0.5 * (((i * 31) % 101) / 50.0 - 1.0);
+        }
+        TallSkinnyQR tsqr1(A1, b1);
+        Vector x1 = tsqr1.Solve();
+        KrylovLeastSquares dense(&A1, &b1);
+        Vector lsqr1 = solve(dense, LeastSquaresMethod::LSQR, "LSQR");
+        Vector cgls1 = solve(dense, LeastSquaresMethod::CGLS, "CGLS");
+        cout << "max |x - x_tsqr| = " << maxDifference(lsqr1, x1) << " (LSQR), " << maxDifference(cgls1, x1)
+             << " (CGLS)" << endl << endl;
+        ok = check(maxDifference(lsqr1, x1) < 1e-8 && maxDifference(cgls1, x1) < 1e-8,
+                   "LSQR and CGLS should match TSQR") && ok;
+        ok = check(dense.Converged() && fabs(dense.ResidualNorm() - tsqr1.ResidualNorm()) < 1e-8 * tsqr1.ResidualNorm(),
+                   "the residual norm should be the least-squares one") && ok;
+
+        // Test 2: sparse rectangular design
+        cout << "Test 2: sparse 2000 x 200 system, 5 entries per row" << endl;
+        const int m2 = 2000, n2 = 200;
+        vector<SparseMatrix::Triplet> entries;
+        Matrix dense2(m2, n2);
+        for (int i = 1; i <= m2; ++i) {
+            for (int k = 0; k < 5; ++k) {
+                int j = (i * 37 + k * 41) % n2 + 1;
+                double value = (rand() % 2001 - 1000) / 1000.0 + (k == 0 ? 2.0 : 0.0);
+                if (dense2(i, j) != 0.0) continue;
+                dense2(i, j) = value;
+                entries.push_back({i, j, value});
+            }
+        }
+        SparseMatrix A2(m2, n2, entries);
+        Vector b2(m2);
+        for (int i = 1; i <= m2; ++i) {
+            b2(i) = (rand() % 2001 - 1000) / 1000.0;
+        }
+        TallSkinnyQR tsqr2(dense2, b2);
+        Vector x2 = tsqr2.Solve();
+        KrylovLeastSquares sparse(&A2, &b2);
+        Vector lsqr2 = solve(sparse, LeastSquaresMethod::LSQR, "LSQR");
+        Vector cgls2 = solve(sparse, LeastSquaresMethod::CGLS, "CGLS");
+        cout << "max |x - x_tsqr| = " << maxDifference(lsqr2, x2) << " (LSQR), " << maxDifference(cgls2, x2)
+             << " (CGLS)" << endl << endl;
+        ok = check(maxDifference(lsqr2, x2) < 1e-8 && maxDifference(cgls2, x2) < 1e-8,
+                   "sparse solutions should match TSQR") && ok;
+
+        // Test 3: damping solves the ridge problem, i.e. least squares on [A; λI]
+        cout << "Test 3: damping 3.0 against TSQR on the augmented system" << endl;
+        double lambda = 3.0;
+        Matrix augmented(2006, 6);
+        Vector bAugmented(2006);
+        for (int i = 1; i <= 2000; ++i) {
+            for (int j = 1; j <= 6; ++j) augmented(i, j) = A1(i, j);
+            bAugmented(i) = b1(i);
+        }
+        for (int j = 1; j <= 6; ++j) augmented(2000 + j, j) = lambda;
+        TallSkinnyQR ridge(augmented, bAugmented);
+        Vector x3 = ridge.Solve();
+        dense.SetDamping(lambda);
+        Vector lsqr3 = solve(dense, LeastSquaresMethod::LSQR, "LSQR");
+        Vector cgls3 = solve(dense, LeastSquaresMethod::CGLS, "CGLS");
+        cout << "max |x - x_ridge| = " << maxDifference(lsqr3, x3) << " (LSQR), " << maxDifference(cgls3, x3)
+             << " (CGLS), shrinkage " << maxDifference(x3, x1) << endl << endl;
+        ok = check(maxDifference(lsqr3, x3) < 1e-8 && maxDifference(cgls3, x3) < 1e-8,
+                   "damped solutions should match the ridge fit") && ok;
+        dense.SetDamping(0.0);
+
+        // Test 4: early stopping
+        cout << "Test 4: early stopping" << endl;
+        KrylovLeastSquares early(&A2, &b2);
+        early.SetMaxIterations(3);
+        solve(early, LeastSquaresMethod::LSQR, "LSQR, 3 iterations");
+        ok = check(!early.Converged() && early.Iterations() == 3, "the iteration cap should stop LSQR") && ok;
+        early.SetMaxIterations(1000);
+        early.SetTolerance(1e-3);
+        Vector loose = solve(early, LeastSquaresMethod::LSQR, "LSQR, tolerance 1e-3");
+        ok = check(early.Converged() && early.Iterations() < sparse.Iterations()
+                   && early.NormalResidualNorm() > 0.0, "a looser tolerance should stop sooner") && ok;
+        cout << endl;
+
+        // Test 5: matrix-free operator
+        cout << "Test 5: operator given by callables" << endl;
+        FunctionOperator op(m2, n2,
+                            [&A2](const double* x, double* y) { A2.multiply(x, y); },
+                            [&A2](const double* x, double* y) { SparseOperator(&A2).applyTranspose(x, y); });
+        KrylovLeastSquares matrixFree(&op, &b2);
+        Vector x5 = solve(matrixFree, LeastSquaresMethod::LSQR, "LSQR");
+        ok = check(maxDifference(x5, lsqr2) == 0.0, "a wrapped operator should give the same iterates") && ok;
+        bool caught = false;
+        try {
+            FunctionOperator noTranspose(m2, n2, [&A2](const double* x, double* y) { A2.multiply(x, y); });
+            KrylovLeastSquares bad(&noTranspose, &b2);
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "an operator without a transpose should be rejected") && ok;
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "ERROR: least-squares results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
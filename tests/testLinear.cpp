@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
 #include "LinearSystem.h"
 #include "Matrix.h"
 #include "Vector.h"
@@ -177,12 +178,97 @@ void tryDirectSolution3x3() {
     }
 }
 
+bool solveMultipleRightHandSides() {
+    cout << "\n=== Multiple Right-Hand Sides Test ===\n" << endl;
+
+    Matrix A(3, 3);
+    A(1, 1) = 3.0; A(1, 2) = 2.0; A(1, 3) = 1.0;
+    A(2, 1) = 2.0; A(2, 2) = 5.0; A(2, 3) = 3.0;
+    A(3, 1) = 1.0; A(3, 2) = 1.0; A(3, 3) = 2.0;
+
+    // Columns are the right-hand sides for x = [1,1,3], [1,0,0] and [0,1,-1]
+    Matrix B(3, 3);
+    B(1, 1) = 8.0;  B(1, 2) = 3.0; B(1, 3) = 1.0;
+    B(2, 1) = 16.0; B(2, 2) = 2.0; B(2, 3) = 2.0;
+    B(3, 1) = 8.0;  B(3, 2) = 1.0; B(3, 3) = -1.0;
+
+    printMatrix(A, "Coefficient Matrix A");
+    printMatrix(B, "Right-hand sides B");
+
+    LinearSystem system(&A, &B);
+    Matrix X = system.SolveMultiple();
+    printMatrix(X, "Solutions X");
+
+    bool ok = true;
+    for (int c = 1; c <= B.numCols(); c++) {
+        Vector x(3);
+        Vector b(3);
+        for (int i = 1; i <= 3; i++) {
+            x(i) = X(i, c);
+            b(i) = B(i, c);
+        }
+        ok = verifySolution(A, x, b) && ok;
+    }
+
+    // Each column must match the single right-hand-side solve
+    Vector b1(3);
+    b1(1) = B(1, 1); b1(2) = B(2, 1); b1(3) = B(3, 1);
+    LinearSystem single(&A, &b1);
+    Vector x1 = single.Solve();
+    for (int i = 1; i <= 3; i++) {
+        if (!isEqual(x1(i), X(i, 1))) ok = false;
+    }
+
+    if (ok) {
+        cout << "Multiple right-hand sides VERIFIED!" << endl;
+    } else {
+        cout << "ERROR: Multiple right-hand-side solution does not satisfy the system!" << endl;
+    }
+    return ok;
+}
+
+bool solveLargeRandomSystem() {
+    cout << "\n=== Large Random System Test (blocked LU) ===\n" << endl;
+
+    // Large enough for several levels of the recursive factorization
+    int n = 300;
+    Matrix A(n, n);
+    Vector xExpected(n);
+    srand(7);
+    for (int i = 1; i <= n; i++) {
+        for (int j = 1; j <= n; j++) {
+            A(i, j) = (rand() % 2000 - 1000) / 1000.0;
+        }
+        xExpected(i) = i % 7 - 3;
+    }
+    Vector b = A * xExpected;
+
+    LinearSystem system(&A, &b);
+    Vector x = system.Solve();
+
+    double maxError = 0.0;
+    for (int i = 1; i <= n; i++) {
+        maxError = fmax(maxError, fabs(x(i) - xExpected(i)));
+    }
+    cout << "n = " << n << ", max |x - x_expected| = " << maxError << endl;
+
+    bool ok = maxError < 1e-8;
+    if (ok) {
+        cout << "Large system VERIFIED!" << endl;
+    } else {
+        cout << "ERROR: Large system solution is inaccurate!" << endl;
+    }
+    return ok;
+}
+
 int main() {
     try {
         cout << "=== SIMPLE LINEAR SYSTEM TEST ===\n" << endl;
         solveAndDebug2x2();
         solveAndDebug3x3();
         tryDirectSolution3x3();
+        if (!solveMultipleRightHandSides()) return 1;
+        if (!solveLargeRandomSystem()) return 1;
         return 0;
     } catch (const std::exception& e) {
         cerr << "Error: " << e.what() << endl;
@@ -0,0 +1,164 @@
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <LinearModel.h>
+#include <Parallel.h>
+#include <Vector.h>
+
+using namespace std;
+
+bool check(bool condition, const string& message) {
+    if (!condition) {
+        cout << "ERROR: " << message << endl;
+    }
+    return condition;
+}
+
+// Prediction the way cpu_regression used to make it: normalize, then dot
+double normalizedPrediction(const Vector& c, const Vector& means, const Vector& stddevs, const double* x) {
+    double sum = 0.0;
+    for (int j = 0; j < c.size(); ++j) {
+        sum += c.data()[j] * (x[j] - means.data()[j]) / stddevs.data()[j];
+    }
+    return sum;
+}
+
+int main() {
+    cout << "===== Testing linear model scoring =====" << endl << endl;
+    bool ok = true;
+    const int p = 6;
+    Vector c(p), means(p), stddevs(p);
+    for (int j = 1; j <= p; ++j) {
+        c(j) = 10.0 * j - 25.0;
+        means(j) = 100.0 * j;
+        stddevs(j) = 3.0 + j * j;
+    }
+    const int m = 50000;
+    vector<double> X((size_t)m * p);
+    srand(11);
+    for (double& v : X) {
+        v = rand() % 100000 / 100.0;
+    }
+    string modelPath = "test_linear_model.bin";
+
+    try {
+        LinearModel model(c, means, stddevs);
+
+        // Test 1: folded weights give the normalized prediction
+        cout << "Test 1: folding the normalization into the weights" << endl;
+        double worst = 0.0;
+        for (int i = 0; i < m; ++i) {
+            const double* x = &X[(size_t)i * p];
+            double expected = normalizedPrediction(c, means, stddevs, x);
+            worst = fmax(worst, fabs(model.predict(x) - expected) / fmax(1.0, fabs(expected)));
+        }
+        cout << "intercept = " << model.intercept() << ", max relative difference = " << worst << endl << endl;
+        ok = check(worst < 1e-12, "folded prediction should match the normalized one") && ok;
+
+        // Test 2: batch prediction, serial and on 4 threads
+        cout << "Test 2: batch prediction" << endl;
+        vector<double> y1(m), y4(m);
+        int savedThreads = ThreadPool::instance().numThreads();
+        ThreadPool::instance().setNumThreads(1);
+        model.predict(X.data(), m, p, y1.data());
+        ThreadPool::instance().setNumThreads(4);
+        model.predict(X.data(), m, p, y4.data());
+        ThreadPool::instance().setNumThreads(savedThreads);
+        bool same = y1 == y4;
+        for (int i = 0; i < m && same; ++i) {
+            same = y1[i] == model.predict(&X[(size_t)i * p]);
+        }
+        ok = check(same, "batch predictions should equal single-row predictions") && ok;
+        cout << endl;
+
+        // Test 3: the file restores the model exactly
+        cout << "Test 3: save and load" << endl;
+        model.save(modelPath);
+        LinearModel loaded = LinearModel::load(modelPath);
+        ok = check(loaded.numFeatures() == p && loaded.intercept() == model.intercept()
+                   && loaded.weights() == model.weights() && loaded.coefficients() == model.coefficients()
+                   && loaded.means() == model.means() && loaded.stddevs() == model.stddevs(),
+                   "a loaded model should equal the saved one") && ok;
+        cout << endl;
+
+        // Test 4: CSV scoring of bare rows and machine.data records
+        cout << "Test 4: scoring text" << endl;
+        string text = "125,256,6000,256,16,128\n"
+                      "\n"
+                      "amdahl,470v/7,29,8000,32000,32,8,32,269,253\r\n"
+                      " 1.5, 2e3 ,0,0,0,-4";
+        string out = "header\n";
+        loaded.score(text.data(), text.data() + text.size(), out);
+        cout << out;
+        double rows[3][6] = {{125, 256, 6000, 256, 16, 128}, {29, 8000, 32000, 32, 8, 32}, {1.5, 2e3, 0, 0, 0, -4}};
+        istringstream lines(out);
+        string line;
+        getline(lines, line);
+        bool exact = line == "header";
+        int count = 0;
+        while (getline(lines, line)) {
+            exact = exact && count < 3 && stod(line) == model.predict(rows[count]);
+            ++count;
+        }
+        ok = check(exact && count == 3, "scores should round-trip the predictions exactly") && ok;
+        cout << endl;
+
+        // Test 5: malformed input and files
+        cout << "Test 5: error handling" << endl;
+        bool caught = false;
+        string bad = "1,2,3,4,5,6\n1,2,x,4,5,6\n";
+        try {
+            string ignored;
+            model.score(bad.data(), bad.data() + bad.size(), ignored);
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = string(e.what()).find("row 2") != string::npos;
+        }
+        ok = check(caught, "a malformed row should be reported by number") && ok;
+
+        caught = false;
+        // Rewrite the file without its intercept
+        vector<char> bytes(sizeof(LinearModel::FileHeader) + 4 * p * sizeof(double));
+        FILE* f = fopen(modelPath.c_str(), "rb");
+        bool read = fread(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        fclose(f);
+        f = fopen(modelPath.c_str(), "wb");
+        bool written = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        fclose(f);
+        ok = check(read && written, "the model file should be rewritable") && ok;
+        try {
+            LinearModel::load(modelPath);
+        } catch (const runtime_error& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "a truncated model file should be rejected") && ok;
+
+        caught = false;
+        try {
+            Vector zero(p);
+            LinearModel constant(c, means, zero);
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "a zero standard deviation should be rejected") && ok;
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+    remove(modelPath.c_str());
+
+    if (!ok) {
+        cerr << "ERROR: linear model results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
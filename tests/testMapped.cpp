@@ -0,0 +1,180 @@
+#include <iostream>
+#include <cmath>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <MappedMatrix.h>
+#include <Matrix.h>
+#include <Vector.h>
+
+using namespace std;
+
+double maxDifference(const Matrix& A, const Matrix& B) {
+    double diff = 0.0;
+    for (int i = 1; i <= A.numRows(); ++i) {
+        for (int j = 1; j <= A.numCols(); ++j) {
+            diff = fmax(diff, fabs(A(i, j) - B(i, j)));
+        }
+    }
+    return diff;
+}
+
+double maxDifference(Vector& x, Vector& y) {
+    double diff = 0.0;
+    for (int i = 1; i <= x.size(); ++i) {
+        diff = fmax(diff, fabs(x(i) - y(i)));
+    }
+    return diff;
+}
+
+int main() {
+    cout << "===== Testing memory-mapped matrices =====" << endl << endl;
+    bool ok = true;
+    const string rowMajorPath = "test_mapped_rowmajor.mat";
+    const string tiledPath = "test_mapped_tiled.mat";
+    const string createdPath = "test_mapped_created.mat";
+
+    Matrix A(75, 37);
+    for (int i = 1; i <= A.numRows(); ++i) {
+        for (int j = 1; j <= A.numCols(); ++j) {
+            A(i, j) = ((i * 13 + j * 7) % 19) / 9.0 - 1.0;
+        }
+    }
+    Matrix B(37, 5);
+    Vector x(37);
+    for (int i = 1; i <= 37; ++i) {
+        x(i) = sin(0.3 * i);
+        for (int j = 1; j <= 5; ++j) {
+            B(i, j) = cos(0.1 * i * j);
+        }
+    }
+    Matrix ABRef = A * B;
+    Vector AxRef = A * x;
+
+    try {
+        // Test 1: Both layouts round-trip and multiply like the in-memory matrix
+        cout << "Test 1: Row-major and tiled files" << endl;
+        MappedMatrix::write(rowMajorPath, A);
+        MappedMatrix::write(tiledPath, A, MappedMatrix::Layout::Tiled, 16);
+        {
+            MappedMatrix rowMajor(rowMajorPath);
+            MappedMatrix tiled(tiledPath);
+            cout << "Tiles: " << tiled.numTileRows() << " x " << tiled.numTileCols() << endl;
+            ok = ok && rowMajor.numRows() == 75 && rowMajor.numCols() == 37;
+            ok = ok && tiled.numTileRows() == 5 && tiled.numTileCols() == 3;
+            ok = ok && rowMajor(75, 37) == A(75, 37) && tiled(40, 20) == A(40, 20);
+            ok = ok && tiled.tile(5, 3).numRows() == 11 && tiled.tile(5, 3).numCols() == 5;
+            ok = ok && maxDifference(rowMajor.toMatrix(), A) == 0.0;
+            ok = ok && maxDifference(tiled.toMatrix(), A) == 0.0;
+
+            // Default panels, then panels of 3 rows so the streaming loop runs many steps
+            size_t savedPanelBytes = MappedMatrix::streamPanelBytes();
+            for (size_t panelBytes : {savedPanelBytes, (size_t)3 * 40 * sizeof(double)}) {
+                MappedMatrix::setStreamPanelBytes(panelBytes);
+                for (MappedMatrix* M : {&rowMajor, &tiled}) {
+                    Matrix AB = (*M) * B;
+                    Vector Ax = (*M) * x;
+                    cout << "Product errors: " << maxDifference(AB, ABRef) << ", "
+                         << maxDifference(Ax, AxRef) << endl;
+                    ok = ok && maxDifference(AB, ABRef) < 1e-12 && maxDifference(Ax, AxRef) < 1e-12;
+                }
+            }
+            MappedMatrix::setStreamPanelBytes(savedPanelBytes);
+
+            try {
+                rowMajor.set(1, 1, 5.0);
+                cout << "ERROR: Should not write through a read-only mapping" << endl;
+                ok = false;
+            } catch (const logic_error& e) {
+                cout << "Correctly caught exception: " << e.what() << endl;
+            }
+        }
+        cout << endl;
+
+        // Test 2: Copy-on-write changes stay in memory
+        cout << "Test 2: Copy-on-write mapping" << endl;
+        {
+            MappedMatrix cow(tiledPath, MappedMatrix::Mode::CopyOnWrite);
+            cow.set(3, 4, 100.0);
+            cow.writableTile(1, 1)(1, 1) = -100.0;
+            ok = ok && cow(3, 4) == 100.0 && cow(1, 1) == -100.0;
+        }
+        {
+            MappedMatrix reopened(tiledPath);
+            cout << "File unchanged: " << (reopened(3, 4) == A(3, 4) && reopened(1, 1) == A(1, 1)) << endl << endl;
+            ok = ok && reopened(3, 4) == A(3, 4) && reopened(1, 1) == A(1, 1);
+        }
+
+        // Test 3: A created file filled through a read-write mapping persists
+        cout << "Test 3: Read-write mapping of a created file" << endl;
+        MappedMatrix::create(createdPath, 300, 200);
+        {
+            MappedMatrix created(createdPath, MappedMatrix::Mode::ReadWrite);
+            MatrixView all = created.writableView();
+            for (int i = 1; i <= 300; ++i) {
+                for (int j = 1; j <= 200; ++j) {
+                    all(i, j) = i - j;
+                }
+            }
+            created.flush();
+        }
+        {
+            MappedMatrix reopened(createdPath);
+            bool persisted = reopened(1, 1) == 0.0 && reopened(300, 1) == 299.0 && reopened(7, 200) == -193.0;
+            cout << "Values persisted: " << persisted << endl << endl;
+            ok = ok && persisted;
+        }
+
+        // Test 4: Files that are not matrices are rejected
+        cout << "Test 4: Invalid files" << endl;
+        {
+            ofstream bogus(createdPath, ios::binary | ios::trunc);
+            bogus << "not a matrix";
+        }
+        try {
+            MappedMatrix bad(createdPath);
+            cout << "ERROR: Should have rejected the file" << endl;
+            ok = false;
+        } catch (const runtime_error& e) {
+            cout << "Correctly caught exception: " << e.what() << endl << endl;
+        }
+
+        // Test 5: Row counts beyond the int range are rejected before narrowing
+        cout << "Test 5: Out-of-range dimensions" << endl;
+        {
+            ifstream source(rowMajorPath, ios::binary);
+            string bytes((istreambuf_iterator<char>(source)), istreambuf_iterator<char>());
+            MappedMatrix::FileHeader h;
+            memcpy(&h, bytes.data(), sizeof(h));
+            h.numRows = (int64_t)INT_MAX + 1;
+            memcpy(&bytes[0], &h, sizeof(h));
+            ofstream patched(createdPath, ios::binary | ios::trunc);
+            patched.write(bytes.data(), bytes.size());
+        }
+        try {
+            MappedMatrix bad(createdPath);
+            cout << "ERROR: Should have rejected the dimensions" << endl;
+            ok = false;
+        } catch (const runtime_error& e) {
+            cout << "Correctly caught exception: " << e.what() << endl << endl;
+        }
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    remove(rowMajorPath.c_str());
+    remove(tiledPath.c_str());
+    remove(createdPath.c_str());
+
+    if (!ok) {
+        cerr << "ERROR: Memory-mapped matrix results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
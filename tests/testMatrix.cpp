@@ -1,4 +1,7 @@
 #include "Matrix.h" // Include your Matrix header file
+#include "Kernels.h"
+#include "Parallel.h"
+#include "Vector.h"
 #include <iostream>
 #include <cassert>
 #include <vector> // For comparing matrices
@@ -277,6 +280,161 @@ int main() {
 
     std::cout << "Test 10 Passed." << std::endl << std::endl;
 
+    // Test 11: Blocked kernels on sizes that don't divide the block sizes
+    std::cout << "Test 11: Large Multiplication, Determinant and Inverse" << std::endl;
+    int rowsL = 131, inner = 270, colsL = 77;
+    Matrix bigA(rowsL, inner);
+    Matrix bigB(inner, colsL);
+    for (int i = 1; i <= rowsL; ++i) {
+        for (int j = 1; j <= inner; ++j) {
+            bigA(i, j) = ((i * 31 + j * 17) % 23) - 11;
+        }
+    }
+    for (int i = 1; i <= inner; ++i) {
+        for (int j = 1; j <= colsL; ++j) {
+            bigB(i, j) = ((i * 13 + j * 7) % 19) - 9;
+        }
+    }
+    Matrix bigC = bigA * bigB;
+    Matrix naiveC(rowsL, colsL);
+    for (int i = 1; i <= rowsL; ++i) {
+        for (int j = 1; j <= colsL; ++j) {
+            double sum = 0.0;
+            for (int k = 1; k <= inner; ++k) {
+                sum += bigA(i, k) * bigB(k, j);
+            }
+            naiveC(i, j) = sum;
+        }
+    }
+    assert(areMatricesEqual(bigC, naiveC));
+
+    // Lower triangular with unit diagonal plus a row swap: determinant is -1
+    int nDet = 100;
+    Matrix lower(nDet, nDet);
+    for (int i = 1; i <= nDet; ++i) {
+        lower(i, i) = 1.0;
+        for (int j = 1; j < i; ++j) {
+            lower(i, j) = 0.1 * (((i + 2 * j) % 5) - 2);
+        }
+    }
+    Matrix swapped(nDet, nDet);
+    for (int i = 1; i <= nDet; ++i) {
+        int src = (i == 1) ? 2 : (i == 2) ? 1 : i;
+        for (int j = 1; j <= nDet; ++j) {
+            swapped(i, j) = lower(src, j);
+        }
+    }
+    double detSwapped = swapped.determinant();
+    std::cout << "Determinant of permuted unit lower triangular matrix: " << detSwapped << std::endl;
+    assert(fabs(detSwapped + 1.0) < 1e-6);
+
+    Matrix invLower = lower.inverse();
+    Matrix identityBig(nDet, nDet);
+    for (int i = 1; i <= nDet; ++i) {
+        identityBig(i, i) = 1.0;
+    }
+    assert(areMatricesEqual(lower * invLower, identityBig, 1e-6));
+    std::cout << "Test 11 Passed." << std::endl << std::endl;
+
+    // Test 12: Strassen-Winograd against the classical kernel, odd sizes included
+    std::cout << "Test 12: Strassen-Winograd Multiplication" << std::endl;
+    Matrix strassenC = bigA.strassenProduct(bigB, 16);
+    assert(areMatricesEqual(strassenC, naiveC, 1e-8));
+
+    Matrix sq(128, 128);
+    for (int i = 1; i <= 128; ++i) {
+        for (int j = 1; j <= 128; ++j) {
+            sq(i, j) = ((i * 5 + j * 11) % 17) / 8.0 - 1.0;
+        }
+    }
+    Matrix classicalSq = sq * sq;
+    assert(areMatricesEqual(sq.strassenProduct(sq, 8), classicalSq, 1e-8));
+
+    // Parallel top level and the operator* switch
+    int savedThreads = ThreadPool::instance().numThreads();
+    ThreadPool::instance().setNumThreads(4);
+    Matrix::setStrassenCrossover(16);
+    assert(areMatricesEqual(bigA * bigB, naiveC, 1e-8));
+    assert(areMatricesEqual(sq * sq, classicalSq, 1e-8));
+    Matrix::setStrassenCrossover(0);
+    ThreadPool::instance().setNumThreads(savedThreads);
+    std::cout << "Test 12 Passed." << std::endl << std::endl;
+
+    // Test 13: Blocks, rows and columns as views share storage with the matrix
+    std::cout << "Test 13: Matrix Views" << std::endl;
+    Matrix grid(6, 5);
+    for (int i = 1; i <= 6; ++i) {
+        for (int j = 1; j <= 5; ++j) {
+            grid(i, j) = 10 * i + j;
+        }
+    }
+    MatrixView middle = grid.block(2, 2, 3, 3);
+    assert(middle(1, 1) == 22 && middle(3, 3) == 44 && middle.ld() == 5);
+    middle(2, 2) = -1.0;
+    assert(grid(3, 3) == -1.0);
+    assert(middle.block(2, 1, 2, 2)(2, 2) == 43);
+
+    VectorView column = grid.col(4);
+    assert(column.size() == 6 && column.stride() == 5 && column(6) == 64);
+    column(1) = 0.0;
+    assert(grid(1, 4) == 0.0);
+    const Matrix& constGrid = grid;
+    assert(constGrid.row(2)(5) == 25);
+
+    Matrix innerCopy(grid.block(2, 2, 3, 3));
+    innerCopy(1, 1) = 99.0;
+    assert(grid(2, 2) == 22 && innerCopy(3, 3) == 44);
+    Vector columnCopy(grid.col(2));
+    assert(columnCopy.size() == 6 && columnCopy(3) == 32);
+
+    // Kernels on views: product of two blocks written into a block of a third matrix
+    Matrix product(8, 8);
+    kernels::gemm(1.0, bigA.block(3, 5, 4, 6), bigB.block(2, 7, 6, 3), 0.0, product.block(2, 2, 4, 3));
+    for (int i = 1; i <= 4; ++i) {
+        for (int j = 1; j <= 3; ++j) {
+            double expected = 0.0;
+            for (int p = 1; p <= 6; ++p) {
+                expected += bigA(i + 2, p + 4) * bigB(p + 1, j + 6);
+            }
+            assert(std::fabs(product(i + 1, j + 1) - expected) < 1e-12);
+        }
+    }
+    assert(product(1, 1) == 0.0 && product(6, 4) == 0.0);
+
+    // Strided dot, axpy and gemv on columns
+    double colDot = kernels::dot(grid.col(1), grid.col(2));
+    double expectedDot = 0.0;
+    for (int i = 1; i <= 6; ++i) {
+        expectedDot += grid(i, 1) * grid(i, 2);
+    }
+    assert(std::fabs(colDot - expectedDot) < 1e-12);
+    kernels::axpy(2.0, grid.col(1), grid.col(5));
+    assert(grid(4, 5) == 45 + 2.0 * 41);
+    Matrix mv(3, 2);
+    kernels::gemv(grid.block(1, 1, 2, 3), grid.col(1).segment(1, 3), mv.col(2).segment(1, 2));
+    assert(mv(1, 2) == 11 * 11 + 12 * 21 + 13 * 31 && mv(3, 2) == 0.0);
+    std::cout << "Test 13 Passed." << std::endl << std::endl;
+
+    // Test 14: Iterators walk the storage in row-major order
+    std::cout << "Test 14: Matrix Iterators" << std::endl;
+    Matrix small(2, 3);
+    double next = 1.0;
+    for (double& x : small) {
+        x = next++;
+    }
+    assert(small.end() - small.begin() == 6);
+    assert(small(1, 3) == 3.0 && small(2, 1) == 4.0);
+    const Matrix& constSmall = small;
+    double total = 0.0;
+    for (double x : constSmall) {
+        total += x;
+    }
+    assert(total == 21.0 && constSmall.begin() == constSmall.data());
+#if __cplusplus >= 202002L
+    assert(constSmall.span().size() == 6 && constSmall.rowSpan(2)[2] == 6.0);
+#endif
+    std::cout << "Test 14 Passed." << std::endl << std::endl;
+
     std::cout << "All tests completed successfully!" << std::endl;
 
     return 0;
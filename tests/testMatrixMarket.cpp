@@ -0,0 +1,193 @@
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <LinearOperator.h>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <MatrixMarket.h>
+#include <Parallel.h>
+#include <PosSymLinSystem.h>
+#include <SparseMatrix.h>
+#include <Vector.h>
+
+using namespace std;
+
+void writeFile(const string& path, const string& text) {
+    ofstream out(path, ios::binary | ios::trunc);
+    out << text;
+}
+
+double maxDifference(const Matrix& A, const Matrix& B) {
+    double diff = 0.0;
+    for (int i = 1; i <= A.numRows(); ++i) {
+        for (int j = 1; j <= A.numCols(); ++j) {
+            diff = fmax(diff, fabs(A(i, j) - B(i, j)));
+        }
+    }
+    return diff;
+}
+
+bool rejects(const string& path, const string& text) {
+    writeFile(path, text);
+    try {
+        matrixmarket::readDense(path);
+    } catch (const runtime_error& e) {
+        cout << "Correctly caught exception: " << e.what() << endl;
+        return true;
+    }
+    cout << "ERROR: Should have rejected:" << endl << text;
+    return false;
+}
+
+int main() {
+    cout << "===== Testing Matrix Market files =====" << endl << endl;
+    bool ok = true;
+    const string path = "test_matrix_market.mtx";
+
+    try {
+        // Test 1: Coordinate files with real, integer and pattern values
+        cout << "Test 1: Coordinate real, integer and pattern files" << endl;
+        writeFile(path,
+                  "%%MatrixMarket matrix coordinate real general\n"
+                  "% a comment\n"
+                  "\n"
+                  "3 4 4\n"
+                  "1 1 1.5\n"
+                  "2 3 -2e-1\n"
+                  "3 4 +7\n"
+                  "   3   1   4.25  \r\n");
+        Matrix A = matrixmarket::readDense(path);
+        ok = ok && A.numRows() == 3 && A.numCols() == 4;
+        ok = ok && A(1, 1) == 1.5 && A(2, 3) == -0.2 && A(3, 4) == 7.0 && A(3, 1) == 4.25 && A(1, 2) == 0.0;
+        SparseMatrix S = matrixmarket::readSparse(path);
+        ok = ok && S.nonZeros() == 4 && S(2, 3) == -0.2;
+        matrixmarket::Header h = matrixmarket::readHeader(path);
+        ok = ok && h.format == matrixmarket::Format::Coordinate && h.numEntries == 4 && h.numCols == 4;
+
+        writeFile(path, "%%MatrixMarket matrix coordinate integer general\n2 2 2\n1 2 -3\n2 1 5\n");
+        Matrix I = matrixmarket::readDense(path);
+        ok = ok && I(1, 2) == -3.0 && I(2, 1) == 5.0;
+
+        writeFile(path, "%%MatrixMarket matrix coordinate pattern general\n2 3 2\n1 3\n2 2\n");
+        Matrix P = matrixmarket::readDense(path);
+        ok = ok && P(1, 3) == 1.0 && P(2, 2) == 1.0 && P(1, 1) == 0.0;
+        cout << "Parsed values match: " << ok << endl << endl;
+
+        // Test 2: Symmetric files mirror the stored triangle
+        cout << "Test 2: Symmetric coordinate and array files" << endl;
+        writeFile(path,
+                  "%%MatrixMarket matrix coordinate real symmetric\n"
+                  "3 3 4\n1 1 4\n2 1 -1\n2 2 4\n3 3 2\n");
+        Matrix symmetric = matrixmarket::readDense(path);
+        ok = ok && symmetric(1, 2) == -1.0 && symmetric(2, 1) == -1.0 && symmetric(3, 3) == 2.0;
+        SparseMatrix symmetricSparse = matrixmarket::readSparse(path);
+        ok = ok && symmetricSparse.nonZeros() == 5;
+
+        writeFile(path, "%%MatrixMarket matrix array real symmetric\n3 3\n1\n2\n3\n4\n5\n6\n");
+        Matrix symmetricArray = matrixmarket::readDense(path);
+        ok = ok && symmetricArray(3, 1) == 3.0 && symmetricArray(1, 3) == 3.0
+                && symmetricArray(2, 2) == 4.0 && symmetricArray(2, 3) == 5.0 && symmetricArray(3, 3) == 6.0;
+        writeFile(path, "%%MatrixMarket matrix array real general\n2 3\n1\n2\n3\n4\n5\n6\n");
+        Matrix general = matrixmarket::readDense(path);
+        ok = ok && general(2, 1) == 2.0 && general(1, 2) == 3.0 && general(2, 3) == 6.0;
+        cout << "Symmetric and array layouts match: " << ok << endl << endl;
+
+        // Test 3: Written files read back exactly
+        cout << "Test 3: Round trips through the writers" << endl;
+        Matrix R(23, 17);
+        for (int i = 1; i <= 23; ++i) {
+            for (int j = 1; j <= 17; ++j) {
+                R(i, j) = sin(1.0 * i * j) / (i + j);
+            }
+        }
+        matrixmarket::write(path, R);
+        ok = ok && maxDifference(matrixmarket::readDense(path), R) == 0.0;
+        SparseMatrix RS(R);
+        matrixmarket::write(path, RS);
+        ok = ok && maxDifference(matrixmarket::readSparse(path).toDense(), R) == 0.0;
+
+        Matrix Rt(17, 23);
+        for (int i = 1; i <= 23; ++i) {
+            for (int j = 1; j <= 17; ++j) {
+                Rt(j, i) = R(i, j);
+            }
+        }
+        Matrix spd = Rt * R;
+        matrixmarket::write(path, spd, matrixmarket::Symmetry::Symmetric);
+        ok = ok && maxDifference(matrixmarket::readDense(path), spd) == 0.0;
+        cout << "Round trips exact: " << ok << endl << endl;
+
+        // Test 4: A large symmetric file, parsed on several threads, solved with sparse CG
+        cout << "Test 4: Sparse SPD system from a symmetric file" << endl;
+        int N = 200;   // a few MB, so the data section splits into several chunks
+        int n = N * N;
+        vector<SparseMatrix::Triplet> lower;
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                int row = i * N + j + 1;
+                lower.push_back({row, row, 4.0});
+                if (j > 0) lower.push_back({row, row - 1, -1.0});
+                if (i > 0) lower.push_back({row, row - N, -1.0});
+            }
+        }
+        SparseMatrix L(n, n, lower);
+        matrixmarket::write(path, L);   // the lower triangle only...
+        // ...relabelled as a symmetric file
+        {
+            ifstream in(path);
+            string text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+            text.replace(0, text.find('\n'), "%%MatrixMarket matrix coordinate real symmetric");
+            writeFile(path, text);
+        }
+        int savedThreads = ThreadPool::instance().numThreads();
+        ThreadPool::instance().setNumThreads(4);
+        SparseMatrix laplacian = matrixmarket::readSparse(path);
+        ThreadPool::instance().setNumThreads(savedThreads);
+        cout << "Nonzeros: " << laplacian.nonZeros() << endl;
+        ok = ok && laplacian.nonZeros() == 5 * n - 4 * N && laplacian(2, 1) == -1.0 && laplacian(1, 2) == -1.0;
+
+        Vector b(n);
+        for (int i = 1; i <= n; ++i) {
+            b(i) = 1.0;
+        }
+        SparseOperator op(&laplacian);
+        PosSymLinSystem system(&op, &b);
+        streambuf* saved = cout.rdbuf(nullptr);   // CG prints every iteration
+        Vector x = system.Solve();
+        cout.rdbuf(saved);
+        Vector r = laplacian * x;
+        double residual = 0.0;
+        for (int i = 1; i <= n; ++i) {
+            residual = fmax(residual, fabs(r(i) - b(i)));
+        }
+        cout << "CG residual: " << residual << endl << endl;
+        ok = ok && residual < 1e-8;
+
+        // Test 5: Malformed files
+        cout << "Test 5: Malformed files" << endl;
+        ok = rejects(path, "%%MatrixMarket matrix coordinate complex general\n1 1 1\n1 1 1 0\n") && ok;
+        ok = rejects(path, "%%MatrixMarket tensor coordinate real general\n1 1 1\n1 1 1\n") && ok;
+        ok = rejects(path, "%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1\n") && ok;
+        ok = rejects(path, "%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n") && ok;
+        ok = rejects(path, "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 x\n") && ok;
+        ok = rejects(path, "%%MatrixMarket matrix coordinate real symmetric\n2 2 1\n1 2 1\n") && ok;
+        ok = rejects(path, "%%MatrixMarket matrix coordinate real general\n3000000000 1 0\n") && ok;
+        ok = rejects(path, "%%MatrixMarket matrix array real general\n3000000000 3000000000\n") && ok;
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    remove(path.c_str());
+    if (!ok) {
+        cerr << "ERROR: Matrix Market results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
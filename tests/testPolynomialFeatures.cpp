@@ -0,0 +1,185 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <PolynomialFeatures.h>
+#include <Vector.h>
+
+using namespace std;
+
+bool check(bool condition, const string& message) {
+    if (!condition) {
+        cout << "ERROR: " << message << endl;
+    }
+    return condition;
+}
+
+// XᵀX and Xᵀy of the materialized expansion, for comparison
+void explicitNormalEquations(const PolynomialFeatures& features, const Matrix& X, const Vector& y,
+                             Matrix& G, Vector& Xty) {
+    int q = features.numFeatures();
+    vector<double> row(q);
+    for (int i = 1; i <= X.numRows(); ++i) {
+        features.expandRow(X.data() + (size_t)(i - 1) * X.numCols(), row.data());
+        for (int a = 0; a < q; ++a) {
+            for (int b = 0; b < q; ++b) {
+                G(a + 1, b + 1) += row[a] * row[b];
+            }
+            Xty(a + 1) += row[a] * y(i);
+        }
+    }
+}
+
+int main() {
+    cout << "===== Testing implicit polynomial features =====" << endl << endl;
+    bool ok = true;
+    vector<string> names = {"MYCT", "MMIN", "MMAX", "CACH", "CHMIN", "CHMAX"};
+
+    try {
+        // Test 1: number and order of terms
+        cout << "Test 1: terms" << endl;
+        PolynomialFeatures quadratic(6, 2);
+        PolynomialFeatures cubic(6, 3);
+        PolynomialFeatures powers(6, 2, InteractionSet::None);
+        PolynomialFeatures pairs(6, 3, InteractionSet::Pairwise);
+        PolynomialFeatures noIntercept(6, 2, InteractionSet::All, false);
+        cout << "degree 2: " << quadratic.numFeatures() << ", degree 3: " << cubic.numFeatures()
+             << ", powers only: " << powers.numFeatures() << ", cubic pairwise: " << pairs.numFeatures()
+             << ", degree 2 without intercept: " << noIntercept.numFeatures() << endl;
+        ok = check(quadratic.numFeatures() == 28 && cubic.numFeatures() == 84 && powers.numFeatures() == 13
+                   && pairs.numFeatures() == 64 && noIntercept.numFeatures() == 27, "wrong number of terms") && ok;
+        cout << "degree 2 terms:";
+        for (int k = 0; k < quadratic.numFeatures(); ++k) {
+            cout << " " << quadratic.termName(k, names);
+        }
+        cout << endl;
+        ok = check(quadratic.termName(0, names) == "1" && quadratic.termName(1, names) == "MYCT"
+                   && quadratic.termName(7, names) == "MYCT^2" && quadratic.termName(8, names) == "MYCT*MMIN",
+                   "terms should be ordered by degree, then by variables") && ok;
+        ok = check(cubic.termName(cubic.numFeatures() - 1, names) == "CHMAX^3"
+                   && pairs.termName(28, names) == "MYCT^3", "cubic terms should be named by their powers") && ok;
+        cout << endl;
+
+        // Test 2: the implicit Gram matrix equals the materialized one
+        cout << "Test 2: Gram matrix of a 10003-row cubic expansion" << endl;
+        const int n = 10003;
+        srand(3);
+        Matrix X(n, 6);
+        Vector y(n);
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= 6; ++j) {
+                X(i, j) = (rand() % 2001 - 1000) / 1000.0;
+            }
+            y(i) = (rand() % 2001 - 1000) / 100.0;
+        }
+        int q = cubic.numFeatures();
+        Matrix G(q, q), Gref(q, q);
+        Vector g(q), gref(q);
+        cubic.normalEquations(X, y, G, g);
+        explicitNormalEquations(cubic, X, y, Gref, gref);
+        double worst = 0.0;
+        for (int a = 1; a <= q; ++a) {
+            for (int b = 1; b <= q; ++b) {
+                worst = fmax(worst, fabs(G(a, b) - Gref(a, b)) / sqrt(Gref(a, a) * Gref(b, b)));
+            }
+            worst = fmax(worst, fabs(g(a) - gref(a)) / (fabs(gref(a)) + 1.0));
+        }
+        cout << "max relative difference = " << worst << endl << endl;
+        ok = check(worst < 1e-12, "implicit and explicit normal equations should agree") && ok;
+
+        // Test 3: the same bits on any thread count; streaming in pieces adds up
+        cout << "Test 3: threads and streaming" << endl;
+        int savedThreads = ThreadPool::instance().numThreads();
+        ThreadPool::instance().setNumThreads(1);
+        Matrix G1(q, q);
+        Vector g1(q);
+        cubic.normalEquations(X, y, G1, g1);
+        ThreadPool::instance().setNumThreads(4);
+        Matrix G4(q, q);
+        Vector g4(q);
+        cubic.normalEquations(X, y, G4, g4);
+        ThreadPool::instance().setNumThreads(savedThreads);
+        bool same = true;
+        for (int a = 1; a <= q; ++a) {
+            same = same && g1(a) == g4(a);
+            for (int b = 1; b <= q; ++b) {
+                same = same && G1(a, b) == G4(a, b);
+            }
+        }
+        ok = check(same, "normal equations should be bitwise identical on 1 and 4 threads") && ok;
+
+        Matrix Gs(q, q);
+        Vector gs(q);
+        cubic.accumulate(X.data(), 5000, 6, y.data(), Gs.data(), gs.data());
+        cubic.accumulate(X.data() + 5000 * 6, n - 5000, 6, y.data() + 5000, Gs.data(), gs.data());
+        double streamed = 0.0;
+        for (int a = 1; a <= q; ++a) {
+            for (int b = 1; b <= q; ++b) {
+                streamed = fmax(streamed, fabs(Gs(a, b) - G(a, b)) / sqrt(G(a, a) * G(b, b)));
+            }
+        }
+        cout << "two pieces vs one pass: " << streamed << endl << endl;
+        ok = check(streamed < 1e-12, "streaming in pieces should give the same normal equations") && ok;
+
+        // Test 4: a polynomial target is recovered exactly
+        cout << "Test 4: fit of 1 + 2*MYCT - MMIN*MMAX + 0.5*CACH^2" << endl;
+        for (int i = 1; i <= n; ++i) {
+            y(i) = 1.0 + 2.0 * X(i, 1) - X(i, 2) * X(i, 3) + 0.5 * X(i, 4) * X(i, 4);
+        }
+        int q2 = quadratic.numFeatures();
+        Matrix G2(q2, q2);
+        Vector g2(q2);
+        quadratic.normalEquations(X, y, G2, g2);
+        LinearSystem system(&G2, &g2);
+        Vector theta = system.Solve();
+        double error = 0.0;
+        for (int k = 0; k < q2; ++k) {
+            string name = quadratic.termName(k, names);
+            double expected = name == "1" ? 1.0 : name == "MYCT" ? 2.0 : name == "MMIN*MMAX" ? -1.0
+                              : name == "CACH^2" ? 0.5 : 0.0;
+            error = fmax(error, fabs(theta(k + 1) - expected));
+        }
+        double row[6] = {0.5, -0.25, 0.75, 0.1, 0.0, 0.0};
+        double predicted = quadratic.predict(theta, row);
+        cout << "max coefficient error = " << error << ", prediction " << predicted << endl << endl;
+        ok = check(error < 1e-9 && fabs(predicted - (1.0 + 1.0 + 0.1875 + 0.005)) < 1e-9,
+                   "the quadratic target should be fitted exactly") && ok;
+
+        // Test 5: invalid configurations
+        cout << "Test 5: error handling" << endl;
+        bool caught = false;
+        try {
+            PolynomialFeatures bad(6, 0);
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "degree 0 should be rejected") && ok;
+        caught = false;
+        try {
+            Matrix narrow(10, 5);
+            Vector t(10);
+            quadratic.normalEquations(narrow, t, G2, g2);
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "a design with the wrong width should be rejected") && ok;
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "ERROR: polynomial feature results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
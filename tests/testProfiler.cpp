@@ -0,0 +1,125 @@
+#include <iostream>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Kernels.h>
+#include <Matrix.h>
+#include <Profiler.h>
+#include <Vector.h>
+
+using namespace std;
+
+// Stats of one region, calls == 0 when it was never entered
+profiler::RegionStats findRegion(const string& name) {
+    for (const profiler::RegionStats& s : profiler::collect()) {
+        if (s.name == name) return s;
+    }
+    return {name, 0, 0.0, 0.0, 0.0};
+}
+
+bool check(bool condition, const string& message) {
+    if (!condition) {
+        cout << "ERROR: " << message << endl;
+    }
+    return condition;
+}
+
+void userRegion(int n) {
+    PROFILE_SCOPE_WORK("user region", n, 8 * n);
+}
+
+int main() {
+    cout << "===== Testing hot-path profiler =====" << endl << endl;
+    bool ok = true;
+
+    try {
+        // Test 1: GEMM calls and FLOPs
+        cout << "Test 1: GEMM counters" << endl;
+        profiler::reset();
+        int m = 40, n = 30, k = 20;
+        vector<double> A(m * k, 1.0), B(k * n, 2.0), C(m * n, 0.0);
+        for (int rep = 0; rep < 3; ++rep) {
+            kernels::gemm(m, n, k, 1.0, A.data(), k, B.data(), n, 0.0, C.data(), n);
+        }
+        profiler::RegionStats gemm = findRegion("gemm");
+        cout << "gemm calls = " << gemm.calls << ", flops = " << gemm.flops << endl;
+        ok = check(gemm.calls == 3, "gemm should be counted three times") && ok;
+        ok = check(gemm.flops == 3 * 2.0 * m * n * k, "gemm flops should be 2mnk per call") && ok;
+        ok = check(gemm.bytes > 0.0 && gemm.seconds >= 0.0, "gemm bytes should be counted") && ok;
+        cout << endl;
+
+        // Test 2: recursive LU is one call, its GEMM updates are counted under gemm
+        cout << "Test 2: LU factorization counted once" << endl;
+        profiler::reset();
+        int size = 200;
+        Matrix M(size, size);
+        for (int i = 1; i <= size; ++i) {
+            for (int j = 1; j <= size; ++j) {
+                M(i, j) = (i == j) ? 2.0 : 1.0 / (i + j);
+            }
+        }
+        double det = M.determinant();
+        profiler::RegionStats lu = findRegion("luFactor");
+        cout << "determinant = " << det << ", luFactor calls = " << lu.calls
+             << ", gemm calls = " << findRegion("gemm").calls << endl;
+        ok = check(findRegion("determinant").calls == 1, "determinant should be counted once") && ok;
+        ok = check(lu.calls == 1, "recursive luFactor should be counted once") && ok;
+        ok = check(findRegion("gemm").calls > 0, "LU trailing updates should go through gemm") && ok;
+        cout << endl;
+
+        // Test 3: counters of several threads are merged
+        cout << "Test 3: per-thread aggregation" << endl;
+        profiler::reset();
+        const int numThreads = 4, callsPerThread = 1000, length = 64;
+        vector<thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&]() {
+                vector<double> x(length, 1.0), y(length, 0.5);
+                double sum = 0.0;
+                for (int i = 0; i < callsPerThread; ++i) {
+                    sum += kernels::dot(length, x.data(), y.data());
+                    userRegion(length);
+                }
+                if (sum != callsPerThread * 0.5 * length) {
+                    cout << "ERROR: wrong dot product" << endl;
+                }
+            });
+        }
+        for (thread& t : threads) {
+            t.join();
+        }
+        profiler::RegionStats dot = findRegion("dot");
+        profiler::RegionStats user = findRegion("user region");
+        cout << "dot calls = " << dot.calls << ", flops = " << dot.flops << endl;
+        ok = check(dot.calls == (uint64_t)numThreads * callsPerThread, "dot calls of all threads should be merged") && ok;
+        ok = check(dot.flops == 2.0 * length * numThreads * callsPerThread, "dot flops should be 2n per call") && ok;
+        ok = check(user.calls == (uint64_t)numThreads * callsPerThread, "user regions should be merged") && ok;
+        ok = check(user.bytes == 8.0 * length * numThreads * callsPerThread, "user region bytes are wrong") && ok;
+        cout << endl;
+
+        // Test 4: reports
+        cout << "Test 4: text and JSON reports" << endl;
+        ostringstream text, json;
+        profiler::writeText(text);
+        profiler::writeJson(json);
+        cout << text.str() << json.str();
+        ok = check(text.str().find("GFLOP/s") != string::npos, "text report should have a header") && ok;
+        ok = check(text.str().find("dot") != string::npos, "text report should list dot") && ok;
+        ok = check(json.str().find("{\"name\": \"dot\", \"calls\": 4000,") != string::npos,
+                   "JSON report should list dot with its calls") && ok;
+        ok = check(json.str().find("\"gemm\"") == string::npos, "reset regions should not be reported") && ok;
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "ERROR: profiler results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
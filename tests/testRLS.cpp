@@ -0,0 +1,135 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <Matrix.h>
+#include <RecursiveLeastSquares.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+#include "TestUtils.h"
+
+using namespace std;
+
+int main() {
+    cout << "===== Testing Recursive Least Squares =====" << endl << endl;
+    bool ok = true;
+    const int p = 6;
+    Vector c(p);
+    for (int j = 1; j <= p; ++j) {
+        c(j) = j - 3.5;
+    }
+
+    try {
+        // Test 1: streamed rows give the batch least-squares fit
+        cout << "Test 1: 2000 x 6 noisy system against TSQR" << endl;
+        Matrix A1(2000, p);
+        Vector b1(2000);
+        buildProblem(A1, b1, c, 0.5);
+        RecursiveLeastSquares rls1(p);
+        rls1.UpdateRows(A1, b1);
+        TallSkinnyQR tsqr1(A1, b1);
+        Vector x1 = tsqr1.Solve();
+        printVector(rls1.Coefficients(), "RLS");
+        printVector(x1, "TSQR");
+        double diff1 = maxDifference(rls1.Coefficients(), x1);
+        cout << "max |x_rls - x_tsqr| = " << diff1 << endl << endl;
+        ok = check(diff1 < 1e-6, "RLS should match the batch fit") && ok;
+        ok = check(rls1.Count() == 2000, "every row should be counted") && ok;
+
+        // Test 2: downdating the oldest rows leaves the fit of the window
+        cout << "Test 2: sliding window of 300 rows over 600" << endl;
+        Matrix A2(600, p);
+        Vector b2(600);
+        buildProblem(A2, b2, c, 0.5);
+        RecursiveLeastSquares rls2(p);
+        const int window = 300;
+        for (int i = 0; i < 600; ++i) {
+            rls2.Update(A2.data() + (size_t)i * p, b2.data()[i]);
+            if (i >= window) {
+                int old = i - window;
+                rls2.Downdate(A2.data() + (size_t)old * p, b2.data()[old]);
+            }
+        }
+        Matrix A2w(window, p);
+        Vector b2w(window);
+        buildProblem(A2w, b2w, c, 0.5, 0.01, 600 - window);
+        TallSkinnyQR tsqr2(A2w, b2w);
+        Vector x2 = tsqr2.Solve();
+        double diff2 = maxDifference(rls2.Coefficients(), x2);
+        cout << "max |x_window - x_tsqr(last 300)| = " << diff2 << endl << endl;
+        ok = check(diff2 < 1e-6, "the window fit should match TSQR on the window") && ok;
+        ok = check(rls2.Count() == window, "the count should follow downdates") && ok;
+
+        // Test 3: forgetting tracks coefficients that change mid-stream
+        cout << "Test 3: forgetting factor after a change of coefficients" << endl;
+        Vector c3(p);
+        for (int j = 1; j <= p; ++j) {
+            c3(j) = 2.0 * j;
+        }
+        Matrix before(1000, p), after(1000, p);
+        Vector bBefore(1000), bAfter(1000);
+        buildProblem(before, bBefore, c, 0.0);
+        buildProblem(after, bAfter, c3, 0.0, 0.01, 1000);
+        RecursiveLeastSquares forgetting(p, 0.98);
+        RecursiveLeastSquares remembering(p);
+        forgetting.UpdateRows(before, bBefore);
+        forgetting.UpdateRows(after, bAfter);
+        remembering.UpdateRows(before, bBefore);
+        remembering.UpdateRows(after, bAfter);
+        printVector(forgetting.Coefficients(), "lambda = 0.98");
+        printVector(remembering.Coefficients(), "lambda = 1");
+        double diff3 = maxDifference(forgetting.Coefficients(), c3);
+        cout << "max |x - new coefficients| = " << diff3 << " (lambda = 0.98), "
+             << maxDifference(remembering.Coefficients(), c3) << " (lambda = 1)" << endl << endl;
+        ok = check(diff3 < 1e-6, "forgetting should converge to the new coefficients") && ok;
+        ok = check(maxDifference(remembering.Coefficients(), c3) > 0.1,
+                   "without forgetting the old rows should still count") && ok;
+
+        // Test 4: P stays symmetric
+        cout << "Test 4: symmetry of P" << endl;
+        const Matrix& P = rls1.InverseGram();
+        double asymmetry = 0.0;
+        for (int i = 1; i <= p; ++i) {
+            for (int j = 1; j <= p; ++j) {
+                asymmetry = fmax(asymmetry, fabs(P(i, j) - P(j, i)));
+            }
+        }
+        cout << "max |P - Pᵀ| = " << asymmetry << endl << endl;
+        ok = check(asymmetry == 0.0, "P should be exactly symmetric") && ok;
+
+        // Test 5: invalid use
+        cout << "Test 5: error handling" << endl;
+        bool caught = false;
+        try {
+            RecursiveLeastSquares bad(p, 1.5);
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "a forgetting factor above 1 should be rejected") && ok;
+        caught = false;
+        try {
+            RecursiveLeastSquares single(2);
+            double added[2] = {1.0, 1.0};
+            double other[2] = {1.0, -1.0};
+            single.Update(added, 1.0);
+            single.Downdate(other, 1.0);
+        } catch (const runtime_error& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "removing a row that was never added should throw") && ok;
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "ERROR: RLS results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
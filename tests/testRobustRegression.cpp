@@ -0,0 +1,201 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <AllocationTracker.h>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <RobustRegression.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+
+using namespace std;
+
+bool check(bool condition, const string& message) {
+    if (!condition) {
+        cout << "ERROR: " << message << endl;
+    }
+    return condition;
+}
+
+void printVector(const Vector& v, const string& label) {
+    cout << label << " = [";
+    for (int i = 0; i < v.size(); ++i) {
+        cout << v.data()[i];
+        if (i + 1 < v.size()) cout << ", ";
+    }
+    cout << "]" << endl;
+}
+
+// Design with an intercept column, the given coefficients and deterministic
+// noise; every tenth row gets a gross error when outliers is set
+void buildProblem(Matrix& A, Vector& b, const Vector& coefficients, double noise, bool outliers) {
+    int m = A.numRows();
+    int p = A.numCols();
+    for (int i = 1; i <= m; ++i) {
+        double sum = 0.0;
+        for (int j = 1; j <= p; ++j) {
+            A(i, j) = j == 1 ? 1.0 : sin(0.01 * i * j + j) + ((i * 7 + j * 13) % 17) / 17.0;
+            sum += A(i, j) * coefficients.data()[j - 1];
+        }
+        b(i) = sum + noise * (((i * 31) % 101) / 50.0 - 1.0);
+        if (outliers && i % 10 == 0) {
+            b(i) += 50.0 + (i % 7);
+        }
+    }
+}
+
+double maxDifference(const Vector& x, const Vector& y) {
+    double diff = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+        diff = fmax(diff, fabs(x.data()[i] - y.data()[i]));
+    }
+    return diff;
+}
+
+int main() {
+    cout << "===== Testing IRLS robust regression =====" << endl << endl;
+    bool ok = true;
+    const int m = 20000;   // several Gram accumulation chunks
+    const int p = 5;
+    Vector c(p);
+    for (int j = 1; j <= p; ++j) {
+        c(j) = j - 2.5;
+    }
+
+    try {
+        // Test 1: without outliers Huber stays close to least squares
+        cout << "Test 1: clean data" << endl;
+        Matrix A(m, p);
+        Vector b(m);
+        buildProblem(A, b, c, 0.1, false);
+        TallSkinnyQR tsqr(A, b);
+        Vector ols = tsqr.Solve();
+        RobustRegression clean(&A, &b, RobustLoss::Huber);
+        Vector huber = clean.Fit();
+        cout << "Huber: " << clean.Iterations() << " iterations, max difference to least squares = "
+             << maxDifference(huber, ols) << endl;
+        ok = check(clean.Converged(), "Huber should converge on clean data") && ok;
+        ok = check(maxDifference(huber, ols) < 1e-2, "Huber should match least squares without outliers") && ok;
+        cout << endl;
+
+        // Test 2: with 10% gross outliers both losses recover the coefficients
+        cout << "Test 2: contaminated data" << endl;
+        buildProblem(A, b, c, 0.1, true);
+        TallSkinnyQR contaminated(A, b);
+        Vector olsOut = contaminated.Solve();
+        RobustRegression huberFit(&A, &b, RobustLoss::Huber);
+        Vector h = huberFit.Fit();
+        RobustRegression tukeyFit(&A, &b, RobustLoss::Tukey);
+        Vector t = tukeyFit.Fit(h);
+        printVector(c, "true ");
+        printVector(olsOut, "OLS  ");
+        printVector(h, "Huber");
+        printVector(t, "Tukey");
+        cout << "errors: OLS " << maxDifference(olsOut, c) << ", Huber " << maxDifference(h, c) << ", Tukey "
+             << maxDifference(t, c) << endl;
+        ok = check(maxDifference(olsOut, c) > 1.0, "least squares should be pulled away by the outliers") && ok;
+        ok = check(maxDifference(h, c) < 0.5, "Huber should resist the outliers") && ok;
+        ok = check(maxDifference(t, c) < 0.05, "Tukey should reject the outliers") && ok;
+        int rejected = 0;
+        for (int i = 1; i <= m; ++i) {
+            rejected += tukeyFit.Weights().data()[i - 1] == 0.0 && i % 10 == 0;
+        }
+        cout << rejected << " of " << m / 10 << " outliers have weight 0" << endl;
+        ok = check(rejected == m / 10, "Tukey should give every outlier weight 0") && ok;
+        cout << endl;
+
+        // Test 3: the in-place updated system is the weighted system of the final weights
+        cout << "Test 3: in-place Gram updates" << endl;
+        int updates = 0;
+        for (const IrlsIteration& it : huberFit.History()) {
+            updates += !it.rebuilt;
+        }
+        Matrix G(p, p);
+        Vector g(p);
+        const Vector& w = huberFit.Weights();
+        for (int i = 1; i <= m; ++i) {
+            for (int j = 1; j <= p; ++j) {
+                g(j) += w.data()[i - 1] * A(i, j) * b(i);
+                for (int k = 1; k <= p; ++k) {
+                    G(j, k) += w.data()[i - 1] * A(i, j) * A(i, k);
+                }
+            }
+        }
+        LinearSystem direct(&G, &g);
+        Vector weighted = direct.Solve();
+        cout << updates << " of " << huberFit.History().size() << " steps updated in place, max difference to a fresh "
+             << "weighted solve = " << maxDifference(h, weighted) << endl;
+        ok = check(updates > 0, "Huber iterations should update the Gram matrix in place") && ok;
+        ok = check(maxDifference(h, weighted) < 1e-9, "updated Gram matrix should equal the rebuilt one") && ok;
+        cout << endl;
+
+        // Test 4: warm starts
+        cout << "Test 4: warm start" << endl;
+        const vector<IrlsIteration>& history = huberFit.History();
+        cout << "CG iterations first/last reweighting: " << history[1].solverIterations << "/"
+             << history.back().solverIterations << endl;
+        ok = check(history.back().solverIterations < history[1].solverIterations,
+                   "CG should need fewer iterations as the fit settles") && ok;
+        Vector again = huberFit.Fit(h);
+        cout << "Restart from the converged fit: " << huberFit.Iterations() << " iterations" << endl;
+        ok = check(huberFit.Iterations() <= 2 && maxDifference(again, h) < 1e-6,
+                   "starting at the solution should converge at once") && ok;
+        cout << endl;
+
+        // Test 5: no Matrix or Vector allocations inside a fit
+        cout << "Test 5: allocations" << endl;
+        uint64_t allocations;
+        {
+            allocation::Scope scope("IRLS fit");
+            tukeyFit.Fit(h);
+            allocations = scope.allocations();
+        }
+        cout << "Allocations during Fit: " << allocations << endl;
+        ok = check(allocations == 0, "Fit should work in the preallocated buffers") && ok;
+        cout << endl;
+
+        // Test 6: the result does not depend on the thread count
+        cout << "Test 6: determinism" << endl;
+        ThreadPool::instance().setNumThreads(1);
+        Vector one = RobustRegression(&A, &b, RobustLoss::Huber).Fit();
+        ThreadPool::instance().setNumThreads(4);
+        Vector four = RobustRegression(&A, &b, RobustLoss::Huber).Fit();
+        ok = check(equal(one.begin(), one.end(), four.begin()), "1 and 4 threads should agree bitwise") && ok;
+        cout << endl;
+
+        // Test 7: invalid arguments
+        cout << "Test 7: invalid arguments" << endl;
+        bool caught = false;
+        try {
+            Vector shortB(m - 1);
+            RobustRegression bad(&A, &shortB, RobustLoss::Huber);
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "mismatched sizes should throw") && ok;
+        caught = false;
+        try {
+            huberFit.Fit(Vector(p + 1));
+        } catch (const invalid_argument& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "a start of the wrong length should throw") && ok;
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "ERROR: robust regression results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
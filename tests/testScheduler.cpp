@@ -0,0 +1,157 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Parallel.h>
+
+using namespace std;
+
+bool check(bool condition, const string& message) {
+    if (!condition) {
+        cout << "ERROR: " << message << endl;
+    }
+    return condition;
+}
+
+// Fork-join Fibonacci, every call below the cutoff forks one task
+long fib(int n) {
+    if (n < 15) {
+        return n < 2 ? n : fib(n - 1) + fib(n - 2);
+    }
+    long a = 0;
+    TaskGroup group;
+    group.run([&a, n] { a = fib(n - 1); });
+    long b = fib(n - 2);
+    group.wait();
+    return a + b;
+}
+
+double harmonic(int threads, int n) {
+    ThreadPool::instance().setNumThreads(threads);
+    return parallelReduce(0, n, 1000, 0.0, [](int b, int e) {
+        double sum = 0.0;
+        for (int i = b; i < e; ++i) {
+            sum += 1.0 / (i + 1.0);
+        }
+        return sum;
+    }, [](double x, double y) { return x + y; });
+}
+
+int main() {
+    // Must be set before the pool is first used
+    setenv("TINI_NUM_THREADS", "3", 1);
+
+    cout << "===== Testing work-stealing scheduler =====" << endl << endl;
+    bool ok = true;
+
+    try {
+        // Test 1: size from the environment and from the API
+        cout << "Test 1: configuration" << endl;
+        ThreadPool& pool = ThreadPool::instance();
+        cout << "TINI_NUM_THREADS=3 gives " << pool.numThreads() << " threads" << endl;
+        ok = check(pool.numThreads() == 3, "TINI_NUM_THREADS should set the pool size") && ok;
+        pool.setNumThreads(4);
+        ok = check(pool.numThreads() == 4, "setNumThreads should resize the pool") && ok;
+        cout << endl;
+
+        // Test 2: nested parallelFor visits every index once
+        cout << "Test 2: nested parallelFor" << endl;
+        const int outer = 16, inner = 5000;
+        vector<atomic<int>> visits(outer * inner);
+        for (auto& v : visits) v = 0;
+        parallelFor(0, outer, 1, [&](int o0, int o1) {
+            for (int o = o0; o < o1; ++o) {
+                parallelFor(0, inner, 100, [&](int i0, int i1) {
+                    for (int i = i0; i < i1; ++i) {
+                        visits[o * inner + i].fetch_add(1);
+                    }
+                });
+            }
+        });
+        bool once = true;
+        for (auto& v : visits) once = once && v.load() == 1;
+        ok = check(once, "every index should be visited exactly once") && ok;
+        cout << endl;
+
+        // Test 3: work reaches several threads
+        cout << "Test 3: stealing" << endl;
+        mutex idsMutex;
+        set<thread::id> ids;
+        parallelFor(0, 32, 1, [&](int, int) {
+            this_thread::sleep_for(chrono::milliseconds(2));
+            lock_guard<mutex> lock(idsMutex);
+            ids.insert(this_thread::get_id());
+        });
+        cout << "Chunks ran on " << ids.size() << " threads" << endl;
+        ok = check(ids.size() > 1 && ids.size() <= 4, "chunks should run on 2 to 4 threads") && ok;
+        cout << endl;
+
+        // Test 4: task groups, recursively
+        cout << "Test 4: task groups" << endl;
+        long f = fib(25);
+        cout << "fib(25) = " << f << endl;
+        ok = check(f == 75025, "fib(25) should be 75025") && ok;
+        cout << endl;
+
+        // Test 5: exceptions reach the joining thread
+        cout << "Test 5: exceptions" << endl;
+        bool caught = false;
+        try {
+            parallelFor(0, 100, 1, [](int b, int) {
+                if (b >= 50) throw runtime_error("chunk failed");
+            });
+        } catch (const runtime_error& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "parallelFor should rethrow a chunk's exception") && ok;
+        caught = false;
+        try {
+            TaskGroup group;
+            group.run([] { throw logic_error("task failed"); });
+            group.wait();
+        } catch (const logic_error& e) {
+            cout << "Correctly caught exception: " << e.what() << endl;
+            caught = true;
+        }
+        ok = check(caught, "TaskGroup::wait should rethrow a task's exception") && ok;
+        cout << endl;
+
+        // Test 6: reductions do not depend on the thread count
+        cout << "Test 6: deterministic parallelReduce" << endl;
+        double one = harmonic(1, 1000000);
+        double two = harmonic(2, 1000000);
+        double four = harmonic(4, 1000000);
+        cout.precision(17);
+        cout << "H(10^6) = " << one << " (1 thread), " << two << " (2), " << four << " (4)" << endl;
+        ok = check(one == two && two == four, "reductions should be bitwise identical") && ok;
+        cout << endl;
+
+        // Test 7: SerialRegion keeps parallelFor on the calling thread
+        cout << "Test 7: serial region" << endl;
+        {
+            SerialRegion serial;
+            set<thread::id> serialIds;
+            parallelFor(0, 64, 1, [&](int, int) { serialIds.insert(this_thread::get_id()); });
+            ok = check(serialIds.size() == 1 && *serialIds.begin() == this_thread::get_id(),
+                       "a serial region should run everything on the caller") && ok;
+        }
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "ERROR: scheduler results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
@@ -0,0 +1,229 @@
+#include <iostream>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <LinearSystem.h>
+#include <Matrix.h>
+#include <SolveService.h>
+#include <Vector.h>
+
+using namespace std;
+
+bool check(bool condition, const string& message) {
+    if (!condition) {
+        cout << "ERROR: " << message << endl;
+    }
+    return condition;
+}
+
+shared_ptr<Matrix> randomSystemMatrix(int n, int seed) {
+    auto A = make_shared<Matrix>(n, n);
+    for (int i = 1; i <= n; ++i) {
+        for (int j = 1; j <= n; ++j) {
+            (*A)(i, j) = sin(seed + 3.0 * i + 7.0 * j);
+        }
+        (*A)(i, i) += n;
+    }
+    return A;
+}
+
+Vector rhs(int n, int seed) {
+    Vector b(n);
+    for (int i = 1; i <= n; ++i) {
+        b(i) = cos(seed + i);
+    }
+    return b;
+}
+
+double residual(const Matrix& A, Vector& x, const Vector& b) {
+    Vector r = A * x - b;
+    return sqrt(r.dot(r));
+}
+
+// Holds the single worker until release() so requests pile up in the queue
+class BlockingSystem : public LinearSystem {
+private:
+    mutex mMutex;
+    condition_variable mSignal;
+    bool mStarted;
+    bool mReleased;
+
+public:
+    BlockingSystem(Matrix* A, Vector* b) : LinearSystem(A, b), mStarted(false), mReleased(false) {}
+
+    Vector Solve() override {
+        unique_lock<mutex> lock(mMutex);
+        mStarted = true;
+        mSignal.notify_all();
+        mSignal.wait(lock, [this] { return mReleased; });
+        return Vector(mSize);
+    }
+
+    void waitStarted() {
+        unique_lock<mutex> lock(mMutex);
+        mSignal.wait(lock, [this] { return mStarted; });
+    }
+
+    void release() {
+        lock_guard<mutex> lock(mMutex);
+        mReleased = true;
+        mSignal.notify_all();
+    }
+};
+
+int main() {
+    cout << "===== Testing asynchronous solve service =====" << endl << endl;
+    bool ok = true;
+
+    try {
+        // Test 1: independent systems of mixed sizes on several workers
+        cout << "Test 1: mixed sizes" << endl;
+        {
+            SolveService::Options options;
+            options.numWorkers = 3;
+            SolveService service(options);
+            vector<shared_ptr<Matrix>> matrices;
+            vector<Vector> rhss;
+            vector<SolveTicket> tickets;
+            for (int k = 0; k < 40; ++k) {
+                int n = 5 + k % 4;
+                matrices.push_back(randomSystemMatrix(n, k));
+                rhss.push_back(rhs(n, k));
+                tickets.push_back(service.submit(*matrices.back(), rhss.back()));
+            }
+            double worst = 0.0;
+            for (int k = 0; k < 40; ++k) {
+                Vector x = tickets[k].result.get();
+                worst = fmax(worst, residual(*matrices[k], x, rhss[k]));
+            }
+            SolveService::Stats stats = service.stats();
+            cout << "Worst residual = " << worst << ", batches = " << stats.batches << endl;
+            ok = check(worst < 1e-10, "every system should be solved") && ok;
+            ok = check(stats.submitted == 40 && stats.completed == 40, "all 40 requests should complete") && ok;
+        }
+        cout << endl;
+
+        // Test 2: queued requests of one size form one batch, shared matrices one factorization
+        cout << "Test 2: batching, cancellation and backpressure" << endl;
+        {
+            SolveService::Options options;
+            options.numWorkers = 1;
+            options.maxPending = 12;
+            options.maxBatch = 32;
+            SolveService service(options);
+
+            Matrix blockA = *randomSystemMatrix(4, 0);
+            Vector blockB = rhs(4, 0);
+            auto blocker = make_shared<BlockingSystem>(&blockA, &blockB);
+            SolveTicket blocked = service.submit(blocker);
+            blocker->waitStarted();
+
+            int n = 6;
+            auto shared = randomSystemMatrix(n, 1);
+            vector<Vector> rhss;
+            vector<SolveTicket> tickets;
+            for (int k = 0; k < 10; ++k) {
+                rhss.push_back(rhs(n, k));
+                tickets.push_back(service.submit(shared, rhss.back()));
+            }
+            auto other = randomSystemMatrix(n, 2);
+            Vector otherB = rhs(n, 99);
+            SolveTicket otherTicket = service.submit(other, otherB);
+            auto singular = make_shared<Matrix>(n, n);
+            SolveTicket singularTicket = service.submit(singular, rhs(n, 5));
+
+            // 12 requests wait, the queue is full
+            SolveTicket refused;
+            ok = check(!service.trySubmit(shared, rhss[0], refused), "a full queue should refuse trySubmit") && ok;
+            ok = check(service.pending() == 12, "12 requests should be queued") && ok;
+
+            ok = check(service.cancel(tickets[3].id), "a queued request can be cancelled") && ok;
+            ok = check(!service.cancel(blocked.id), "a running request cannot be cancelled") && ok;
+            SolveTicket accepted;
+            ok = check(service.trySubmit(shared, rhss[3], accepted), "cancelling frees a queue slot") && ok;
+
+            blocker->release();
+            blocked.result.get();
+
+            double worst = 0.0;
+            for (int k = 0; k < 10; ++k) {
+                if (k == 3) continue;
+                Vector x = tickets[k].result.get();
+                worst = fmax(worst, residual(*shared, x, rhss[k]));
+            }
+            Vector x = accepted.result.get();
+            worst = fmax(worst, residual(*shared, x, rhss[3]));
+            Vector y = otherTicket.result.get();
+            worst = fmax(worst, residual(*other, y, otherB));
+            ok = check(worst < 1e-10, "batched solves should be accurate") && ok;
+
+            try {
+                tickets[3].result.get();
+                ok = check(false, "a cancelled request should report SolveCancelled") && ok;
+            } catch (const SolveCancelled& e) {
+                cout << "Correctly caught exception: " << e.what() << endl;
+            }
+            try {
+                singularTicket.result.get();
+                ok = check(false, "a singular system should fail") && ok;
+            } catch (const runtime_error& e) {
+                cout << "Correctly caught exception: " << e.what() << endl;
+            }
+
+            SolveService::Stats stats = service.stats();
+            cout << "batches = " << stats.batches << ", completed = " << stats.completed << ", failed = "
+                 << stats.failed << ", cancelled = " << stats.cancelled << endl;
+            ok = check(stats.batches == 2, "the blocker and one batch of the 12 queued requests") && ok;
+            ok = check(stats.completed == 12 && stats.failed == 1 && stats.cancelled == 1, "wrong counters") && ok;
+        }
+        cout << endl;
+
+        // Test 3: shutdown cancels what is still queued
+        cout << "Test 3: shutdown" << endl;
+        {
+            SolveService::Options options;
+            options.numWorkers = 1;
+            SolveService service(options);
+            Matrix blockA = *randomSystemMatrix(4, 0);
+            Vector blockB = rhs(4, 0);
+            auto blocker = make_shared<BlockingSystem>(&blockA, &blockB);
+            SolveTicket blocked = service.submit(blocker);
+            blocker->waitStarted();
+            SolveTicket queued = service.submit(*randomSystemMatrix(3, 1), rhs(3, 1));
+
+            blocker->release();
+            service.shutdown();
+            blocked.result.get();
+            bool cancelled = false;
+            try {
+                queued.result.get();
+            } catch (const SolveCancelled&) {
+                cancelled = true;
+            }
+            // The worker may take the request before shutdown() runs
+            ok = check(cancelled || service.stats().completed == 2, "queued request should be cancelled or done") && ok;
+            bool rejected = false;
+            try {
+                service.submit(*randomSystemMatrix(3, 2), rhs(3, 2));
+            } catch (const logic_error& e) {
+                cout << "Correctly caught exception: " << e.what() << endl;
+                rejected = true;
+            }
+            ok = check(rejected, "submit after shutdown should throw") && ok;
+        }
+        cout << endl;
+    } catch (const exception& e) {
+        cerr << "Unexpected exception: " << e.what() << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cerr << "ERROR: solve service results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <Matrix.h>
+#include <Parallel.h>
+#include <TallSkinnyQR.h>
+#include <Vector.h>
+
+using namespace std;
+
+void printVector(Vector& v, const string& label) {
+    cout << label << " = [";
+    for (int i = 1; i <= v.size(); ++i) {
+        cout << v(i);
+        if (i < v.size()) cout << ", ";
+    }
+    cout << "]" << endl;
+}
+
+// Regression-shaped design: m rows, p features, known coefficients plus noise
+void buildProblem(Matrix& A, Vector& b, Vector& coefficients, double noise) {
+    int m = A.numRows();
+    int p = A.numCols();
+    for (int j = 1; j <= p; ++j) {
+        coefficients(j) = j - 3.5;
+    }
+    for (int i = 1; i <= m; ++i) {
+        double sum = 0.0;
+        for (int j = 1; j <= p; ++j) {
+            A(i, j) = sin(0.001 * i * j + j) + ((i * 7 + j * 13) % 17) / 17.0;
+            sum += A(i, j) * coefficients(j);
+        }
+        b(i) = sum + noise * (((i * 31) % 101) / 50.0 - 1.0);
+    }
+}
+
+// Normal-equation solution through pseudoInverse() for comparison
+Vector solveNormalEquations(Matrix& A, Vector& b) {
+    Matrix Aplus = A.pseudoInverse();
+    return Aplus * b;
+}
+
+double maxDifference(Vector& x, Vector& y) {
+    double diff = 0.0;
+    for (int i = 1; i <= x.size(); ++i) {
+        diff = fmax(diff, fabs(x(i) - y(i)));
+    }
+    return diff;
+}
+
+int main() {
+    cout << "===== Testing Tall-Skinny QR Least Squares =====" << endl << endl;
+    bool ok = true;
+
+    // Test 1: Exact data, coefficients must be recovered
+    cout << "Test 1: Consistent 5000 x 6 system" << endl;
+    Matrix A1(5000, 6);
+    Vector b1(5000);
+    Vector c1(6);
+    buildProblem(A1, b1, c1, 0.0);
+    TallSkinnyQR tsqr1(A1, b1, 8);
+    Vector x1 = tsqr1.Solve();
+    printVector(x1, "Solution x");
+    printVector(c1, "Expected");
+    cout << "Residual norm: " << tsqr1.ResidualNorm() << endl << endl;
+    ok = ok && maxDifference(x1, c1) < 1e-9 && tsqr1.ResidualNorm() < 1e-8;
+
+    // Test 2: Noisy data, agreement with the normal equations and residual norm check
+    cout << "Test 2: Noisy 20000 x 6 system, block counts 1, 3 and 16" << endl;
+    Matrix A2(20000, 6);
+    Vector b2(20000);
+    Vector c2(6);
+    buildProblem(A2, b2, c2, 0.5);
+    Vector xRef = solveNormalEquations(A2, b2);
+    Vector residual = b2 - A2 * xRef;
+    double residualRef = sqrt(residual.dot(residual));
+
+    int blockCounts[] = {1, 3, 16};
+    for (int blocks : blockCounts) {
+        TallSkinnyQR tsqr(A2, b2, blocks);
+        Vector x = tsqr.Solve();
+        double diff = maxDifference(x, xRef);
+        cout << blocks << " blocks: max |x - x_normal| = " << diff
+             << ", residual " << tsqr.ResidualNorm() << " (expected " << residualRef << ")" << endl;
+        ok = ok && diff < 1e-8 && fabs(tsqr.ResidualNorm() - residualRef) < 1e-8 * residualRef;
+    }
+
+    // Test 3: Same result on a multi-threaded pool
+    int savedThreads = ThreadPool::instance().numThreads();
+    ThreadPool::instance().setNumThreads(4);
+    TallSkinnyQR tsqr3(A2, b2);
+    Vector x3 = tsqr3.Solve();
+    ThreadPool::instance().setNumThreads(savedThreads);
+    cout << "4 threads: max |x - x_normal| = " << maxDifference(x3, xRef) << endl << endl;
+    ok = ok && maxDifference(x3, xRef) < 1e-8;
+
+    // Test 4: RᵀR must equal AᵀA
+    cout << "Test 4: R factor" << endl;
+    Matrix R = tsqr1.R();
+    Matrix At(6, 5000);
+    for (int i = 1; i <= 5000; ++i) {
+        for (int j = 1; j <= 6; ++j) At(j, i) = A1(i, j);
+    }
+    Matrix Rt(6, 6);
+    for (int i = 1; i <= 6; ++i) {
+        for (int j = 1; j <= 6; ++j) Rt(j, i) = R(i, j);
+    }
+    Matrix gram = At * A1;
+    Matrix diffGram = Rt * R - gram;
+    double gramError = 0.0;
+    for (int i = 1; i <= 6; ++i) {
+        for (int j = 1; j <= 6; ++j) {
+            gramError = fmax(gramError, fabs(diffGram(i, j)) / fabs(gram(i, i)));
+            if (j < i && R(i, j) != 0.0) ok = false;
+        }
+    }
+    cout << "max |RᵀR - AᵀA| / |AᵀA|_ii = " << gramError << endl << endl;
+    ok = ok && gramError < 1e-12;
+
+    if (!ok) {
+        cerr << "ERROR: TSQR results are wrong" << endl;
+        return 1;
+    }
+    cout << "All tests completed." << endl;
+    return 0;
+}
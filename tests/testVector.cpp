@@ -165,6 +165,37 @@ void testIndexing() {
     cout << "Indexing tests passed!" << endl;
 }
 
+void testIterators() {
+    cout << "Testing iterators and raw access..." << endl;
+
+    Vector v1(4);
+    double value = 1.0;
+    for (double& x : v1) {
+        x = value++;
+    }
+    assert(v1.end() - v1.begin() == 4);
+    assert(v1.begin() == v1.data());
+    assert(isEqual(v1(4), 4.0));
+
+    const Vector& c = v1;
+    double sum = 0.0;
+    for (double x : c) {
+        sum += x;
+    }
+    assert(isEqual(sum, 10.0));
+    assert(isEqual(c[0], 1.0));
+    assert(isEqual(c(2), 2.0));
+
+#if __cplusplus >= 202002L
+    std::span<const double> s = c.span();
+    assert(s.size() == 4 && isEqual(s[3], 4.0));
+    Vector v2(s.subspan(1, 2));
+    assert(v2.size() == 2 && isEqual(v2(1), 2.0) && isEqual(v2(2), 3.0));
+#endif
+
+    cout << "Iterator tests passed!" << endl;
+}
+
 int main() {
     try {
         cout << "Running Vector class tests..." << endl;
@@ -175,6 +206,7 @@ int main() {
         testBinaryOperators();
         testDotProduct();
         testIndexing();
+        testIterators();
 
         cout << "All tests passed successfully!" << endl;
         return 0;